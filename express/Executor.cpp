@@ -6,7 +6,9 @@
 //  Copyright © 2018, Alibaba Group Holding Limited
 //
 
+#include <future>
 #include <set>
+#include <tuple>
 #include <MNN/expr/Executor.hpp>
 #include "core/Session.hpp"
 #include "core/TensorUtils.hpp"
@@ -17,6 +19,7 @@
 #include "geometry/GeometryComputerUtils.hpp"
 #include <MNN/expr/ExecutorScope.hpp>
 #include <core/BufferAllocator.hpp>
+#include "core/PlanBundle.hpp"
 #ifdef MNN_EXPR_ENABLE_PROFILER
 #define MNN_EXPRESS_ERROR_REPORT
 #endif
@@ -83,6 +86,198 @@ void Executor::Profiler::addFlops(const std::string& opType, float flops) {
     iter->second += flops;
 }
 #endif
+// Executions of weight-carrying ops, shared between compute caches. Every training step rebuilds its graph and
+// so its compute cache, but ops with constant weights (frozen layers, evaluation) come back with the same content:
+// a clone reuses the prototype's prepacked weights instead of packing them again in onCreate. The command orders
+// of reorderCommands are kept the same way, a rebuilt step has the same command graph.
+class Executor::ExecutionCache {
+public:
+    // two unrelated hashes of the content and its size: sharing on a collision would run with other weights
+    typedef std::tuple<uint64_t, uint64_t, size_t> Key;
+    struct Entry {
+        // the prototype's resources are released through the backend that created them
+        std::shared_ptr<Backend> backend;
+        std::shared_ptr<Execution> execution;
+        bool used = true;
+    };
+    // false if executions of this op are not shared
+    static bool makeKey(const Op* op, const std::vector<Tensor*>& inputs, Key& key);
+    Entry* find(const Key& key) {
+        auto iter = mEntries.find(key);
+        if (iter == mEntries.end()) {
+            return nullptr;
+        }
+        iter->second.used = true;
+        return &iter->second;
+    }
+    void insert(const Key& key, std::shared_ptr<Backend> backend, std::shared_ptr<Execution> execution) {
+        Entry entry;
+        entry.backend   = std::move(backend);
+        entry.execution = std::move(execution);
+        mEntries[key]   = std::move(entry);
+    }
+    struct OrderEntry {
+        // empty if the graph keeps its original order
+        std::vector<int> order;
+        // simulated peaks of live bytes in the original order and in the one run
+        int64_t originPeak = 0;
+        int64_t orderPeak  = 0;
+        bool used = true;
+    };
+    // the order found for a command graph, also the last one looked up or found for lastOrderPeak
+    const OrderEntry* findOrder(const Key& key) {
+        auto iter = mOrders.find(key);
+        if (iter == mOrders.end()) {
+            return nullptr;
+        }
+        iter->second.used = true;
+        mLastPeak = std::make_pair(iter->second.originPeak, iter->second.orderPeak);
+        return &iter->second;
+    }
+    void insertOrder(const Key& key, OrderEntry entry) {
+        mLastPeak    = std::make_pair(entry.originPeak, entry.orderPeak);
+        mOrders[key] = std::move(entry);
+    }
+    std::pair<int64_t, int64_t> lastPeak() const {
+        return mLastPeak;
+    }
+    // full: drop all, otherwise the ones unused since the last gc
+    void gc(bool full) {
+        _gc(mEntries, full);
+        _gc(mOrders, full);
+    }
+
+private:
+    template <typename T>
+    static void _gc(std::map<Key, T>& entries, bool full) {
+        for (auto iter = entries.begin(); iter != entries.end();) {
+            if (full || !iter->second.used) {
+                iter = entries.erase(iter);
+                continue;
+            }
+            iter->second.used = false;
+            iter++;
+        }
+    }
+    std::map<Key, Entry> mEntries;
+    std::map<Key, OrderEntry> mOrders;
+    std::pair<int64_t, int64_t> mLastPeak;
+};
+
+namespace {
+class KeyHasher {
+public:
+    void mix(const void* data, size_t size) {
+        auto bytes = (const uint8_t*)data;
+        // FNV-1a
+        for (size_t i = 0; i < size; ++i) {
+            mHash ^= bytes[i];
+            mHash *= 1099511628211ULL;
+        }
+        // multiply-rotate over words, so it doesn't collide where FNV does
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            ::memcpy(&word, bytes + i, sizeof(word));
+            _mixCheck(word);
+        }
+        uint64_t tail = 0;
+        ::memcpy(&tail, bytes + i, size - i);
+        _mixCheck(tail);
+        mSize += size;
+    }
+    template <typename T>
+    void mix(const flatbuffers::Vector<T>* vec) {
+        // absent and empty differ
+        int32_t size = nullptr == vec ? -1 : (int32_t)vec->size();
+        mix(&size, sizeof(size));
+        if (nullptr != vec) {
+            mix(vec->data(), vec->size() * sizeof(T));
+        }
+    }
+    template <typename T>
+    void mixValue(T value) {
+        mix(&value, sizeof(value));
+    }
+    std::tuple<uint64_t, uint64_t, size_t> key() const {
+        return std::make_tuple(mHash, mCheck, mSize);
+    }
+
+private:
+    void _mixCheck(uint64_t word) {
+        mCheck ^= word;
+        mCheck = (mCheck << 31) | (mCheck >> 33);
+        mCheck *= 0x9E3779B97F4A7C15ULL;
+    }
+    uint64_t mHash  = 14695981039346656037ULL;
+    uint64_t mCheck = 0;
+    size_t mSize    = 0;
+};
+} // namespace
+
+bool Executor::ExecutionCache::makeKey(const Op* op, const std::vector<Tensor*>& inputs, Key& key) {
+    // weights are part of the op for single input convolutions. A convolution with its weight as second input
+    // (the data gradient of a trainable one) repacks it on every execution, op and input shapes are its key
+    if (op->main_type() != OpParameter_Convolution2D ||
+        (1 != inputs.size() && (OpType_Convolution != op->type() || 2 != inputs.size()))) {
+        return false;
+    }
+    // the content is the key: ops are rebuilt at new addresses every step, and an op reusing a freed
+    // address may carry other weights. Read in place, repacking the op would copy all of them
+    KeyHasher hasher;
+    hasher.mixValue((int32_t)op->type());
+    hasher.mixValue((int32_t)inputs.size());
+    auto conv   = op->main_as_Convolution2D();
+    auto common = conv->common();
+    hasher.mixValue((int32_t)(nullptr != common));
+    if (nullptr != common) {
+        int32_t values[] = {common->padX(),    common->padY(),    common->kernelX(),     common->kernelY(),
+                            common->strideX(), common->strideY(), common->dilateX(),     common->dilateY(),
+                            common->padMode(), common->group(),   common->outputCount(), common->inputCount(),
+                            common->relu(),    common->relu6()};
+        hasher.mix(values, sizeof(values));
+        hasher.mix(common->pads());
+        hasher.mix(common->outPads());
+    }
+    hasher.mix(conv->weight());
+    hasher.mix(conv->bias());
+    auto quan = conv->quanParameter();
+    hasher.mixValue((int32_t)(nullptr != quan));
+    if (nullptr != quan) {
+        hasher.mix(quan->buffer());
+        hasher.mix(quan->alpha());
+        int32_t values[] = {quan->type(), quan->useInt32(), quan->aMax(), quan->aMin(), quan->readType(),
+                            quan->has_scaleInt()};
+        hasher.mix(values, sizeof(values));
+        float scales[] = {quan->quantScale(), quan->scaleIn(), quan->scaleOut()};
+        hasher.mix(scales, sizeof(scales));
+    }
+    auto symmetric = conv->symmetricQuan();
+    hasher.mixValue((int32_t)(nullptr != symmetric));
+    if (nullptr != symmetric) {
+        hasher.mix(symmetric->weight());
+        hasher.mix(symmetric->bias());
+        hasher.mix(symmetric->scale());
+        hasher.mix(symmetric->tensorScale());
+        int32_t values[] = {symmetric->method(),          symmetric->nbits(),    symmetric->zeroPoint(),
+                            symmetric->outputZeroPoint(), symmetric->clampMin(), symmetric->clampMax()};
+        hasher.mix(values, sizeof(values));
+    }
+    // Winograd picks its unit and transforms its weights for the input shape
+    for (auto t : inputs) {
+        auto& buffer = t->buffer();
+        // field by field, halide_type_t has padding
+        int32_t values[] = {(int32_t)buffer.type.code, (int32_t)buffer.type.bits,
+                            (int32_t)TensorUtils::getDescribe(t)->dimensionFormat, buffer.dimensions};
+        hasher.mix(values, sizeof(values));
+        for (int d = 0; d < buffer.dimensions; ++d) {
+            hasher.mixValue(buffer.dim[d].extent);
+        }
+    }
+    key = hasher.key();
+    return true;
+}
+
 void Executor::setGlobalExecutorConfig(MNNForwardType type, const BackendConfig& config, int numberThread) {
     std::lock_guard<std::mutex> _l(mMutex);
     auto creator = MNNGetExtraRuntimeCreator(type);
@@ -98,11 +293,13 @@ void Executor::setGlobalExecutorConfig(MNNForwardType type, const BackendConfig&
     info.numThread = numberThread;
     info.user = (BackendConfig*)&config;
     std::shared_ptr<Runtime> bn(creator->onCreate(info));
+    mExecutionCache->gc(true);
     mRuntime.first = bn;
     mRuntime.second = type;
 }
 
 void Executor::gc(GCFlag flag) {
+    mExecutionCache->gc(FULL == flag);
     if (FULL == flag) {
         mBackupRuntime.first->onGabageCollect(100);
         mRuntime.first->onGabageCollect(100);
@@ -112,6 +309,7 @@ void Executor::gc(GCFlag flag) {
     }
 }
 Executor::Executor(std::shared_ptr<Runtime> backend, MNNForwardType type) {
+    mExecutionCache.reset(new ExecutionCache);
     mRuntime.first = backend;
     mRuntime.second = type;
     Backend::Info info;
@@ -127,6 +325,7 @@ Executor::Executor(std::shared_ptr<Runtime> backend, MNNForwardType type) {
 #endif
 }
 Executor::~Executor(){
+    mExecutionCache = nullptr;
     mRuntime.first = nullptr;
     mBackupRuntime.first = nullptr;
 }
@@ -177,6 +376,7 @@ std::shared_ptr<Executor> Executor::newExecutor(MNNForwardType type,
     Backend::Info info;
     info.type = type;
     info.numThread = numberThread;
+    info.user = (BackendConfig*)&config;
     std::shared_ptr<Runtime> bn(creator->onCreate(info));
     return std::shared_ptr<Executor>(new Executor(bn, type));
 }
@@ -237,8 +437,16 @@ public:
     ErrorCode computeViaStrategy();
     ErrorCode computeAdaptively();
     ErrorCode computeViaSwapping();
+    ErrorCode estimateExecution();
+    // run one (action, op) step of mExecuteStrategy, maxComputed tracks the furthest op computed
+    ErrorCode computeStrategyStep(const std::pair<std::string, int>& step, int& maxComputed);
+    ErrorCode waitSwap(int op);
+    // wait for every swap in flight, the first error of them
+    ErrorCode waitAllSwaps();
     ErrorCode computeIthOp(int i, bool profile=false, bool recompute=false, std::vector<int> skipReleaseOpID={}, bool viaStrategy=false, bool enableSwap=false);
     ErrorCode setExecutionStrategy(std::string model, int batch, int bgt);
+    ErrorCode setExecutionStrategy(std::shared_ptr<PlanBundle> bundle, int rung);
+    void rewind();
     void setMethodAndTarget(std::string method, std::string target);
     void config(std::string model, int batch);
     void setBudgetAndProgress(size_t bgt, size_t bgt_adap, float adaptiveProgress);
@@ -253,12 +461,35 @@ private:
     friend class Executor;
     bool mContentDirty = true;
     bool mShapeDirty = true;
+    // a run left its buffers and use counts behind, rewind before running again
+    bool mComputed = false;
     GeometryComputer::Context mContext;
     CommandBuffer mCmdBuffer;
     std::vector<std::shared_ptr<Execution>> mExecutions;
     std::map<const Op*, std::shared_ptr<Execution>> mCacheExes;
+    std::shared_ptr<ExecutionCache> mExecutionCache;
+    // backends of the prototypes this cache cloned from
+    std::set<std::shared_ptr<Backend>> mCloneSources;
+    std::shared_ptr<Execution> _createExecution(const Command& cmd, const Op* op);
     std::vector<std::pair<std::string, int>> mExecuteStrategy;
+    std::shared_ptr<PlanBundle> mPlan;
     bool mComputeHeuristically=false;
+    bool _planMatchGraph();
+    void countUses();
+    // reorder independent commands to lower the peak of live bytes, kept only when the peak drops
+    void reorderCommands();
+    bool mMemoryAwareOrder = false;
+    // copy an output to host memory once its last reader ran and give its buffer back to the pool
+    void planDrain();
+    ErrorCode drainOutput(int offset);
+    bool isEagerOutput(const Tensor* t) const {
+        return mDrainOffset.find(t) != mDrainOffset.end();
+    }
+    bool mEagerOutputs = false;
+    std::map<int, std::vector<int>> mDrainAfter;  // command -> offsets of the outputs drained after it
+    std::map<const Tensor*, int> mDrainOffset;
+    std::vector<std::vector<uint8_t>> mDrained;
+    std::set<int> mDrainedOffsets;
 
     bool zeroInputs() {
 //        return mInputs.empty();
@@ -282,11 +513,13 @@ private:
     std::vector<int> getRecomputeOpList(int curOpID);
     std::string mModelname = "";
     int mBatchsize = 0;
-    std::string mComputeMethod = "direct";  // == "direct" || "sublinear" || "strategy"
-    std::string mComputeTarget = "mnn";  // == "mnn" || "sublinear" || "ours" || "capuchin" || "profile" || "resize" || "cost"
+    std::string mComputeMethod = "direct";  // == "direct" || "sublinear" || "strategy" || "estimate"
+    std::string mComputeTarget = "mnn";  // == "mnn" || "sublinear" || "ours" || "capuchin" || "profile" || "resize" || "cost" || "estimate"
     std::set<Tensor*> allocatedTensor;
     std::vector<int> featureMap;
     std::map<int, bool>featureSwapoutFlag;
+    // swap-out / swap-in of op outputs still in flight, planned swaps overlap the compute that follows them
+    std::map<int, std::future<ErrorCode>> mSwapping;
     size_t budget, adaptiveBudget;
     float adaptiveProgress;
 };
@@ -320,6 +553,13 @@ Tensor* Executor::getOutput(ComputeCache* cache, int offset) {
 
 void* Executor::ComputeCache::mapOutput(int offset, Tensor* dest) {
     auto tensor = mOutputs[offset];
+    if (mDrainedOffsets.find(offset) != mDrainedOffsets.end()) {
+        auto ptr = mDrained[offset].data();
+        Utils::releaseMemoryForHostTensor(dest);
+        TensorUtils::getDescribe(dest)->memoryType = Tensor::InsideDescribe::MEMORY_BACKEND;
+        dest->buffer().host = (uint8_t*)ptr;
+        return ptr;
+    }
     if (0 == tensor->deviceId()) {
         auto ptr =  tensor->host<void>();
         Utils::releaseMemoryForHostTensor(dest);
@@ -345,16 +585,22 @@ void Executor::ComputeCache::setContentDirty() {
 Executor::ComputeCache::ComputeCache(std::shared_ptr<Backend> backend, std::shared_ptr<Backend> backupBackend) : mContext(backupBackend) {
     mBackend = backend;
     mBackupBackend = backupBackend;
+    mContext.setPermitRegionInput(MNN_FORWARD_CPU == backend->type());
+    mContext.setPermitWeightInput(MNN_FORWARD_CPU == backend->type());
 }
 Executor::ComputeCache::~ComputeCache() {
     MNN_DEBUG_PRINT("call %s\n", __FUNCTION__ )
     mUnits.clear();
     mCacheExes.clear();
+    // clones release shared resources through mCloneSources
+    mExecutions.clear();
 }
 ErrorCode Executor::ComputeCache::compute() {
     MNN_DEBUG_PRINT("call ComputeCache::compute\n")
-    allocatedTensor.clear();
 //    MNN_ASSERT(validCkptLevel.size()==0)
+    if (mComputed && (mShapeDirty || mContentDirty)) {
+        rewind();
+    }
     if (mShapeDirty) { // default true
         auto code = resize();
         if (zeroInputs()) {
@@ -384,6 +630,8 @@ ErrorCode Executor::ComputeCache::compute() {
 //    mBackend->onClearBuffer();
 //    MNN_DEBUG_PRINT("%s: finish onClearBuffer\n", __FUNCTION__ )
 //    ExecutorScope::Current()->gc();
+    allocatedTensor.clear();
+    mComputed = true;
     MNN_DEBUG_PRINT("before execute %lu cmds\n", mExecutions.size())
     MNN_MEMORY_PROFILE("before execute %lu cmds", mExecutions.size())
     tensorFromOp.resize(mExecutions.size());
@@ -396,6 +644,14 @@ ErrorCode Executor::ComputeCache::compute() {
         MNN_DEBUG_PRINT("call computeViaCheckpoint due to mComputeMethod==sublinear\n")
         code = computeViaCheckpoint();
     } else if (mComputeMethod == "strategy") {
+        if (nullptr != mPlan && !_planMatchGraph()) {
+            MNN_ERROR("plan of %s.%d doesn't match the graph (%lu cmds), regenerate it; compute directly\n",
+                      mModelname.c_str(), mBatchsize, mCmdBuffer.command.size());
+            mBackend->setHeuristicStrategy(false, mModelname, mBatchsize, budget);
+            mBackupBackend->setHeuristicStrategy(false, mModelname, mBatchsize, budget);
+            mExecuteStrategy.clear();
+            mPlan = nullptr;
+        }
         if(mExecuteStrategy.empty()) {
             MNN_PRINT("call computeDirectly due to mComputeMethod==strategy but mExecuteStrategy is empty\n")
             code = computeDirectly();
@@ -412,6 +668,9 @@ ErrorCode Executor::ComputeCache::compute() {
     } else if (mComputeMethod == "adaptive") {
         MNN_DEBUG_PRINT("call computeAdaptively due to mComputeMethod==adaptive\n")
         code = computeAdaptively();
+    } else if (mComputeMethod == "estimate") {
+        MNN_DEBUG_PRINT("call estimateExecution due to mComputeMethod==estimate\n")
+        code = estimateExecution();
     } else {
         MNN_ASSERT(0)
         return COMPUTE_METHOD_ERROR;
@@ -450,6 +709,10 @@ ErrorCode Executor::ComputeCache::computeDirectly() {
             return code;
         }
     }
+    auto swapCode = waitAllSwaps();
+    if (NO_ERROR != swapCode) {
+        return swapCode;
+    }
     mBackend->onExecuteEnd();
     mBackupBackend->onExecuteEnd();
 //    mBackend->onClearBuffer();
@@ -524,28 +787,16 @@ ErrorCode Executor::ComputeCache::computeAdaptively() {
     for (int i=0; i<progress_len; i++) {
         auto iter = mExecuteStrategy[i];
         MNN_DEBUG_PRINT("Strategy: %s\t%d\n", iter.first.c_str(), iter.second)
-        if (iter.first == "compute" || iter.first == "recompute") {
-            if (iter.second >= mExecutions.size()) {
-                continue;
-            }
-            max_computed = std::max(iter.second, max_computed);
-            computeIthOp(iter.second, false, false, {}, true);
-        } else {
-            auto& cmd = mCmdBuffer.command[iter.second];
-            for(auto t: cmd.outputs) {
-                if (dynamic_type == 0) {
-                    mBackend->onReleaseBuffer(t, Backend::DYNAMIC);
-                } else if (dynamic_type == 1) {
-                    mBackend->onFreeBufferToOS(t);
-                } else if (dynamic_type == 2) {
-                    mBackend->onFreeBufferHybrid(t);
-                } else {
-                    MNN_ASSERT(false)
-                }
-                allocatedTensor.erase(t);
-            }
+        auto code = computeStrategyStep(iter, max_computed);
+        if (NO_ERROR != code) {
+            waitAllSwaps();
+            return code;
         }
     }
+    auto swapCode = waitAllSwaps();
+    if (NO_ERROR != swapCode) {
+        return swapCode;
+    }
     MNN_DEBUG_PRINT("finish prev-progress in %s\n", __FUNCTION__)
     char filename[100];
     sprintf(filename, "heuristic/execution/%s/%s.%d.%lu.execution.txt", mModelname.c_str(), mModelname.c_str(), mBatchsize, adaptiveBudget);
@@ -557,9 +808,9 @@ ErrorCode Executor::ComputeCache::computeAdaptively() {
     //加载新的ExecutionStrategy
     while (ifs >> str >> a) {
         if (a <= max_computed) {
-            if (str.find("compute") != std::string::npos) {
+            if (str.find("compute") != std::string::npos || str == "swap-in") {
                 tensorIDShouldAppear.insert(a);
-            } else {
+            } else if (str != "swap-out") {
                 tensorIDShouldAppear.erase(a);
             }
         } else {
@@ -651,26 +902,9 @@ ErrorCode Executor::ComputeCache::computeAdaptively() {
     for (auto iter: mExecuteStrategy) {
         MNN_DEBUG_PRINT("Strategy: %s\t%d\n", iter.first.c_str(), iter.second)
 //        AUTOTIME;
-        if (iter.first == "compute" || iter.first == "recompute") {
-            if (iter.second >= mExecutions.size()) {
-                continue;
-            }
-            max_computed = std::max(iter.second, max_computed);
-            computeIthOp(iter.second, false, false, {}, true);
-        } else {
-            auto& cmd = mCmdBuffer.command[iter.second];
-            for(auto t: cmd.outputs) {
-                if (dynamic_type == 0) {
-                    mBackend->onReleaseBuffer(t, Backend::DYNAMIC);
-                } else if (dynamic_type == 1) {
-                    mBackend->onFreeBufferToOS(t);
-                } else if (dynamic_type == 2) {
-                    mBackend->onFreeBufferHybrid(t);
-                } else {
-                    MNN_ASSERT(false)
-                }
-                allocatedTensor.erase(t);
-            }
+        auto code = computeStrategyStep(iter, max_computed);
+        if (NO_ERROR != code) {
+            return code;
         }
     }
 
@@ -683,6 +917,130 @@ ErrorCode Executor::ComputeCache::computeAdaptively() {
 }
 
 
+ErrorCode Executor::ComputeCache::waitSwap(int op) {
+    auto iter = mSwapping.find(op);
+    if (iter == mSwapping.end()) {
+        return NO_ERROR;
+    }
+    auto code = iter->second.get();
+    mSwapping.erase(iter);
+    return code;
+}
+
+ErrorCode Executor::ComputeCache::waitAllSwaps() {
+    auto code = NO_ERROR;
+    while (!mSwapping.empty()) {
+        auto swapCode = waitSwap(mSwapping.begin()->first);
+        if (NO_ERROR == code) {
+            code = swapCode;
+        }
+    }
+    return code;
+}
+
+ErrorCode Executor::ComputeCache::computeStrategyStep(const std::pair<std::string, int>& step, int& maxComputed) {
+    if (step.second >= mCmdBuffer.command.size()) {
+        return NO_ERROR;
+    }
+    auto& cmd = mCmdBuffer.command[step.second];
+    if (step.first == "compute" || step.first == "recompute") {
+        if (step.second >= mExecutions.size()) {
+            return NO_ERROR;
+        }
+        // inputs being read back have to be in place
+        auto op = cmd.buffer.empty() ? cmd.op : flatbuffers::GetRoot<Op>(cmd.buffer.data());
+        for (auto v = 0; v < cmd.inputs.size() && !mSwapping.empty(); ++v) {
+            if (!SizeComputer::opNeedContent(op->type(), v)) {
+                continue;
+            }
+            auto des = TensorUtils::getDescribe(cmd.inputs[v]);
+            std::vector<const Tensor*> reads;
+            if (des->memoryType == Tensor::InsideDescribe::MEMORY_BACKEND) {
+                reads.emplace_back(cmd.inputs[v]);
+            }
+            for (auto& s : des->regions) {
+                reads.emplace_back(s.origin);
+            }
+            for (auto t : reads) {
+                if (t->cacheID() < 0) {
+                    continue;
+                }
+                auto code = waitSwap(tensorFromOp[t->cacheID()]);
+                if (NO_ERROR != code) {
+                    return code;
+                }
+            }
+        }
+        maxComputed = std::max(step.second, maxComputed);
+        return computeIthOp(step.second, false, false, {}, true);
+    }
+    // every output of the op is moved, as the release steps free every output
+    auto swapAll = [](std::vector<Tensor*> tensors, ErrorCode (*swap)(const Tensor*)) {
+        for (auto t : tensors) {
+            auto code = swap(t);
+            if (NO_ERROR != code) {
+                return code;
+            }
+        }
+        return NO_ERROR;
+    };
+    if (step.first == "swap-out") {
+        mSwapping[step.second] = std::async(std::launch::async, swapAll, cmd.outputs, &ComputeCache::swapout);
+        return NO_ERROR;
+    }
+    if (step.first == "swap-in") {
+        auto code = waitSwap(step.second);
+        if (NO_ERROR != code) {
+            return code;
+        }
+        // allocated like an output, the plan counts the swap-in as one more step of the pool
+        for (auto t : cmd.outputs) {
+            auto bn = TensorUtils::getDescribe(t)->backend;
+            bn->changeBufferType(Backend::DYNAMIC_OUTPUT);
+            auto rst = false;
+            if (dynamic_type == 0) {
+                rst = bn->onAcquireBuffer(t, Backend::DYNAMIC);
+            } else if (dynamic_type == 1) {
+                rst = bn->onRequireBufferFromOS(t);
+            } else if (dynamic_type == 2) {
+                rst = bn->onRequireBufferHybrid(t);
+            } else {
+                MNN_ASSERT(false)
+            }
+            bn->changeBufferType(Backend::DYNAMIC_OTHER);
+            if (!rst) {
+                return OUT_OF_MEMORY;
+            }
+            allocatedTensor.insert(t);
+        }
+        mSwapping[step.second] = std::async(std::launch::async, swapAll, cmd.outputs, &ComputeCache::swapin);
+        return NO_ERROR;
+    }
+    // release, the write of a swapped tensor has to finish before its memory is reused
+    auto code = waitSwap(step.second);
+    if (NO_ERROR != code) {
+        return code;
+    }
+    for(auto t: cmd.outputs) {
+        // an evicted output is computed again for its next reader, the last release keeps its content
+        if (step.first != "pre-release" && isEagerOutput(t)) {
+            drainOutput(mDrainOffset[t]);
+            continue;
+        }
+        if (dynamic_type == 0) {
+            TensorUtils::getDescribe(t)->backend->onReleaseBuffer(t, Backend::DYNAMIC);
+        } else if (dynamic_type == 1) {
+            TensorUtils::getDescribe(t)->backend->onFreeBufferToOS(t);
+        } else if (dynamic_type == 2) {
+            TensorUtils::getDescribe(t)->backend->onFreeBufferHybrid(t);
+        } else {
+            MNN_ASSERT(false)
+        }
+        allocatedTensor.erase(t);
+    }
+    return NO_ERROR;
+}
+
 ErrorCode Executor::ComputeCache::computeViaStrategy() {
     if (mComputeTarget == "capuchin") {
         mBackend->onClearBuffer();
@@ -703,28 +1061,16 @@ ErrorCode Executor::ComputeCache::computeViaStrategy() {
     for (auto iter: mExecuteStrategy) {
         MNN_DEBUG_PRINT("Strategy: %s\t%d\n", iter.first.c_str(), iter.second)
 //        AUTOTIME;
-        if (iter.first == "compute" || iter.first == "recompute") {
-            if (iter.second >= mExecutions.size()) {
-                continue;
-            }
-            max_computed = std::max(iter.second, max_computed);
-            computeIthOp(iter.second, false, false, {}, true);
-        } else {
-            auto& cmd = mCmdBuffer.command[iter.second];
-            for(auto t: cmd.outputs) {
-                if (dynamic_type == 0) {
-                    TensorUtils::getDescribe(t)->backend->onReleaseBuffer(t, Backend::DYNAMIC);
-                } else if (dynamic_type == 1) {
-                    TensorUtils::getDescribe(t)->backend->onFreeBufferToOS(t);
-                } else if (dynamic_type == 2) {
-                    TensorUtils::getDescribe(t)->backend->onFreeBufferHybrid(t);
-                } else {
-                    MNN_ASSERT(false)
-                }
-                allocatedTensor.erase(t);
-            }
+        auto code = computeStrategyStep(iter, max_computed);
+        if (NO_ERROR != code) {
+            waitAllSwaps();
+            return code;
         }
     }
+    auto swapCode = waitAllSwaps();
+    if (NO_ERROR != swapCode) {
+        return swapCode;
+    }
     while (max_computed < mExecutions.size()) {
         computeIthOp(max_computed++, false, false, {}, true);
     }
@@ -949,6 +1295,34 @@ ErrorCode Executor::ComputeCache::computeViaCheckpoint() {
     return NO_ERROR;
 }
 
+std::shared_ptr<Execution> Executor::ComputeCache::_createExecution(const Command& cmd, const Op* op) {
+    ExecutionCache::Key key;
+    // the key is the op content, so ops the geometry builds are shared as well
+    bool shared = nullptr != mExecutionCache && ExecutionCache::makeKey(op, cmd.inputs, key);
+    if (shared) {
+        auto entry = mExecutionCache->find(key);
+        if (nullptr != entry) {
+            auto bn = entry->backend->type() == mBackend->type() ? mBackend.get() : mBackupBackend.get();
+            Execution* dst = nullptr;
+            if (entry->execution->onClone(bn, op, &dst) && nullptr != dst) {
+                MNN_DEBUG_PRINT("\tclone execution of %s\n", EnumNameOpType(op->type()))
+                mCloneSources.insert(entry->backend);
+                return std::shared_ptr<Execution>(dst);
+            }
+        }
+    }
+    auto bn = mBackend;
+    std::shared_ptr<Execution> exe(mBackend->onCreate(cmd.inputs, cmd.outputs, op));
+    if (nullptr == exe) {
+        bn = mBackupBackend;
+        exe.reset(mBackupBackend->onCreate(cmd.inputs, cmd.outputs, op));
+    }
+    if (nullptr != exe && shared && exe->onClone(nullptr, op, nullptr)) {
+        mExecutionCache->insert(key, bn, exe);
+    }
+    return exe;
+}
+
 ErrorCode Executor::ComputeCache::computeIthOp(int i, bool profile, bool recompute, std::vector<int> skipReleaseOpID, bool viaStrategy, bool enableSwap) {
 #ifdef PROFILE_COST_IN_LOG
     AUTOTIME;
@@ -980,10 +1354,7 @@ ErrorCode Executor::ComputeCache::computeIthOp(int i, bool profile, bool recompu
             }
         }
         if (nullptr == mExecutions[i]) {
-            mExecutions[i].reset(mBackend->onCreate(cmd.inputs, cmd.outputs, op));
-            if (nullptr == mExecutions[i]) {
-                mExecutions[i].reset(mBackupBackend->onCreate(cmd.inputs, cmd.outputs, op));
-            }
+            mExecutions[i] = _createExecution(cmd, op);
             if (nullptr == mExecutions[i]) {
                 return NOT_SUPPORT;
             }
@@ -1188,7 +1559,7 @@ ErrorCode Executor::ComputeCache::computeIthOp(int i, bool profile, bool recompu
             continue;
         }
         auto des = TensorUtils::getDescribe(cmd.inputs[v]);
-        if (des->memoryType == Tensor::InsideDescribe::MEMORY_BACKEND && des->usage == Tensor::InsideDescribe::NORMAL) {
+        if (des->memoryType == Tensor::InsideDescribe::MEMORY_BACKEND && (des->usage == Tensor::InsideDescribe::NORMAL || isEagerOutput(cmd.inputs[v]))) {
 #ifdef PROFILE_EXECUTION_IN_LOG
             MNN_PRINT("(%d %d), ", cmd.inputs[v]->cacheID(), cmd.inputs[v]->size());
 #endif
@@ -1198,7 +1569,7 @@ ErrorCode Executor::ComputeCache::computeIthOp(int i, bool profile, bool recompu
         }
         for (auto& s : des->regions) {
             auto subDes = TensorUtils::getDescribe(s.origin);
-            if (subDes->memoryType == Tensor::InsideDescribe::MEMORY_BACKEND && subDes->usage == Tensor::InsideDescribe::NORMAL) {
+            if (subDes->memoryType == Tensor::InsideDescribe::MEMORY_BACKEND && (subDes->usage == Tensor::InsideDescribe::NORMAL || isEagerOutput(s.origin))) {
 #ifdef PROFILE_EXECUTION_IN_LOG
                 MNN_PRINT("(%d %d), ", s.origin->cacheID(), s.origin->size());
 #endif
@@ -1290,6 +1661,16 @@ ErrorCode Executor::ComputeCache::computeIthOp(int i, bool profile, bool recompu
             regidx++;
         }
     }
+    // outputs read for the last time, a recompute doesn't end their life
+    auto drain = mDrainAfter.find(i);
+    if (!recompute && drain != mDrainAfter.end()) {
+        for (auto offset : drain->second) {
+#ifdef PROFILE_EXECUTION_IN_LOG
+            MNN_PRINT("(%d %d), ", mOutputs[offset]->cacheID(), mOutputs[offset]->size());
+#endif
+            drainOutput(offset);
+        }
+    }
     MNN_DEBUG_PRINT("\t%s: finish release memory for no-usable tensors\n", __FUNCTION__ );
 #ifdef PROFILE_EXECUTION_IN_LOG
     MNN_PRINT("]\n");
@@ -1314,6 +1695,390 @@ ExecutorScope::Current()->addOpCostTime((int)op->type(), costTime);
     return NO_ERROR;
 }
 
+void Executor::ComputeCache::reorderCommands() {
+    // list scheduling over the command graph. getExecuteOrder visits the outputs one after another, so the
+    // gradient of the first parameter drags the whole backward pass before the other weight gradients and
+    // their updates can run, while the data gradients they wait on stay alive. among the commands whose
+    // inputs are ready, run the one that leaves the least live bytes once the commands it unlocks and that
+    // free memory have run as well
+    auto size = (int)mCmdBuffer.command.size();
+    if (size < 3) {
+        return;
+    }
+    std::map<const Tensor*, int> producer;
+    for (int i=0; i<size; ++i) {
+        for (auto t : mCmdBuffer.command[i].outputs) {
+            producer[t] = i;
+        }
+    }
+    // outputs drained after their last reader are freed like the intermediate tensors
+    auto eager = mEagerOutputs && mBackend->type() == MNN_FORWARD_CPU;
+    auto isCounted = [&producer, eager](const Tensor* t) {
+        auto des = TensorUtils::getDescribe(t);
+        return des->memoryType == Tensor::InsideDescribe::MEMORY_BACKEND
+               && (des->usage == Tensor::InsideDescribe::NORMAL || (eager && des->usage == Tensor::InsideDescribe::OUTPUT))
+               && producer.find(t) != producer.end();
+    };
+    std::map<const Tensor*, int> tensorIndex;
+    std::vector<int64_t> bytes;
+    std::vector<std::vector<int>> reads(size), users(size);
+    std::vector<std::set<int>> depends(size);
+    std::vector<int64_t> allocBytes(size, 0);
+    for (int i=0; i<size; ++i) {
+        auto& cmd = mCmdBuffer.command[i];
+        auto op = cmd.buffer.empty() ? cmd.op : flatbuffers::GetRoot<Op>(cmd.buffer.data());
+        // every producer is a dependency, also the ones of shape-only inputs and nested regions
+        std::vector<const Tensor*> visit(cmd.inputs.begin(), cmd.inputs.end());
+        while (!visit.empty()) {
+            auto t = visit.back();
+            visit.pop_back();
+            auto iter = producer.find(t);
+            if (iter != producer.end() && iter->second != i) {
+                depends[i].insert(iter->second);
+            }
+            for (auto& s : TensorUtils::getDescribe(t)->regions) {
+                visit.emplace_back(s.origin);
+            }
+        }
+        // the tensors countUses counts for this command
+        std::set<const Tensor*> read;
+        for (auto v = 0; v<cmd.inputs.size(); ++v) {
+            if (!SizeComputer::opNeedContent(op->type(), v)) {
+                continue;
+            }
+            if (isCounted(cmd.inputs[v])) {
+                read.insert(cmd.inputs[v]);
+                continue;
+            }
+            for (auto& s : TensorUtils::getDescribe(cmd.inputs[v])->regions) {
+                if (isCounted(s.origin)) {
+                    read.insert(s.origin);
+                }
+            }
+        }
+        for (auto t : read) {
+            auto iter = tensorIndex.find(t);
+            if (iter == tensorIndex.end()) {
+                iter = tensorIndex.insert(std::make_pair(t, (int)bytes.size())).first;
+                bytes.emplace_back(t->size());
+            }
+            reads[i].emplace_back(iter->second);
+        }
+        for (auto t : cmd.outputs) {
+            if (isCounted(t)) {
+                allocBytes[i] += t->size();
+            }
+        }
+        for (auto d : depends[i]) {
+            users[d].emplace_back(i);
+        }
+    }
+    std::vector<int> uses(bytes.size(), 0);
+    // outputs nobody reads are drained right after they are computed
+    std::vector<int64_t> dropBytes(size, 0);
+    for (int i=0; i<size; ++i) {
+        for (auto t : reads[i]) {
+            uses[t]++;
+        }
+        for (auto t : mCmdBuffer.command[i].outputs) {
+            if (eager && isCounted(t) && TensorUtils::getDescribe(t)->usage == Tensor::InsideDescribe::OUTPUT
+                && tensorIndex.find(t) == tensorIndex.end()) {
+                dropBytes[i] += t->size();
+            }
+        }
+    }
+    // the schedule only depends on these, a rebuilt step finds the order its first build made
+    KeyHasher hasher;
+    hasher.mixValue(size);
+    hasher.mix(bytes.data(), bytes.size() * sizeof(int64_t));
+    for (int i=0; i<size; ++i) {
+        int64_t values[] = {allocBytes[i], dropBytes[i], (int64_t)reads[i].size(), (int64_t)depends[i].size()};
+        hasher.mix(values, sizeof(values));
+        hasher.mix(reads[i].data(), reads[i].size() * sizeof(int));
+        for (auto d : depends[i]) {
+            hasher.mixValue(d);
+        }
+    }
+    auto key = hasher.key();
+    auto apply = [this, size](const std::vector<int>& order) {
+        std::vector<Command> commands(size);
+        for (int i=0; i<size; ++i) {
+            commands[i] = std::move(mCmdBuffer.command[order[i]]);
+        }
+        mCmdBuffer.command.swap(commands);
+    };
+    if (nullptr != mExecutionCache) {
+        auto cached = mExecutionCache->findOrder(key);
+        if (nullptr != cached) {
+            if (!cached->order.empty()) {
+                apply(cached->order);
+            }
+            return;
+        }
+    }
+    // peak of live bytes for an order, the outputs of a command are allocated before its inputs are freed
+    auto peakOf = [&](const std::vector<int>& order) {
+        auto remain = uses;
+        int64_t live = 0, peak = 0;
+        for (auto i : order) {
+            live += allocBytes[i];
+            peak = std::max(peak, live);
+            live -= dropBytes[i];
+            for (auto t : reads[i]) {
+                if (0 == --remain[t]) {
+                    live -= bytes[t];
+                }
+            }
+        }
+        return peak;
+    };
+    auto remain = uses;
+    std::vector<int> indegree(size);
+    std::vector<bool> done(size, false);
+    auto deltaOf = [&](int i) {
+        int64_t delta = allocBytes[i] - dropBytes[i];
+        for (auto t : reads[i]) {
+            if (1 == remain[t]) {
+                delta -= bytes[t];
+            }
+        }
+        return delta;
+    };
+    // run i, the changes are logged so that a lookahead can be undone
+    std::vector<int> tensorLog, userLog;
+    auto run = [&](int i, std::vector<int>& ready) {
+        for (auto t : reads[i]) {
+            remain[t]--;
+            tensorLog.emplace_back(t);
+        }
+        for (auto u : users[i]) {
+            userLog.emplace_back(u);
+            if (0 == --indegree[u]) {
+                ready.emplace_back(u);
+            }
+        }
+    };
+    auto undo = [&]() {
+        for (auto t : tensorLog) {
+            remain[t]++;
+        }
+        for (auto u : userLog) {
+            indegree[u]++;
+        }
+        tensorLog.clear();
+        userLog.clear();
+    };
+    const int kLookahead = 16;
+    auto score = [&](int i) {
+        std::vector<int> unlocked;
+        int64_t live = deltaOf(i);
+        run(i, unlocked);
+        for (int step = 0; step < kLookahead && !unlocked.empty(); ++step) {
+            auto best = unlocked.begin();
+            for (auto iter = unlocked.begin(); iter != unlocked.end(); ++iter) {
+                if (deltaOf(*iter) < deltaOf(*best)) {
+                    best = iter;
+                }
+            }
+            auto delta = deltaOf(*best);
+            if (delta > 0) {
+                break;
+            }
+            auto next = *best;
+            unlocked.erase(best);
+            live += delta;
+            run(next, unlocked);
+        }
+        undo();
+        return live;
+    };
+    std::vector<int> origin(size), order;
+    std::set<int> ready;
+    for (int i=0; i<size; ++i) {
+        origin[i] = i;
+        indegree[i] = (int)depends[i].size();
+        if (0 == indegree[i]) {
+            ready.insert(i);
+        }
+    }
+    order.reserve(size);
+    std::vector<int> unlocked;
+    while (!ready.empty()) {
+        // ties keep the original order, so nothing moves unless it pays
+        int best = -1;
+        int64_t bestLive = 0;
+        for (auto i : ready) {
+            auto live = score(i);
+            if (-1 == best || live < bestLive) {
+                best = i;
+                bestLive = live;
+            }
+        }
+        ready.erase(best);
+        order.emplace_back(best);
+        unlocked.clear();
+        run(best, unlocked);
+        tensorLog.clear();
+        userLog.clear();
+        ready.insert(unlocked.begin(), unlocked.end());
+    }
+    ExecutionCache::OrderEntry entry;
+    entry.originPeak = peakOf(origin);
+    entry.orderPeak  = entry.originPeak;
+    if (order.size() != size) {
+        MNN_ERROR("%s: command graph has a cycle, keep the original order\n", __FUNCTION__);
+    } else if (peakOf(order) < entry.originPeak) {
+        entry.orderPeak = peakOf(order);
+        MNN_DEBUG_PRINT("reorder %d commands: peak %.2f MB -> %.2f MB\n", size, entry.originPeak / 1048576.0f, entry.orderPeak / 1048576.0f);
+        apply(order);
+        entry.order = std::move(order);
+    }
+    if (nullptr != mExecutionCache) {
+        mExecutionCache->insertOrder(key, std::move(entry));
+    }
+}
+
+void Executor::ComputeCache::countUses() {
+    // zero first, a cache that runs again still holds the counts its last run ended with
+    for (auto& cmd : mCmdBuffer.command) {
+        for (auto t : cmd.inputs) {
+            TensorUtils::getDescribe(t)->useCount = 0;
+            for (auto& s : TensorUtils::getDescribe(t)->regions) {
+                TensorUtils::getDescribe(s.origin)->useCount = 0;
+            }
+        }
+    }
+    for (int k=0; k<mCmdBuffer.command.size(); ++k) {
+        auto& cmd = mCmdBuffer.command[k];
+        auto op = cmd.op;
+        if (!cmd.buffer.empty()) {
+            op = flatbuffers::GetMutableRoot<Op>(cmd.buffer.data());
+        }
+        for (auto v = 0; v<cmd.inputs.size(); ++v) {
+            if (!SizeComputer::opNeedContent(op->type(), v)) {
+                continue;
+            }
+            auto des = TensorUtils::getDescribe(cmd.inputs[v]);
+            if (des->memoryType == Tensor::InsideDescribe::MEMORY_BACKEND && des->usage == Tensor::InsideDescribe::NORMAL) {
+                des->useCount+=1;
+//                MNN_PRINT("%s: cmd[%d].input[%d].useCount ++ to %d\n", __FUNCTION__, k, v, des->useCount);
+                continue;;
+            }
+            int regidx = 0;
+            for (auto& s : des->regions) {
+                auto subDes = TensorUtils::getDescribe(s.origin);
+                if (subDes->memoryType == Tensor::InsideDescribe::MEMORY_BACKEND && subDes->usage == Tensor::InsideDescribe::NORMAL) {
+                    subDes->useCount+=1;
+//                    MNN_PRINT("%s: cmd[%d].input[%d].region[%d].useCount ++ to %d\n", __FUNCTION__, k, v, regidx++, subDes->useCount);
+                }
+            }
+        }
+    }
+}
+
+void Executor::ComputeCache::planDrain() {
+    mDrainAfter.clear();
+    mDrainOffset.clear();
+    if (!mEagerOutputs) {
+        return;
+    }
+    std::map<const Tensor*, int> producer;
+    for (int i=0; i<mCmdBuffer.command.size(); ++i) {
+        for (auto t : mCmdBuffer.command[i].outputs) {
+            producer[t] = i;
+        }
+    }
+    std::map<const Tensor*, int> lastReader;
+    for (int i=0; i<mCmdBuffer.command.size(); ++i) {
+        auto& cmd = mCmdBuffer.command[i];
+        auto op = cmd.buffer.empty() ? cmd.op : flatbuffers::GetRoot<Op>(cmd.buffer.data());
+        for (auto v = 0; v<cmd.inputs.size(); ++v) {
+            if (!SizeComputer::opNeedContent(op->type(), v)) {
+                continue;
+            }
+            lastReader[cmd.inputs[v]] = i;
+            for (auto& s : TensorUtils::getDescribe(cmd.inputs[v])->regions) {
+                lastReader[s.origin] = i;
+            }
+        }
+    }
+    // only the outputs in a buffer of a cpu backend, the others are copied by mapOutput anyway
+    for (int offset=0; offset<mOutputs.size(); ++offset) {
+        auto t = mOutputs[offset];
+        auto iter = producer.find(t);
+        if (iter == producer.end() || TensorUtils::getDescribe(t)->memoryType != Tensor::InsideDescribe::MEMORY_BACKEND
+            || mBackend->type() != MNN_FORWARD_CPU || mDrainOffset.find(t) != mDrainOffset.end()) {
+            continue;
+        }
+        auto after = iter->second;
+        auto reader = lastReader.find(t);
+        if (reader != lastReader.end()) {
+            after = std::max(after, reader->second);
+        }
+        mDrainAfter[after].emplace_back(offset);
+        mDrainOffset[t] = offset;
+    }
+    mDrained.resize(mOutputs.size());
+}
+
+ErrorCode Executor::ComputeCache::drainOutput(int offset) {
+    auto t = mOutputs[offset];
+    if (allocatedTensor.find(t) == allocatedTensor.end()) {
+        return NO_ERROR;
+    }
+    auto des = TensorUtils::getDescribe(t);
+    mDrained[offset].resize(t->size());
+    ::memcpy(mDrained[offset].data(), t->host<void>(), t->size());
+    if (dynamic_type == 0) {
+        des->backend->onReleaseBuffer(t, Backend::DYNAMIC);
+    } else if (dynamic_type == 1) {
+        des->backend->onFreeBufferToOS(t);
+    } else if (dynamic_type == 2) {
+        des->backend->onFreeBufferHybrid(t);
+    } else {
+        MNN_ASSERT(false)
+    }
+    allocatedTensor.erase(t);
+    mDrainedOffsets.insert(offset);
+    return NO_ERROR;
+}
+
+void Executor::ComputeCache::rewind() {
+    MNN_DEBUG_PRINT("call %s: %lu tensors still allocated\n", __FUNCTION__, allocatedTensor.size())
+    // commands and executions stay, only the buffers and use counts of the last run are reset
+    for (auto t : allocatedTensor) {
+        auto des = TensorUtils::getDescribe(t);
+        if (nullptr == des->backend || featureSwapoutFlag[t->cacheID()]) {
+            continue;
+        }
+        if (dynamic_type == 0) {
+            des->backend->onReleaseBuffer(t, Backend::DYNAMIC);
+        } else if (dynamic_type == 1) {
+            des->backend->onFreeBufferToOS(t);
+        } else if (dynamic_type == 2) {
+            des->backend->onFreeBufferHybrid(t);
+        } else {
+            MNN_ASSERT(false)
+        }
+    }
+    allocatedTensor.clear();
+    featureSwapoutFlag.clear();
+    mDrainedOffsets.clear();
+    for (auto& cmd : mCmdBuffer.command) {
+        for (auto t : cmd.outputs) {
+            auto des = TensorUtils::getDescribe(t);
+            if (des->memoryType == Tensor::InsideDescribe::MEMORY_BACKEND) {
+                des->backend = nullptr;
+            }
+        }
+    }
+    mUniqueCacheID = 0;
+    mComputed = false;
+    if (!mShapeDirty) {
+        countUses();
+    }
+}
+
 ErrorCode Executor::ComputeCache::resize() {
     if (!mShapeDirty) {
         return NO_ERROR;
@@ -1420,33 +2185,18 @@ Timer autoTime;
 ExecutorScope::Current()->addOpCostTime((int)OpType_If, costTime);
 }
 #endif
-    }
-    for (int k=0; k<mCmdBuffer.command.size(); ++k) {
-        auto& cmd = mCmdBuffer.command[k];
-        auto op = cmd.op;
-        if (!cmd.buffer.empty()) {
-            op = flatbuffers::GetMutableRoot<Op>(cmd.buffer.data());
+        if (mContext.skippedRaster() > 0) {
+            MNN_DEBUG_PRINT("skip %d layout conversion raster of %lu commands\n", mContext.skippedRaster(), mCmdBuffer.command.size());
         }
-        for (auto v = 0; v<cmd.inputs.size(); ++v) {
-            if (!SizeComputer::opNeedContent(op->type(), v)) {
-                continue;
-            }
-            auto des = TensorUtils::getDescribe(cmd.inputs[v]);
-            if (des->memoryType == Tensor::InsideDescribe::MEMORY_BACKEND && des->usage == Tensor::InsideDescribe::NORMAL) {
-                des->useCount+=1;
-//                MNN_PRINT("%s: cmd[%d].input[%d].useCount ++ to %d\n", __FUNCTION__, k, v, des->useCount);
-                continue;;
-            }
-            int regidx = 0;
-            for (auto& s : des->regions) {
-                auto subDes = TensorUtils::getDescribe(s.origin);
-                if (subDes->memoryType == Tensor::InsideDescribe::MEMORY_BACKEND && subDes->usage == Tensor::InsideDescribe::NORMAL) {
-                    subDes->useCount+=1;
-//                    MNN_PRINT("%s: cmd[%d].input[%d].region[%d].useCount ++ to %d\n", __FUNCTION__, k, v, regidx++, subDes->useCount);
-                }
-            }
+        if (mContext.regionInput() > 0) {
+            MNN_DEBUG_PRINT("read %d virtual tensors without raster of %lu commands\n", mContext.regionInput(), mCmdBuffer.command.size());
         }
     }
+    if (mMemoryAwareOrder) {
+        reorderCommands();
+    }
+    countUses();
+    planDrain();
     /** Encoder End */
 
     /** Prepare Begin */
@@ -1590,6 +2340,7 @@ ErrorCode Executor::ComputeCache::swapout(const Tensor *tensor) {
     if(f != nullptr) {
         numwrite = fwrite(tensor->host<void>(), sizeof(char), tensor->size(), f);
 //        MNN_PRINT("%d\n", numwrite);
+        fclose(f);
     }
     if (numwrite != tensor->size()){
         return SWAP_OUT_ERROR;
@@ -1606,6 +2357,7 @@ ErrorCode Executor::ComputeCache::swapin(const Tensor *tensor) {
     int numread = -1;
     if (f != nullptr) {
         numread = fread(tensor->host<void>(), sizeof(char), tensor->size(), f);
+        fclose(f);
     }
     if (numread != tensor->size()){
         return SWAP_IN_ERROR;
@@ -1638,17 +2390,38 @@ ErrorCode Executor::ComputeCache::setExecutionStrategy(std::string model, int ba
     return NO_ERROR;
 }
 
+bool Executor::ComputeCache::_planMatchGraph() {
+    std::vector<int> opTypes(mCmdBuffer.command.size());
+    for (int i = 0; i < mCmdBuffer.command.size(); ++i) {
+        auto& cmd = mCmdBuffer.command[i];
+        auto op = cmd.op;
+        if (!cmd.buffer.empty()) {
+            op = flatbuffers::GetRoot<Op>(cmd.buffer.data());
+        }
+        opTypes[i] = op->type();
+    }
+    return mPlan->matchGraph(opTypes);
+}
+
+ErrorCode Executor::ComputeCache::setExecutionStrategy(std::shared_ptr<PlanBundle> bundle, int rung) {
+    mPlan = bundle;
+    bundle->loadSequence(rung, mExecuteStrategy);
+    mComputeHeuristically = !mExecuteStrategy.empty();
+    MNN_DEBUG_PRINT("%s: rung = %d, mExecuteStrategy.size = %lu\n", __FUNCTION__, rung, mExecuteStrategy.size())
+    return NO_ERROR;
+}
+
 void Executor::ComputeCache::config(std::string model, int batch) {
     mModelname = model;
     mBatchsize = batch;
 }
 
 void Executor::ComputeCache::setMethodAndTarget(std::string method, std::string target) {
-    if (method == "direct" || method == "sublinear" || method == "strategy" || method == "swap" || method == "adaptive") {
+    if (method == "direct" || method == "sublinear" || method == "strategy" || method == "swap" || method == "adaptive" || method == "estimate") {
         mComputeMethod = method;
     }
     if (target == "mnn" || target == "sublinear" || target == "ours" || target == "capuchin" || target == "vdnn" || target == "adaptive"
-            || target == "profile" || target == "resize" || target == "cost") {
+            || target == "bundle" || target == "profile" || target == "resize" || target == "cost" || target == "estimate") {
         mComputeTarget = target;
     }
 }
@@ -1722,6 +2495,123 @@ ErrorCode Executor::ComputeCache::profileExecution() {
 
 }
 
+ErrorCode Executor::ComputeCache::estimateExecution() {
+    // walk the lowered commands with the shapes from SizeComputer only: no execution is created and no
+    // buffer of a command is allocated. prints the same per-op log as target "profile", plus the flops
+    // and bytes of every op, which the plan generator turns into cost with a per-device calibration
+    MNN_PRINT("call %s\n", __FUNCTION__ );
+#ifndef ALLOCATE_CACHE_ID_RUNTIME
+    for (int i=0; i<mCmdBuffer.command.size(); ++i) {
+        for (auto output: mCmdBuffer.command[i].outputs) {
+            output->setCacheID(mUniqueCacheID++);
+            tensorFromOp[output->cacheID()] = i;
+        }
+    }
+#endif
+    std::map<const Tensor*, int> produced, uses;
+    for (int i=0; i<mCmdBuffer.command.size(); ++i) {
+        for (auto output: mCmdBuffer.command[i].outputs) {
+            produced[output] = i;
+        }
+    }
+    auto isCounted = [&produced, this](const Tensor* t) {
+        auto des = TensorUtils::getDescribe(t);
+        return des->memoryType == Tensor::InsideDescribe::MEMORY_BACKEND && (des->usage == Tensor::InsideDescribe::NORMAL || isEagerOutput(t))
+               && produced.find(t) != produced.end();
+    };
+    // tensors read by op i, the same ones countUses counts, plus the outputs drained after their last reader
+    auto opReads = [&](int i, const Op* op) {
+        std::vector<const Tensor*> reads;
+        auto& cmd = mCmdBuffer.command[i];
+        for (auto v = 0; v<cmd.inputs.size(); ++v) {
+            if (!SizeComputer::opNeedContent(op->type(), v)) {
+                continue;
+            }
+            if (isCounted(cmd.inputs[v])) {
+                reads.emplace_back(cmd.inputs[v]);
+                continue;
+            }
+            for (auto& s : TensorUtils::getDescribe(cmd.inputs[v])->regions) {
+                if (isCounted(s.origin)) {
+                    reads.emplace_back(s.origin);
+                }
+            }
+        }
+        return reads;
+    };
+    for (int i=0; i<mCmdBuffer.command.size(); ++i) {
+        auto& cmd = mCmdBuffer.command[i];
+        auto op = cmd.buffer.empty() ? cmd.op : flatbuffers::GetRoot<Op>(cmd.buffer.data());
+        for (auto t : opReads(i, op)) {
+            uses[t]++;
+        }
+    }
+    for (int i=0; i<mCmdBuffer.command.size(); ++i) {
+        auto& cmd = mCmdBuffer.command[i];
+        auto op = cmd.buffer.empty() ? cmd.op : flatbuffers::GetRoot<Op>(cmd.buffer.data());
+        auto reads = opReads(i, op);
+        double bytes = 0.0;
+        MNN_PRINT("current Op is %dth:%d:%s\n", i, op->type(), EnumNameOpType(op->type()));
+        MNN_PRINT("\tinputs: [");
+        for (auto t : reads) {
+            MNN_PRINT("(%d %d), ", t->cacheID(), t->size());
+            bytes += t->size();
+        }
+        MNN_PRINT("]\n\toutputs: [");
+        for (auto t : cmd.outputs) {
+            MNN_PRINT("(%d %d), ", t->cacheID(), t->size());
+            bytes += t->size();
+        }
+        MNN_PRINT("]\n\ttemporary: [");
+        for (auto t : cmd.outputs) {
+            if (isCounted(t) && !isEagerOutput(t)) {
+                MNN_PRINT("(%d %d), ", t->cacheID(), t->size());
+            }
+        }
+        MNN_PRINT("]\n\trelease: [");
+        for (auto t : reads) {
+            if (0 == --uses[t] && !isEagerOutput(t)) {
+                MNN_PRINT("(%d %d), ", t->cacheID(), t->size());
+            }
+        }
+        auto drain = mDrainAfter.find(i);
+        if (drain != mDrainAfter.end()) {
+            for (auto offset : drain->second) {
+                MNN_PRINT("(%d %d), ", mOutputs[offset]->cacheID(), mOutputs[offset]->size());
+            }
+        }
+        // computeFlops counts in units of 1024 * 1024
+        auto flops = SizeComputer::computeFlops(op, cmd.inputs, cmd.outputs) * 1024.0 * 1024.0;
+        MNN_PRINT("]\n\testimate flops: %f bytes: %f\n", flops, bytes);
+    }
+    // only the outputs of the cache get memory, so that they can still be read
+    for (auto t : mOutputs) {
+        auto des = TensorUtils::getDescribe(t);
+        if (des->memoryType != Tensor::InsideDescribe::MEMORY_BACKEND || nullptr != des->backend) {
+            continue;
+        }
+        TensorUtils::setLinearLayout(t);
+        des->backend = mBackend.get();
+        auto rst = false;
+        if (dynamic_type == 0) {
+            rst = mBackend->onAcquireBuffer(t, Backend::DYNAMIC);
+        } else if (dynamic_type == 1) {
+            rst = mBackend->onRequireBufferFromOS(t);
+        } else if (dynamic_type == 2) {
+            rst = mBackend->onRequireBufferHybrid(t);
+        } else {
+            MNN_ASSERT(false)
+        }
+        if (!rst) {
+            return OUT_OF_MEMORY;
+        }
+        ::memset(t->host<void>(), 0, t->size());
+        allocatedTensor.insert(t);
+    }
+    MNN_PRINT("%s: finish & return\n", __FUNCTION__ );
+    return NO_ERROR;
+}
+
 void Executor::ComputeCache::getValidCheckpointLevel() {
     // build input dependency opGraph
     /*std::vector<std::set<int>> opGraph, reversedOpGraph;
@@ -2049,6 +2939,9 @@ void Executor::_create(const std::vector<EXPRP>& outputs, std::set<std::shared_p
     std::shared_ptr<ComputeCache> packedCache(new ComputeCache(cacheBn, cacheBackupBn));
     packedCache->config(mModelname, mBatchsize);
     if (mHeuristic) {  // 在计算整个model之前还有别的简单计算，这部分不需要通过 mHeuristic == false 过滤
+        // the featuremap list of vdnn is written for the original order
+        packedCache->mMemoryAwareOrder = mMemoryAwareOrder && mTarget != "vdnn";
+        packedCache->mEagerOutputs = mEagerOutputs;
         MNN_DEBUG_PRINT("%s: %s: mTarget=%s\n", __FILE_NAME__, __FUNCTION__, mTarget.c_str())
         if (mTarget == "profile" || mTarget == "resize" || mTarget == "cost") {
             packedCache->setMethodAndTarget("direct", mTarget);
@@ -2056,17 +2949,44 @@ void Executor::_create(const std::vector<EXPRP>& outputs, std::set<std::shared_p
             if (typeid(cacheBn) != typeid(cacheBackupBn)) {
                 cacheBackupBn->setHeuristicStrategy(mHeuristic, mModelname, mBatchsize, mBudgetMB, true);
             }
+        } else if (mTarget == "estimate") {
+            packedCache->setMethodAndTarget("estimate", mTarget);
         } else if (mTarget == "mnn") {
             packedCache->setMethodAndTarget("direct", mTarget);
         } else if (mTarget == "sublinear") {
             packedCache->setMethodAndTarget("sublinear", mTarget);
         } else if (mTarget == "ours") {
-            cacheBn->setHeuristicStrategy(mHeuristic, mModelname, mBatchsize, mBudgetMB);
-            if (typeid(cacheBn) != typeid(cacheBackupBn)) {
-                cacheBackupBn->setHeuristicStrategy(mHeuristic, mModelname, mBatchsize, mBudgetMB);
+            if (nullptr == mPlanBundle) {
+                mPlanBundle = PlanBundle::load(PlanBundle::planPath(mModelname, mBatchsize, mBudgetMB));
+            }
+            if (nullptr != mPlanBundle) {
+                cacheBn->setHeuristicBundle(mHeuristic, mPlanBundle, 0);
+                if (typeid(cacheBn) != typeid(cacheBackupBn)) {
+                    cacheBackupBn->setHeuristicBundle(mHeuristic, mPlanBundle, 0);
+                }
+                packedCache->setMethodAndTarget("strategy", mTarget);
+                packedCache->setExecutionStrategy(mPlanBundle, 0);
+            } else {
+                // plans generated before the binary format
+                cacheBn->setHeuristicStrategy(mHeuristic, mModelname, mBatchsize, mBudgetMB);
+                if (typeid(cacheBn) != typeid(cacheBackupBn)) {
+                    cacheBackupBn->setHeuristicStrategy(mHeuristic, mModelname, mBatchsize, mBudgetMB);
+                }
+                packedCache->setMethodAndTarget("strategy", mTarget);
+                packedCache->setExecutionStrategy(mModelname, mBatchsize, mBudgetMB);
+            }
+        } else if (mTarget == "bundle") {
+            int rung = _selectPlanRung();
+            if (rung >= 0) {
+                cacheBn->setHeuristicBundle(mHeuristic, mPlanBundle, rung);
+                if (typeid(cacheBn) != typeid(cacheBackupBn)) {
+                    cacheBackupBn->setHeuristicBundle(mHeuristic, mPlanBundle, rung);
+                }
+                packedCache->setMethodAndTarget("strategy", mTarget);
+                packedCache->setExecutionStrategy(mPlanBundle, rung);
+            } else {
+                packedCache->setMethodAndTarget("direct", mTarget);
             }
-            packedCache->setMethodAndTarget("strategy", mTarget);
-            packedCache->setExecutionStrategy(mModelname, mBatchsize, mBudgetMB);
         } else if (mTarget == "capuchin") {
             packedCache->setMethodAndTarget("strategy", mTarget);
             packedCache->setExecutionStrategy(mModelname, mBatchsize, mBudgetMB);
@@ -2083,6 +3003,7 @@ void Executor::_create(const std::vector<EXPRP>& outputs, std::set<std::shared_p
         packedCache->setBudgetAndProgress(mBudgetMB, mAdaptiveBudgetMB, mAdaptiveProgress);
     }
 
+    packedCache->mExecutionCache = mExecutionCache;
     packedCache->mInputs = std::move(inputCaches);
     packedCache->mInputInside = std::move(inputNode);
     for (auto expr : packed) {
@@ -2214,6 +3135,15 @@ void Executor::setHeuristicAlloc(bool flag) {
 bool Executor::getHeuristicAllocFlag(){
     return mHeuristic;
 }
+void Executor::setMemoryAwareOrder(bool flag) {
+    mMemoryAwareOrder = flag;
+}
+std::pair<int64_t, int64_t> Executor::lastOrderPeak() const {
+    return mExecutionCache->lastPeak();
+}
+void Executor::setEagerOutputs(bool flag) {
+    mEagerOutputs = flag;
+}
 void Executor::configExecution(std::string modelName, int batchsize, std::string target, size_t budgetMB, size_t adaptiveBudget, float adapProg) {
     mModelname = modelName;
     mBatchsize = batchsize;
@@ -2221,10 +3151,53 @@ void Executor::configExecution(std::string modelName, int batchsize, std::string
     mBudgetMB = budgetMB;
     mAdaptiveBudgetMB = adaptiveBudget;
     mAdaptiveProgress = adapProg;
+    mPlanBundle = nullptr;
+    mPlanRung = -1;
     MNN_DEBUG_PRINT("%s:          mModelname=%s,      mBatchsize=%d, mTarget=%s,      mBudgetMB=%lu, mAdaptiveBudgetMB=%lu, mAdaptiveProgress=%.1f\n",
                     __FUNCTION__, mModelname.c_str(), mBatchsize,    mTarget.c_str(), mBudgetMB,     mAdaptiveBudgetMB,     mAdaptiveProgress)
 }
 
+void Executor::setMemoryProvider(std::function<size_t()> provider) {
+    mMemoryProvider = std::move(provider);
+}
+
+size_t Executor::planBudgetMB() const {
+    if (mTarget.empty()) {
+        return 0;
+    }
+    if (mTarget == "bundle" && nullptr != mPlanBundle && mPlanRung >= 0) {
+        return mPlanBundle->budgetMB(mPlanRung);
+    }
+    return mBudgetMB;
+}
+
+int Executor::_selectPlanRung() {
+    if (nullptr == mPlanBundle) {
+        mPlanBundle = PlanBundle::load(PlanBundle::defaultPath(mModelname, mBatchsize));
+        if (nullptr == mPlanBundle) {
+            MNN_ERROR("%s: no plan bundle for %s.%d, fall back to direct compute\n", __FUNCTION__, mModelname.c_str(), mBatchsize);
+            return -1;
+        }
+    }
+    // only called when a new cache is created, i.e. at iteration boundary, so a rung is never switched mid-step
+    size_t availableMB = mMemoryProvider ? mMemoryProvider() : 0;
+    if (0 == availableMB) {
+        availableMB = PlanBundle::availableMemoryMB();
+        if (0 != availableMB && mPlanRung >= 0) {
+            // the memory of the rung in use goes back with the cache that holds it, else the rung could only go down
+            availableMB += mPlanBundle->budgetMB(mPlanRung);
+        }
+    }
+    if (0 == availableMB || availableMB > mBudgetMB) {
+        availableMB = mBudgetMB;
+    }
+    int rung = mPlanBundle->selectRung(availableMB);
+    if (rung != mPlanRung) {
+        MNN_PRINT("%s: switch to plan of %lu MB (available %lu MB)\n", __FUNCTION__, mPlanBundle->budgetMB(rung), availableMB);
+        mPlanRung = rung;
+    }
+    return rung;
+}
 
 ErrorCode Executor::runCache(std::shared_ptr<ComputeCache> cache) {
     std::lock_guard<std::mutex> _l(mMutex);
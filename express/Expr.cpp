@@ -771,71 +771,113 @@ bool Expr::setInfoDirty() {
 }
 
 std::vector<VARP> Variable::load(const char* fileName) {
+    std::shared_ptr<FileLoader> loader(new FileLoader(fileName));
+    if (!loader->valid()) {
+        MNN_ERROR("Error for open %s\n", fileName);
+        return {};
+    }
+    if (loader->map()) {
+        return loadInternal(loader->mapped(), loader->size(), loader);
+    }
     AutoStorage<uint8_t> buffer;
-    {
-        FileLoader loader(fileName);
-        if (!loader.valid()) {
-            MNN_ERROR("Error for open %s\n", fileName);
-            return {};
-        }
-        loader.read();
-        if (!loader.valid()) {
-            return {};
-        }
-        loader.merge(buffer);
-        if (buffer.get() == nullptr) {
-            return {};
-        }
+    loader->read();
+    if (!loader->valid()) {
+        return {};
+    }
+    loader->merge(buffer);
+    loader.reset();
+    if (buffer.get() == nullptr) {
+        return {};
     }
     return load(buffer.get(), buffer.size());
 }
 std::vector<VARP> Variable::load(const uint8_t* buffer, size_t length) {
+    return loadInternal(buffer, length, nullptr);
+}
+
+static const void* _blobData(const Blob* blob) {
+    switch (blob->dataType()) {
+        case DataType_DT_INT8:
+            return nullptr != blob->int8s() ? (const void*)blob->int8s()->data() : nullptr;
+        case DataType_DT_INT32:
+            return nullptr != blob->int32s() ? (const void*)blob->int32s()->data() : nullptr;
+        case DataType_DT_UINT8:
+            return nullptr != blob->uint8s() ? (const void*)blob->uint8s()->data() : nullptr;
+        case DataType_DT_FLOAT:
+            return nullptr != blob->float32s() ? (const void*)blob->float32s()->data() : nullptr;
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+std::vector<VARP> Variable::loadInternal(const uint8_t* buffer, size_t length, std::shared_ptr<void> mapping) {
     AUTOTIME;
     flatbuffers::Verifier verify((const uint8_t*)(buffer), length);
     if (false == VerifyNetBuffer(verify)) {
         MNN_PRINT("Invalidate buffer to create variable\n");
         return {};
     }
-    std::unique_ptr<NetT> source(UnPackNet(buffer));
-    if (nullptr == source) {
-        return {};
-    }
-    if (source->oplists.empty()) {
+    auto source = GetNet(buffer);
+    if (nullptr == source->oplists() || 0 == source->oplists()->size()) {
         MNN_ERROR("Invalid net\n");
         return {};
     }
-    // FUNC_PRINT(source->oplists.size());
+    // FUNC_PRINT(source->oplists()->size());
 
-    auto opSize      = source->oplists.size();
-    auto tensorCount = source->tensorName.size();
+    auto opSize      = source->oplists()->size();
+    auto tensorNames = source->tensorName();
+    int tensorCount  = nullptr != tensorNames ? (int)tensorNames->size() : 0;
     if (tensorCount == 0) {
-        tensorCount = source->tensorNumber;
+        tensorCount = source->tensorNumber();
     }
     std::vector<VARP> variable;
     variable.reserve(tensorCount);
     std::map<int, VARP> variableMap;
 
-    // Generate All Exprs by order of net
+    // Generate All Exprs by order of net, ops are unpacked one by one so the weights are never copied as a whole
     for (int i = 0; i < opSize; ++i) {
+        auto op = source->oplists()->GetAs<Op>(i);
         std::vector<VARP> inputs;
-        auto op = source->oplists[i].get();
-        for (int index = 0; index < op->inputIndexes.size(); ++index) {
-            auto inputIndex = op->inputIndexes[index];
-            if (variableMap.find(inputIndex) == variableMap.end()) {
-                MNN_ERROR("Can't find variable for %s, the graph is error\n", op->name.c_str());
-                break;
+        if (nullptr != op->inputIndexes()) {
+            for (int index = 0; index < op->inputIndexes()->size(); ++index) {
+                auto inputIndex = op->inputIndexes()->data()[index];
+                if (variableMap.find(inputIndex) == variableMap.end()) {
+                    MNN_ERROR("Can't find variable for %s, the graph is error\n", nullptr != op->name() ? op->name()->c_str() : "");
+                    break;
+                }
+                inputs.emplace_back(variableMap[inputIndex]);
+            }
+        }
+        int outputSize = nullptr != op->outputIndexes() ? (int)op->outputIndexes()->size() : 0;
+        EXPRP expr;
+        if (nullptr != mapping && (OpType_Const == op->type() || OpType_TrainableParam == op->type()) &&
+            nullptr != op->main_as_Blob() && nullptr != _blobData(op->main_as_Blob())) {
+            // alias the mapping, the first write to a page copies it (MAP_PRIVATE)
+            auto blob = op->main_as_Blob();
+            Variable::Info info;
+            if (nullptr != blob->dims()) {
+                info.dim.assign(blob->dims()->begin(), blob->dims()->end());
+            }
+            info.order = Utils::revertFormat(blob->dataFormat());
+            info.type  = Utils::revertDataType(blob->dataType());
+            expr       = Expr::create(std::move(info), _blobData(blob), VARP::CONSTANT, Expr::REF);
+            expr->mInside->mMapping = mapping;
+            if (OpType_TrainableParam == op->type()) {
+                expr->mType = VARP::TRAINABLE;
             }
-            inputs.emplace_back(variableMap[inputIndex]);
+        } else {
+            std::unique_ptr<OpT> opT(op->UnPack());
+            expr = Expr::create(opT.get(), inputs, outputSize);
         }
-        EXPRP expr = Expr::create(source->oplists[i].get(), inputs, (int)op->outputIndexes.size());
-        expr->setName(source->oplists[i]->name);
+        expr->setName(nullptr != op->name() ? op->name()->str() : "");
 
-        for (int index = 0; index < op->outputIndexes.size(); ++index) {
-            auto outputIndex = op->outputIndexes[index];
+        for (int index = 0; index < outputSize; ++index) {
+            auto outputIndex = op->outputIndexes()->data()[index];
             if (variableMap.find(outputIndex) == variableMap.end()) {
                 auto newVariable = Variable::create(expr, index);
-                if (source->tensorName.size() > outputIndex) {
-                    newVariable->setName(source->tensorName[outputIndex]);
+                if (nullptr != tensorNames && tensorNames->size() > outputIndex) {
+                    newVariable->setName(tensorNames->GetAsString(outputIndex)->str());
                 }
                 variableMap[outputIndex] = newVariable;
                 variable.emplace_back(newVariable);
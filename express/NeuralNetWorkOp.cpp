@@ -1474,6 +1474,25 @@ VARP _ZeroGrad(VARP x) {
     return Variable::create(Expr::create(std::move(op), {x}));
 }
 
+std::vector<VARP> _FakeQuant(VARP x, VARP runningScale, float limit, int axis, float minScale, float momentum, bool maximum) {
+    std::unique_ptr<OpT> op(new OpT);
+    op->type       = OpType_FakeQuant;
+    op->main.type  = OpParameter_FakeQuant;
+    auto param      = new FakeQuantT;
+    param->limit    = limit;
+    param->axis     = axis;
+    param->minScale = minScale;
+    param->momentum = momentum;
+    param->maximum  = maximum;
+    op->main.value  = param;
+    std::vector<VARP> inputs = {x};
+    if (nullptr != runningScale) {
+        inputs.emplace_back(runningScale);
+    }
+    EXPRP expr = Expr::create(std::move(op), inputs, 2);
+    return {Variable::create(expr, 0), Variable::create(expr, 1)};
+}
+
 VARP _Conv(std::vector<int8_t>&& weight, std::vector<int>&& bias, std::vector<float>&& scale, VARP x, INTS channel, INTS kernelSize,
                               PaddingMode pad, INTS stride, INTS dilate, int group, INTS pads, bool relu, int nbits) {
     std::unique_ptr<OpT> convOp(new OpT);
@@ -41,6 +41,8 @@ struct Expr::Inside {
     bool mContentDirty = true;
     bool mOwnTensor = true;
     Tensor* mHostTensor = nullptr;
+    // keeps a mapped model alive while the output tensor aliases it
+    std::shared_ptr<void> mMapping;
 };
 class Utils {
 public:
@@ -126,6 +126,10 @@ Module* Module::load(const std::vector<std::string>& inputs, const std::vector<s
             MNN_ERROR("Error for open %s\n", fileName);
             return {};
         }
+        if (loader.map()) {
+            // the module copies what it keeps, the mapping only has to outlive load
+            return load(inputs, outputs, loader.mapped(), loader.size(), config);
+        }
         loader.read();
         if (!loader.valid()) {
             return {};
@@ -706,6 +706,7 @@ public:
 
         mBits = bits;
         auto limit = (float)(1 << (bits - 1)) - 1.0f;
+        mLimit = limit;
         mLimitScale = _Scalar<float>(1.0f / limit);
         mClampValue = _Scalar<float>(limit);
         
@@ -715,63 +716,26 @@ public:
         setType("ConvBNReluFused");
     }
 
-    std::pair<VARP, VARP> fakeQuantFeature(VARP x, VARP useScale = nullptr) {
-        auto originFormat = x->getInfo()->order;
-        auto tempX        = x;
-        if (originFormat == NC4HW4) {
-            tempX = _Convert(tempX, NCHW);
-        }
-        auto originX = tempX;
-        VARP scale = _Maximum(_ReduceMax(_Abs(tempX)), _Scalar<float>(0.0001f)) * mLimitScale;
-        if (useScale == nullptr) {
-            tempX = _Round(tempX * _Reciprocal(scale)) * scale;
-        } else {
-            tempX = _Round(tempX * _Reciprocal(useScale)) * useScale;
-        }
-        // Break the grad by use cast
-        tempX = _Cast<float>(tempX);
-        
-        // Move grad from tempX to originX
-        tempX = _Convert(tempX + _ZeroGrad(originX), originFormat);
-        return std::make_pair(tempX, scale);
-    }
-
-    VARP clamp(VARP x) {
-        return _Maximum(_Minimum(x, mClampValue), _Negative(mClampValue));
-    }
-
-    VARP updateScale(VARP originValue, VARP newValue) const {
-        if (nullptr == originValue) {
-            return newValue;
-        }
-        switch (mScaleUpdateMethod) {
-            case NN::MovingAverage:
-                return originValue * _Scalar<float>(mMomentum) + newValue * _Scalar<float>(1.0f-mMomentum);
-            case NN::Maximum:
-                return _Maximum(originValue, newValue);
-            default:
-                break;
-        }
-        MNN_ASSERT(false);
-        return nullptr;
+    // Quantized x and its scale, the scale is updated from runningScale if it is given
+    std::pair<VARP, VARP> fakeQuantFeature(VARP x, VARP runningScale = nullptr) {
+        auto res = _FakeQuant(x, runningScale, mLimit, -1, 0.0001f, mMomentum, mScaleUpdateMethod == NN::Maximum);
+        return std::make_pair(res[0], res[1]);
     }
 
     virtual std::vector<Express::VARP> onForward(const std::vector<Express::VARP>& inputs) override {
         VARP res;
         if (getIsTraining()) {
-            auto x = _Convert(inputs[0], NCHW);
-            // simulate weight quant
-            auto weightScale = _Maximum(_ReduceMax(_Abs(mWeight), {1, 2, 3}, true), _Scalar<float>(1E-6)) * mLimitScale;
-            auto weightTemp = _Round(mWeight * _Reciprocal(weightScale)) * weightScale;
-            weightTemp = weightTemp + _ZeroGrad(mWeight);
+            auto x = _Convert(inputs[0], NC4HW4);
+            // simulate weight quant, a scale for each output channel
+            auto weightTemp = _FakeQuant(mWeight, nullptr, mLimit, 0, 1E-6f)[0];
 
             // simulate input quant to get original input scale
-            auto inputPair  = fakeQuantFeature(x);
-            mInputScale = updateScale(mInputScale, inputPair.second);
+            auto inputPair  = fakeQuantFeature(x, mInputScale);
+            mInputScale = inputPair.second;
             setParameter(mInputScale, mInputScalePos);
 
             // simulate output quant to get original output scale
-            res = _Conv(weightTemp, mBias, _Convert(inputPair.first, NC4HW4), mOption.padMode, mOption.stride,
+            res = _Conv(weightTemp, mBias, inputPair.first, mOption.padMode, mOption.stride,
                         mOption.dilate, mGroup, mOption.pads);
             res->setName(name());
             auto conv = res;
@@ -782,25 +746,23 @@ public:
 
             res = _activate(res, mActivation);
 
-            auto outputPair = fakeQuantFeature(res);
-            mOutputScale = updateScale(mOutputScale, outputPair.second);
+            auto outputPair = fakeQuantFeature(res, mOutputScale);
+            mOutputScale = outputPair.second;
             setParameter(mOutputScale, mOutputScalePos);
             res = outputPair.first;
         } else {
             if (nullptr == mInputScale) {
                 // Initial for test
                 // simulate weight quant
-                auto weightScale = _Maximum(_ReduceMax(_Abs(mWeight), {1, 2, 3}, true), _Scalar<float>(1E-6)) * mLimitScale;
-                weightScale.fix(VARP::CONSTANT);
-                auto weightTemp = _Round(mWeight * _Reciprocal(weightScale)) * weightScale;
+                auto weightTemp = _FakeQuant(mWeight, nullptr, mLimit, 0, 1E-6f)[0];
 
-                auto x = _Convert(inputs[0], NCHW);
+                auto x = _Convert(inputs[0], NC4HW4);
                 auto inputPair  = fakeQuantFeature(x);
                 mInputScale     = inputPair.second;
                 setParameter(mInputScale, mInputScalePos);
                 inputPair.first.fix(VARP::CONSTANT);
 
-                auto simuRes = _Conv(weightTemp, mBias, _Convert(inputPair.first, NC4HW4), mOption.padMode, mOption.stride,
+                auto simuRes = _Conv(weightTemp, mBias, inputPair.first, mOption.padMode, mOption.stride,
                                      mOption.dilate, mGroup, mOption.pads);
                 if (mBatchNorm) {
                     simuRes = mBatchNorm->forward(simuRes);
@@ -915,6 +877,7 @@ private:
         module->mBias = ctx->getOrClone(mBias);
         module->mActivation = mActivation;
         module->mBits = mBits;
+        module->mLimit = mLimit;
         module->mLimitScale = ctx->getOrClone(mLimitScale);
         module->mInputScalePos = mInputScalePos;
         module->mOutputScalePos = mOutputScalePos;
@@ -939,6 +902,7 @@ private:
     NN::ActivationFunctionType mActivation = NN::ActivationFunctionType::None;
     std::shared_ptr<Module> mBatchNorm = nullptr;
     int mBits;
+    float mLimit;
     VARP mLimitScale;
     int mInputScalePos = -1;
     int mOutputScalePos = -1;
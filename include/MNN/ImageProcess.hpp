@@ -119,6 +119,28 @@ public:
     ErrorCode convert(const uint8_t* source, int iw, int ih, int stride, void* dest, int ow, int oh, int outputBpp = 0,
                       int outputStride = 0, halide_type_t type = halide_type_of<float>());
 
+    struct Image {
+        /** source data, in config.sourceFormat */
+        const uint8_t* source = nullptr;
+        int width  = 0;
+        int height = 0;
+        /** number of elements per row, if 0, set as width * bpp of config.sourceFormat */
+        int stride = 0;
+        /** transform of this image, same as setMatrix, eg: a random crop / flip for augmentation */
+        Matrix matrix;
+    };
+
+    /**
+     * @brief convert a batch of images to given tensor, image n goes to batch n of dest.
+     * rows of all images are spread over threadNumber threads of the CPU thread pool,
+     * matrix() of this processor is not used and not changed.
+     * @param images        source images with their own transform.
+     * @param dest          given tensor, its batch must be images.size().
+     * @param threadNumber  number of threads.
+     * @return result code.
+     */
+    ErrorCode convert(const std::vector<Image>& images, Tensor* dest, int threadNumber = 4);
+
     /**
      * @brief create tensor with given data.
      * @param w     image width.
@@ -49,6 +49,14 @@ typedef enum {
     MNN_FORWARD_CPU_EXTENSION
 
 } MNNForwardType;
+
+/* Bits of BackendConfig::flags for the CPU backend */
+/* Check the outputs of every op for NaN */
+#define MNN_CPU_CHECK_NAN 1
+/* Time the convolution algorithms on the first use of a shape, Interpreter::setCacheFile keeps the winners */
+#define MNN_CPU_TUNING 2
+/* Keep the freed buffers in TLSF size classes instead of the size ordered free list */
+#define MNN_CPU_TLSF_ALLOCATOR 4
 #ifdef __cplusplus
 namespace MNN {
 struct BackendConfig {
@@ -67,7 +75,7 @@ struct BackendConfig {
     /** user defined context */
     union {
         void* sharedContext = nullptr;
-        size_t flags; // Valid for CPU Backend
+        size_t flags; // Valid for CPU Backend, MNN_CPU_* bits
     };
 };
 }; // namespace MNN
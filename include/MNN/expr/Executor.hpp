@@ -19,9 +19,11 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <functional>
 #include <MNN/MNNForwardType.h>
 namespace MNN {
 class Backend;
+class PlanBundle;
 class Execution;
 class Runtime;
 struct Op;
@@ -48,6 +50,7 @@ public:
         FULL,
         PART
     };
+    // FULL also drops executions shared between compute caches, PART the ones unused since the last gc
     void gc(GCFlag flag = FULL);
     static std::shared_ptr<Executor> getGlobalExecutor();
 
@@ -66,7 +69,22 @@ public:
     void setHeuristicAlloc(bool flag);
     bool getHeuristicAllocFlag();
     void configExecution(std::string modelName, int batchsize, std::string target, size_t budgetMB, size_t adaptiveBudget=-1, float adapProg=1.0);
+    // for target "bundle": returns the memory (MB) the next iteration may use, counting what the plan in use holds.
+    // Without a provider, or when it returns 0, MemAvailable of the OS plus the budget of the plan in use
+    void setMemoryProvider(std::function<size_t()> provider);
+    // budget (MB) of the plan in use: the rung last selected for target "bundle", else the configured budget
+    size_t planBudgetMB() const;
+    // let the heuristic caches reorder independent commands to lower the peak memory, off by default.
+    // profiles and plans only fit a run with the same setting, the vdnn target always keeps the original order
+    void setMemoryAwareOrder(bool flag);
+    // simulated peak of live bytes of the last command graph a heuristic cache scheduled, in the original order
+    // and in the one it runs, the orders are reused by rebuilt graphs of the same shape
+    std::pair<int64_t, int64_t> lastOrderPeak() const;
+    // heuristic caches created while set copy each output to host memory right after its last reader and give
+    // its buffer back, instead of holding every output in the pool until the end of the run
+    void setEagerOutputs(bool flag);
 private:
+    int _selectPlanRung();
     void _makeCache(const std::vector<EXPRP>& outputs, bool forceCPU);
     void _create(const std::vector<EXPRP>& outputs, std::set<std::shared_ptr<Executor::ComputeCache>>&& inputCaches, std::set<std::shared_ptr<Expr::Inside>>&& inputNode, bool forceCPU);
 
@@ -84,6 +102,13 @@ private:
     size_t mBudgetMB;
     size_t mAdaptiveBudgetMB = -1;
     float mAdaptiveProgress = 1.0;
+    std::shared_ptr<PlanBundle> mPlanBundle;
+    int mPlanRung = -1;
+    std::function<size_t()> mMemoryProvider;
+    bool mMemoryAwareOrder = false;
+    bool mEagerOutputs = false;
+    class ExecutionCache;
+    std::shared_ptr<ExecutionCache> mExecutionCache;
 };
 } // namespace Express
 } // namespace MNN
@@ -136,6 +136,9 @@ public:
     T* writeMap() {
         return (T*)writeInternal();
     }
+    // writeMap without marking the users of the variable dirty, for a writer on another thread than them:
+    // the thread using the variable calls writeMap once the content is written
+    void* writeInternal(bool inform=true);
 
     //Depecerate
     void unMap();
@@ -175,8 +178,9 @@ private:
         mFromIndex = index;
     }
 
+    // mapping non-null means buffer stays valid while mapping is alive, constants then alias it instead of copying
+    static std::vector<VARP> loadInternal(const uint8_t* buffer, size_t length, std::shared_ptr<void> mapping);
     void* readInternal(bool forShape = false);
-    void* writeInternal(bool inform=true);
     void informDirty();
 
     friend class Expr;
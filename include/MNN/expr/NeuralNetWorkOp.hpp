@@ -126,6 +126,13 @@ MNN_PUBLIC  std::vector<VARP> _DetectionPostProcess(VARP encode_boxes, VARP clas
 MNN_PUBLIC VARP _Interp(VARPS xs, float widthScale, float heightScale, int outputWidth, int outputHeight, int resizeType, bool alignCorners);
 
 MNN_PUBLIC VARP _ZeroGrad(VARP x);
+/* Quantize and dequantize x for quantization aware training: clamp(round(x / scale), -limit, limit) * scale,
+   where scale = max(max(|x|), minScale) / limit for the whole tensor, or for each slice along axis if axis >= 0.
+   Returns x quantized and its scale. If runningScale is not nullptr, the scale returned moves from it by momentum,
+   or is the larger one of both if maximum is true. The gradient of x passes straight through.
+*/
+MNN_PUBLIC std::vector<VARP> _FakeQuant(VARP x, VARP runningScale, float limit, int axis = -1, float minScale = 0.0001f,
+                                        float momentum = 0.99f, bool maximum = false);
 
 // Int8 Inference
 MNN_PUBLIC VARP _Conv(std::vector<int8_t>&& weight, std::vector<int>&& bias, std::vector<float>&& scale, VARP x, INTS channel, INTS kernelSize,
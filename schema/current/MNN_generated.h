@@ -220,6 +220,7 @@ enum OpType {
   OpType_TrainableParam = 266,
   OpType_BatchNorm = 267,
   OpType_ZeroGrad = 268,
+  OpType_FakeQuant = 269,
   OpType_Extra = 512,
   OpType_ConvInt8 = 513,
   OpType_Int8ToFloat = 514,
@@ -234,7 +235,7 @@ enum OpType {
   OpType_MAX = OpType_LayerNorm
 };
 
-inline const OpType (&EnumValuesOpType())[159] {
+inline const OpType (&EnumValuesOpType())[160] {
   static const OpType values[] = {
     OpType_AbsVal,
     OpType_QuantizedAdd,
@@ -385,6 +386,7 @@ inline const OpType (&EnumValuesOpType())[159] {
     OpType_TrainableParam,
     OpType_BatchNorm,
     OpType_ZeroGrad,
+    OpType_FakeQuant,
     OpType_Extra,
     OpType_ConvInt8,
     OpType_Int8ToFloat,
@@ -670,7 +672,7 @@ inline const char * const *EnumNamesOpType() {
     "TrainableParam",
     "BatchNorm",
     "ZeroGrad",
-    "",
+    "FakeQuant",
     "",
     "",
     "",
@@ -1108,11 +1110,12 @@ enum OpParameter {
   OpParameter_LayerNorm = 88,
   OpParameter_TensorArray = 89,
   OpParameter_LSTMBlockCell = 90,
+  OpParameter_FakeQuant = 91,
   OpParameter_MIN = OpParameter_NONE,
-  OpParameter_MAX = OpParameter_LSTMBlockCell
+  OpParameter_MAX = OpParameter_FakeQuant
 };
 
-inline const OpParameter (&EnumValuesOpParameter())[91] {
+inline const OpParameter (&EnumValuesOpParameter())[92] {
   static const OpParameter values[] = {
     OpParameter_NONE,
     OpParameter_QuantizedAdd,
@@ -1204,7 +1207,8 @@ inline const OpParameter (&EnumValuesOpParameter())[91] {
     OpParameter_RandomUniform,
     OpParameter_LayerNorm,
     OpParameter_TensorArray,
-    OpParameter_LSTMBlockCell
+    OpParameter_LSTMBlockCell,
+    OpParameter_FakeQuant
   };
   return values;
 }
@@ -1302,13 +1306,14 @@ inline const char * const *EnumNamesOpParameter() {
     "LayerNorm",
     "TensorArray",
     "LSTMBlockCell",
+    "FakeQuant",
     nullptr
   };
   return names;
 }
 
 inline const char *EnumNameOpParameter(OpParameter e) {
-  if (e < OpParameter_NONE || e > OpParameter_LSTMBlockCell) return "";
+  if (e < OpParameter_NONE || e > OpParameter_FakeQuant) return "";
   const size_t index = static_cast<int>(e);
   return EnumNamesOpParameter()[index];
 }
@@ -1677,6 +1682,10 @@ template<> struct OpParameterTraits<LSTMBlockCell> {
   static const OpParameter enum_value = OpParameter_LSTMBlockCell;
 };
 
+template<> struct OpParameterTraits<FakeQuant> {
+  static const OpParameter enum_value = OpParameter_FakeQuant;
+};
+
 struct OpParameterUnion {
   OpParameter type;
   void *value;
@@ -2428,6 +2437,14 @@ struct OpParameterUnion {
     return type == OpParameter_LSTMBlockCell ?
       reinterpret_cast<const LSTMBlockCellT *>(value) : nullptr;
   }
+  FakeQuantT *AsFakeQuant() {
+    return type == OpParameter_FakeQuant ?
+      reinterpret_cast<FakeQuantT *>(value) : nullptr;
+  }
+  const FakeQuantT *AsFakeQuant() const {
+    return type == OpParameter_FakeQuant ?
+      reinterpret_cast<const FakeQuantT *>(value) : nullptr;
+  }
 };
 
 bool VerifyOpParameter(flatbuffers::Verifier &verifier, const void *obj, OpParameter type);
@@ -3316,6 +3333,9 @@ struct Op FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   const LSTMBlockCell *main_as_LSTMBlockCell() const {
     return main_type() == OpParameter_LSTMBlockCell ? static_cast<const LSTMBlockCell *>(main()) : nullptr;
   }
+  const FakeQuant *main_as_FakeQuant() const {
+    return main_type() == OpParameter_FakeQuant ? static_cast<const FakeQuant *>(main()) : nullptr;
+  }
   const flatbuffers::String *name() const {
     return GetPointer<const flatbuffers::String *>(VT_NAME);
   }
@@ -3708,6 +3728,10 @@ template<> inline const LSTMBlockCell *Op::main_as<LSTMBlockCell>() const {
   return main_as_LSTMBlockCell();
 }
 
+template<> inline const FakeQuant *Op::main_as<FakeQuant>() const {
+  return main_as_FakeQuant();
+}
+
 struct OpBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
@@ -5196,6 +5220,10 @@ inline bool VerifyOpParameter(flatbuffers::Verifier &verifier, const void *obj,
       auto ptr = reinterpret_cast<const LSTMBlockCell *>(obj);
       return verifier.VerifyTable(ptr);
     }
+    case OpParameter_FakeQuant: {
+      auto ptr = reinterpret_cast<const FakeQuant *>(obj);
+      return verifier.VerifyTable(ptr);
+    }
     default: return false;
   }
 }
@@ -5574,6 +5602,10 @@ inline void *OpParameterUnion::UnPack(const void *obj, OpParameter type, const f
       auto ptr = reinterpret_cast<const LSTMBlockCell *>(obj);
       return ptr->UnPack(resolver);
     }
+    case OpParameter_FakeQuant: {
+      auto ptr = reinterpret_cast<const FakeQuant *>(obj);
+      return ptr->UnPack(resolver);
+    }
     default: return nullptr;
   }
 }
@@ -5940,6 +5972,10 @@ inline flatbuffers::Offset<void> OpParameterUnion::Pack(flatbuffers::FlatBufferB
       auto ptr = reinterpret_cast<const LSTMBlockCellT *>(value);
       return CreateLSTMBlockCell(_fbb, ptr, _rehasher).Union();
     }
+    case OpParameter_FakeQuant: {
+      auto ptr = reinterpret_cast<const FakeQuantT *>(value);
+      return CreateFakeQuant(_fbb, ptr, _rehasher).Union();
+    }
     default: return 0;
   }
 }
@@ -6306,6 +6342,10 @@ inline OpParameterUnion::OpParameterUnion(const OpParameterUnion &u) FLATBUFFERS
       value = new LSTMBlockCellT(*reinterpret_cast<LSTMBlockCellT *>(u.value));
       break;
     }
+    case OpParameter_FakeQuant: {
+      value = new FakeQuantT(*reinterpret_cast<FakeQuantT *>(u.value));
+      break;
+    }
     default:
       break;
   }
@@ -6763,6 +6803,11 @@ inline void OpParameterUnion::Reset() {
       delete ptr;
       break;
     }
+    case OpParameter_FakeQuant: {
+      auto ptr = reinterpret_cast<FakeQuantT *>(value);
+      delete ptr;
+      break;
+    }
     default: break;
   }
   value = nullptr;
@@ -6929,12 +6974,13 @@ inline const flatbuffers::TypeTable *OpTypeTypeTable() {
     { flatbuffers::ET_INT, 0, 0 },
     { flatbuffers::ET_INT, 0, 0 },
     { flatbuffers::ET_INT, 0, 0 },
+    { flatbuffers::ET_INT, 0, 0 },
     { flatbuffers::ET_INT, 0, 0 }
   };
   static const flatbuffers::TypeFunction type_refs[] = {
     OpTypeTypeTable
   };
-  static const int64_t values[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 256, 257, 258, 259, 260, 261, 262, 263, 264, 265, 266, 267, 268, 512, 513, 514, 515, 516, 517, 518, 600, 601, 603 };
+  static const int64_t values[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 256, 257, 258, 259, 260, 261, 262, 263, 264, 265, 266, 267, 268, 269, 512, 513, 514, 515, 516, 517, 518, 600, 601, 603 };
   static const char * const names[] = {
     "AbsVal",
     "QuantizedAdd",
@@ -7085,6 +7131,7 @@ inline const flatbuffers::TypeTable *OpTypeTypeTable() {
     "TrainableParam",
     "BatchNorm",
     "ZeroGrad",
+    "FakeQuant",
     "Extra",
     "ConvInt8",
     "Int8ToFloat",
@@ -7097,7 +7144,7 @@ inline const flatbuffers::TypeTable *OpTypeTypeTable() {
     "LayerNorm"
   };
   static const flatbuffers::TypeTable tt = {
-    flatbuffers::ST_ENUM, 159, type_codes, type_refs, values, names
+    flatbuffers::ST_ENUM, 160, type_codes, type_refs, values, names
   };
   return &tt;
 }
@@ -7194,7 +7241,8 @@ inline const flatbuffers::TypeTable *OpParameterTypeTable() {
     { flatbuffers::ET_SEQUENCE, 0, 86 },
     { flatbuffers::ET_SEQUENCE, 0, 87 },
     { flatbuffers::ET_SEQUENCE, 0, 88 },
-    { flatbuffers::ET_SEQUENCE, 0, 89 }
+    { flatbuffers::ET_SEQUENCE, 0, 89 },
+    { flatbuffers::ET_SEQUENCE, 0, 90 }
   };
   static const flatbuffers::TypeFunction type_refs[] = {
     QuantizedAddTypeTable,
@@ -7286,7 +7334,8 @@ inline const flatbuffers::TypeTable *OpParameterTypeTable() {
     RandomUniformTypeTable,
     LayerNormTypeTable,
     TensorArrayTypeTable,
-    LSTMBlockCellTypeTable
+    LSTMBlockCellTypeTable,
+    FakeQuantTypeTable
   };
   static const char * const names[] = {
     "NONE",
@@ -7379,10 +7428,11 @@ inline const flatbuffers::TypeTable *OpParameterTypeTable() {
     "RandomUniform",
     "LayerNorm",
     "TensorArray",
-    "LSTMBlockCell"
+    "LSTMBlockCell",
+    "FakeQuant"
   };
   static const flatbuffers::TypeTable tt = {
-    flatbuffers::ST_UNION, 91, type_codes, type_refs, nullptr, names
+    flatbuffers::ST_UNION, 92, type_codes, type_refs, nullptr, names
   };
   return &tt;
 }
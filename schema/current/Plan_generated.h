@@ -0,0 +1,623 @@
+// automatically generated by the FlatBuffers compiler, do not modify
+
+
+#ifndef FLATBUFFERS_GENERATED_PLAN_MNN_H_
+#define FLATBUFFERS_GENERATED_PLAN_MNN_H_
+
+#include "flatbuffers/flatbuffers.h"
+
+namespace MNN {
+
+struct MemoryPlanAddress;
+
+struct MemoryPlanStep;
+
+struct MemoryPlanRung;
+struct MemoryPlanRungT;
+
+struct MemoryPlan;
+struct MemoryPlanT;
+
+inline const flatbuffers::TypeTable *MemoryPlanAddressTypeTable();
+
+inline const flatbuffers::TypeTable *MemoryPlanStepTypeTable();
+
+inline const flatbuffers::TypeTable *MemoryPlanRungTypeTable();
+
+inline const flatbuffers::TypeTable *MemoryPlanTypeTable();
+
+enum MemoryPlanAction {
+  MemoryPlanAction_COMPUTE = 0,
+  MemoryPlanAction_RECOMPUTE = 1,
+  MemoryPlanAction_RELEASE = 2,
+  MemoryPlanAction_RERELEASE = 3,
+  MemoryPlanAction_RE_RELEASE = 4,
+  MemoryPlanAction_PRE_RELEASE = 5,
+  MemoryPlanAction_SWAP_OUT = 6,
+  MemoryPlanAction_SWAP_IN = 7,
+  MemoryPlanAction_MIN = MemoryPlanAction_COMPUTE,
+  MemoryPlanAction_MAX = MemoryPlanAction_SWAP_IN
+};
+
+inline const MemoryPlanAction (&EnumValuesMemoryPlanAction())[8] {
+  static const MemoryPlanAction values[] = {
+    MemoryPlanAction_COMPUTE,
+    MemoryPlanAction_RECOMPUTE,
+    MemoryPlanAction_RELEASE,
+    MemoryPlanAction_RERELEASE,
+    MemoryPlanAction_RE_RELEASE,
+    MemoryPlanAction_PRE_RELEASE,
+    MemoryPlanAction_SWAP_OUT,
+    MemoryPlanAction_SWAP_IN
+  };
+  return values;
+}
+
+inline const char * const *EnumNamesMemoryPlanAction() {
+  static const char * const names[] = {
+    "COMPUTE",
+    "RECOMPUTE",
+    "RELEASE",
+    "RERELEASE",
+    "RE_RELEASE",
+    "PRE_RELEASE",
+    "SWAP_OUT",
+    "SWAP_IN",
+    nullptr
+  };
+  return names;
+}
+
+inline const char *EnumNameMemoryPlanAction(MemoryPlanAction e) {
+  if (e < MemoryPlanAction_COMPUTE || e > MemoryPlanAction_SWAP_IN) return "";
+  const size_t index = static_cast<int>(e);
+  return EnumNamesMemoryPlanAction()[index];
+}
+
+FLATBUFFERS_MANUALLY_ALIGNED_STRUCT(8) MemoryPlanAddress FLATBUFFERS_FINAL_CLASS {
+ private:
+  int32_t op_;
+  int32_t resize_;
+  uint64_t offset_;
+  uint64_t size_;
+
+ public:
+  MemoryPlanAddress() {
+    memset(this, 0, sizeof(MemoryPlanAddress));
+  }
+  MemoryPlanAddress(int32_t _op, int32_t _resize, uint64_t _offset, uint64_t _size)
+      : op_(flatbuffers::EndianScalar(_op)),
+        resize_(flatbuffers::EndianScalar(_resize)),
+        offset_(flatbuffers::EndianScalar(_offset)),
+        size_(flatbuffers::EndianScalar(_size)) {
+  }
+  int32_t op() const {
+    return flatbuffers::EndianScalar(op_);
+  }
+  int32_t resize() const {
+    return flatbuffers::EndianScalar(resize_);
+  }
+  uint64_t offset() const {
+    return flatbuffers::EndianScalar(offset_);
+  }
+  uint64_t size() const {
+    return flatbuffers::EndianScalar(size_);
+  }
+};
+FLATBUFFERS_STRUCT_END(MemoryPlanAddress, 24);
+
+FLATBUFFERS_MANUALLY_ALIGNED_STRUCT(4) MemoryPlanStep FLATBUFFERS_FINAL_CLASS {
+ private:
+  int8_t action_;
+  int8_t padding0__;  int16_t padding1__;
+  int32_t op_;
+
+ public:
+  MemoryPlanStep() {
+    memset(this, 0, sizeof(MemoryPlanStep));
+  }
+  MemoryPlanStep(MemoryPlanAction _action, int32_t _op)
+      : action_(flatbuffers::EndianScalar(static_cast<int8_t>(_action))),
+        padding0__(0),
+        padding1__(0),
+        op_(flatbuffers::EndianScalar(_op)) {
+    (void)padding0__;    (void)padding1__;
+  }
+  MemoryPlanAction action() const {
+    return static_cast<MemoryPlanAction>(flatbuffers::EndianScalar(action_));
+  }
+  int32_t op() const {
+    return flatbuffers::EndianScalar(op_);
+  }
+};
+FLATBUFFERS_STRUCT_END(MemoryPlanStep, 8);
+
+struct MemoryPlanRungT : public flatbuffers::NativeTable {
+  typedef MemoryPlanRung TableType;
+  uint64_t budgetMB;
+  uint64_t maxSize;
+  std::vector<MemoryPlanAddress> address;
+  std::vector<MemoryPlanStep> sequence;
+  MemoryPlanRungT()
+      : budgetMB(0),
+        maxSize(0) {
+  }
+};
+
+struct MemoryPlanRung FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef MemoryPlanRungT NativeTableType;
+  static const flatbuffers::TypeTable *MiniReflectTypeTable() {
+    return MemoryPlanRungTypeTable();
+  }
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_BUDGETMB = 4,
+    VT_MAXSIZE = 6,
+    VT_ADDRESS = 8,
+    VT_SEQUENCE = 10
+  };
+  uint64_t budgetMB() const {
+    return GetField<uint64_t>(VT_BUDGETMB, 0);
+  }
+  uint64_t maxSize() const {
+    return GetField<uint64_t>(VT_MAXSIZE, 0);
+  }
+  const flatbuffers::Vector<const MemoryPlanAddress *> *address() const {
+    return GetPointer<const flatbuffers::Vector<const MemoryPlanAddress *> *>(VT_ADDRESS);
+  }
+  const flatbuffers::Vector<const MemoryPlanStep *> *sequence() const {
+    return GetPointer<const flatbuffers::Vector<const MemoryPlanStep *> *>(VT_SEQUENCE);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<uint64_t>(verifier, VT_BUDGETMB) &&
+           VerifyField<uint64_t>(verifier, VT_MAXSIZE) &&
+           VerifyOffset(verifier, VT_ADDRESS) &&
+           verifier.VerifyVector(address()) &&
+           VerifyOffset(verifier, VT_SEQUENCE) &&
+           verifier.VerifyVector(sequence()) &&
+           verifier.EndTable();
+  }
+  MemoryPlanRungT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  void UnPackTo(MemoryPlanRungT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  static flatbuffers::Offset<MemoryPlanRung> Pack(flatbuffers::FlatBufferBuilder &_fbb, const MemoryPlanRungT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+};
+
+struct MemoryPlanRungBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_budgetMB(uint64_t budgetMB) {
+    fbb_.AddElement<uint64_t>(MemoryPlanRung::VT_BUDGETMB, budgetMB, 0);
+  }
+  void add_maxSize(uint64_t maxSize) {
+    fbb_.AddElement<uint64_t>(MemoryPlanRung::VT_MAXSIZE, maxSize, 0);
+  }
+  void add_address(flatbuffers::Offset<flatbuffers::Vector<const MemoryPlanAddress *>> address) {
+    fbb_.AddOffset(MemoryPlanRung::VT_ADDRESS, address);
+  }
+  void add_sequence(flatbuffers::Offset<flatbuffers::Vector<const MemoryPlanStep *>> sequence) {
+    fbb_.AddOffset(MemoryPlanRung::VT_SEQUENCE, sequence);
+  }
+  explicit MemoryPlanRungBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  MemoryPlanRungBuilder &operator=(const MemoryPlanRungBuilder &);
+  flatbuffers::Offset<MemoryPlanRung> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<MemoryPlanRung>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<MemoryPlanRung> CreateMemoryPlanRung(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    uint64_t budgetMB = 0,
+    uint64_t maxSize = 0,
+    flatbuffers::Offset<flatbuffers::Vector<const MemoryPlanAddress *>> address = 0,
+    flatbuffers::Offset<flatbuffers::Vector<const MemoryPlanStep *>> sequence = 0) {
+  MemoryPlanRungBuilder builder_(_fbb);
+  builder_.add_maxSize(maxSize);
+  builder_.add_budgetMB(budgetMB);
+  builder_.add_sequence(sequence);
+  builder_.add_address(address);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<MemoryPlanRung> CreateMemoryPlanRungDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    uint64_t budgetMB = 0,
+    uint64_t maxSize = 0,
+    const std::vector<MemoryPlanAddress> *address = nullptr,
+    const std::vector<MemoryPlanStep> *sequence = nullptr) {
+  auto address__ = address ? _fbb.CreateVectorOfStructs<MemoryPlanAddress>(*address) : 0;
+  auto sequence__ = sequence ? _fbb.CreateVectorOfStructs<MemoryPlanStep>(*sequence) : 0;
+  return MNN::CreateMemoryPlanRung(
+      _fbb,
+      budgetMB,
+      maxSize,
+      address__,
+      sequence__);
+}
+
+flatbuffers::Offset<MemoryPlanRung> CreateMemoryPlanRung(flatbuffers::FlatBufferBuilder &_fbb, const MemoryPlanRungT *_o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+
+struct MemoryPlanT : public flatbuffers::NativeTable {
+  typedef MemoryPlan TableType;
+  int32_t version;
+  std::string model;
+  int32_t batch;
+  int32_t opCount;
+  uint64_t fingerprint;
+  std::vector<std::unique_ptr<MemoryPlanRungT>> rungs;
+  MemoryPlanT()
+      : version(0),
+        batch(0),
+        opCount(0),
+        fingerprint(0) {
+  }
+};
+
+struct MemoryPlan FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef MemoryPlanT NativeTableType;
+  static const flatbuffers::TypeTable *MiniReflectTypeTable() {
+    return MemoryPlanTypeTable();
+  }
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_VERSION = 4,
+    VT_MODEL = 6,
+    VT_BATCH = 8,
+    VT_OPCOUNT = 10,
+    VT_FINGERPRINT = 12,
+    VT_RUNGS = 14
+  };
+  int32_t version() const {
+    return GetField<int32_t>(VT_VERSION, 0);
+  }
+  const flatbuffers::String *model() const {
+    return GetPointer<const flatbuffers::String *>(VT_MODEL);
+  }
+  int32_t batch() const {
+    return GetField<int32_t>(VT_BATCH, 0);
+  }
+  int32_t opCount() const {
+    return GetField<int32_t>(VT_OPCOUNT, 0);
+  }
+  uint64_t fingerprint() const {
+    return GetField<uint64_t>(VT_FINGERPRINT, 0);
+  }
+  const flatbuffers::Vector<flatbuffers::Offset<MemoryPlanRung>> *rungs() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<MemoryPlanRung>> *>(VT_RUNGS);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<int32_t>(verifier, VT_VERSION) &&
+           VerifyOffset(verifier, VT_MODEL) &&
+           verifier.VerifyString(model()) &&
+           VerifyField<int32_t>(verifier, VT_BATCH) &&
+           VerifyField<int32_t>(verifier, VT_OPCOUNT) &&
+           VerifyField<uint64_t>(verifier, VT_FINGERPRINT) &&
+           VerifyOffset(verifier, VT_RUNGS) &&
+           verifier.VerifyVector(rungs()) &&
+           verifier.VerifyVectorOfTables(rungs()) &&
+           verifier.EndTable();
+  }
+  MemoryPlanT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  void UnPackTo(MemoryPlanT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  static flatbuffers::Offset<MemoryPlan> Pack(flatbuffers::FlatBufferBuilder &_fbb, const MemoryPlanT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+};
+
+struct MemoryPlanBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_version(int32_t version) {
+    fbb_.AddElement<int32_t>(MemoryPlan::VT_VERSION, version, 0);
+  }
+  void add_model(flatbuffers::Offset<flatbuffers::String> model) {
+    fbb_.AddOffset(MemoryPlan::VT_MODEL, model);
+  }
+  void add_batch(int32_t batch) {
+    fbb_.AddElement<int32_t>(MemoryPlan::VT_BATCH, batch, 0);
+  }
+  void add_opCount(int32_t opCount) {
+    fbb_.AddElement<int32_t>(MemoryPlan::VT_OPCOUNT, opCount, 0);
+  }
+  void add_fingerprint(uint64_t fingerprint) {
+    fbb_.AddElement<uint64_t>(MemoryPlan::VT_FINGERPRINT, fingerprint, 0);
+  }
+  void add_rungs(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<MemoryPlanRung>>> rungs) {
+    fbb_.AddOffset(MemoryPlan::VT_RUNGS, rungs);
+  }
+  explicit MemoryPlanBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  MemoryPlanBuilder &operator=(const MemoryPlanBuilder &);
+  flatbuffers::Offset<MemoryPlan> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<MemoryPlan>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<MemoryPlan> CreateMemoryPlan(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    int32_t version = 0,
+    flatbuffers::Offset<flatbuffers::String> model = 0,
+    int32_t batch = 0,
+    int32_t opCount = 0,
+    uint64_t fingerprint = 0,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<MemoryPlanRung>>> rungs = 0) {
+  MemoryPlanBuilder builder_(_fbb);
+  builder_.add_fingerprint(fingerprint);
+  builder_.add_rungs(rungs);
+  builder_.add_opCount(opCount);
+  builder_.add_batch(batch);
+  builder_.add_model(model);
+  builder_.add_version(version);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<MemoryPlan> CreateMemoryPlanDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    int32_t version = 0,
+    const char *model = nullptr,
+    int32_t batch = 0,
+    int32_t opCount = 0,
+    uint64_t fingerprint = 0,
+    const std::vector<flatbuffers::Offset<MemoryPlanRung>> *rungs = nullptr) {
+  auto model__ = model ? _fbb.CreateString(model) : 0;
+  auto rungs__ = rungs ? _fbb.CreateVector<flatbuffers::Offset<MemoryPlanRung>>(*rungs) : 0;
+  return MNN::CreateMemoryPlan(
+      _fbb,
+      version,
+      model__,
+      batch,
+      opCount,
+      fingerprint,
+      rungs__);
+}
+
+flatbuffers::Offset<MemoryPlan> CreateMemoryPlan(flatbuffers::FlatBufferBuilder &_fbb, const MemoryPlanT *_o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+
+inline MemoryPlanRungT *MemoryPlanRung::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = new MemoryPlanRungT();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
+inline void MemoryPlanRung::UnPackTo(MemoryPlanRungT *_o, const flatbuffers::resolver_function_t *_resolver) const {
+  (void)_o;
+  (void)_resolver;
+  { auto _e = budgetMB(); _o->budgetMB = _e; };
+  { auto _e = maxSize(); _o->maxSize = _e; };
+  { auto _e = address(); if (_e) { _o->address.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->address[_i] = *_e->Get(_i); } } };
+  { auto _e = sequence(); if (_e) { _o->sequence.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->sequence[_i] = *_e->Get(_i); } } };
+}
+
+inline flatbuffers::Offset<MemoryPlanRung> MemoryPlanRung::Pack(flatbuffers::FlatBufferBuilder &_fbb, const MemoryPlanRungT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  return CreateMemoryPlanRung(_fbb, _o, _rehasher);
+}
+
+inline flatbuffers::Offset<MemoryPlanRung> CreateMemoryPlanRung(flatbuffers::FlatBufferBuilder &_fbb, const MemoryPlanRungT *_o, const flatbuffers::rehasher_function_t *_rehasher) {
+  (void)_rehasher;
+  (void)_o;
+  struct _VectorArgs { flatbuffers::FlatBufferBuilder *__fbb; const MemoryPlanRungT* __o; const flatbuffers::rehasher_function_t *__rehasher; } _va = { &_fbb, _o, _rehasher}; (void)_va;
+  auto _budgetMB = _o->budgetMB;
+  auto _maxSize = _o->maxSize;
+  auto _address = _o->address.size() ? _fbb.CreateVectorOfStructs(_o->address) : 0;
+  auto _sequence = _o->sequence.size() ? _fbb.CreateVectorOfStructs(_o->sequence) : 0;
+  return MNN::CreateMemoryPlanRung(
+      _fbb,
+      _budgetMB,
+      _maxSize,
+      _address,
+      _sequence);
+}
+
+inline MemoryPlanT *MemoryPlan::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = new MemoryPlanT();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
+inline void MemoryPlan::UnPackTo(MemoryPlanT *_o, const flatbuffers::resolver_function_t *_resolver) const {
+  (void)_o;
+  (void)_resolver;
+  { auto _e = version(); _o->version = _e; };
+  { auto _e = model(); if (_e) _o->model = _e->str(); };
+  { auto _e = batch(); _o->batch = _e; };
+  { auto _e = opCount(); _o->opCount = _e; };
+  { auto _e = fingerprint(); _o->fingerprint = _e; };
+  { auto _e = rungs(); if (_e) { _o->rungs.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->rungs[_i] = std::unique_ptr<MemoryPlanRungT>(_e->Get(_i)->UnPack(_resolver)); } } };
+}
+
+inline flatbuffers::Offset<MemoryPlan> MemoryPlan::Pack(flatbuffers::FlatBufferBuilder &_fbb, const MemoryPlanT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  return CreateMemoryPlan(_fbb, _o, _rehasher);
+}
+
+inline flatbuffers::Offset<MemoryPlan> CreateMemoryPlan(flatbuffers::FlatBufferBuilder &_fbb, const MemoryPlanT *_o, const flatbuffers::rehasher_function_t *_rehasher) {
+  (void)_rehasher;
+  (void)_o;
+  struct _VectorArgs { flatbuffers::FlatBufferBuilder *__fbb; const MemoryPlanT* __o; const flatbuffers::rehasher_function_t *__rehasher; } _va = { &_fbb, _o, _rehasher}; (void)_va;
+  auto _version = _o->version;
+  auto _model = _o->model.empty() ? 0 : _fbb.CreateString(_o->model);
+  auto _batch = _o->batch;
+  auto _opCount = _o->opCount;
+  auto _fingerprint = _o->fingerprint;
+  auto _rungs = _o->rungs.size() ? _fbb.CreateVector<flatbuffers::Offset<MemoryPlanRung>> (_o->rungs.size(), [](size_t i, _VectorArgs *__va) { return CreateMemoryPlanRung(*__va->__fbb, __va->__o->rungs[i].get(), __va->__rehasher); }, &_va ) : 0;
+  return MNN::CreateMemoryPlan(
+      _fbb,
+      _version,
+      _model,
+      _batch,
+      _opCount,
+      _fingerprint,
+      _rungs);
+}
+
+inline const flatbuffers::TypeTable *MemoryPlanActionTypeTable() {
+  static const flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_CHAR, 0, 0 },
+    { flatbuffers::ET_CHAR, 0, 0 },
+    { flatbuffers::ET_CHAR, 0, 0 },
+    { flatbuffers::ET_CHAR, 0, 0 },
+    { flatbuffers::ET_CHAR, 0, 0 },
+    { flatbuffers::ET_CHAR, 0, 0 },
+    { flatbuffers::ET_CHAR, 0, 0 },
+    { flatbuffers::ET_CHAR, 0, 0 }
+  };
+  static const flatbuffers::TypeFunction type_refs[] = {
+    MemoryPlanActionTypeTable
+  };
+  static const char * const names[] = {
+    "COMPUTE",
+    "RECOMPUTE",
+    "RELEASE",
+    "RERELEASE",
+    "RE_RELEASE",
+    "PRE_RELEASE",
+    "SWAP_OUT",
+    "SWAP_IN"
+  };
+  static const flatbuffers::TypeTable tt = {
+    flatbuffers::ST_ENUM, 8, type_codes, type_refs, nullptr, names
+  };
+  return &tt;
+}
+
+inline const flatbuffers::TypeTable *MemoryPlanAddressTypeTable() {
+  static const flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_INT, 0, -1 },
+    { flatbuffers::ET_INT, 0, -1 },
+    { flatbuffers::ET_ULONG, 0, -1 },
+    { flatbuffers::ET_ULONG, 0, -1 }
+  };
+  static const int64_t values[] = { 0, 4, 8, 16, 24 };
+  static const char * const names[] = {
+    "op",
+    "resize",
+    "offset",
+    "size"
+  };
+  static const flatbuffers::TypeTable tt = {
+    flatbuffers::ST_STRUCT, 4, type_codes, nullptr, values, names
+  };
+  return &tt;
+}
+
+inline const flatbuffers::TypeTable *MemoryPlanStepTypeTable() {
+  static const flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_CHAR, 0, 0 },
+    { flatbuffers::ET_INT, 0, -1 }
+  };
+  static const flatbuffers::TypeFunction type_refs[] = {
+    MemoryPlanActionTypeTable
+  };
+  static const int64_t values[] = { 0, 4, 8 };
+  static const char * const names[] = {
+    "action",
+    "op"
+  };
+  static const flatbuffers::TypeTable tt = {
+    flatbuffers::ST_STRUCT, 2, type_codes, type_refs, values, names
+  };
+  return &tt;
+}
+
+inline const flatbuffers::TypeTable *MemoryPlanRungTypeTable() {
+  static const flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_ULONG, 0, -1 },
+    { flatbuffers::ET_ULONG, 0, -1 },
+    { flatbuffers::ET_SEQUENCE, 1, 0 },
+    { flatbuffers::ET_SEQUENCE, 1, 1 }
+  };
+  static const flatbuffers::TypeFunction type_refs[] = {
+    MemoryPlanAddressTypeTable,
+    MemoryPlanStepTypeTable
+  };
+  static const char * const names[] = {
+    "budgetMB",
+    "maxSize",
+    "address",
+    "sequence"
+  };
+  static const flatbuffers::TypeTable tt = {
+    flatbuffers::ST_TABLE, 4, type_codes, type_refs, nullptr, names
+  };
+  return &tt;
+}
+
+inline const flatbuffers::TypeTable *MemoryPlanTypeTable() {
+  static const flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_INT, 0, -1 },
+    { flatbuffers::ET_STRING, 0, -1 },
+    { flatbuffers::ET_INT, 0, -1 },
+    { flatbuffers::ET_INT, 0, -1 },
+    { flatbuffers::ET_ULONG, 0, -1 },
+    { flatbuffers::ET_SEQUENCE, 1, 0 }
+  };
+  static const flatbuffers::TypeFunction type_refs[] = {
+    MemoryPlanRungTypeTable
+  };
+  static const char * const names[] = {
+    "version",
+    "model",
+    "batch",
+    "opCount",
+    "fingerprint",
+    "rungs"
+  };
+  static const flatbuffers::TypeTable tt = {
+    flatbuffers::ST_TABLE, 6, type_codes, type_refs, nullptr, names
+  };
+  return &tt;
+}
+
+inline const MNN::MemoryPlan *GetMemoryPlan(const void *buf) {
+  return flatbuffers::GetRoot<MNN::MemoryPlan>(buf);
+}
+
+inline const MNN::MemoryPlan *GetSizePrefixedMemoryPlan(const void *buf) {
+  return flatbuffers::GetSizePrefixedRoot<MNN::MemoryPlan>(buf);
+}
+
+inline const char *MemoryPlanIdentifier() {
+  return "MNPB";
+}
+
+inline bool MemoryPlanBufferHasIdentifier(const void *buf) {
+  return flatbuffers::BufferHasIdentifier(
+      buf, MemoryPlanIdentifier());
+}
+
+inline bool VerifyMemoryPlanBuffer(
+    flatbuffers::Verifier &verifier) {
+  return verifier.VerifyBuffer<MNN::MemoryPlan>(MemoryPlanIdentifier());
+}
+
+inline bool VerifySizePrefixedMemoryPlanBuffer(
+    flatbuffers::Verifier &verifier) {
+  return verifier.VerifySizePrefixedBuffer<MNN::MemoryPlan>(MemoryPlanIdentifier());
+}
+
+inline void FinishMemoryPlanBuffer(
+    flatbuffers::FlatBufferBuilder &fbb,
+    flatbuffers::Offset<MNN::MemoryPlan> root) {
+  fbb.Finish(root, MemoryPlanIdentifier());
+}
+
+inline void FinishSizePrefixedMemoryPlanBuffer(
+    flatbuffers::FlatBufferBuilder &fbb,
+    flatbuffers::Offset<MNN::MemoryPlan> root) {
+  fbb.FinishSizePrefixed(root, MemoryPlanIdentifier());
+}
+
+inline std::unique_ptr<MemoryPlanT> UnPackMemoryPlan(
+    const void *buf,
+    const flatbuffers::resolver_function_t *res = nullptr) {
+  return std::unique_ptr<MemoryPlanT>(GetMemoryPlan(buf)->UnPack(res));
+}
+
+}  // namespace MNN
+
+#endif  // FLATBUFFERS_GENERATED_PLAN_MNN_H_
@@ -62,6 +62,9 @@ struct RequantizeT;
 struct TfQuantizedConv2D;
 struct TfQuantizedConv2DT;
 
+struct FakeQuant;
+struct FakeQuantT;
+
 inline const flatbuffers::TypeTable *QuantizedParamTypeTable();
 
 inline const flatbuffers::TypeTable *QuantizedAddTypeTable();
@@ -96,6 +99,8 @@ inline const flatbuffers::TypeTable *RequantizeTypeTable();
 
 inline const flatbuffers::TypeTable *TfQuantizedConv2DTypeTable();
 
+inline const flatbuffers::TypeTable *FakeQuantTypeTable();
+
 enum FusedActivation {
   FusedActivation_kTfLiteActNone = 0,
   FusedActivation_kTfLiteActRelu = 1,
@@ -1919,6 +1924,111 @@ inline flatbuffers::Offset<TfQuantizedConv2D> CreateTfQuantizedConv2DDirect(
 
 flatbuffers::Offset<TfQuantizedConv2D> CreateTfQuantizedConv2D(flatbuffers::FlatBufferBuilder &_fbb, const TfQuantizedConv2DT *_o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
 
+struct FakeQuantT : public flatbuffers::NativeTable {
+  typedef FakeQuant TableType;
+  float limit;
+  int32_t axis;
+  float minScale;
+  float momentum;
+  bool maximum;
+  FakeQuantT()
+      : limit(127.0f),
+        axis(-1),
+        minScale(0.0001f),
+        momentum(0.99f),
+        maximum(false) {
+  }
+};
+
+struct FakeQuant FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef FakeQuantT NativeTableType;
+  static const flatbuffers::TypeTable *MiniReflectTypeTable() {
+    return FakeQuantTypeTable();
+  }
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_LIMIT = 4,
+    VT_AXIS = 6,
+    VT_MINSCALE = 8,
+    VT_MOMENTUM = 10,
+    VT_MAXIMUM = 12
+  };
+  float limit() const {
+    return GetField<float>(VT_LIMIT, 127.0f);
+  }
+  int32_t axis() const {
+    return GetField<int32_t>(VT_AXIS, -1);
+  }
+  float minScale() const {
+    return GetField<float>(VT_MINSCALE, 0.0001f);
+  }
+  float momentum() const {
+    return GetField<float>(VT_MOMENTUM, 0.99f);
+  }
+  bool maximum() const {
+    return GetField<uint8_t>(VT_MAXIMUM, 0) != 0;
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<float>(verifier, VT_LIMIT) &&
+           VerifyField<int32_t>(verifier, VT_AXIS) &&
+           VerifyField<float>(verifier, VT_MINSCALE) &&
+           VerifyField<float>(verifier, VT_MOMENTUM) &&
+           VerifyField<uint8_t>(verifier, VT_MAXIMUM) &&
+           verifier.EndTable();
+  }
+  FakeQuantT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  void UnPackTo(FakeQuantT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  static flatbuffers::Offset<FakeQuant> Pack(flatbuffers::FlatBufferBuilder &_fbb, const FakeQuantT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+};
+
+struct FakeQuantBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_limit(float limit) {
+    fbb_.AddElement<float>(FakeQuant::VT_LIMIT, limit, 127.0f);
+  }
+  void add_axis(int32_t axis) {
+    fbb_.AddElement<int32_t>(FakeQuant::VT_AXIS, axis, -1);
+  }
+  void add_minScale(float minScale) {
+    fbb_.AddElement<float>(FakeQuant::VT_MINSCALE, minScale, 0.0001f);
+  }
+  void add_momentum(float momentum) {
+    fbb_.AddElement<float>(FakeQuant::VT_MOMENTUM, momentum, 0.99f);
+  }
+  void add_maximum(bool maximum) {
+    fbb_.AddElement<uint8_t>(FakeQuant::VT_MAXIMUM, static_cast<uint8_t>(maximum), 0);
+  }
+  explicit FakeQuantBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  FakeQuantBuilder &operator=(const FakeQuantBuilder &);
+  flatbuffers::Offset<FakeQuant> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<FakeQuant>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<FakeQuant> CreateFakeQuant(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    float limit = 127.0f,
+    int32_t axis = -1,
+    float minScale = 0.0001f,
+    float momentum = 0.99f,
+    bool maximum = false) {
+  FakeQuantBuilder builder_(_fbb);
+  builder_.add_momentum(momentum);
+  builder_.add_minScale(minScale);
+  builder_.add_axis(axis);
+  builder_.add_limit(limit);
+  builder_.add_maximum(maximum);
+  return builder_.Finish();
+}
+
+flatbuffers::Offset<FakeQuant> CreateFakeQuant(flatbuffers::FlatBufferBuilder &_fbb, const FakeQuantT *_o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+
 inline QuantizedParamT *QuantizedParam::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
   auto _o = new QuantizedParamT();
   UnPackTo(_o, _resolver);
@@ -2520,6 +2630,44 @@ inline flatbuffers::Offset<TfQuantizedConv2D> CreateTfQuantizedConv2D(flatbuffer
       _outputQuantizedParam);
 }
 
+inline FakeQuantT *FakeQuant::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = new FakeQuantT();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
+inline void FakeQuant::UnPackTo(FakeQuantT *_o, const flatbuffers::resolver_function_t *_resolver) const {
+  (void)_o;
+  (void)_resolver;
+  { auto _e = limit(); _o->limit = _e; };
+  { auto _e = axis(); _o->axis = _e; };
+  { auto _e = minScale(); _o->minScale = _e; };
+  { auto _e = momentum(); _o->momentum = _e; };
+  { auto _e = maximum(); _o->maximum = _e; };
+}
+
+inline flatbuffers::Offset<FakeQuant> FakeQuant::Pack(flatbuffers::FlatBufferBuilder &_fbb, const FakeQuantT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  return CreateFakeQuant(_fbb, _o, _rehasher);
+}
+
+inline flatbuffers::Offset<FakeQuant> CreateFakeQuant(flatbuffers::FlatBufferBuilder &_fbb, const FakeQuantT *_o, const flatbuffers::rehasher_function_t *_rehasher) {
+  (void)_rehasher;
+  (void)_o;
+  struct _VectorArgs { flatbuffers::FlatBufferBuilder *__fbb; const FakeQuantT* __o; const flatbuffers::rehasher_function_t *__rehasher; } _va = { &_fbb, _o, _rehasher}; (void)_va;
+  auto _limit = _o->limit;
+  auto _axis = _o->axis;
+  auto _minScale = _o->minScale;
+  auto _momentum = _o->momentum;
+  auto _maximum = _o->maximum;
+  return MNN::CreateFakeQuant(
+      _fbb,
+      _limit,
+      _axis,
+      _minScale,
+      _momentum,
+      _maximum);
+}
+
 inline const flatbuffers::TypeTable *FusedActivationTypeTable() {
   static const flatbuffers::TypeCode type_codes[] = {
     { flatbuffers::ET_CHAR, 0, 0 },
@@ -2973,6 +3121,27 @@ inline const flatbuffers::TypeTable *TfQuantizedConv2DTypeTable() {
   return &tt;
 }
 
+inline const flatbuffers::TypeTable *FakeQuantTypeTable() {
+  static const flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_FLOAT, 0, -1 },
+    { flatbuffers::ET_INT, 0, -1 },
+    { flatbuffers::ET_FLOAT, 0, -1 },
+    { flatbuffers::ET_FLOAT, 0, -1 },
+    { flatbuffers::ET_BOOL, 0, -1 }
+  };
+  static const char * const names[] = {
+    "limit",
+    "axis",
+    "minScale",
+    "momentum",
+    "maximum"
+  };
+  static const flatbuffers::TypeTable tt = {
+    flatbuffers::ST_TABLE, 5, type_codes, nullptr, nullptr, names
+  };
+  return &tt;
+}
+
 }  // namespace MNN
 
 #endif  // FLATBUFFERS_GENERATED_TFQUANTIZEOP_MNN_H_
@@ -20,6 +20,7 @@
 #include <omp.h>
 #endif // _OPENMP
 #include "backend/cpu/CPURuntime.hpp"
+#include "backend/cpu/schema/current/CPUCache_generated.h"
 #if defined(__aarch64__) && ENABLE_ARMV82
 #include "backend/arm82/Arm82Backend.hpp"
 #endif
@@ -27,12 +28,12 @@
 #define LARGE_MEMORY 1024 * 1024 * 500
 
 //#define MNN_DUMP_MEMORY_USAGE
-#define MNN_CPU_CHECK_NAN 1
 namespace MNN {
 void registerCPUOps();
 #if defined(__aarch64__) && ENABLE_ARMV82
 struct cpuinfo_arm_isa gCPUInfo;
 #endif
+static std::vector<CPUBackend::AllocRecord>* gAllocTrace = nullptr;
 
 CPURuntime::CPURuntime(const Backend::Info& info) {
     mStaticAllocator.reset(new BufferAllocator(BufferAllocator::Allocator::createDefault()));
@@ -54,6 +55,9 @@ CPURuntime::CPURuntime(const Backend::Info& info) {
         mMemory = info.user->memory;
         mFlags = info.user->flags;
     }
+    if (mFlags & MNN_CPU_TLSF_ALLOCATOR) {
+        mStaticAllocator->setEngine(BufferAllocator::ENGINE_TLSF);
+    }
 #ifdef _OPENMP
     switch (mPower) {
         case BackendConfig::Power_Low:
@@ -101,6 +105,83 @@ Backend* CPURuntime::onCreate() const{
 void CPURuntime::onGabageCollect(int level) {
     mStaticAllocator->release(false);
 }
+
+// Tunings only hold for the kernels they were timed with
+static std::string _tuningDevice() {
+    int eP, lP, hP;
+    MNNGetMatMulPackMode(&eP, &lP, &hP);
+#if defined(__aarch64__)
+    std::string device = "arm64";
+#elif defined(__arm__)
+    std::string device = "arm";
+#elif defined(__x86_64__) || defined(_M_X64)
+    std::string device = "x64";
+#else
+    std::string device = "cpu";
+#endif
+    return device + ":" + std::to_string(eP) + "x" + std::to_string(lP) + "x" + std::to_string(hP);
+}
+
+bool CPURuntime::onSetCache(const void* buffer, size_t size) {
+    if (nullptr == buffer) {
+        // The tunings stay for the next sessions, only the file's copy is dropped
+        mCacheBuffer.clear();
+        return false;
+    }
+    flatbuffers::Verifier verify((const uint8_t*)buffer, size);
+    if (!CPUCache::VerifyCacheBuffer(verify)) {
+        return false;
+    }
+    auto cache = CPUCache::GetCache(buffer);
+    if (nullptr == cache->device() || cache->device()->str() != _tuningDevice() || nullptr == cache->tunings()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> _l(mTuningLock);
+    for (int i = 0; i < cache->tunings()->size(); ++i) {
+        auto tuning = cache->tunings()->GetAs<CPUCache::ConvTuning>(i);
+        if (nullptr == tuning->key()) {
+            continue;
+        }
+        mConvTunings[tuning->key()->str()] = std::make_pair(tuning->algorithm(), tuning->parameter());
+    }
+    return true;
+}
+
+std::pair<const void*, size_t> CPURuntime::onGetCache() {
+    std::lock_guard<std::mutex> _l(mTuningLock);
+    if (mConvTunings.empty()) {
+        return std::make_pair(nullptr, 0);
+    }
+    std::unique_ptr<CPUCache::CacheT> cache(new CPUCache::CacheT);
+    cache->device = _tuningDevice();
+    for (auto& iter : mConvTunings) {
+        std::unique_ptr<CPUCache::ConvTuningT> tuning(new CPUCache::ConvTuningT);
+        tuning->key       = iter.first;
+        tuning->algorithm = iter.second.first;
+        tuning->parameter = iter.second.second;
+        cache->tunings.emplace_back(std::move(tuning));
+    }
+    flatbuffers::FlatBufferBuilder builder;
+    builder.Finish(CPUCache::Cache::Pack(builder, cache.get()));
+    mCacheBuffer.resize(builder.GetSize());
+    ::memcpy(mCacheBuffer.data(), builder.GetBufferPointer(), builder.GetSize());
+    return std::make_pair(mCacheBuffer.data(), mCacheBuffer.size());
+}
+
+bool CPURuntime::findConvTuning(const std::string& key, std::pair<int, int>& algorithm) const {
+    std::lock_guard<std::mutex> _l(mTuningLock);
+    auto iter = mConvTunings.find(key);
+    if (iter == mConvTunings.end()) {
+        return false;
+    }
+    algorithm = iter->second;
+    return true;
+}
+
+void CPURuntime::insertConvTuning(const std::string& key, std::pair<int, int> algorithm) const {
+    std::lock_guard<std::mutex> _l(mTuningLock);
+    mConvTunings[key] = algorithm;
+}
 std::map<OpType, CPUBackend::Creator*>* CPUBackend::gCreator = nullptr;
 
 void CPUBackend::initCreatorMap() {
@@ -123,12 +204,19 @@ bool CPUBackend::addCreator(OpType t, Creator* c) {
 
 CPUBackend::CPUBackend(const CPURuntime* runtime, MNNForwardType type) : Backend(type) {
     mRuntime = runtime;
-    mCheckNAN = runtime->mFlags == MNN_CPU_CHECK_NAN;
+    mCheckNAN = 0 != (runtime->mFlags & MNN_CPU_CHECK_NAN);
     std::shared_ptr<BufferAllocator::Allocator> defaultAlloc(BufferAllocator::Allocator::createRecurse(runtime->mStaticAllocator.get()));
     mDynamicAllocator.reset(new BufferAllocator(defaultAlloc));
     mDynamicAllocator->setName("dynamic");
+    if (runtime->mFlags & MNN_CPU_TLSF_ALLOCATOR) {
+        mDynamicAllocator->setEngine(BufferAllocator::ENGINE_TLSF);
+    }
     mStaticAllocator = runtime->mStaticAllocator;
 }
+
+void CPUBackend::setAllocTrace(std::vector<AllocRecord>* trace) {
+    gAllocTrace = trace;
+}
 bool CPUBackend::supportDot() const {
     return mRuntime->mIsSupportDot;
 }
@@ -204,6 +292,9 @@ bool CPUBackend::allocBuffer(int size, Tensor* dest, StorageType storageType) {
         MNN_ERROR("Alloc buffer error for cpu backend\n");
         return false;
     }
+    if (nullptr != gAllocTrace) {
+        gAllocTrace->emplace_back(AllocRecord{dest, size, storageType});
+    }
 
     MNN_DEBUG_PRINT("\tallocated points.second = %lu for id = %s\n", points.second, id.c_str())
     buffer.host = (uint8_t*)points.first + points.second;
@@ -239,6 +330,9 @@ bool CPUBackend::onReleaseBuffer(const MNN::Tensor* nativeTensor, StorageType st
     if (nullptr == nativeTensor->buffer().host) {
         return false;
     }
+    if (nullptr != gAllocTrace) {
+        gAllocTrace->emplace_back(AllocRecord{nativeTensor, 0, storageType});
+    }
     auto des = TensorUtils::getDescribe(nativeTensor);
     std::pair<void*, int> pointer;
     pointer.second = des->extra.offset;
@@ -314,6 +408,9 @@ Execution* CPUBackend::onCreate(const std::vector<Tensor*>& inputs, const std::v
                     if (halide_type_float != tensor->getType().code) {
                         return NO_ERROR;
                     }
+                    if (TensorUtils::getDescribe(tensor)->memoryType == Tensor::InsideDescribe::MEMORY_VIRTUAL) {
+                        continue;
+                    }
                     auto size = tensor->elementSize();
                     auto ptr  = tensor->host<float>();
                     for (int i = 0; i < size; ++i) {
@@ -436,6 +533,14 @@ void CPUBackend::setHeuristicStrategy(bool flag, std::string modelName, int batc
     }
 }
 
+void CPUBackend::setHeuristicBundle(bool flag, std::shared_ptr<PlanBundle> bundle, int rung) {
+    MNN_DEBUG_PRINT("%s: rung = %d\n", __FUNCTION__, rung);
+    mHeuristic = flag && nullptr != bundle;
+    if (mHeuristic) {
+        mDynamicAllocator->setHeuristicBundle(bundle, rung);
+    }
+}
+
 
 std::pair<int, int> CPUBackend::multiThreadDivide(int size) const {
     int sizeDivide = size / threadNumber();
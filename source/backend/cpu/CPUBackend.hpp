@@ -12,6 +12,8 @@
 #include <stdio.h>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 #include "core/Backend.hpp"
 #include "core/Execution.hpp"
 #include "core/BufferAllocator.hpp"
@@ -33,6 +35,16 @@ public:
     virtual Backend* onCreate() const override;
     virtual void onGabageCollect(int level) override;
     virtual float onGetMemoryInMB() override;
+    virtual bool onSetCache(const void* buffer, size_t size) override;
+    virtual std::pair<const void*, size_t> onGetCache() override;
+
+    // Convolution algorithms timed by ConvolutionFloatFactory, keyed by shape, stride, pad, threads and
+    // the memory and precision modes
+    bool convTuning() const {
+        return 0 != (mFlags & MNN_CPU_TUNING);
+    }
+    bool findConvTuning(const std::string& key, std::pair<int, int>& algorithm) const;
+    void insertConvTuning(const std::string& key, std::pair<int, int> algorithm) const;
 //private:
     std::shared_ptr<BufferAllocator> mStaticAllocator;
     int mThreadNumber;
@@ -48,6 +60,11 @@ public:
     bool mIsSupportFp16arith = false;
     float mFlops = 0.0f;
     static Backend*(*gExtraCreate)(const Runtime* runtime);
+
+private:
+    mutable std::mutex mTuningLock;
+    mutable std::map<std::string, std::pair<int, int>> mConvTunings;
+    std::vector<uint8_t> mCacheBuffer;
 };
 
 class CPUBackend : public Backend {
@@ -67,6 +84,7 @@ public:
     virtual bool onFreeBufferHybrid(const Tensor* nativeTensor, int hybrid_thres=MNN_HYBRID_DYNAMIC_THRESHOLD) override;
     virtual void changeBufferType(BufferType bufferType) override;
     virtual void setHeuristicStrategy(bool flag, std::string modelName, int batchsize, int bgt, bool alignBottom=false, bool needAlloc=true) override;
+    virtual void setHeuristicBundle(bool flag, std::shared_ptr<PlanBundle> bundle, int rung) override;
     virtual void onCopyBuffer(const Tensor* srcTensor, const Tensor* dstTensor) const override;
     virtual std::pair<float, bool> onMeasure(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs,
                                             const MNN::Op* op) override;
@@ -93,6 +111,10 @@ public:
         return mRuntime->mThreadNumber;
     }
 
+    const CPURuntime* runtime() const {
+        return mRuntime;
+    }
+
     BufferAllocator* getBufferAllocator() const {
         return mDynamicAllocator.get();
     }
@@ -100,12 +122,24 @@ public:
     BackendConfig::MemoryMode memoryMode() const {
         return mRuntime->mMemory;
     }
+    BackendConfig::PrecisionMode precisionMode() const {
+        return mRuntime->mPrecision;
+    }
 #ifdef MNN_USE_THREAD_POOL
     inline int taskIndex() const {return mRuntime->mTaskIndex;}
 #endif
     bool supportDot() const;
     static void initCreatorMap();
 
+    // One buffer request of allocBuffer / onReleaseBuffer, size is 0 for releasing
+    struct AllocRecord {
+        const Tensor* tensor;
+        int size;
+        StorageType storageType;
+    };
+    // While trace is set, the requests of every CPU backend are appended to it for replaying, not thread safe
+    MNN_PUBLIC static void setAllocTrace(std::vector<AllocRecord>* trace);
+
 protected:
     bool allocBuffer(int size, Tensor* dest,  StorageType storageType);
 private:
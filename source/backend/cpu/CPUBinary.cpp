@@ -13,7 +13,9 @@
 #include "core/Macro.h"
 #include "core/Concurrency.h"
 #include "core/OpCommonUtils.hpp"
+#include "core/TensorUtils.hpp"
 #include "BinaryUtils.hpp"
+#include <algorithm>
 namespace MNN {
 #define MAX_DIM 6
 CPUBinaryInt::CPUBinaryInt(Backend* b, int32_t type) : MNN::Execution(b), mType(type) {
@@ -23,6 +25,26 @@ CPUBinaryFloat::CPUBinaryFloat(Backend* b, int32_t type) : MNN::Execution(b), mT
     // nothing to do
 }
 
+// Floats processed at once for a row of a region input, see CPUBinaryFloat::executeRegion
+#define REGION_TILE 256
+typedef void (*ElementProc)(float* C, const float* A, const float* B, size_t width, size_t cStride, size_t aStride, size_t bStride, size_t height);
+
+static ElementProc _selectElementProc(int32_t type) {
+    switch (type) {
+        case BinaryOpOperation_MUL:
+            return MNNMatrixProdCommon;
+        case BinaryOpOperation_ADD:
+            return MNNMatrixAddCommon;
+        case BinaryOpOperation_MAXIMUM:
+            return MNNMatrixMaxCommon;
+        case BinaryOpOperation_SUB:
+            return MNNMatrixSubCommon;
+        default:
+            break;
+    }
+    return nullptr;
+}
+
 ErrorCode CPUBinaryFloat::onResize(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
     MNN_ASSERT(1 == outputs.size());
     const int input0DataCount = inputs[0]->elementSize();
@@ -31,27 +53,33 @@ ErrorCode CPUBinaryFloat::onResize(const std::vector<Tensor*>& inputs, const std
     int maxCount = input0DataCount > input1DataCount ?  input0DataCount : input1DataCount;
     mElementProc = nullptr;
     mSupportScale = false;
+    mRegionInput = -1;
+    for (int i = 0; i < inputs.size(); ++i) {
+        if (TensorUtils::getDescribe(inputs[i])->memoryType == Tensor::InsideDescribe::MEMORY_VIRTUAL) {
+            mRegionInput = i;
+        }
+    }
+    if (mRegionInput >= 0) {
+        // The geometry only keeps a virtual input for a same-shape elementwise op, see GeometryComputerUtils
+        mElementProc = _selectElementProc(mType);
+        if (nullptr == mElementProc) {
+            return NOT_SUPPORT;
+        }
+        mRegionFull = TensorUtils::regionIsFull(inputs[mRegionInput]);
+        auto threadNumber = ((CPUBackend*)backend())->threadNumber();
+        mRegionCache.reset(Tensor::createDevice<float>({threadNumber, 3 * REGION_TILE}));
+        auto res = backend()->onAcquireBuffer(mRegionCache.get(), Backend::DYNAMIC);
+        if (!res) {
+            return OUT_OF_MEMORY;
+        }
+        backend()->onReleaseBuffer(mRegionCache.get(), Backend::DYNAMIC);
+        return NO_ERROR;
+    }
     if (outputs[0]->getType().code != halide_type_float || maxCount < 4 || (outputDataCount > input0DataCount && outputDataCount > input1DataCount)) {
         // Can't optimize
         return NO_ERROR;
     }
-    auto eleProc = mElementProc;// Set nullptr for begin
-    switch (mType) {
-        case BinaryOpOperation_MUL:
-            eleProc = MNNMatrixProdCommon;
-            break;
-        case BinaryOpOperation_ADD:
-            eleProc = MNNMatrixAddCommon;
-            break;
-        case BinaryOpOperation_MAXIMUM:
-            eleProc = MNNMatrixMaxCommon;
-            break;
-        case BinaryOpOperation_SUB:
-            eleProc = MNNMatrixSubCommon;
-            break;
-        default:
-            break;
-    }
+    auto eleProc = _selectElementProc(mType);
     if (input1DataCount == input0DataCount) {
         mOutside = 1;
         mInside = input0DataCount;
@@ -209,7 +237,75 @@ static void callEleFunc(void(*proc)(float* C, const float* A, const float* B, si
     }
 }
 
+static void _gatherRow(float* dst, const float* src, int size, int stride) {
+    for (int i = 0; i < size; ++i) {
+        dst[i] = src[i * stride];
+    }
+}
+
+static void _scatterRow(float* dst, const float* src, int size, int stride) {
+    for (int i = 0; i < size; ++i) {
+        dst[i * stride] = src[i];
+    }
+}
+
+ErrorCode CPUBinaryFloat::executeRegion(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
+    auto other        = inputs[1 - mRegionInput]->host<float>();
+    auto output       = outputs[0]->host<float>();
+    auto numberThread = ((CPUBackend*)backend())->threadNumber();
+    // The region input is A, swap it to the right side when it is inputs[1]
+    bool swap = 1 == mRegionInput;
+    if (!mRegionFull) {
+        // Elements not covered by a region read zero
+        int size = outputs[0]->elementSize();
+        MNN_CONCURRENCY_BEGIN(tId, numberThread) {
+            auto zero = mRegionCache->host<float>() + tId * 3 * REGION_TILE;
+            ::memset(zero, 0, REGION_TILE * sizeof(float));
+            for (int start = (int)tId * REGION_TILE; start < size; start += numberThread * REGION_TILE) {
+                callEleFunc(mElementProc, output + start, zero, other + start, std::min(REGION_TILE, size - start), swap);
+            }
+        }
+        MNN_CONCURRENCY_END();
+    }
+    for (auto& reg : TensorUtils::getDescribe(inputs[mRegionInput])->regions) {
+        auto source = reg.origin->host<float>() + reg.src.offset;
+        // Tiles of all rows are shared between threads, so a region of few long rows is still split
+        int tileCount = UP_DIV(reg.size[2], REGION_TILE);
+        int total     = reg.size[0] * reg.size[1] * tileCount;
+        MNN_CONCURRENCY_BEGIN(tId, numberThread) {
+            auto a = mRegionCache->host<float>() + tId * 3 * REGION_TILE;
+            auto b = a + REGION_TILE;
+            auto c = b + REGION_TILE;
+            for (int index = (int)tId; index < total; index += numberThread) {
+                int x   = (index % tileCount) * REGION_TILE;
+                int row = index / tileCount;
+                int y   = row % reg.size[1];
+                int z   = row / reg.size[1];
+                int count = std::min(REGION_TILE, reg.size[2] - x);
+                const float* srcRow = source + z * reg.src.stride[0] + y * reg.src.stride[1] + x * reg.src.stride[2];
+                int dstOffset = reg.dst.offset + z * reg.dst.stride[0] + y * reg.dst.stride[1] + x * reg.dst.stride[2];
+                if (1 != reg.src.stride[2]) {
+                    _gatherRow(a, srcRow, count, reg.src.stride[2]);
+                    srcRow = a;
+                }
+                if (1 == reg.dst.stride[2]) {
+                    callEleFunc(mElementProc, output + dstOffset, srcRow, other + dstOffset, count, swap);
+                    continue;
+                }
+                _gatherRow(b, other + dstOffset, count, reg.dst.stride[2]);
+                callEleFunc(mElementProc, c, srcRow, b, count, swap);
+                _scatterRow(output + dstOffset, c, count, reg.dst.stride[2]);
+            }
+        }
+        MNN_CONCURRENCY_END();
+    }
+    return NO_ERROR;
+}
+
 ErrorCode CPUBinaryFloat::onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
+    if (mRegionInput >= 0) {
+        return executeRegion(inputs, outputs);
+    }
     auto input  = inputs[0];
     auto input1 = inputs[1];
     auto output = outputs[0];
@@ -9,6 +9,7 @@
 #ifndef CPUBinary_hpp
 #define CPUBinary_hpp
 
+#include <memory>
 #include "core/Execution.hpp"
 
 namespace MNN {
@@ -21,12 +22,18 @@ public:
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
 
 protected:
+    // Read the virtual input through its regions instead of a rastered copy
+    ErrorCode executeRegion(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs);
     int32_t mType;
     void (*mElementProc)(float* C, const float* A, const float* B, size_t width, size_t cStride, size_t aStride, size_t bStride, size_t height) = nullptr;
     bool mSupportScale = false;
     int mOutside = 1;
     int mInside = 1;
     int mAxis = 1;
+    // Index of the virtual input, -1 if both inputs are real
+    int mRegionInput = -1;
+    bool mRegionFull = true;
+    std::shared_ptr<Tensor> mRegionCache;
 };
 class CPUBinaryInt : public Execution {
 public:
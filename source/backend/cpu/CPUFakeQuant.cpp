@@ -0,0 +1,140 @@
+//
+//  CPUFakeQuant.cpp
+//  MNN
+//
+//  Created by MNN on 2021/07/29.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <algorithm>
+#include "backend/cpu/CPUFakeQuant.hpp"
+#include "backend/cpu/compute/CommonOptFunction.h"
+#include "core/Concurrency.h"
+#include "core/Macro.h"
+#include "core/TensorUtils.hpp"
+
+namespace MNN {
+CPUFakeQuant::CPUFakeQuant(const FakeQuant* param, Backend* bn) : Execution(bn) {
+    mLimit    = param->limit();
+    mAxis     = param->axis();
+    mMinScale = param->minScale();
+    mMomentum = param->momentum();
+    mMaximum  = param->maximum();
+}
+
+ErrorCode CPUFakeQuant::onResize(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
+    mThreadMax.resize(static_cast<CPUBackend*>(backend())->threadNumber());
+    return NO_ERROR;
+}
+
+ErrorCode CPUFakeQuant::onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
+    auto input        = inputs[0];
+    auto srcPtr       = input->host<float>();
+    auto dstPtr       = outputs[0]->host<float>();
+    auto scalePtr     = outputs[1]->host<float>();
+    auto numberThread = static_cast<CPUBackend*>(backend())->threadNumber();
+    auto limitScale   = 1.0f / mLimit;
+    int scaleNumber   = 1;
+    if (mAxis < 0) {
+        int size = 0;
+        if (TensorUtils::getDescribe(input)->dimensionFormat == MNN_DATA_FORMAT_NC4HW4) {
+            // The padded channels are not counted in the scale
+            auto channel = input->length(1);
+            auto depthC4 = UP_DIV(channel, 4);
+            auto remain  = channel % 4;
+            auto area    = 1;
+            for (int i = 2; i < input->dimensions(); ++i) {
+                area *= input->length(i);
+            }
+            auto units = input->length(0) * depthC4;
+            size       = units * area * 4;
+            MNN_CONCURRENCY_BEGIN(tId, numberThread) {
+                float maxValue = 0.0f;
+                for (int u = (int)tId; u < units; u += numberThread) {
+                    auto src = srcPtr + u * area * 4;
+                    if (remain > 0 && u % depthC4 == depthC4 - 1) {
+                        for (int i = 0; i < area; ++i) {
+                            for (int k = 0; k < remain; ++k) {
+                                maxValue = std::max(maxValue, fabsf(src[4 * i + k]));
+                            }
+                        }
+                        continue;
+                    }
+                    maxValue = std::max(maxValue, MNNAbsMaxFloat(src, area * 4));
+                }
+                mThreadMax[tId] = maxValue;
+            }
+            MNN_CONCURRENCY_END();
+        } else {
+            size       = input->elementSize();
+            auto chunk = UP_DIV(size, numberThread);
+            MNN_CONCURRENCY_BEGIN(tId, numberThread) {
+                auto start      = (int)tId * chunk;
+                auto end        = std::min(size, start + chunk);
+                mThreadMax[tId] = start < end ? MNNAbsMaxFloat(srcPtr + start, end - start) : 0.0f;
+            }
+            MNN_CONCURRENCY_END();
+        }
+        auto maxValue = *std::max_element(mThreadMax.begin(), mThreadMax.end());
+        auto scale    = std::max(maxValue, mMinScale) * limitScale;
+        auto chunk    = UP_DIV(size, numberThread);
+        MNN_CONCURRENCY_BEGIN(tId, numberThread) {
+            auto start = (int)tId * chunk;
+            auto end   = std::min(size, start + chunk);
+            if (start < end) {
+                MNNFakeQuant(dstPtr + start, srcPtr + start, end - start, scale, mLimit);
+            }
+        }
+        MNN_CONCURRENCY_END();
+        scalePtr[0] = scale;
+    } else {
+        int outside = 1, inside = 1;
+        for (int i = 0; i < mAxis; ++i) {
+            outside *= input->length(i);
+        }
+        for (int i = mAxis + 1; i < input->dimensions(); ++i) {
+            inside *= input->length(i);
+        }
+        scaleNumber = input->length(mAxis);
+        MNN_CONCURRENCY_BEGIN(tId, numberThread) {
+            for (int c = (int)tId; c < scaleNumber; c += numberThread) {
+                float maxValue = 0.0f;
+                for (int o = 0; o < outside; ++o) {
+                    maxValue = std::max(maxValue, MNNAbsMaxFloat(srcPtr + (o * scaleNumber + c) * inside, inside));
+                }
+                auto scale = std::max(maxValue, mMinScale) * limitScale;
+                for (int o = 0; o < outside; ++o) {
+                    auto offset = (o * scaleNumber + c) * inside;
+                    MNNFakeQuant(dstPtr + offset, srcPtr + offset, inside, scale, mLimit);
+                }
+                scalePtr[c] = scale;
+            }
+        }
+        MNN_CONCURRENCY_END();
+    }
+    if (inputs.size() > 1) {
+        auto runningPtr    = inputs[1]->host<float>();
+        auto runningNumber = inputs[1]->elementSize();
+        for (int i = 0; i < scaleNumber; ++i) {
+            auto running = runningPtr[runningNumber == 1 ? 0 : i];
+            if (mMaximum) {
+                scalePtr[i] = std::max(running, scalePtr[i]);
+            } else {
+                scalePtr[i] = running * mMomentum + scalePtr[i] * (1.0f - mMomentum);
+            }
+        }
+    }
+    return NO_ERROR;
+}
+
+class CPUFakeQuantCreator : public CPUBackend::Creator {
+public:
+    virtual Execution* onCreate(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs,
+                                const MNN::Op* op, Backend* backend) const override {
+        return new CPUFakeQuant(op->main_as_FakeQuant(), backend);
+    }
+};
+
+REGISTER_CPU_OP_CREATOR(CPUFakeQuantCreator, OpType_FakeQuant);
+} // namespace MNN
@@ -0,0 +1,32 @@
+//
+//  CPUFakeQuant.hpp
+//  MNN
+//
+//  Created by MNN on 2021/07/29.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef CPUFakeQuant_hpp
+#define CPUFakeQuant_hpp
+
+#include "backend/cpu/CPUBackend.hpp"
+
+namespace MNN {
+class CPUFakeQuant : public Execution {
+public:
+    CPUFakeQuant(const FakeQuant* param, Backend* bn);
+    virtual ErrorCode onResize(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) override;
+    virtual ErrorCode onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) override;
+
+private:
+    float mLimit;
+    int mAxis;
+    float mMinScale;
+    float mMomentum;
+    bool mMaximum;
+    // largest magnitude seen by each thread
+    std::vector<float> mThreadMax;
+};
+} // namespace MNN
+
+#endif /* CPUFakeQuant_hpp */
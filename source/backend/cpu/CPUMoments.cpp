@@ -9,15 +9,12 @@
 #include "backend/cpu/CPUMoments.hpp"
 #include <math.h>
 #include "backend/cpu/CPUBackend.hpp"
+#include "backend/cpu/compute/CommonOptFunction.h"
 #include "core/Concurrency.h"
 #include <MNN/MNNDefine.h>
 #include "core/Macro.h"
 #include "core/TensorUtils.hpp"
 
-#ifdef MNN_USE_NEON
-#include <arm_neon.h>
-#endif
-
 namespace MNN {
 
 CPUMoments::CPUMoments(Backend *backend, const MNN::Op *op) : Execution(backend) {
@@ -31,45 +28,6 @@ CPUMoments::CPUMoments(Backend *backend, const MNN::Op *op) : Execution(backend)
     MNN_ASSERT(DataType_DT_FLOAT == momentsParam->dType());
 }
 
-ErrorCode CPUMoments::onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
-    auto input = inputs[0];
-    mMidBuffer.reset(new Tensor(input->dimensions()));
-    TensorUtils::copyShape(input, mMidBuffer.get(), true);
-    backend()->onAcquireBuffer(mMidBuffer.get(), Backend::DYNAMIC);
-    backend()->onReleaseBuffer(mMidBuffer.get(), Backend::DYNAMIC);
-    return NO_ERROR;
-}
-// calculate the Mean of the Image(Height,Width)
-void CPUMoments::CalculateMean(const float *src, float *dst, int batch, int channelDiv4, int inImageSize,
-                               int inBatchStride, int outBatchStride) {
-    for (int b = 0; b < batch; ++b) {
-        MNN_CONCURRENCY_BEGIN(oc, channelDiv4);
-        const float *channelSrcPtr = src + b * inBatchStride + oc * inImageSize * 4;
-        float *channelDstPtr       = dst + b * outBatchStride + oc * 4;
-#ifdef MNN_USE_NEON
-        float32x4_t sum = vdupq_n_f32(0.0);
-        for (int i = 0; i < inImageSize; ++i) {
-            float32x4_t value = vld1q_f32(channelSrcPtr + i * 4);
-            sum               = vaddq_f32(sum, value);
-        }
-        float32x4_t lengthReciprocal = vdupq_n_f32(1.0f / inImageSize);
-        float32x4_t result           = vmulq_f32(sum, lengthReciprocal);
-        vst1q_f32(channelDstPtr, result);
-#else
-        std::vector<float> sum(4, 0.0f);
-        for (int i = 0; i < inImageSize; ++i) {
-            for (int k = 0; k < 4; ++k) {
-                sum[k] += channelSrcPtr[i * 4 + k];
-            }
-        }
-        for (int j = 0; j < 4; ++j) {
-            channelDstPtr[j] = sum[j] / inImageSize;
-        }
-#endif
-        MNN_CONCURRENCY_END();
-    }
-}
-
 ErrorCode CPUMoments::onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
     MNN_ASSERT(1 == inputs.size());
     MNN_ASSERT(2 == outputs.size());
@@ -84,41 +42,14 @@ ErrorCode CPUMoments::onExecute(const std::vector<Tensor *> &inputs, const std::
 
     const int batch       = input->batch();
     const int channelDiv4 = UP_DIV(mean->channel(), 4);
-
-    const int inBatchStride  = input->stride(0);
-    const int inImagSize     = input->stride(1);
-    const int outBatchStride = mean->stride(0);
-    const float *src         = input->host<float>();
-    float *meanPtr           = mean->host<float>();
-    float *variancePtr       = variance->host<float>();
-    // mean
-    CalculateMean(src, meanPtr, batch, channelDiv4, inImagSize, inBatchStride, outBatchStride);
-
-    float *subMeanSqaure = mMidBuffer->host<float>();
-    // variance
-    for (int b = 0; b < batch; ++b) {
-        MNN_CONCURRENCY_BEGIN(oc, channelDiv4)
-        const float *channelMean       = meanPtr + b * outBatchStride + oc * 4;
-        const float *channelSrcPtr     = src + b * outBatchStride + oc * inImagSize * 4;
-        float *channelSubMeanSqaurePtr = subMeanSqaure + b * outBatchStride + oc * inImagSize * 4;
-
-        for (int i = 0; i < inImagSize; ++i) {
-#ifdef MNN_USE_NEON
-            float32x4_t value = vld1q_f32(channelSrcPtr + i * 4);
-            float32x4_t mean4 = vld1q_f32(channelMean);
-            float32x4_t diff  = vsubq_f32(value, mean4);
-            vst1q_f32(channelSubMeanSqaurePtr + i * 4, diff * diff);
-#else
-            for (int k = 0; k < 4; ++k) {
-                auto subData                       = channelSrcPtr[i * 4 + k] - channelMean[k];
-                channelSubMeanSqaurePtr[i * 4 + k] = powf(subData, 2);
-            }
-#endif
-        }
-        MNN_CONCURRENCY_END();
+    const int inImageSize = input->width() * input->height();
+    const float *src      = input->host<float>();
+    float *meanPtr        = mean->host<float>();
+    float *variancePtr    = variance->host<float>();
+    MNN_CONCURRENCY_BEGIN(index, batch * channelDiv4) {
+        MNNMomentsC4(meanPtr + index * 4, variancePtr + index * 4, src + index * inImageSize * 4, inImageSize);
     }
-    CalculateMean(subMeanSqaure, variancePtr, batch, channelDiv4, inImagSize, inBatchStride, outBatchStride);
-
+    MNN_CONCURRENCY_END();
     return NO_ERROR;
 }
 
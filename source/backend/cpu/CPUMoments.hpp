@@ -18,14 +18,10 @@ public:
     CPUMoments(Backend* backend, const MNN::Op* op);
     virtual ~CPUMoments() = default;
     virtual ErrorCode onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) override;
-    virtual ErrorCode onResize(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) override;
 
 private:
-    void CalculateMean(const float* src, float* dst, int batch, int channelDiv4, int inImageSize, int inBatchStride,
-                       int outBatchStride);
     std::vector<int> mAxis;
     bool mKeepDims;
-    std::shared_ptr<Tensor> mMidBuffer;
 };
 
 } // namespace MNN
@@ -10,6 +10,7 @@ extern void ___CPUSoftmaxCreator__OpType_Softmax__();
 extern void ___CPUDetectionPostProcessCreator__OpType_DetectionPostProcess__();
 extern void ___CPUCastCreator__OpType_Cast__();
 extern void ___CPUSoftmaxGradCreator__OpType_SoftmaxGrad__();
+extern void ___CPUFakeQuantCreator__OpType_FakeQuant__();
 extern void ___CPUProposalCreator__OpType_Proposal__();
 extern void ___CPUInterpCreator__OpType_Interp__();
 extern void ___CPUConstCreator__OpType_Const__();
@@ -84,6 +85,7 @@ ___CPUSoftmaxCreator__OpType_Softmax__();
 ___CPUDetectionPostProcessCreator__OpType_DetectionPostProcess__();
 ___CPUCastCreator__OpType_Cast__();
 ___CPUSoftmaxGradCreator__OpType_SoftmaxGrad__();
+___CPUFakeQuantCreator__OpType_FakeQuant__();
 ___CPUProposalCreator__OpType_Proposal__();
 ___CPUInterpCreator__OpType_Interp__();
 ___CPUConstCreator__OpType_Const__();
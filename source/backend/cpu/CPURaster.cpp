@@ -12,6 +12,7 @@
 #include "math/Vec.hpp"
 #include "core/OpCommonUtils.hpp"
 #include "core/Concurrency.h"
+#include <algorithm>
 using Vec4 = MNN::Math::Vec<float, 4>;
 namespace MNN {
 static bool _canBlitFast(const Tensor::InsideDescribe::Region& region, const Tensor* dest) {
@@ -118,6 +119,119 @@ static bool _transpose(const Tensor::InsideDescribe::Region& region) {
     return srcOne >= 0 && dstOne >= 0 && srcOne != dstOne;
 }
 
+// Drop the unit dims and merge the dims that are contiguous in both src and dst, the kept dims are moved to the end
+static void _compressRegion(Tensor::InsideDescribe::Region& region) {
+    int size[3], srcStride[3], dstStride[3];
+    int count = 0;
+    for (int i = 0; i < 3; ++i) {
+        if (1 == region.size[i]) {
+            continue;
+        }
+        if (count > 0 && srcStride[count - 1] == region.src.stride[i] * region.size[i] &&
+            dstStride[count - 1] == region.dst.stride[i] * region.size[i]) {
+            size[count - 1] *= region.size[i];
+            srcStride[count - 1] = region.src.stride[i];
+            dstStride[count - 1] = region.dst.stride[i];
+            continue;
+        }
+        size[count]      = region.size[i];
+        srcStride[count] = region.src.stride[i];
+        dstStride[count] = region.dst.stride[i];
+        count++;
+    }
+    int pad = 3 - count;
+    for (int i = 0; i < 3; ++i) {
+        if (i < pad) {
+            region.size[i]       = 1;
+            region.src.stride[i] = 0;
+            region.dst.stride[i] = 0;
+        } else {
+            region.size[i]       = size[i - pad];
+            region.src.stride[i] = srcStride[i - pad];
+            region.dst.stride[i] = dstStride[i - pad];
+        }
+    }
+}
+
+// Append next to region along the outside dim if next continues it, offsets are counted in pack elements
+static bool _mergeRegion(Tensor::InsideDescribe::Region& region, const Tensor::InsideDescribe::Region& next, int pack) {
+    if (region.offset != nullptr || next.offset != nullptr) {
+        return false;
+    }
+    for (int i = 1; i < 3; ++i) {
+        if (region.size[i] != next.size[i] || region.src.stride[i] != next.src.stride[i] ||
+            region.dst.stride[i] != next.dst.stride[i]) {
+            return false;
+        }
+    }
+    auto srcDiff = next.src.offset - region.src.offset;
+    auto dstDiff = next.dst.offset - region.dst.offset;
+    if (srcDiff % pack != 0 || dstDiff % pack != 0 || 0 == dstDiff) {
+        return false;
+    }
+    srcDiff /= pack;
+    dstDiff /= pack;
+    if (1 == region.size[0]) {
+        if (1 != next.size[0] && (next.src.stride[0] != srcDiff || next.dst.stride[0] != dstDiff)) {
+            return false;
+        }
+        region.src.stride[0] = srcDiff;
+        region.dst.stride[0] = dstDiff;
+    } else {
+        if (srcDiff != region.size[0] * region.src.stride[0] || dstDiff != region.size[0] * region.dst.stride[0]) {
+            return false;
+        }
+        if (1 != next.size[0] && (next.src.stride[0] != region.src.stride[0] || next.dst.stride[0] != region.dst.stride[0])) {
+            return false;
+        }
+    }
+    region.size[0] += next.size[0];
+    _compressRegion(region);
+    return true;
+}
+
+// Cut a large region along its largest dim, so that the threads share it instead of one thread copying it
+static void _splitRegion(const std::pair<void*, Tensor::InsideDescribe::Region>& iter, int threadNum, int pack,
+                         std::vector<std::pair<void*, Tensor::InsideDescribe::Region>>& units) {
+    static const int gSplitUnit = 4096;
+    auto& region = iter.second;
+    int total = region.size[0] * region.size[1] * region.size[2];
+    int dim   = 0;
+    for (int i = 1; i < 3; ++i) {
+        if (region.size[i] > region.size[dim]) {
+            dim = i;
+        }
+    }
+    int parts = std::min(std::min(threadNum, total / gSplitUnit), region.size[dim]);
+    if (region.offset != nullptr || parts <= 1) {
+        units.emplace_back(iter);
+        return;
+    }
+    int step = UP_DIV(region.size[dim], parts);
+    for (int start = 0; start < region.size[dim]; start += step) {
+        auto piece = iter;
+        piece.second.size[dim] = std::min(step, region.size[dim] - start);
+        piece.second.src.offset += start * region.src.stride[dim] * pack;
+        piece.second.dst.offset += start * region.dst.stride[dim] * pack;
+        units.emplace_back(std::move(piece));
+    }
+}
+
+static void _optimizeRegions(std::vector<std::pair<void*, Tensor::InsideDescribe::Region>>& regions, int threadNum, int pack) {
+    std::vector<std::pair<void*, Tensor::InsideDescribe::Region>> merged;
+    for (auto& iter : regions) {
+        _compressRegion(iter.second);
+        if (!merged.empty() && merged.back().first == iter.first && _mergeRegion(merged.back().second, iter.second, pack)) {
+            continue;
+        }
+        merged.emplace_back(iter);
+    }
+    regions.clear();
+    for (auto& iter : merged) {
+        _splitRegion(iter, threadNum, pack, regions);
+    }
+}
+
 ErrorCode CPURaster::onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
     MNN_ASSERT(inputs.size() == 1);
     MNN_ASSERT(outputs.size() == 1);
@@ -126,6 +240,7 @@ ErrorCode CPURaster::onResize(const std::vector<Tensor *> &inputs, const std::ve
     auto des = TensorUtils::getDescribe(input);
     MNN_ASSERT(des->memoryType == Tensor::InsideDescribe::MEMORY_VIRTUAL);
     auto outputDes = TensorUtils::getDescribe(output);
+    auto threadNum = static_cast<CPUBackend*>(backend())->threadNumber();
     mNeedZero = !TensorUtils::regionIsFull(input);
     mTempInput.clear();
     mFastBlit.clear();
@@ -158,10 +273,11 @@ ErrorCode CPURaster::onResize(const std::vector<Tensor *> &inputs, const std::ve
                 _turnToC4Region(slice, newRegion, output);
                 mFastBlit.emplace_back(std::make_pair(slice.origin->host<void>(), std::move(newRegion)));
             }
+            _optimizeRegions(mFastBlit, threadNum, 4);
             return NO_ERROR;
         }
     }
-    if (1 < static_cast<CPUBackend*>(backend())->threadNumber()) {
+    if (1 < threadNum) {
         mConverter.reset(new CPUTensorConverter(backend()));
     }
     mSingleConvert = false;
@@ -239,12 +355,13 @@ ErrorCode CPURaster::onResize(const std::vector<Tensor *> &inputs, const std::ve
         }
         auto iter = mTempInput.find(slice.origin);
         if (iter != mTempInput.end()) {
-            mTempInputCopy.emplace_back(std::make_pair(iter->second->host<void>(), &slice));
+            mTempInputCopy.emplace_back(std::make_pair(iter->second->host<void>(), slice));
             continue;
         }
-        mTempInputCopy.emplace_back(std::make_pair(slice.origin->host<void>(), &slice));
-        MNN_ASSERT(mTempInputCopy[i].first != nullptr);
+        mTempInputCopy.emplace_back(std::make_pair(slice.origin->host<void>(), slice));
+        MNN_ASSERT(mTempInputCopy.back().first != nullptr);
     }
+    _optimizeRegions(mTempInputCopy, threadNum, 1);
     return NO_ERROR;
 }
 static void _transpose4Bit(int32_t* dstO, const int32_t* srcO, const Tensor::InsideDescribe::Region& region) {
@@ -356,7 +473,7 @@ void CPURaster::executeFaster(const std::vector<Tensor *> &inputs, const std::ve
             //Offset use byte
             auto srcPtr = (uint8_t*)iter.first + slice.src.offset * bytes;
             auto dstPtr = (uint8_t*)mOutputPtr + slice.dst.offset * bytes;
-            if (slice.src.stride[1] == slice.size[2] && slice.dst.stride[1] == slice.size[2] && slice.src.stride[2] == 1) {
+            if (slice.src.stride[1] == slice.size[2] && slice.dst.stride[1] == slice.size[2] && slice.src.stride[2] == 1 && slice.dst.stride[2] == 1) {
                 for (int z=0; z<slice.size[0]; ++z) {
                     auto srcZ = srcPtr + z * slice.src.stride[0] * byteC4;
                     auto dstZ = dstPtr + z * slice.dst.stride[0] * byteC4;
@@ -390,8 +507,22 @@ void CPURaster::executeFaster(const std::vector<Tensor *> &inputs, const std::ve
     MNN_CONCURRENCY_END();
 }
 
+static void _broadcastRow(uint8_t* dstO, const uint8_t* srcO, int size, int bytes) {
+    switch (bytes) {
+        case 4:
+            std::fill_n((uint32_t*)dstO, size, *(const uint32_t*)srcO);
+            break;
+        case 2:
+            std::fill_n((uint16_t*)dstO, size, *(const uint16_t*)srcO);
+            break;
+        default:
+            ::memset(dstO, *srcO, size);
+            break;
+    }
+}
+
 static void _blit(const Tensor::InsideDescribe::Region& slice, int bytes, const uint8_t* srcPtr, uint8_t* dstPtr, void(*proc)(uint8_t* dstO, const uint8_t* srcO, int size, int stride, int ds)) {
-    if (slice.src.stride[1] == slice.size[2] && slice.dst.stride[1] == slice.size[2] && slice.src.stride[2] == 1) {
+    if (slice.src.stride[1] == slice.size[2] && slice.dst.stride[1] == slice.size[2] && slice.src.stride[2] == 1 && slice.dst.stride[2] == 1) {
         for (int z=0; z<slice.size[0]; ++z) {
             auto srcZ = srcPtr + z * slice.src.stride[0] * bytes;
             auto dstZ = dstPtr + z * slice.dst.stride[0] * bytes;
@@ -415,6 +546,17 @@ static void _blit(const Tensor::InsideDescribe::Region& slice, int bytes, const
         }
         return;
     }
+    if (0 == slice.src.stride[2] && 1 == slice.dst.stride[2]) {
+        // Broadcast the inside dim, such as the [C, 1] statistics of batchnorm
+        for (int z=0; z<slice.size[0]; ++z) {
+            auto srcZ = srcPtr + z * slice.src.stride[0] * bytes;
+            auto dstZ = dstPtr + z * slice.dst.stride[0] * bytes;
+            for (int y=0; y<slice.size[1]; ++y) {
+                _broadcastRow(dstZ + y * slice.dst.stride[1] * bytes, srcZ + y * slice.src.stride[1] * bytes, slice.size[2], bytes);
+            }
+        }
+        return;
+    }
     for (int z=0; z<slice.size[0]; ++z) {
         auto srcZ = srcPtr + z * slice.src.stride[0] * bytes;
         auto dstZ = dstPtr + (z) * slice.dst.stride[0] * bytes;
@@ -498,7 +640,7 @@ ErrorCode CPURaster::onExecute(const std::vector<Tensor *> &inputs, const std::v
     MNN_CONCURRENCY_BEGIN(tId, threadNum) {
         for (int u=tId; u<mTempInputCopy.size(); u+=threadNum) {
             auto& iter = mTempInputCopy[u];
-            auto& slice = *(iter.second);
+            auto& slice = iter.second;
             if (slice.offset != nullptr) {
                 auto len = slice.offset->length(1);
                 auto srcOffset = slice.offset->host<int>() + 0;
@@ -25,7 +25,7 @@ public:
     void executeFaster(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) const;
 private:
     std::map<Tensor*, std::shared_ptr<Tensor>> mTempInput;
-    std::vector<std::pair<void*, Tensor::InsideDescribe::Region*>> mTempInputCopy;
+    std::vector<std::pair<void*, Tensor::InsideDescribe::Region>> mTempInputCopy;
     std::vector<std::pair<void*, Tensor::InsideDescribe::Region>> mFastBlit;
     std::shared_ptr<Tensor> mTempOutput;
     std::shared_ptr<Execution> mConverter;
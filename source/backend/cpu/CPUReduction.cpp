@@ -73,26 +73,15 @@ protected:
             for (int oi = tId; oi < outside; oi+=numberThread) {
                 auto srcOutSide = src + oi * axisSize * inside;
                 auto dstOutSide = dst + oi * inside;
-                if (inside % 4 == 0) {
+                if (1 == inside) {
+                    *dstOutSide = MNNSumFloat(srcOutSide, axisSize) / (float)axisSize;
+                } else {
                     ::memcpy(dstOutSide, srcOutSide, inside * sizeof(float));
                     for (int a = 1; a < axisSize; ++a) {
                         auto srcAxis = srcOutSide + a * inside;
                         MNNMatrixAddCommon(dstOutSide, dstOutSide, srcAxis, inside, 0, 0, 0, 1);
                     }
-                    float divide = 1.0f / (float)axisSize;
-                    for (int i=0; i<inside; ++i) {
-                        dstOutSide[i] = dstOutSide[i] * divide;
-                    }
-                } else {
-                    for (int ii = 0; ii < inside; ++ii) {
-                        auto srcInside = srcOutSide + ii;
-                        auto dstInside = dstOutSide + ii;
-                        float summer   = 0.0f;
-                        for (int a = 0; a < axisSize; ++a) {
-                            summer += srcInside[a * inside];
-                        }
-                        *dstInside = summer / (float)axisSize;
-                    }
+                    MNNScaleAndAddBiasScalar(dstOutSide, dstOutSide, 0.0f, 1.0f / (float)axisSize, inside);
                 }
             }
         }
@@ -130,22 +119,14 @@ protected:
             for (int oi = tId; oi < outside; oi+=numberThread) {
                 auto srcOutSide = src + oi * axisSize * inside;
                 auto dstOutSide = dst + oi * inside;
-                if (inside % 4 == 0) {
+                if (1 == inside) {
+                    *dstOutSide = MNNSumFloat(srcOutSide, axisSize);
+                } else {
                     ::memcpy(dstOutSide, srcOutSide, inside * sizeof(float));
                     for (int a = 1; a < axisSize; ++a) {
                         auto srcAxis = srcOutSide + a * inside;
                         MNNMatrixAddCommon(dstOutSide, dstOutSide, srcAxis, inside, 0, 0, 0, 1);
                     }
-                } else {
-                    for (int ii = 0; ii < inside; ++ii) {
-                        auto srcInside = srcOutSide + ii;
-                        auto dstInside = dstOutSide + ii;
-                        float summer   = 0.0f;
-                        for (int a = 0; a < axisSize; ++a) {
-                            summer += srcInside[a * inside];
-                        }
-                        *dstInside = summer;
-                    }
                 }
             }
         }
@@ -7,8 +7,10 @@
 //
 
 #include "CPUReluGrad.hpp"
+#include <limits>
 #include "core/Concurrency.h"
 #include "CPUBackend.hpp"
+#include "compute/CommonOptFunction.h"
 namespace MNN {
 ErrorCode CPUReluGrad::onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
     MNN_ASSERT(0 == mSlope);
@@ -20,18 +22,19 @@ ErrorCode CPUReluGrad::onExecute(const std::vector<Tensor*>& inputs, const std::
     auto reluOriginPtr = reluOrigin->host<float>();
     auto reluDiffPtr   = reluDiff->host<float>();
     auto outputDiffPtr = outputDiff->host<float>();
-    auto numberThread = ((CPUBackend*)backend())->threadNumber();
-    MNN_CONCURRENCY_BEGIN(tId, numberThread) {
-        for (int n = tId; n < size; n+=numberThread) {
-            if (reluOriginPtr[n] > 0.0f) {
-                outputDiffPtr[n] = reluDiffPtr[n];
-            } else {
-                outputDiffPtr[n] = 0.0f;
-            }
+    auto schedule      = ((CPUBackend*)backend())->multiThreadDivide(size);
+    MNN_CONCURRENCY_BEGIN(tId, schedule.second) {
+        int start    = schedule.first * (int)tId;
+        int realSize = schedule.first;
+        if (tId == schedule.second - 1) {
+            realSize = size - start;
+        }
+        if (realSize > 0) {
+            MNNReluGradMask(outputDiffPtr + start, reluOriginPtr + start, reluDiffPtr + start, realSize, 0.0f,
+                            std::numeric_limits<float>::max());
         }
     }
     MNN_CONCURRENCY_END();
-
     return NO_ERROR;
 }
 class CPURelu6Grad : public Execution {
@@ -48,14 +51,15 @@ public:
         auto reluOriginPtr = reluOrigin->host<float>();
         auto reluDiffPtr   = reluDiff->host<float>();
         auto outputDiffPtr = outputDiff->host<float>();
-        auto numberThread = ((CPUBackend*)backend())->threadNumber();
-        MNN_CONCURRENCY_BEGIN(tId, numberThread) {
-            for (int n = tId; n < size; n+=numberThread) {
-                if (reluOriginPtr[n] > 0.0f && reluOriginPtr[n] <= 6.0f) {
-                    outputDiffPtr[n] = reluDiffPtr[n];
-                } else {
-                    outputDiffPtr[n] = 0.0f;
-                }
+        auto schedule      = ((CPUBackend*)backend())->multiThreadDivide(size);
+        MNN_CONCURRENCY_BEGIN(tId, schedule.second) {
+            int start    = schedule.first * (int)tId;
+            int realSize = schedule.first;
+            if (tId == schedule.second - 1) {
+                realSize = size - start;
+            }
+            if (realSize > 0) {
+                MNNReluGradMask(outputDiffPtr + start, reluOriginPtr + start, reluDiffPtr + start, realSize, 0.0f, 6.0f);
             }
         }
         MNN_CONCURRENCY_END();
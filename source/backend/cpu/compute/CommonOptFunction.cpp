@@ -994,3 +994,102 @@ void MNNComputeMatMulForE_1(const float* A, const float* B, float* C, const floa
     }
 }
 #endif
+
+#ifndef MNN_USE_SSE
+void MNNReluGradMask(float* dst, const float* origin, const float* diff, size_t size, float minValue, float maxValue) {
+    size_t start = 0;
+#ifdef MNN_USE_NEON
+    auto minV = vdupq_n_f32(minValue);
+    auto maxV = vdupq_n_f32(maxValue);
+    for (; start + 4 <= size; start += 4) {
+        auto o    = vld1q_f32(origin + start);
+        auto mask = vandq_u32(vcgtq_f32(o, minV), vcleq_f32(o, maxV));
+        auto d    = vreinterpretq_u32_f32(vld1q_f32(diff + start));
+        vst1q_f32(dst + start, vreinterpretq_f32_u32(vandq_u32(mask, d)));
+    }
+#endif
+    for (size_t i = start; i < size; ++i) {
+        dst[i] = (origin[i] > minValue && origin[i] <= maxValue) ? diff[i] : 0.0f;
+    }
+}
+
+void MNNSoftmaxGrad(float* dst, const float* softmax, const float* grad, size_t size) {
+    auto sizeC4 = size / 4;
+    Vec4 sumV(0.0f);
+    for (int i = 0; i < sizeC4; ++i) {
+        sumV = sumV + Vec4::load(softmax + 4 * i) * Vec4::load(grad + 4 * i);
+    }
+    float sum = sumV[0] + sumV[1] + sumV[2] + sumV[3];
+    for (int i = sizeC4 * 4; i < size; ++i) {
+        sum += softmax[i] * grad[i];
+    }
+    sumV = Vec4(sum);
+    for (int i = 0; i < sizeC4; ++i) {
+        Vec4::save(dst + 4 * i, Vec4::load(softmax + 4 * i) * (Vec4::load(grad + 4 * i) - sumV));
+    }
+    for (int i = sizeC4 * 4; i < size; ++i) {
+        dst[i] = softmax[i] * (grad[i] - sum);
+    }
+}
+
+void MNNMomentsC4(float* mean, float* variance, const float* src, size_t planeNumber) {
+    Vec4 sumV(0.0f);
+    for (int i = 0; i < planeNumber; ++i) {
+        sumV = sumV + Vec4::load(src + 4 * i);
+    }
+    auto meanV = sumV * (1.0f / planeNumber);
+    Vec4 squareV(0.0f);
+    for (int i = 0; i < planeNumber; ++i) {
+        auto diff = Vec4::load(src + 4 * i) - meanV;
+        squareV   = squareV + diff * diff;
+    }
+    Vec4::save(mean, meanV);
+    Vec4::save(variance, squareV * (1.0f / planeNumber));
+}
+
+float MNNSumFloat(const float* src, size_t size) {
+    auto sizeC4 = size / 4;
+    Vec4 sumV(0.0f);
+    for (int i = 0; i < sizeC4; ++i) {
+        sumV = sumV + Vec4::load(src + 4 * i);
+    }
+    float sum = sumV[0] + sumV[1] + sumV[2] + sumV[3];
+    for (int i = sizeC4 * 4; i < size; ++i) {
+        sum += src[i];
+    }
+    return sum;
+}
+
+float MNNAbsMaxFloat(const float* src, size_t size) {
+    auto sizeC4 = size / 4;
+    Vec4 maxV(0.0f);
+    for (int i = 0; i < sizeC4; ++i) {
+        auto v = Vec4::load(src + 4 * i);
+        maxV   = Vec4::max(maxV, Vec4::max(v, -v));
+    }
+    float maxValue = std::max(std::max(maxV[0], maxV[1]), std::max(maxV[2], maxV[3]));
+    for (int i = sizeC4 * 4; i < size; ++i) {
+        maxValue = std::max(maxValue, fabsf(src[i]));
+    }
+    return maxValue;
+}
+
+void MNNFakeQuant(float* dst, const float* src, size_t size, float scale, float limit) {
+    auto inverse = 1.0f / scale;
+    size_t start = 0;
+#if defined(MNN_USE_NEON) && defined(__aarch64__)
+    auto inverseV = vdupq_n_f32(inverse);
+    auto scaleV   = vdupq_n_f32(scale);
+    auto maxV     = vdupq_n_f32(limit);
+    auto minV     = vdupq_n_f32(-limit);
+    for (; start + 4 <= size; start += 4) {
+        auto v = vmulq_f32(vld1q_f32(src + start), inverseV);
+        v      = vrndaq_f32(vminq_f32(vmaxq_f32(v, minV), maxV));
+        vst1q_f32(dst + start, vmulq_f32(v, scaleV));
+    }
+#endif
+    for (size_t i = start; i < size; ++i) {
+        dst[i] = roundf(std::min(std::max(src[i] * inverse, -limit), limit)) * scale;
+    }
+}
+#endif
@@ -91,6 +91,18 @@ void MNNAxByClampBroadcastC4(float* C, const float* A, const float* B, size_t wi
 // dim: 4-element, sizeDW, sizeDH, strideSW, strideDH
 void MNNTranspose32Bit(int32_t* dstO, const int32_t* srcO, int32_t* dim); // not C4
 
+// Training kernels
+// dst = minValue < origin <= maxValue ? diff : 0
+void MNNReluGradMask(float* dst, const float* origin, const float* diff, size_t size, float minValue, float maxValue);
+// dst = softmax * (grad - sum(softmax * grad))
+void MNNSoftmaxGrad(float* dst, const float* softmax, const float* grad, size_t size);
+// mean and variance for each of the 4 channels in a C4 plane
+void MNNMomentsC4(float* mean, float* variance, const float* src, size_t planeNumber);
+float MNNSumFloat(const float* src, size_t size);
+float MNNAbsMaxFloat(const float* src, size_t size);
+// dst = clamp(round(src / scale), -limit, limit) * scale, rounding half away from zero
+void MNNFakeQuant(float* dst, const float* src, size_t size, float scale, float limit);
+
 void MNNVectorTop1Float(float* input, float* maxValue, int32_t* maxIndex, size_t inputCountUnit);
 void MNNVectorTop1Int32(int32_t* input, int32_t* maxValue, int32_t* maxIndex, size_t inputCountUnit);
 struct MatMulParam {
@@ -100,6 +100,19 @@ void MNNConvRunForLineDepthwise(float* dst, const float* src, const float* weigh
         }
     }
 }
+void MNNMatrixProd(float* C, const float* A, const float* B, size_t widthC4, size_t cStride, size_t aStride,
+                   size_t bStride, size_t height) {
+    for (int y = 0; y < height; ++y) {
+        auto a = A + aStride * y;
+        auto b = B + bStride * y;
+        auto c = C + cStride * y;
+        for (int x = 0; x < widthC4; ++x) {
+            auto aV = Vec4::load(a + 4 * x);
+            auto bV = Vec4::load(b + 4 * x);
+            Vec4::save(c + 4 * x, aV * bV);
+        }
+    }
+}
 #endif
 
 void MNNConvRunForUnitDepthWise(float* dst, const float* src, const float* weight, size_t fw, size_t fh,
@@ -204,19 +217,6 @@ void MNNDeconvRunForUnitDepthWise(const float* dst, float* src, const float* wei
         }
     }
 }
-void MNNMatrixProd(float* C, const float* A, const float* B, size_t widthC4, size_t cStride, size_t aStride,
-                   size_t bStride, size_t height) {
-    for (int y = 0; y < height; ++y) {
-        auto a = A + aStride * y;
-        auto b = B + bStride * y;
-        auto c = C + cStride * y;
-        for (int x = 0; x < widthC4; ++x) {
-            auto aV = Vec4::load(a + 4 * x);
-            auto bV = Vec4::load(b + 4 * x);
-            Vec4::save(c + 4 * x, aV * bV);
-        }
-    }
-}
 void MNNMatrixMax(float* C, const float* A, const float* B, size_t widthC4, size_t cStride, size_t aStride,
                   size_t bStride, size_t height) {
     for (int y = 0; y < height; ++y) {
@@ -51,6 +51,10 @@ Convolution1x1Strassen::~Convolution1x1Strassen() {
     // Do nothing
 }
 
+void Convolution1x1Strassen::updateWeight(const float *originWeight, int srcCount, int outputCount) {
+    MNNPackForMatMul_B(mResource->mWeight->host<float>(), originWeight, outputCount, srcCount, true);
+}
+
 bool Convolution1x1Strassen::onClone(Backend* bn, const Op* op, Execution** dst) {
     if (!mValid) {
         return false;
@@ -58,7 +62,9 @@ bool Convolution1x1Strassen::onClone(Backend* bn, const Op* op, Execution** dst)
     if (nullptr == dst) {
         return true;
     }
-    *dst = new Convolution1x1Strassen(mResource, op->main_as_Convolution2D()->common(), bn);
+    auto dstExe = new Convolution1x1Strassen(mResource, op->main_as_Convolution2D()->common(), bn);
+    dstExe->mMaxDepth = mMaxDepth;
+    *dst = dstExe;
     return true;
 }
 
@@ -182,7 +188,7 @@ ErrorCode Convolution1x1Strassen::onResize(const std::vector<Tensor *> &inputs,
     auto memoryPool = ((CPUBackend *)backend())->getBufferAllocator();
     memoryPool->barrierBegin();
     std::shared_ptr<void> __a(nullptr, [memoryPool](void *) { memoryPool->barrierEnd(); });
-    int maxDepth = 5;
+    int maxDepth = mMaxDepth;
     if (matrixSizeE > CONVOLUTION_TILED_NUMBER * 8 * numberThread && matrixSizeE > ocC4) {
         // Divide in plane, in this case the divide equal numberThread
         int divideStep = UP_DIV(matrixSizeE, numberThread);
@@ -24,6 +24,12 @@ public:
 
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual bool onClone(Backend* bn, const Op* op, Execution** dst) override;
+    // Pack a new weight in place, for convolutions reading their weight from an input
+    void updateWeight(const float *originWeight, int srcCount, int outputCount);
+    // Recursion depth of the Strassen GEMM, 0 for a plain packed GEMM
+    void setMaxDepth(int depth) {
+        mMaxDepth = depth;
+    }
 private:
     std::shared_ptr<CPUConvolution::Resource> mResource;
 
@@ -42,6 +48,7 @@ private:
     std::shared_ptr<Tensor> mTempInputBatch;
     std::shared_ptr<Tensor> mTempOutputBatch;
     bool mNeedPretreat = false;
+    int mMaxDepth      = 5;
     std::function<void(const float *srcBatch, float *dstBatch)> mPretreatFunction;
 };
 } // namespace MNN
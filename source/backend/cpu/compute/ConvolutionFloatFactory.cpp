@@ -7,6 +7,10 @@
 //
 
 #include "backend/cpu/compute/ConvolutionFloatFactory.h"
+#include <functional>
+#include <limits>
+#include <string>
+#include <MNN/AutoTime.hpp>
 #include "backend/cpu/CPUConvolutionDepthwise.hpp"
 #include "backend/cpu/compute/ConvOpt.h"
 #include "backend/cpu/compute/Convolution1x1Strassen.hpp"
@@ -15,16 +19,147 @@
 #include "backend/cpu/compute/ConvolutionTiledExecutor.hpp"
 #include "backend/cpu/compute/ConvolutionWinograd.hpp"
 #include "core/Macro.h"
+#include "core/TensorUtils.hpp"
 #include "backend/cpu/OneDNNConvolution.hpp"
 
 namespace MNN {
 
+enum ConvAlgorithm { CONV_TILED = 0, CONV_WINOGRAD = 1, CONV_STRASSEN = 2 };
+
+// parameter: the Winograd unit or the Strassen depth
+static Execution* _createAlgorithm(std::pair<int, int> algorithm, const Tensor* input, const Tensor* output,
+                                   Backend* backend, const Convolution2DCommon* common, const float* originWeight,
+                                   size_t originWeightSize, const float* bias, size_t biasSize) {
+    switch (algorithm.first) {
+        case CONV_WINOGRAD:
+            return new ConvolutionWinograd(common, input, output, backend, originWeight, originWeightSize, bias,
+                                           biasSize, algorithm.second);
+        case CONV_STRASSEN: {
+            auto strassen = new Convolution1x1Strassen(common, backend, originWeight, originWeightSize, bias, biasSize);
+            strassen->setMaxDepth(algorithm.second);
+            return strassen;
+        }
+        default:
+            break;
+    }
+    return new ConvolutionTiledExecutor(common, backend, originWeight, originWeightSize, bias, biasSize);
+}
+
+static std::vector<std::pair<int, int>> _candidates(const Convolution2DCommon* common, Backend* backend) {
+    std::vector<std::pair<int, int>> candidates = {std::make_pair((int)CONV_TILED, 0)};
+    if (common->kernelY() == 1 && common->kernelX() == 1) {
+        // 0 is a plain packed GEMM
+        for (int depth : {5, 2, 0}) {
+            candidates.emplace_back(std::make_pair((int)CONV_STRASSEN, depth));
+        }
+        return candidates;
+    }
+    if (!ConvolutionWinograd::canUseWinograd(common) ||
+        ((CPUBackend*)backend)->memoryMode() == BackendConfig::Memory_Low) {
+        return candidates;
+    }
+    for (int unit = 2; unit <= 8; ++unit) {
+        int srcUnit = unit + common->kernelY() - 1;
+        if ((srcUnit != 4 && srcUnit != 6 && srcUnit != 8) ||
+            nullptr == WinogradFunction::chooseDestTransform(srcUnit, unit)) {
+            continue;
+        }
+        candidates.emplace_back(std::make_pair((int)CONV_WINOGRAD, unit));
+    }
+    return candidates;
+}
+
+// Best of a few runs on zeroed tensors, with a backend of its own so that the session's memory plan is untouched
+static uint64_t _timeAlgorithm(std::pair<int, int> algorithm, const Tensor* input, const Tensor* output,
+                               const CPURuntime* runtime, const Convolution2DCommon* common,
+                               const float* originWeight, size_t originWeightSize, const float* bias,
+                               size_t biasSize) {
+    std::shared_ptr<Backend> bn(runtime->onCreate());
+    std::shared_ptr<Tensor> tempInput(new Tensor(input->dimensions()));
+    std::shared_ptr<Tensor> tempOutput(new Tensor(output->dimensions()));
+    TensorUtils::copyShape(input, tempInput.get(), true);
+    TensorUtils::copyShape(output, tempOutput.get(), true);
+    TensorUtils::getDescribe(tempInput.get())->dimensionFormat  = MNN_DATA_FORMAT_NC4HW4;
+    TensorUtils::getDescribe(tempOutput.get())->dimensionFormat = MNN_DATA_FORMAT_NC4HW4;
+    TensorUtils::setLinearLayout(tempInput.get());
+    TensorUtils::setLinearLayout(tempOutput.get());
+    if (!bn->onAcquireBuffer(tempInput.get(), Backend::STATIC) ||
+        !bn->onAcquireBuffer(tempOutput.get(), Backend::STATIC)) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    std::shared_ptr<void> __release(nullptr, [&](void*) {
+        bn->onReleaseBuffer(tempInput.get(), Backend::STATIC);
+        bn->onReleaseBuffer(tempOutput.get(), Backend::STATIC);
+    });
+    ::memset(tempInput->host<float>(), 0, tempInput->size());
+    std::unique_ptr<Execution> exe(_createAlgorithm(algorithm, input, output, bn.get(), common, originWeight,
+                                                    originWeightSize, bias, biasSize));
+    std::vector<Tensor*> inputs = {tempInput.get()}, outputs = {tempOutput.get()};
+    if (!exe->valid() || NO_ERROR != exe->onResize(inputs, outputs)) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    auto cost = std::numeric_limits<uint64_t>::max();
+    bn->onExecuteBegin();
+    for (int i = 0; i < 4; ++i) {
+        Timer timer;
+        exe->onExecute(inputs, outputs);
+        // the first run warms the caches
+        if (i > 0) {
+            cost = std::min(cost, timer.durationInUs());
+        }
+    }
+    bn->onExecuteEnd();
+    return cost;
+}
+
+// The memory mode changes the candidates and the precision the kernels, so both are part of the key
+static std::string _tuningKey(const Tensor* input, const Tensor* output, const Convolution2DCommon* common,
+                              const CPUBackend* backend) {
+    auto pads = ConvolutionCommon::convolutionPad(input, output, common);
+    int values[] = {input->batch(), input->channel(), input->height(), input->width(), output->channel(),
+                    output->height(), output->width(), common->kernelY(), common->kernelX(), common->strideY(),
+                    common->strideX(), common->dilateY(), common->dilateX(), pads.second, pads.first,
+                    backend->threadNumber(), (int)backend->memoryMode(), (int)backend->precisionMode()};
+    std::string key;
+    for (auto v : values) {
+        key += std::to_string(v) + ",";
+    }
+    return key;
+}
+
 static Execution* _createUnit(const Tensor* input, const Tensor* output, Backend* backend,
                               const Convolution2DCommon* common, const float* originWeight, size_t originWeightSize,
                               const float* bias, size_t biasSize) {
 #ifdef MNN_USE_ONEDNN
     return OneDNN::createConvolution(common, backend, originWeight, originWeightSize, bias, biasSize);
 #endif
+    auto cpuBackend = (CPUBackend*)backend;
+    auto runtime    = cpuBackend->runtime();
+    {
+        // A timed choice, from this session or the cache file, wins over the heuristics below
+        auto key = _tuningKey(input, output, common, cpuBackend);
+        std::pair<int, int> algorithm;
+        if (runtime->findConvTuning(key, algorithm)) {
+            return _createAlgorithm(algorithm, input, output, backend, common, originWeight, originWeightSize, bias,
+                                    biasSize);
+        }
+        auto candidates = _candidates(common, backend);
+        if (runtime->convTuning() && candidates.size() > 1) {
+            uint64_t bestCost = std::numeric_limits<uint64_t>::max();
+            algorithm         = candidates[0];
+            for (auto& candidate : candidates) {
+                auto cost = _timeAlgorithm(candidate, input, output, runtime, common, originWeight, originWeightSize,
+                                           bias, biasSize);
+                if (cost < bestCost) {
+                    bestCost  = cost;
+                    algorithm = candidate;
+                }
+            }
+            runtime->insertConvTuning(key, algorithm);
+            return _createAlgorithm(algorithm, input, output, backend, common, originWeight, originWeightSize, bias,
+                                    biasSize);
+        }
+    }
     auto layer   = common;
     bool fastWay = layer->kernelY() == 1 && layer->kernelX() == 1;
     if (fastWay) {
@@ -33,7 +168,6 @@ static Execution* _createUnit(const Tensor* input, const Tensor* output, Backend
     if (!ConvolutionWinograd::canUseWinograd(common)) {
         return new ConvolutionTiledExecutor(common, backend, originWeight, originWeightSize, bias, biasSize);
     }
-    auto cpuBackend = (CPUBackend*)backend;
     if (cpuBackend->memoryMode() == BackendConfig::Memory_Low) {
         return new ConvolutionTiledExecutor(common, backend, originWeight, originWeightSize, bias, biasSize);
     }
@@ -45,6 +179,103 @@ static Execution* _createUnit(const Tensor* input, const Tensor* output, Backend
                                    unit);
 }
 
+// Weight read from the second input, as the geometry emits for the data gradient of a stride 1 convolution.
+// The unit is chosen as for a constant weight and repacks the current weight before each execution
+class ConvolutionWeightInput : public Execution {
+public:
+    // update repacks a weight into the unit, or into a clone of it
+    typedef std::function<ErrorCode(Execution*, const float*)> Update;
+    ConvolutionWeightInput(Backend* backend, std::shared_ptr<Execution> unit, Update update)
+        : Execution(backend), mUnit(unit), mUpdate(update) {
+        // Do nothing
+    }
+    virtual ~ConvolutionWeightInput() = default;
+    virtual ErrorCode onResize(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) override {
+        mInputs = {inputs[0]};
+        return mUnit->onResize(mInputs, outputs);
+    }
+    virtual ErrorCode onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) override {
+        auto code = mUpdate(mUnit.get(), inputs[1]->host<float>());
+        if (NO_ERROR != code) {
+            return code;
+        }
+        return mUnit->onExecute(mInputs, outputs);
+    }
+    // clones share the packed weight of the unit: each execution repacks it first, and the executions of a
+    // backend don't overlap
+    virtual bool onClone(Backend* bn, const Op* op, Execution** dst) override {
+        if (!mUnit->onClone(bn, op, nullptr)) {
+            return false;
+        }
+        if (nullptr == dst) {
+            return true;
+        }
+        Execution* unit = nullptr;
+        if (!mUnit->onClone(bn, op, &unit) || nullptr == unit) {
+            return false;
+        }
+        *dst = new ConvolutionWeightInput(bn, std::shared_ptr<Execution>(unit), mUpdate);
+        return true;
+    }
+
+private:
+    std::shared_ptr<Execution> mUnit;
+    Update mUpdate;
+    std::vector<Tensor*> mInputs;
+};
+
+static Execution* _createWeightInput(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs,
+                                     const Convolution2DCommon* common, Backend* backend) {
+    auto input  = inputs[0];
+    auto output = outputs[0];
+    int ic = input->channel(), oc = output->channel();
+    int kernelSize = common->kernelX() * common->kernelY();
+    if (1 != common->group() || inputs[1]->elementSize() != oc * ic * kernelSize || inputs.size() > 2) {
+        MNN_ERROR("Convolution with weight input only supports group 1 without bias input\n");
+        return nullptr;
+    }
+    // The packed weights are filled on execution
+    std::vector<float> weight(oc * ic * kernelSize, 0.0f);
+    std::vector<float> bias(oc, 0.0f);
+    std::shared_ptr<Execution> unit;
+    ConvolutionWeightInput::Update update;
+    if (1 == kernelSize) {
+        unit.reset(new Convolution1x1Strassen(common, backend, weight.data(), weight.size(), bias.data(), oc));
+        update = [ic, oc](Execution* unit, const float* w) {
+            static_cast<Convolution1x1Strassen*>(unit)->updateWeight(w, ic, oc);
+            return NO_ERROR;
+        };
+    } else {
+        int winogradUnit = 0;
+        // tiles up to 6x6 only, F(4x4) for 3x3 and F(2x2) for 5x5: gradients are more sensitive to the
+        // transform error than inference, which grows with the tile rather than the unit
+        int maxUnit = 7 - common->kernelY();
+        if (ConvolutionWinograd::canUseWinograd(common) && maxUnit >= 2) {
+            winogradUnit = ConvolutionWinograd::bestWinogradUnit(common, input, output,
+                                                                 ((CPUBackend*)backend)->threadNumber(), maxUnit);
+        }
+        if (winogradUnit > 1) {
+            unit.reset(new ConvolutionWinograd(common, input, output, backend, weight.data(), weight.size(),
+                                               bias.data(), oc, winogradUnit));
+            update = [](Execution* unit, const float* w) {
+                static_cast<ConvolutionWinograd*>(unit)->updateWeight(w);
+                return NO_ERROR;
+            };
+        } else {
+            auto tiled = new ConvolutionTiledExecutor(common, backend, weight.data(), weight.size(), bias.data(), oc);
+            tiled->setWeightInput(ic, kernelSize);
+            unit.reset(tiled);
+            update = [](Execution* unit, const float* w) {
+                return static_cast<ConvolutionTiledExecutor*>(unit)->updateWeight(w);
+            };
+        }
+    }
+    if (!unit->valid()) {
+        return nullptr;
+    }
+    return new ConvolutionWeightInput(backend, unit, update);
+}
+
 Execution* ConvolutionFloatFactory::create(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs,
                                            const MNN::Op* op, Backend* backend) {
     auto conv2d = op->main_as_Convolution2D();
@@ -60,6 +291,9 @@ Execution* ConvolutionFloatFactory::create(const std::vector<Tensor*>& inputs, c
         tempOutput.reset(Tensor::createDevice<float>({1, conv2d->common()->outputCount(), oh, ow}, Tensor::CAFFE_C4));
         return create({tempInput.get()}, {tempOutput.get()}, op, backend);
     }
+    if (inputs.size() > 1) {
+        return _createWeightInput(inputs, outputs, conv2d->common(), backend);
+    }
     const float* originWeight = nullptr;
     size_t originWeightSize   = 0;
     std::shared_ptr<ConvolutionCommon::Int8Common> quanCommon;
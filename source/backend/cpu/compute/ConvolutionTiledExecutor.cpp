@@ -72,6 +72,31 @@ ConvolutionTiledExecutor::ConvolutionTiledExecutor(std::shared_ptr<CPUConvolutio
 ConvolutionTiledExecutor::~ConvolutionTiledExecutor() {
     // Do nothing
 }
+ErrorCode ConvolutionTiledExecutor::onResize(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
+    mInputs = {inputs[0], mResource->mWeight.get(), mResource->mBias.get()};
+    if (0 == mWeightInputSrcCount) {
+        return mProxy->onResize(mInputs, outputs);
+    }
+    // Held across the resize of the proxy, so its buffers don't share memory with the cache
+    mWeightCache.reset(Tensor::createDevice<float>(
+        {outputs[0]->channel(), mWeightInputSrcCount * mWeightInputKernelSize}));
+    if (!backend()->onAcquireBuffer(mWeightCache.get(), Backend::DYNAMIC)) {
+        mWeightCache = nullptr;
+        return OUT_OF_MEMORY;
+    }
+    auto code = mProxy->onResize(mInputs, outputs);
+    backend()->onReleaseBuffer(mWeightCache.get(), Backend::DYNAMIC);
+    return code;
+}
+ErrorCode ConvolutionTiledExecutor::updateWeight(const float* originWeight) {
+    if (nullptr == mWeightCache) {
+        MNN_ERROR("The weight of convolution is updated before resize\n");
+        return INVALID_VALUE;
+    }
+    _initWeight(mResource->mWeight->host<float>(), originWeight, mWeightCache->host<float>(), mWeightInputSrcCount,
+                mWeightCache->length(0), mWeightInputKernelSize);
+    return NO_ERROR;
+}
 bool ConvolutionTiledExecutor::onClone(Backend* bn, const Op* op, Execution** dst) {
     if (!mValid) {
         return false;
@@ -79,7 +104,9 @@ bool ConvolutionTiledExecutor::onClone(Backend* bn, const Op* op, Execution** ds
     if (nullptr == dst) {
         return true;
     }
-    *dst = new ConvolutionTiledExecutor(mResource, op->main_as_Convolution2D()->common(), bn);
+    auto dstExe = new ConvolutionTiledExecutor(mResource, op->main_as_Convolution2D()->common(), bn);
+    dstExe->setWeightInput(mWeightInputSrcCount, mWeightInputKernelSize);
+    *dst = dstExe;
     return true;
 }
 
@@ -37,16 +37,23 @@ public:
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override {
         return mProxy->onExecute(inputs, outputs);
     }
-    virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override {
-        mInputs = {inputs[0], mResource->mWeight.get(), mResource->mBias.get()};
-        return mProxy->onResize(mInputs, outputs);
-    }
+    virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual bool onClone(Backend* bn, const Op* op, Execution** dst) override;
+    // For convolutions reading their weight from an input: onResize then keeps the cache to pack it with,
+    // and updateWeight packs a new weight in place on execution
+    void setWeightInput(int srcCount, int kernelSize) {
+        mWeightInputSrcCount   = srcCount;
+        mWeightInputKernelSize = kernelSize;
+    }
+    ErrorCode updateWeight(const float *originWeight);
 
 protected:
     std::shared_ptr<ConvolutionTiledExecutorBasic> mProxy;
     std::vector<Tensor *> mInputs;
     std::shared_ptr<CPUConvolution::Resource> mResource;
+    int mWeightInputSrcCount   = 0;
+    int mWeightInputKernelSize = 0;
+    std::shared_ptr<Tensor> mWeightCache;
 };
 } // namespace MNN
 
@@ -45,7 +45,8 @@ ConvolutionWinograd::ConvolutionWinograd(const Convolution2DCommon *convOp, cons
     int threadNumber = ((CPUBackend *)backend())->threadNumber();
 
     auto kernelSize = mCommon->kernelY();
-    WinogradGenerater generator(unit, kernelSize, 1, true);
+    mGenerater.reset(new WinogradGenerater(unit, kernelSize, 1, true));
+    auto& generator = *mGenerater;
 
     int alpha        = unit + kernelSize - 1;
     int alpha2       = alpha * alpha;
@@ -89,7 +90,8 @@ ConvolutionWinograd::ConvolutionWinograd(const Convolution2DCommon *convOp, cons
     
 
     // Transform Kernel
-    auto G = generator.G();
+    mSrcCount    = srcCount;
+    mOutputCount = outputCount;
     std::shared_ptr<Tensor> sourceWeight(Tensor::create<float>(
         std::vector<int>{outputCount, srcCount, kernelSize, kernelSize}, (void *)originWeight, Tensor::CAFFE));
     mResource->mWeight = generator.allocTransformWeight(sourceWeight.get(), 1, hPack, false);
@@ -99,6 +101,12 @@ ConvolutionWinograd::ConvolutionWinograd(const Convolution2DCommon *convOp, cons
     }
     generator.transformWeight(mResource->mWeight.get(), sourceWeight.get());
 }
+void ConvolutionWinograd::updateWeight(const float *originWeight) {
+    auto kernelSize = mCommon->kernelY();
+    std::shared_ptr<Tensor> sourceWeight(Tensor::create<float>(
+        std::vector<int>{mOutputCount, mSrcCount, kernelSize, kernelSize}, (void *)originWeight, Tensor::CAFFE));
+    mGenerater->transformWeight(mResource->mWeight.get(), sourceWeight.get());
+}
 ConvolutionWinograd::~ConvolutionWinograd() {
     // Do nothing
 }
@@ -118,6 +126,9 @@ bool ConvolutionWinograd::onClone(Backend* bn, const Op* op, Execution** dst) {
     TensorUtils::copyShape(&mGemmMidBuffer, &(dstExe->mGemmMidBuffer), true);
     dstExe->mSourceTransform = mSourceTransform;
     dstExe->mDestTransform = mDestTransform;
+    dstExe->mGenerater = mGenerater;
+    dstExe->mSrcCount = mSrcCount;
+    dstExe->mOutputCount = mOutputCount;
     *dst = dstExe;
     return true;
 }
@@ -349,7 +360,7 @@ ErrorCode ConvolutionWinograd::onExecute(const std::vector<Tensor *> &inputs, co
 }
 
 int ConvolutionWinograd::bestWinogradUnit(const Convolution2DCommon *common, const Tensor *inputTensor,
-                                          const Tensor *outputTensor, int threadNumber) {
+                                          const Tensor *outputTensor, int threadNumber, int maxUnitLimit) {
     int ow      = outputTensor->width();
     int oh      = outputTensor->height();
     int oc      = outputTensor->channel();
@@ -358,6 +369,9 @@ int ConvolutionWinograd::bestWinogradUnit(const Convolution2DCommon *common, con
     int unit2   = UP_DIV(ow * oh, ePack * threadNumber);
     int maxUnit = (int)::sqrtf((float)unit2);
     maxUnit     = std::min(maxUnit, CONVOLUTION_WINOGRAD_MAX_UNIT);
+    if (maxUnitLimit > 0) {
+        maxUnit = std::min(maxUnit, maxUnitLimit);
+    }
     maxUnit     = std::max(maxUnit, CONVOLUTION_WINOGRAD_MIN_UNIT);
 
     int ic           = inputTensor->channel();
@@ -12,6 +12,7 @@
 #include "backend/cpu/CPUConvolution.hpp"
 #include "backend/cpu/compute/ConvolutionFloatFactory.h"
 #include "backend/cpu/compute/WinogradOptFunction.hpp"
+#include "math/WingoradGenerater.hpp"
 
 namespace MNN {
 class ConvolutionWinograd : public CPUConvolution {
@@ -24,9 +25,12 @@ public:
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
 
     static bool canUseWinograd(const Convolution2DCommon *convOp);
+    // maxUnitLimit > 0 bounds the output tile, larger tiles lose more precision
     static int bestWinogradUnit(const Convolution2DCommon *convOp, const Tensor *input, const Tensor *output,
-                                int threadnumber);
+                                int threadnumber, int maxUnitLimit = 0);
     virtual bool onClone(Backend* bn, const Op* op, Execution** dst) override;
+    // Transform a new weight in place, for convolutions reading their weight from an input
+    void updateWeight(const float *originWeight);
 private:
     ConvolutionWinograd(std::shared_ptr<CPUConvolution::Resource> resource, const Convolution2DCommon *convOp, Backend* b) : CPUConvolution(convOp, b) {
         mResource = resource;
@@ -42,6 +46,10 @@ private:
 
     WinogradFunction::TransformFunc mSourceTransform;
     WinogradFunction::TransformFunc mDestTransform;
+
+    std::shared_ptr<Math::WinogradGenerater> mGenerater;
+    int mSrcCount    = 0;
+    int mOutputCount = 0;
 };
 } // namespace MNN
 #endif /* ConvolutionWinograd_hpp */
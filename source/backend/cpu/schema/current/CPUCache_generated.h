@@ -0,0 +1,331 @@
+// automatically generated by the FlatBuffers compiler, do not modify
+
+
+#ifndef FLATBUFFERS_GENERATED_CPUCACHE_CPUCACHE_H_
+#define FLATBUFFERS_GENERATED_CPUCACHE_CPUCACHE_H_
+
+#include "flatbuffers/flatbuffers.h"
+
+namespace CPUCache {
+
+struct ConvTuning;
+struct ConvTuningT;
+
+struct Cache;
+struct CacheT;
+
+inline const flatbuffers::TypeTable *ConvTuningTypeTable();
+
+inline const flatbuffers::TypeTable *CacheTypeTable();
+
+struct ConvTuningT : public flatbuffers::NativeTable {
+  typedef ConvTuning TableType;
+  std::string key;
+  int32_t algorithm;
+  int32_t parameter;
+  ConvTuningT()
+      : algorithm(0),
+        parameter(0) {
+  }
+};
+
+struct ConvTuning FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef ConvTuningT NativeTableType;
+  static const flatbuffers::TypeTable *MiniReflectTypeTable() {
+    return ConvTuningTypeTable();
+  }
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_KEY = 4,
+    VT_ALGORITHM = 6,
+    VT_PARAMETER = 8
+  };
+  const flatbuffers::String *key() const {
+    return GetPointer<const flatbuffers::String *>(VT_KEY);
+  }
+  int32_t algorithm() const {
+    return GetField<int32_t>(VT_ALGORITHM, 0);
+  }
+  int32_t parameter() const {
+    return GetField<int32_t>(VT_PARAMETER, 0);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_KEY) &&
+           verifier.VerifyString(key()) &&
+           VerifyField<int32_t>(verifier, VT_ALGORITHM) &&
+           VerifyField<int32_t>(verifier, VT_PARAMETER) &&
+           verifier.EndTable();
+  }
+  ConvTuningT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  void UnPackTo(ConvTuningT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  static flatbuffers::Offset<ConvTuning> Pack(flatbuffers::FlatBufferBuilder &_fbb, const ConvTuningT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+};
+
+struct ConvTuningBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_key(flatbuffers::Offset<flatbuffers::String> key) {
+    fbb_.AddOffset(ConvTuning::VT_KEY, key);
+  }
+  void add_algorithm(int32_t algorithm) {
+    fbb_.AddElement<int32_t>(ConvTuning::VT_ALGORITHM, algorithm, 0);
+  }
+  void add_parameter(int32_t parameter) {
+    fbb_.AddElement<int32_t>(ConvTuning::VT_PARAMETER, parameter, 0);
+  }
+  explicit ConvTuningBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ConvTuningBuilder &operator=(const ConvTuningBuilder &);
+  flatbuffers::Offset<ConvTuning> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<ConvTuning>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<ConvTuning> CreateConvTuning(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<flatbuffers::String> key = 0,
+    int32_t algorithm = 0,
+    int32_t parameter = 0) {
+  ConvTuningBuilder builder_(_fbb);
+  builder_.add_parameter(parameter);
+  builder_.add_algorithm(algorithm);
+  builder_.add_key(key);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<ConvTuning> CreateConvTuningDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    const char *key = nullptr,
+    int32_t algorithm = 0,
+    int32_t parameter = 0) {
+  auto key__ = key ? _fbb.CreateString(key) : 0;
+  return CPUCache::CreateConvTuning(
+      _fbb,
+      key__,
+      algorithm,
+      parameter);
+}
+
+flatbuffers::Offset<ConvTuning> CreateConvTuning(flatbuffers::FlatBufferBuilder &_fbb, const ConvTuningT *_o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+
+struct CacheT : public flatbuffers::NativeTable {
+  typedef Cache TableType;
+  std::string device;
+  std::vector<std::unique_ptr<ConvTuningT>> tunings;
+  CacheT() {
+  }
+};
+
+struct Cache FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef CacheT NativeTableType;
+  static const flatbuffers::TypeTable *MiniReflectTypeTable() {
+    return CacheTypeTable();
+  }
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_DEVICE = 4,
+    VT_TUNINGS = 6
+  };
+  const flatbuffers::String *device() const {
+    return GetPointer<const flatbuffers::String *>(VT_DEVICE);
+  }
+  const flatbuffers::Vector<flatbuffers::Offset<ConvTuning>> *tunings() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<ConvTuning>> *>(VT_TUNINGS);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_DEVICE) &&
+           verifier.VerifyString(device()) &&
+           VerifyOffset(verifier, VT_TUNINGS) &&
+           verifier.VerifyVector(tunings()) &&
+           verifier.VerifyVectorOfTables(tunings()) &&
+           verifier.EndTable();
+  }
+  CacheT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  void UnPackTo(CacheT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  static flatbuffers::Offset<Cache> Pack(flatbuffers::FlatBufferBuilder &_fbb, const CacheT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+};
+
+struct CacheBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_device(flatbuffers::Offset<flatbuffers::String> device) {
+    fbb_.AddOffset(Cache::VT_DEVICE, device);
+  }
+  void add_tunings(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<ConvTuning>>> tunings) {
+    fbb_.AddOffset(Cache::VT_TUNINGS, tunings);
+  }
+  explicit CacheBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  CacheBuilder &operator=(const CacheBuilder &);
+  flatbuffers::Offset<Cache> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<Cache>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Cache> CreateCache(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<flatbuffers::String> device = 0,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<ConvTuning>>> tunings = 0) {
+  CacheBuilder builder_(_fbb);
+  builder_.add_tunings(tunings);
+  builder_.add_device(device);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<Cache> CreateCacheDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    const char *device = nullptr,
+    const std::vector<flatbuffers::Offset<ConvTuning>> *tunings = nullptr) {
+  auto device__ = device ? _fbb.CreateString(device) : 0;
+  auto tunings__ = tunings ? _fbb.CreateVector<flatbuffers::Offset<ConvTuning>>(*tunings) : 0;
+  return CPUCache::CreateCache(
+      _fbb,
+      device__,
+      tunings__);
+}
+
+flatbuffers::Offset<Cache> CreateCache(flatbuffers::FlatBufferBuilder &_fbb, const CacheT *_o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
+
+inline ConvTuningT *ConvTuning::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = new ConvTuningT();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
+inline void ConvTuning::UnPackTo(ConvTuningT *_o, const flatbuffers::resolver_function_t *_resolver) const {
+  (void)_o;
+  (void)_resolver;
+  { auto _e = key(); if (_e) _o->key = _e->str(); };
+  { auto _e = algorithm(); _o->algorithm = _e; };
+  { auto _e = parameter(); _o->parameter = _e; };
+}
+
+inline flatbuffers::Offset<ConvTuning> ConvTuning::Pack(flatbuffers::FlatBufferBuilder &_fbb, const ConvTuningT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  return CreateConvTuning(_fbb, _o, _rehasher);
+}
+
+inline flatbuffers::Offset<ConvTuning> CreateConvTuning(flatbuffers::FlatBufferBuilder &_fbb, const ConvTuningT *_o, const flatbuffers::rehasher_function_t *_rehasher) {
+  (void)_rehasher;
+  (void)_o;
+  struct _VectorArgs { flatbuffers::FlatBufferBuilder *__fbb; const ConvTuningT* __o; const flatbuffers::rehasher_function_t *__rehasher; } _va = { &_fbb, _o, _rehasher}; (void)_va;
+  auto _key = _o->key.empty() ? 0 : _fbb.CreateString(_o->key);
+  auto _algorithm = _o->algorithm;
+  auto _parameter = _o->parameter;
+  return CPUCache::CreateConvTuning(
+      _fbb,
+      _key,
+      _algorithm,
+      _parameter);
+}
+
+inline CacheT *Cache::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = new CacheT();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
+inline void Cache::UnPackTo(CacheT *_o, const flatbuffers::resolver_function_t *_resolver) const {
+  (void)_o;
+  (void)_resolver;
+  { auto _e = device(); if (_e) _o->device = _e->str(); };
+  { auto _e = tunings(); if (_e) { _o->tunings.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->tunings[_i] = std::unique_ptr<ConvTuningT>(_e->Get(_i)->UnPack(_resolver)); } } };
+}
+
+inline flatbuffers::Offset<Cache> Cache::Pack(flatbuffers::FlatBufferBuilder &_fbb, const CacheT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
+  return CreateCache(_fbb, _o, _rehasher);
+}
+
+inline flatbuffers::Offset<Cache> CreateCache(flatbuffers::FlatBufferBuilder &_fbb, const CacheT *_o, const flatbuffers::rehasher_function_t *_rehasher) {
+  (void)_rehasher;
+  (void)_o;
+  struct _VectorArgs { flatbuffers::FlatBufferBuilder *__fbb; const CacheT* __o; const flatbuffers::rehasher_function_t *__rehasher; } _va = { &_fbb, _o, _rehasher}; (void)_va;
+  auto _device = _o->device.empty() ? 0 : _fbb.CreateString(_o->device);
+  auto _tunings = _o->tunings.size() ? _fbb.CreateVector<flatbuffers::Offset<ConvTuning>> (_o->tunings.size(), [](size_t i, _VectorArgs *__va) { return CreateConvTuning(*__va->__fbb, __va->__o->tunings[i].get(), __va->__rehasher); }, &_va ) : 0;
+  return CPUCache::CreateCache(
+      _fbb,
+      _device,
+      _tunings);
+}
+
+inline const flatbuffers::TypeTable *ConvTuningTypeTable() {
+  static const flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_STRING, 0, -1 },
+    { flatbuffers::ET_INT, 0, -1 },
+    { flatbuffers::ET_INT, 0, -1 }
+  };
+  static const char * const names[] = {
+    "key",
+    "algorithm",
+    "parameter"
+  };
+  static const flatbuffers::TypeTable tt = {
+    flatbuffers::ST_TABLE, 3, type_codes, nullptr, nullptr, names
+  };
+  return &tt;
+}
+
+inline const flatbuffers::TypeTable *CacheTypeTable() {
+  static const flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_STRING, 0, -1 },
+    { flatbuffers::ET_SEQUENCE, 1, 0 }
+  };
+  static const flatbuffers::TypeFunction type_refs[] = {
+    ConvTuningTypeTable
+  };
+  static const char * const names[] = {
+    "device",
+    "tunings"
+  };
+  static const flatbuffers::TypeTable tt = {
+    flatbuffers::ST_TABLE, 2, type_codes, type_refs, nullptr, names
+  };
+  return &tt;
+}
+
+inline const CPUCache::Cache *GetCache(const void *buf) {
+  return flatbuffers::GetRoot<CPUCache::Cache>(buf);
+}
+
+inline const CPUCache::Cache *GetSizePrefixedCache(const void *buf) {
+  return flatbuffers::GetSizePrefixedRoot<CPUCache::Cache>(buf);
+}
+
+inline bool VerifyCacheBuffer(
+    flatbuffers::Verifier &verifier) {
+  return verifier.VerifyBuffer<CPUCache::Cache>(nullptr);
+}
+
+inline bool VerifySizePrefixedCacheBuffer(
+    flatbuffers::Verifier &verifier) {
+  return verifier.VerifySizePrefixedBuffer<CPUCache::Cache>(nullptr);
+}
+
+inline void FinishCacheBuffer(
+    flatbuffers::FlatBufferBuilder &fbb,
+    flatbuffers::Offset<CPUCache::Cache> root) {
+  fbb.Finish(root);
+}
+
+inline void FinishSizePrefixedCacheBuffer(
+    flatbuffers::FlatBufferBuilder &fbb,
+    flatbuffers::Offset<CPUCache::Cache> root) {
+  fbb.FinishSizePrefixed(root);
+}
+
+inline std::unique_ptr<CacheT> UnPackCache(
+    const void *buf,
+    const flatbuffers::resolver_function_t *res = nullptr) {
+  return std::unique_ptr<CacheT>(GetCache(buf)->UnPack(res));
+}
+
+}  // namespace CPUCache
+
+#endif  // FLATBUFFERS_GENERATED_CPUCACHE_CPUCACHE_H_
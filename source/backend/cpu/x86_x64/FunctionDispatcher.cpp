@@ -39,6 +39,8 @@ struct FunctionGroup {
                          size_t bStride, size_t height) = _SSE_MNNMatrixAdd;
     void (*MNNMatrixSub)(float* C, const float* A, const float* B, size_t widthC4, size_t cStride, size_t aStride,
                          size_t bStride, size_t height) = _SSE_MNNMatrixSub;
+    void (*MNNMatrixProd)(float* C, const float* A, const float* B, size_t widthC4, size_t cStride, size_t aStride,
+                          size_t bStride, size_t height) = _SSE_MNNMatrixProd;
 
     void (*MNNGemmFloatUnit_4)(float* dstOrigin, const float* src, const float* weight, size_t src_depth_quad,
                                size_t dst_step, size_t dst_depth_quad,
@@ -65,6 +67,15 @@ struct FunctionGroup {
     void (*MNNInt8ScaleToFloat)(float* dst, const int8_t* src, const float* scale, size_t size, ssize_t zeroPoint) = _SSE_MNNInt8ScaleToFloat;
     void (*MNNLineDepthWiseInt8AddBiasScaleUnit)(int8_t* dst, const int8_t* src, const int8_t* weight, const QuanPostTreatParameters* parameters, size_t width, size_t src_w_step, size_t fw, size_t fh, size_t dilateX_step, size_t dilateY_step) = _SSE_MNNLineDepthWiseInt8AddBiasScaleUnit;
     void (*MNNComputeMatMulForE_1)(const float* A, const float* B, float* C, const float* biasPtr, const MatMulParam* param, size_t tId) = _SSE_MNNComputeMatMulForE_1;
+
+    // Training
+    void (*MNNReluGradMask)(float* dst, const float* origin, const float* diff, size_t size, float minValue,
+                            float maxValue)                                                = _SSE_MNNReluGradMask;
+    void (*MNNSoftmaxGrad)(float* dst, const float* softmax, const float* grad, size_t size) = _SSE_MNNSoftmaxGrad;
+    void (*MNNMomentsC4)(float* mean, float* variance, const float* src, size_t planeNumber)  = _SSE_MNNMomentsC4;
+    float (*MNNSumFloat)(const float* src, size_t size)                                      = _SSE_MNNSumFloat;
+    float (*MNNAbsMaxFloat)(const float* src, size_t size)                                   = _SSE_MNNAbsMaxFloat;
+    void (*MNNFakeQuant)(float* dst, const float* src, size_t size, float scale, float limit) = _SSE_MNNFakeQuant;
 };
 
 static FunctionGroup gFunc;
@@ -76,6 +87,7 @@ void MNNFunctionInit() {
         gFunc.MNNAddBiasRelu6       = _AVX_MNNAddBiasRelu6;
         gFunc.MNNMatrixAdd          = _AVX_MNNMatrixAdd;
         gFunc.MNNMatrixSub          = _AVX_MNNMatrixSub;
+        gFunc.MNNMatrixProd         = _AVX_MNNMatrixProd;
         gFunc.MNNGemmFloatUnit_4    = _AVX_MNNGemmFloatUnit_4;
         gFunc.MNNGemmFloatCommon_4  = _AVX_MNNGemmFloatCommon_4;
         gFunc.MNNPackedMatMul       = _AVX_MNNPackedMatMul;
@@ -90,6 +102,12 @@ void MNNFunctionInit() {
         gFunc.MNNLineDepthWiseInt8AddBiasScaleUnit = _AVX_MNNLineDepthWiseInt8AddBiasScaleUnit;
         gFunc.MNNComputeMatMulForE_1 = _AVX_MNNComputeMatMulForE_1;
         gFunc.MNNGemmInt8AddBiasScale_16x4_Unit_FAST = _AVX_MNNGemmInt8AddBiasScale_16x4_Unit_Fast;
+        gFunc.MNNReluGradMask = _AVX_MNNReluGradMask;
+        gFunc.MNNSoftmaxGrad  = _AVX_MNNSoftmaxGrad;
+        gFunc.MNNMomentsC4    = _AVX_MNNMomentsC4;
+        gFunc.MNNSumFloat     = _AVX_MNNSumFloat;
+        gFunc.MNNAbsMaxFloat  = _AVX_MNNAbsMaxFloat;
+        gFunc.MNNFakeQuant    = _AVX_MNNFakeQuant;
         if (cpuFlags & libyuv::kCpuHasFMA3) {
             gFunc.MNNGemmFloatUnit_4    = _AVX_MNNGemmFloatUnitFMA_4;
             gFunc.MNNGemmFloatCommon_4  = _AVX_MNNGemmFloatCommonFMA_4;
@@ -109,6 +127,15 @@ void MNNFunctionInit() {
         gFunc.MNNGemmInt8AddBiasScale_16x4_Unit = _AVX512_MNNGemmInt8AddBiasScale_16x4_Unit;
         gFunc.MNNGemmInt8AddBiasScale_16x4_Unit_FAST = _AVX512_MNNGemmInt8AddBiasScale_16x4_Unit;
     }
+    if (cpuFlags & libyuv::kCpuHasAVX512VL) {
+        gFunc.MNNMatrixProd   = _AVX512_MNNMatrixProd;
+        gFunc.MNNReluGradMask = _AVX512_MNNReluGradMask;
+        gFunc.MNNSoftmaxGrad  = _AVX512_MNNSoftmaxGrad;
+        gFunc.MNNMomentsC4    = _AVX512_MNNMomentsC4;
+        gFunc.MNNSumFloat     = _AVX512_MNNSumFloat;
+        gFunc.MNNAbsMaxFloat  = _AVX512_MNNAbsMaxFloat;
+        gFunc.MNNFakeQuant    = _AVX512_MNNFakeQuant;
+    }
 #endif
 }
 
@@ -156,6 +183,11 @@ void MNNMatrixSub(float* C, const float* A, const float* B, size_t widthC4, size
     gFunc.MNNMatrixSub(C, A, B, widthC4, cStride, aStride, bStride, height);
 }
 
+void MNNMatrixProd(float* C, const float* A, const float* B, size_t widthC4, size_t cStride, size_t aStride,
+                   size_t bStride, size_t height) {
+    gFunc.MNNMatrixProd(C, A, B, widthC4, cStride, aStride, bStride, height);
+}
+
 void MNNReluWithSlopeChannel(float* dst, const float* src, const float* slope, size_t sizeQuad, size_t depthQuad) {
     return _SSE_MNNReluWithSlopeChannel(dst, src, slope, sizeQuad, depthQuad);
 }
@@ -220,3 +252,28 @@ void MNNComputeMatMulForE_1(const float* A, const float* B, float* C, const floa
 void MNNGemmInt8AddBiasScale_16x4_Unit_FAST(int8_t* dst, const int8_t* src, const int8_t* weight, size_t src_depth_quad, size_t dst_step, size_t dst_depth_quad, const QuanPostTreatParameters* post, size_t realCount) {
     gFunc.MNNGemmInt8AddBiasScale_16x4_Unit_FAST(dst, src, weight, src_depth_quad, dst_step, dst_depth_quad, post, realCount);
 }
+
+// ========= TrainFunction.cpp ===========
+void MNNReluGradMask(float* dst, const float* origin, const float* diff, size_t size, float minValue, float maxValue) {
+    gFunc.MNNReluGradMask(dst, origin, diff, size, minValue, maxValue);
+}
+
+void MNNSoftmaxGrad(float* dst, const float* softmax, const float* grad, size_t size) {
+    gFunc.MNNSoftmaxGrad(dst, softmax, grad, size);
+}
+
+void MNNMomentsC4(float* mean, float* variance, const float* src, size_t planeNumber) {
+    gFunc.MNNMomentsC4(mean, variance, src, planeNumber);
+}
+
+float MNNSumFloat(const float* src, size_t size) {
+    return gFunc.MNNSumFloat(src, size);
+}
+
+float MNNAbsMaxFloat(const float* src, size_t size) {
+    return gFunc.MNNAbsMaxFloat(src, size);
+}
+
+void MNNFakeQuant(float* dst, const float* src, size_t size, float scale, float limit) {
+    gFunc.MNNFakeQuant(dst, src, size, scale, limit);
+}
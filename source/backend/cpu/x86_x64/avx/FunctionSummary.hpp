@@ -71,6 +71,11 @@ void _AVX_MNNMatrixAdd(float* C, const float* A, const float* B, size_t widthC4,
 void _AVX_MNNMatrixSub(float* C, const float* A, const float* B, size_t widthC4, size_t cStride, size_t aStride,
                        size_t bStride, size_t height);
 
+// ========= MNNMatrixProd.cpp ===========
+
+void _AVX_MNNMatrixProd(float* C, const float* A, const float* B, size_t widthC4, size_t cStride, size_t aStride,
+                        size_t bStride, size_t height);
+
 void _AVX_MNNStrassenMergeCFunction(float* c11, float* c12, float* c21, float* c22, float* xAddr, size_t cStride,
                                     size_t length, size_t hSub);
 
@@ -99,4 +104,11 @@ void _AVX_MNNLineDepthWiseInt8AddBiasScaleUnit(int8_t* dstO, const int8_t* srcO,
 void _AVX_MNNComputeMatMulForE_1(const float* A, const float* B, float* C, const float* biasPtr, const MatMulParam* param, size_t tId);
 void _AVX_MNNComputeMatMulForE_1FMA(const float* A, const float* B, float* C, const float* biasPtr, const MatMulParam* param, size_t tId);
 
+// ========= TrainFunction.cpp ===========
+void _AVX_MNNReluGradMask(float* dst, const float* origin, const float* diff, size_t size, float minValue, float maxValue);
+void _AVX_MNNSoftmaxGrad(float* dst, const float* softmax, const float* grad, size_t size);
+void _AVX_MNNMomentsC4(float* mean, float* variance, const float* src, size_t planeNumber);
+float _AVX_MNNSumFloat(const float* src, size_t size);
+float _AVX_MNNAbsMaxFloat(const float* src, size_t size);
+void _AVX_MNNFakeQuant(float* dst, const float* src, size_t size, float scale, float limit);
 }
@@ -0,0 +1,139 @@
+//
+//  TrainFunction.cpp
+//  MNN
+//
+//  Created by MNN on 2021/07/26.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <algorithm>
+#include "FunctionSummary.hpp"
+
+// Sum the two C4 halves
+static __m128 _fold(__m256 v) {
+    return _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+}
+
+static float _reduce(__m256 v) {
+    float temp[4];
+    _mm_storeu_ps(temp, _fold(v));
+    return temp[0] + temp[1] + temp[2] + temp[3];
+}
+
+void _AVX_MNNReluGradMask(float* dst, const float* origin, const float* diff, size_t size, float minValue, float maxValue) {
+    auto minV    = _mm256_set1_ps(minValue);
+    auto maxV    = _mm256_set1_ps(maxValue);
+    size_t start = 0;
+    for (; start + 8 <= size; start += 8) {
+        auto o    = _mm256_loadu_ps(origin + start);
+        auto mask = _mm256_and_ps(_mm256_cmp_ps(o, minV, _CMP_GT_OQ), _mm256_cmp_ps(o, maxV, _CMP_LE_OQ));
+        _mm256_storeu_ps(dst + start, _mm256_and_ps(mask, _mm256_loadu_ps(diff + start)));
+    }
+    for (size_t i = start; i < size; ++i) {
+        dst[i] = (origin[i] > minValue && origin[i] <= maxValue) ? diff[i] : 0.0f;
+    }
+}
+
+void _AVX_MNNSoftmaxGrad(float* dst, const float* softmax, const float* grad, size_t size) {
+    auto sizeC8 = size / 8;
+    auto sumV   = _mm256_setzero_ps();
+    for (int i = 0; i < sizeC8; ++i) {
+        sumV = _mm256_add_ps(sumV, _mm256_mul_ps(_mm256_loadu_ps(softmax + 8 * i), _mm256_loadu_ps(grad + 8 * i)));
+    }
+    float sum = _reduce(sumV);
+    for (int i = sizeC8 * 8; i < size; ++i) {
+        sum += softmax[i] * grad[i];
+    }
+    sumV = _mm256_set1_ps(sum);
+    for (int i = 0; i < sizeC8; ++i) {
+        auto g = _mm256_sub_ps(_mm256_loadu_ps(grad + 8 * i), sumV);
+        _mm256_storeu_ps(dst + 8 * i, _mm256_mul_ps(_mm256_loadu_ps(softmax + 8 * i), g));
+    }
+    for (int i = sizeC8 * 8; i < size; ++i) {
+        dst[i] = softmax[i] * (grad[i] - sum);
+    }
+}
+
+void _AVX_MNNMomentsC4(float* mean, float* variance, const float* src, size_t planeNumber) {
+    // Two planes in each register
+    auto countC2 = planeNumber / 2;
+    auto sumV    = _mm256_setzero_ps();
+    for (int i = 0; i < countC2; ++i) {
+        sumV = _mm256_add_ps(sumV, _mm256_loadu_ps(src + 8 * i));
+    }
+    auto sum = _fold(sumV);
+    if (planeNumber % 2 == 1) {
+        sum = _mm_add_ps(sum, _mm_loadu_ps(src + 8 * countC2));
+    }
+    auto divide  = _mm_set1_ps(1.0f / planeNumber);
+    auto meanV   = _mm_mul_ps(sum, divide);
+    auto meanV2  = _mm256_insertf128_ps(_mm256_castps128_ps256(meanV), meanV, 1);
+    auto squareV = _mm256_setzero_ps();
+    for (int i = 0; i < countC2; ++i) {
+        auto diff = _mm256_sub_ps(_mm256_loadu_ps(src + 8 * i), meanV2);
+        squareV   = _mm256_add_ps(squareV, _mm256_mul_ps(diff, diff));
+    }
+    auto square = _fold(squareV);
+    if (planeNumber % 2 == 1) {
+        auto diff = _mm_sub_ps(_mm_loadu_ps(src + 8 * countC2), meanV);
+        square    = _mm_add_ps(square, _mm_mul_ps(diff, diff));
+    }
+    _mm_storeu_ps(mean, meanV);
+    _mm_storeu_ps(variance, _mm_mul_ps(square, divide));
+}
+
+float _AVX_MNNSumFloat(const float* src, size_t size) {
+    auto sizeC16 = size / 16;
+    auto sum0    = _mm256_setzero_ps();
+    auto sum1    = _mm256_setzero_ps();
+    for (int i = 0; i < sizeC16; ++i) {
+        sum0 = _mm256_add_ps(sum0, _mm256_loadu_ps(src + 16 * i));
+        sum1 = _mm256_add_ps(sum1, _mm256_loadu_ps(src + 16 * i + 8));
+    }
+    float sum = _reduce(_mm256_add_ps(sum0, sum1));
+    for (int i = sizeC16 * 16; i < size; ++i) {
+        sum += src[i];
+    }
+    return sum;
+}
+
+float _AVX_MNNAbsMaxFloat(const float* src, size_t size) {
+    auto signMask = _mm256_set1_ps(-0.0f);
+    auto maxV     = _mm256_setzero_ps();
+    size_t start  = 0;
+    for (; start + 8 <= size; start += 8) {
+        maxV = _mm256_max_ps(maxV, _mm256_andnot_ps(signMask, _mm256_loadu_ps(src + start)));
+    }
+    float temp[4];
+    _mm_storeu_ps(temp, _mm_max_ps(_mm256_castps256_ps128(maxV), _mm256_extractf128_ps(maxV, 1)));
+    float maxValue = std::max(std::max(temp[0], temp[1]), std::max(temp[2], temp[3]));
+    for (size_t i = start; i < size; ++i) {
+        maxValue = std::max(maxValue, fabsf(src[i]));
+    }
+    return maxValue;
+}
+
+void _AVX_MNNFakeQuant(float* dst, const float* src, size_t size, float scale, float limit) {
+    auto inverse  = 1.0f / scale;
+    auto inverseV = _mm256_set1_ps(inverse);
+    auto scaleV   = _mm256_set1_ps(scale);
+    auto maxV     = _mm256_set1_ps(limit);
+    auto minV     = _mm256_set1_ps(-limit);
+    auto signMask = _mm256_set1_ps(-0.0f);
+    auto half     = _mm256_set1_ps(0.5f);
+    auto one      = _mm256_set1_ps(1.0f);
+    size_t start  = 0;
+    for (; start + 8 <= size; start += 8) {
+        auto v = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + start), inverseV), minV), maxV);
+        // truncate, then step away from zero if the dropped part is at least a half
+        auto t    = _mm256_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        auto frac = _mm256_andnot_ps(signMask, _mm256_sub_ps(v, t));
+        auto step = _mm256_or_ps(_mm256_and_ps(v, signMask), one);
+        t         = _mm256_add_ps(t, _mm256_and_ps(_mm256_cmp_ps(frac, half, _CMP_GE_OQ), step));
+        _mm256_storeu_ps(dst + start, _mm256_mul_ps(t, scaleV));
+    }
+    for (size_t i = start; i < size; ++i) {
+        dst[i] = roundf(std::min(std::max(src[i] * inverse, -limit), limit)) * scale;
+    }
+}
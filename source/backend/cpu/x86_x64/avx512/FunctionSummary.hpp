@@ -30,4 +30,14 @@ void _AVX512_MNNPackedMatMul(float* C, const float* A, const float* B, const siz
 void _AVX512_MNNPackedMatMulRemain(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter, float* cache, const float* postParameters, const float* bias);
 void _AVX512_MNNGemmInt8AddBiasScale_16x4_Unit(int8_t* dst, const int8_t* src, const int8_t* weight, size_t src_depth_quad, size_t dst_step, size_t dst_depth_quad, const QuanPostTreatParameters* post, size_t realDst);
 
+
+// ========= TrainFunction.cpp ===========
+void _AVX512_MNNMatrixProd(float* C, const float* A, const float* B, size_t widthC4, size_t cStride, size_t aStride,
+                           size_t bStride, size_t height);
+void _AVX512_MNNReluGradMask(float* dst, const float* origin, const float* diff, size_t size, float minValue, float maxValue);
+void _AVX512_MNNSoftmaxGrad(float* dst, const float* softmax, const float* grad, size_t size);
+void _AVX512_MNNMomentsC4(float* mean, float* variance, const float* src, size_t planeNumber);
+float _AVX512_MNNSumFloat(const float* src, size_t size);
+float _AVX512_MNNAbsMaxFloat(const float* src, size_t size);
+void _AVX512_MNNFakeQuant(float* dst, const float* src, size_t size, float scale, float limit);
 }
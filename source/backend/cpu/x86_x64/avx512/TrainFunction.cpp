@@ -0,0 +1,128 @@
+//
+//  TrainFunction.cpp
+//  MNN
+//
+//  Created by MNN on 2021/07/26.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "FunctionSummary.hpp"
+
+// Sum the four C4 quarters
+static __m128 _fold(__m512 v) {
+    auto v01 = _mm_add_ps(_mm512_extractf32x4_ps(v, 0), _mm512_extractf32x4_ps(v, 1));
+    auto v23 = _mm_add_ps(_mm512_extractf32x4_ps(v, 2), _mm512_extractf32x4_ps(v, 3));
+    return _mm_add_ps(v01, v23);
+}
+
+void _AVX512_MNNMatrixProd(float* C, const float* A, const float* B, size_t widthC4, size_t cStride, size_t aStride,
+                           size_t bStride, size_t height) {
+    auto countC4     = widthC4 / 4;
+    __mmask16 remain = (1 << ((widthC4 % 4) * 4)) - 1;
+    for (int y = 0; y < height; ++y) {
+        auto a = A + aStride * y;
+        auto b = B + bStride * y;
+        auto c = C + cStride * y;
+        for (int x = 0; x < countC4; ++x) {
+            _mm512_storeu_ps(c + 16 * x, _mm512_mul_ps(_mm512_loadu_ps(a + 16 * x), _mm512_loadu_ps(b + 16 * x)));
+        }
+        if (remain) {
+            auto offset = 16 * countC4;
+            auto value  = _mm512_mul_ps(_mm512_maskz_loadu_ps(remain, a + offset), _mm512_maskz_loadu_ps(remain, b + offset));
+            _mm512_mask_storeu_ps(c + offset, remain, value);
+        }
+    }
+}
+
+void _AVX512_MNNReluGradMask(float* dst, const float* origin, const float* diff, size_t size, float minValue, float maxValue) {
+    auto minV = _mm512_set1_ps(minValue);
+    auto maxV = _mm512_set1_ps(maxValue);
+    for (size_t start = 0; start < size; start += 16) {
+        __mmask16 valid = size - start >= 16 ? 0xFFFF : (1 << (size - start)) - 1;
+        auto o          = _mm512_maskz_loadu_ps(valid, origin + start);
+        __mmask16 mask  = _mm512_mask_cmp_ps_mask(valid, o, minV, _CMP_GT_OQ) & _mm512_cmp_ps_mask(o, maxV, _CMP_LE_OQ);
+        _mm512_mask_storeu_ps(dst + start, valid, _mm512_maskz_loadu_ps(mask, diff + start));
+    }
+}
+
+void _AVX512_MNNSoftmaxGrad(float* dst, const float* softmax, const float* grad, size_t size) {
+    auto sumV = _mm512_setzero_ps();
+    for (size_t start = 0; start < size; start += 16) {
+        __mmask16 valid = size - start >= 16 ? 0xFFFF : (1 << (size - start)) - 1;
+        auto s          = _mm512_maskz_loadu_ps(valid, softmax + start);
+        sumV            = _mm512_add_ps(sumV, _mm512_mul_ps(s, _mm512_maskz_loadu_ps(valid, grad + start)));
+    }
+    sumV = _mm512_set1_ps(_mm512_reduce_add_ps(sumV));
+    for (size_t start = 0; start < size; start += 16) {
+        __mmask16 valid = size - start >= 16 ? 0xFFFF : (1 << (size - start)) - 1;
+        auto g          = _mm512_sub_ps(_mm512_maskz_loadu_ps(valid, grad + start), sumV);
+        _mm512_mask_storeu_ps(dst + start, valid, _mm512_mul_ps(_mm512_maskz_loadu_ps(valid, softmax + start), g));
+    }
+}
+
+void _AVX512_MNNMomentsC4(float* mean, float* variance, const float* src, size_t planeNumber) {
+    // Four planes in each register, the remaining ones masked
+    auto countC4     = planeNumber / 4;
+    __mmask16 remain = (1 << ((planeNumber % 4) * 4)) - 1;
+    auto sumV        = _mm512_setzero_ps();
+    for (int i = 0; i < countC4; ++i) {
+        sumV = _mm512_add_ps(sumV, _mm512_loadu_ps(src + 16 * i));
+    }
+    sumV         = _mm512_add_ps(sumV, _mm512_maskz_loadu_ps(remain, src + 16 * countC4));
+    auto divide  = _mm_set1_ps(1.0f / planeNumber);
+    auto meanV   = _mm_mul_ps(_fold(sumV), divide);
+    auto meanV4  = _mm512_broadcast_f32x4(meanV);
+    auto squareV = _mm512_setzero_ps();
+    for (int i = 0; i < countC4; ++i) {
+        auto diff = _mm512_sub_ps(_mm512_loadu_ps(src + 16 * i), meanV4);
+        squareV   = _mm512_add_ps(squareV, _mm512_mul_ps(diff, diff));
+    }
+    auto diff = _mm512_maskz_sub_ps(remain, _mm512_maskz_loadu_ps(remain, src + 16 * countC4), meanV4);
+    squareV   = _mm512_add_ps(squareV, _mm512_mul_ps(diff, diff));
+    _mm_storeu_ps(mean, meanV);
+    _mm_storeu_ps(variance, _mm_mul_ps(_fold(squareV), divide));
+}
+
+float _AVX512_MNNSumFloat(const float* src, size_t size) {
+    auto sizeC32 = size / 32;
+    auto sum0    = _mm512_setzero_ps();
+    auto sum1    = _mm512_setzero_ps();
+    for (int i = 0; i < sizeC32; ++i) {
+        sum0 = _mm512_add_ps(sum0, _mm512_loadu_ps(src + 32 * i));
+        sum1 = _mm512_add_ps(sum1, _mm512_loadu_ps(src + 32 * i + 16));
+    }
+    for (size_t start = sizeC32 * 32; start < size; start += 16) {
+        __mmask16 valid = size - start >= 16 ? 0xFFFF : (1 << (size - start)) - 1;
+        sum0            = _mm512_add_ps(sum0, _mm512_maskz_loadu_ps(valid, src + start));
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+}
+
+float _AVX512_MNNAbsMaxFloat(const float* src, size_t size) {
+    auto maxV = _mm512_setzero_ps();
+    for (size_t start = 0; start < size; start += 16) {
+        __mmask16 valid = size - start >= 16 ? 0xFFFF : (1 << (size - start)) - 1;
+        maxV            = _mm512_max_ps(maxV, _mm512_abs_ps(_mm512_maskz_loadu_ps(valid, src + start)));
+    }
+    return _mm512_reduce_max_ps(maxV);
+}
+
+void _AVX512_MNNFakeQuant(float* dst, const float* src, size_t size, float scale, float limit) {
+    auto inverseV = _mm512_set1_ps(1.0f / scale);
+    auto scaleV   = _mm512_set1_ps(scale);
+    auto maxV     = _mm512_set1_ps(limit);
+    auto minV     = _mm512_set1_ps(-limit);
+    auto half     = _mm512_set1_ps(0.5f);
+    for (size_t start = 0; start < size; start += 16) {
+        __mmask16 valid = size - start >= 16 ? 0xFFFF : (1 << (size - start)) - 1;
+        auto v          = _mm512_mul_ps(_mm512_maskz_loadu_ps(valid, src + start), inverseV);
+        v               = _mm512_min_ps(_mm512_max_ps(v, minV), maxV);
+        // truncate, then step away from zero if the dropped part is at least a half
+        auto t          = _mm512_roundscale_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        auto away       = _mm512_cmp_ps_mask(_mm512_abs_ps(_mm512_sub_ps(v, t)), half, _CMP_GE_OQ);
+        auto positive   = _mm512_cmp_ps_mask(v, _mm512_setzero_ps(), _CMP_GT_OQ);
+        t               = _mm512_mask_add_ps(t, away & positive, t, _mm512_set1_ps(1.0f));
+        t               = _mm512_mask_sub_ps(t, away & ~positive, t, _mm512_set1_ps(1.0f));
+        _mm512_mask_storeu_ps(dst + start, valid, _mm512_mul_ps(t, scaleV));
+    }
+}
@@ -59,6 +59,11 @@ void _SSE_MNNMatrixAdd(float* C, const float* A, const float* B, size_t widthC4,
 void _SSE_MNNMatrixSub(float* C, const float* A, const float* B, size_t widthC4, size_t cStride, size_t aStride,
                        size_t bStride, size_t height);
 
+// ========= MNNMatrixProd.cpp ===========
+
+void _SSE_MNNMatrixProd(float* C, const float* A, const float* B, size_t widthC4, size_t cStride, size_t aStride,
+                        size_t bStride, size_t height);
+
 void _SSE_MNNReluWithSlopeChannel(float* dst, const float* src, const float* slope, size_t sizeQuad, size_t depthQuad);
 
 void _SSE_MNNStrassenMergeCFunction(float* c11, float* c12, float* c21, float* c22, float* xAddr, size_t cStride,
@@ -83,3 +88,11 @@ void _SSE_MNNInt8ScaleToFloat(float* dst, const int8_t* src, const float* scale,
 void _SSE_MNNLineDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight, const QuanPostTreatParameters* parameters, size_t width, size_t src_w_step, size_t fw, size_t fh, size_t dilateX_step, size_t dilateY_step);
 void _SSE_MNNInt8ToInt16(int16_t* dest, const int8_t* source, size_t count);
 void _SSE_MNNComputeMatMulForE_1(const float* A, const float* B, float* C, const float* biasPtr, const MatMulParam* param, size_t tId);
+
+// ========= TrainFunction.cpp ===========
+void _SSE_MNNReluGradMask(float* dst, const float* origin, const float* diff, size_t size, float minValue, float maxValue);
+void _SSE_MNNSoftmaxGrad(float* dst, const float* softmax, const float* grad, size_t size);
+void _SSE_MNNMomentsC4(float* mean, float* variance, const float* src, size_t planeNumber);
+float _SSE_MNNSumFloat(const float* src, size_t size);
+float _SSE_MNNAbsMaxFloat(const float* src, size_t size);
+void _SSE_MNNFakeQuant(float* dst, const float* src, size_t size, float scale, float limit);
@@ -0,0 +1,22 @@
+//
+//  MNNMatrixProd.cpp
+//  MNN
+//
+//  Created by MNN on 2021/07/26.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <emmintrin.h>
+#include <stdint.h>
+
+void _SSE_MNNMatrixProd(float* C, const float* A, const float* B, size_t widthC4, size_t cStride, size_t aStride,
+                       size_t bStride, size_t height) {
+    for (int y = 0; y < height; ++y) {
+        auto a = A + aStride * y;
+        auto b = B + bStride * y;
+        auto c = C + cStride * y;
+        for (int x = 0; x < widthC4; ++x) {
+            _mm_storeu_ps(c + 4 * x, _mm_mul_ps(_mm_loadu_ps(b + 4 * x), _mm_loadu_ps(a + 4 * x)));
+        }
+    }
+}
@@ -0,0 +1,122 @@
+//
+//  TrainFunction.cpp
+//  MNN
+//
+//  Created by MNN on 2021/07/26.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <algorithm>
+#include "FunctionSummary.hpp"
+
+static float _reduce(__m128 v) {
+    float temp[4];
+    _mm_storeu_ps(temp, v);
+    return temp[0] + temp[1] + temp[2] + temp[3];
+}
+
+void _SSE_MNNReluGradMask(float* dst, const float* origin, const float* diff, size_t size, float minValue, float maxValue) {
+    auto minV    = _mm_set1_ps(minValue);
+    auto maxV    = _mm_set1_ps(maxValue);
+    size_t start = 0;
+    for (; start + 4 <= size; start += 4) {
+        auto o    = _mm_loadu_ps(origin + start);
+        auto mask = _mm_and_ps(_mm_cmpgt_ps(o, minV), _mm_cmple_ps(o, maxV));
+        _mm_storeu_ps(dst + start, _mm_and_ps(mask, _mm_loadu_ps(diff + start)));
+    }
+    for (size_t i = start; i < size; ++i) {
+        dst[i] = (origin[i] > minValue && origin[i] <= maxValue) ? diff[i] : 0.0f;
+    }
+}
+
+void _SSE_MNNSoftmaxGrad(float* dst, const float* softmax, const float* grad, size_t size) {
+    auto sizeC4 = size / 4;
+    auto sumV   = _mm_setzero_ps();
+    for (int i = 0; i < sizeC4; ++i) {
+        sumV = _mm_add_ps(sumV, _mm_mul_ps(_mm_loadu_ps(softmax + 4 * i), _mm_loadu_ps(grad + 4 * i)));
+    }
+    float sum = _reduce(sumV);
+    for (int i = sizeC4 * 4; i < size; ++i) {
+        sum += softmax[i] * grad[i];
+    }
+    sumV = _mm_set1_ps(sum);
+    for (int i = 0; i < sizeC4; ++i) {
+        auto g = _mm_sub_ps(_mm_loadu_ps(grad + 4 * i), sumV);
+        _mm_storeu_ps(dst + 4 * i, _mm_mul_ps(_mm_loadu_ps(softmax + 4 * i), g));
+    }
+    for (int i = sizeC4 * 4; i < size; ++i) {
+        dst[i] = softmax[i] * (grad[i] - sum);
+    }
+}
+
+void _SSE_MNNMomentsC4(float* mean, float* variance, const float* src, size_t planeNumber) {
+    auto sumV = _mm_setzero_ps();
+    for (int i = 0; i < planeNumber; ++i) {
+        sumV = _mm_add_ps(sumV, _mm_loadu_ps(src + 4 * i));
+    }
+    auto divide  = _mm_set1_ps(1.0f / planeNumber);
+    auto meanV   = _mm_mul_ps(sumV, divide);
+    auto squareV = _mm_setzero_ps();
+    for (int i = 0; i < planeNumber; ++i) {
+        auto diff = _mm_sub_ps(_mm_loadu_ps(src + 4 * i), meanV);
+        squareV   = _mm_add_ps(squareV, _mm_mul_ps(diff, diff));
+    }
+    _mm_storeu_ps(mean, meanV);
+    _mm_storeu_ps(variance, _mm_mul_ps(squareV, divide));
+}
+
+float _SSE_MNNSumFloat(const float* src, size_t size) {
+    auto sizeC8 = size / 8;
+    auto sum0   = _mm_setzero_ps();
+    auto sum1   = _mm_setzero_ps();
+    for (int i = 0; i < sizeC8; ++i) {
+        sum0 = _mm_add_ps(sum0, _mm_loadu_ps(src + 8 * i));
+        sum1 = _mm_add_ps(sum1, _mm_loadu_ps(src + 8 * i + 4));
+    }
+    float sum = _reduce(_mm_add_ps(sum0, sum1));
+    for (int i = sizeC8 * 8; i < size; ++i) {
+        sum += src[i];
+    }
+    return sum;
+}
+
+float _SSE_MNNAbsMaxFloat(const float* src, size_t size) {
+    auto signMask = _mm_set1_ps(-0.0f);
+    auto maxV     = _mm_setzero_ps();
+    size_t start  = 0;
+    for (; start + 4 <= size; start += 4) {
+        maxV = _mm_max_ps(maxV, _mm_andnot_ps(signMask, _mm_loadu_ps(src + start)));
+    }
+    float temp[4];
+    _mm_storeu_ps(temp, maxV);
+    float maxValue = std::max(std::max(temp[0], temp[1]), std::max(temp[2], temp[3]));
+    for (size_t i = start; i < size; ++i) {
+        maxValue = std::max(maxValue, fabsf(src[i]));
+    }
+    return maxValue;
+}
+
+void _SSE_MNNFakeQuant(float* dst, const float* src, size_t size, float scale, float limit) {
+    auto inverse  = 1.0f / scale;
+    auto inverseV = _mm_set1_ps(inverse);
+    auto scaleV   = _mm_set1_ps(scale);
+    auto maxV     = _mm_set1_ps(limit);
+    auto minV     = _mm_set1_ps(-limit);
+    auto signMask = _mm_set1_ps(-0.0f);
+    auto half     = _mm_set1_ps(0.5f);
+    auto one      = _mm_set1_ps(1.0f);
+    size_t start  = 0;
+    for (; start + 4 <= size; start += 4) {
+        auto v = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + start), inverseV), minV), maxV);
+        // truncate, then step away from zero if the dropped part is at least a half
+        auto t    = _mm_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        auto frac = _mm_andnot_ps(signMask, _mm_sub_ps(v, t));
+        auto step = _mm_or_ps(_mm_and_ps(v, signMask), one);
+        t         = _mm_add_ps(t, _mm_and_ps(_mm_cmpge_ps(frac, half), step));
+        _mm_storeu_ps(dst + start, _mm_mul_ps(t, scaleV));
+    }
+    for (size_t i = start; i < size; ++i) {
+        dst[i] = roundf(std::min(std::max(src[i] * inverse, -limit), limit)) * scale;
+    }
+}
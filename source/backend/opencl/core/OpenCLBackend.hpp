@@ -108,6 +108,7 @@ public:
     // TODO: 可能要涉及到bufferPool
     virtual void changeBufferType(BufferType bufferType) override {return ;}
     virtual void setHeuristicStrategy(bool flag, std::string modelName, int batchsize, int bgt, bool alignBottom=false, bool needAlloc=true) override {return ;}
+    virtual void setHeuristicBundle(bool flag, std::shared_ptr<PlanBundle> bundle, int rung) override {return ;}
 
     OpenCLRuntime *getOpenCLRuntime();
     virtual bool onAcquireBuffer(const Tensor *nativeTensor, StorageType storageType) override;
@@ -30,6 +30,7 @@ namespace MNN {
 struct Op;
 struct GpuLibrary;
 class Execution;
+class PlanBundle;
 
 class Runtime;
 /** abstract backend */
@@ -181,6 +182,7 @@ public:
     BufferType mBufferType = BufferType::DYNAMIC_OTHER;
     virtual void changeBufferType(BufferType bufferType) = 0;
     virtual void setHeuristicStrategy(bool flag, std::string modelName, int batchsize, int bgt, bool alignBottom=false, bool needAlloc=true) = 0;
+    virtual void setHeuristicBundle(bool flag, std::shared_ptr<PlanBundle> bundle, int rung) = 0;
     /**
      * @brief copy buffer from tensor to tensor.
      * @param srcTensor source buffer provider.
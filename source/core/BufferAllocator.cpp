@@ -8,6 +8,7 @@
 
 #include "core/BufferAllocator.hpp"
 #include "core/Macro.h"
+#include "core/TLSFAllocator.hpp"
 
 //#define DUMP_USAGE
 //#define MNN_DEBUG_MEMORY
@@ -79,6 +80,11 @@ std::pair<void*, size_t> BufferAllocator::alloc(size_t size, bool seperate) {
             mUsedSize += pointer.second;
             return pointer;
         }
+    }
+    if (nullptr != mTLSF && !mDisableHeuristicWhileAdapting) {
+        return mTLSF->alloc(size, seperate);
+    }
+    if (!seperate) {
         if (mName == "dynamic" && mCurrentFreeList == nullptr) {
             MNN_DEBUG_PRINT("\ttry get %lu bytes dynamic memory\n", UP_DIV(size, mAlign) * mAlign)
         }
@@ -127,6 +133,9 @@ std::pair<void*, size_t> BufferAllocator::alloc(size_t size, bool seperate) {
 
 void BufferAllocator::setHeuristicStrategy(std::string model, int batch, int bgt, bool alignBottom, bool needAlloc) {
     release();
+    mHeuristicBundle = nullptr;
+    mHeuristicRung = -1;
+    mHeuristicStale = false;
     char filename[100];
     if (alignBottom) {
         sprintf(filename, "heuristic/allocation/%s/%s.address.txt", model.c_str(), model.c_str());
@@ -157,10 +166,47 @@ void BufferAllocator::setHeuristicStrategy(std::string model, int batch, int bgt
     }
 }
 
+void BufferAllocator::setHeuristicBundle(std::shared_ptr<PlanBundle> bundle, int rung, bool needAlloc) {
+    auto size = bundle->maxSize(rung);
+    mHeuristicStrategy.clear();
+    mHeuristicBundle = std::move(bundle);
+    mHeuristicRung = rung;
+    mHeuristicStale = false;
+    MNN_DEBUG_PRINT("%s: %s: rung = %d, maxsize = %lu\n", mName.c_str(), __FUNCTION__ , rung, size)
+    if (nullptr != mHeuristicPtr && size == mHeuristicSize) {
+        return;
+    }
+    // a smaller rung gives the difference back, the point of switching down under memory pressure
+    release();
+    mHeuristicSize = size;
+    if (mHeuristicSize && needAlloc) {
+        auto heuristicPool = alloc(mHeuristicSize);
+        mHeuristicPtr = heuristicPool.first;
+        MNN_DEBUG_PRINT("%s: alloc mHeuristicPtr = %p\n", __FUNCTION__, mHeuristicPtr)
+    }
+}
+
+bool BufferAllocator::hasHeuristicPlan() const {
+    return nullptr != mHeuristicBundle || !mHeuristicStrategy.empty();
+}
+
+size_t BufferAllocator::heuristicOffset(const std::string& id) const {
+    size_t offset = 0, size = 0;
+    if (nullptr != mHeuristicBundle) {
+        mHeuristicBundle->lookup(mHeuristicRung, id, offset, size);
+        return offset;
+    }
+    auto iter = mHeuristicStrategy.find(id);
+    if (iter != mHeuristicStrategy.end()) {
+        offset = iter->second;
+    }
+    return offset;
+}
+
 std::pair<void*, size_t> BufferAllocator::allocHeuristically(std::string id, size_t size) {
     MNN_DEBUG_PRINT("\t%s: call %s\n",mName.c_str(), __FUNCTION__ )
 //    debugUsage(__LINE__);
-    if (mHeuristicStrategy.empty() || mDisableHeuristicWhileAdapting) {
+    if (!hasHeuristicPlan() || mDisableHeuristicWhileAdapting) {
         MNN_DEBUG_PRINT("\tmHeuristicStrategy is empty, return alloc()\n")
         return alloc(size, false);
     }
@@ -173,16 +219,32 @@ std::pair<void*, size_t> BufferAllocator::allocHeuristically(std::string id, siz
     if (mName == "dynamic" && mCurrentFreeList == nullptr) {
         debugUsage(__LINE__);
         MNN_DEBUG_PRINT("\ttry get %lu bytes dynamic.heuristic memory at pos [%lu, %lu) %c %lu\n",
-                        size, mHeuristicStrategy[id], size + mHeuristicStrategy[id], size + mHeuristicStrategy[id] < mHeuristicSize ? '<' : '>', mHeuristicSize)
+                        size, heuristicOffset(id), size + heuristicOffset(id), size + heuristicOffset(id) < mHeuristicSize ? '<' : '>', mHeuristicSize)
     }
 #endif
+    if (nullptr != mHeuristicBundle && !mHeuristicStale) {
+        size_t offset = 0, planned = 0;
+        if (mHeuristicBundle->lookup(mHeuristicRung, id, offset, planned) && planned > 0 && size > planned) {
+            // the graph changed since the plan was generated, placing this tensor would overlap its neighbours
+            MNN_ERROR("%s: tensor %s needs %lu bytes but the plan reserves %lu, drop the plan\n", mName.c_str(), id.c_str(), size, planned);
+            mHeuristicStale = true;
+        }
+    }
+    if (mHeuristicStale) {
+        return alloc(size, false);
+    }
     mAllocatedSize[id] = size;
-    return std::make_pair(mHeuristicPtr, std::min(mHeuristicStrategy[id], mHeuristicSize - size));
+    return std::make_pair(mHeuristicPtr, std::min(heuristicOffset(id), mHeuristicSize - size));
 }
 
 bool BufferAllocator::freeHeuristically(std::string id, std::pair<void*, size_t> pointer) {
     MNN_DEBUG_PRINT("\tcall %s\n", __FUNCTION__ )
-    if (mHeuristicStrategy.empty() || mDisableHeuristicWhileAdapting) {
+    if (mHeuristicStale && mUsedList.find(pointer) == mUsedList.end() &&
+        (nullptr == mTLSF || 0 == mTLSF->blockSize(pointer))) {
+        // placed by the plan before it was dropped, lives as long as the pool
+        return true;
+    }
+    if (!hasHeuristicPlan() || mDisableHeuristicWhileAdapting || mHeuristicStale) {
         return free(pointer);
     } else {
         MNN_DEBUG_PRINT("\ttry return %lu bytes to heuristic pool\n", mAllocatedSize[id])
@@ -202,7 +264,7 @@ bool BufferAllocator::freeToOS(std::pair<void*, size_t> ptr) {
 
 void BufferAllocator::returnMemory(FREELIST* listP, std::shared_ptr<Node> node, bool permitMerge) {
 //    MNN_PRINT("\tcall %s: %s\n", mName.c_str(), __FUNCTION__ )
-    if (*listP == mFreeList && mName == "dynamic") {
+    if (listP == &mFreeList && mName == "dynamic") {
         MNN_DEBUG_PRINT("\ttry return %lu bytes to freelist\n", node->size)
     }
 
@@ -242,6 +304,9 @@ bool BufferAllocator::free(std::pair<void*, size_t> pointer) {
     MNN_DEBUG_PRINT("\t%s: call %s\n", mName.c_str(), __FUNCTION__ )
     auto x = mUsedList.find(pointer);
     if (x == mUsedList.end()) {
+        if (nullptr != mTLSF) {
+            return freeToTLSF(pointer);
+        }
         MNN_ASSERT(false);
         return false;
     }
@@ -251,6 +316,8 @@ bool BufferAllocator::free(std::pair<void*, size_t> pointer) {
     mUsedList.erase(x);
     if (nullptr != mCurrentFreeList) {
         returnMemory(mCurrentFreeList, node, false);
+    } else if (nullptr != mTLSF && node->outside == mTLSF.get()) {
+        // a block held by a group, dropping the node gives it back to the size classes
     } else {
         returnMemory(&mFreeList, node);
     }
@@ -262,6 +329,42 @@ bool BufferAllocator::free(std::pair<void*, size_t> pointer) {
     return true;
 }
 
+bool BufferAllocator::freeToTLSF(std::pair<void*, size_t> pointer) {
+    if (nullptr == mCurrentFreeList) {
+        mTLSF->onRelease(pointer);
+        return true;
+    }
+    // other groups may still use the memory, keep it in this group until barrierEnd
+    auto size = mTLSF->blockSize(pointer);
+    if (0 == size) {
+        MNN_ASSERT(false);
+        return false;
+    }
+    std::shared_ptr<Node> node(new Node);
+    node->size    = size;
+    node->pointer = pointer;
+    node->outside = mTLSF.get();
+    returnMemory(mCurrentFreeList, node, false);
+    return true;
+}
+
+void BufferAllocator::setEngine(Engine engine) {
+    MNN_ASSERT(mGroups.empty());
+    release();
+    if (ENGINE_TLSF == engine) {
+        mTLSF.reset(new TLSFAllocator(mAllocator, mAlign));
+    } else {
+        mTLSF = nullptr;
+    }
+}
+
+size_t BufferAllocator::totalSize() const {
+    if (nullptr != mTLSF) {
+        return mTotalSize + mTLSF->totalSize();
+    }
+    return mTotalSize;
+}
+
 void BufferAllocator::debugUsage(int line) const {
 #ifdef DEBUG_EXECUTION_DETAIL
     size_t used_size = 0, free_size = 0;
@@ -278,6 +381,9 @@ void BufferAllocator::debugUsage(int line) const {
 }
 size_t BufferAllocator::usedSize() const {
     MNN_DEBUG_PRINT("\tbefore return usedSize(), mUsedSize = %lu\n", mUsedSize)
+    if (nullptr != mTLSF) {
+        return mUsedSize + mTLSF->usedSize();
+    }
     return mUsedSize;
 }
 
@@ -288,10 +394,16 @@ void BufferAllocator::release(bool allRelease) {
     if (allRelease) {
         mUsedList.clear();
         mFreeList.clear();
+        if (nullptr != mTLSF) {
+            mTLSF->releaseAll();
+        }
         mTotalSize = 0;
         mUsedSize = 0;
         return;
     }
+    if (nullptr != mTLSF) {
+        mTLSF->releaseFree();
+    }
     for (auto f : mFreeList) {
         if (f.second->parent == nullptr) {
             MNN_ASSERT(mTotalSize >= f.first);
@@ -308,6 +420,11 @@ void BufferAllocator::barrierBegin() {
 }
 
 void BufferAllocator::barrierEnd() {
+    if (nullptr != mTLSF) {
+        // the nodes of the groups give their blocks back on destruction
+        mGroups.clear();
+        return;
+    }
     for (auto& freeGroup : mGroups) {
         auto freeList = *freeGroup;
         for (auto& iter : freeList) {
@@ -395,7 +512,7 @@ std::pair<void*, size_t> BufferAllocator::getFromFreeList(FREELIST* list, size_t
 std::vector<Tensor*> BufferAllocator::moveTensor2bottom(std::vector<Tensor *> tensorList, size_t bgt_new_mb) {
     std::sort(tensorList.begin(), tensorList.end(),
               [this](Tensor* a, Tensor* b) {
-                  return mHeuristicStrategy[std::to_string(a->cacheID())] < mHeuristicStrategy[std::to_string(b->cacheID())];
+                  return heuristicOffset(std::to_string(a->cacheID())) < heuristicOffset(std::to_string(b->cacheID()));
               }
     );
     // TODO: realloc doen not work, just simulate
@@ -405,7 +522,7 @@ std::vector<Tensor*> BufferAllocator::moveTensor2bottom(std::vector<Tensor *> te
     mTotalSize = mHeuristicSize;
     shrinkPointer = 0;
     for (auto t: tensorList) {
-        if (mHeuristicStrategy[std::to_string(t->cacheID())] + t->size() < mHeuristicSize) {
+        if (heuristicOffset(std::to_string(t->cacheID())) + t->size() < mHeuristicSize) {
 //            MNN_DEBUG_PRINT("\t before memcpy\n")
             memcpy((uint8_t*)mHeuristicPtr + shrinkPointer, t->host<uint8_t>(), t->size());
 //            MNN_DEBUG_PRINT("\t before adaptHost\n")
@@ -441,7 +558,7 @@ std::vector<Tensor*> BufferAllocator::moveTensor2bottom(std::vector<Tensor *> te
 bool BufferAllocator::adaptTensorToNewAddress(std::vector<Tensor*> tensors) {
     std::sort(tensors.begin(), tensors.end(),
               [this](Tensor* a, Tensor* b) {
-                  return mHeuristicStrategy[std::to_string(a->cacheID())] < mHeuristicStrategy[std::to_string(b->cacheID())];
+                  return heuristicOffset(std::to_string(a->cacheID())) < heuristicOffset(std::to_string(b->cacheID()));
               }
     );
     MNN_DEBUG_PRINT("%s: moving recomputed tensors to bottom\n", __FUNCTION__)
@@ -456,7 +573,7 @@ bool BufferAllocator::adaptTensorToNewAddress(std::vector<Tensor*> tensors) {
     // 按照新的策略重新排布
     for(auto iter = tensors.rbegin(); iter != tensors.rend(); iter++) {
         auto t = *iter;
-        memcpy((uint8_t*)mHeuristicPtr + mHeuristicStrategy[std::to_string(t->cacheID())], t->host<uint8_t>(), t->size());
+        memcpy((uint8_t*)mHeuristicPtr + heuristicOffset(std::to_string(t->cacheID())), t->host<uint8_t>(), t->size());
     }
     // remove nodes due to recompute for adaptiveness
     mFreeList.clear();
@@ -18,11 +18,13 @@
 #include <algorithm>
 #include "MNNMemoryUtils.h"
 #include "NonCopyable.hpp"
+#include "PlanBundle.hpp"
 #include <MNN/Tensor.hpp>
 #define TEST() printf("test\n");
 
 
 namespace MNN {
+class TLSFAllocator;
 
 /** memory utils wrapper. provides memory reusing with alignment ability. */
 class MNN_PUBLIC BufferAllocator : public NonCopyable {
@@ -36,6 +38,12 @@ public:
         static std::shared_ptr<Allocator> createDefault();
         static std::shared_ptr<Allocator> createRecurse(BufferAllocator* parent);
     };
+    enum Engine {
+        // size ordered free list, split chunks are merged back when all of their parts are freed
+        ENGINE_TREE = 0,
+        // size classes of TLSFAllocator, freed blocks merge with their address neighbours at once
+        ENGINE_TLSF = 1,
+    };
     /**
      * @brief init buffer allocator with pointer alignment.
      * @param align given pointer alignment.
@@ -89,9 +97,7 @@ public:
      * @brief query total size allocated indeed.
      * @return total size allocated indeed.
      */
-    size_t totalSize() const {
-        return mTotalSize;
-    }
+    size_t totalSize() const;
     size_t usedSize() const ;
 
     void debugUsage(int line) const;
@@ -111,7 +117,14 @@ public:
     void setName(std::string name) {
         mName = std::move(name);
     }
+    /**
+     * @brief choose how the freed memory is kept for reusing, all memory is released before switching.
+     * the heuristic plans and their adapting keep the tree engine.
+     */
+    void setEngine(Engine engine);
     void setHeuristicStrategy(std::string model, int batch, int bgt, bool alignBottom=false, bool needAlloc=true);
+    // use one rung of a mapped plan bundle, the pool is allocated again for a rung of another size
+    void setHeuristicBundle(std::shared_ptr<PlanBundle> bundle, int rung, bool needAlloc=true);
     //move all tensor to bottom first and move them to the exact address after adaptiveness
     std::vector<Tensor*> moveTensor2bottom(std::vector<Tensor*> tensors, size_t bgt_new);
     bool adaptTensorToNewAddress(std::vector<Tensor*> tensors);
@@ -138,6 +151,9 @@ private:
 
     void returnMemory(FREELIST* list, std::shared_ptr<Node> node, bool permitMerge = true);
     std::pair<void*, size_t> getFromFreeList(FREELIST* list, size_t size, bool permiteSplit = true);
+    bool freeToTLSF(std::pair<void*, size_t> pointer);
+    bool hasHeuristicPlan() const;
+    size_t heuristicOffset(const std::string& id) const;
 
     std::map<std::pair<void*, size_t>, std::shared_ptr<Node>> mUsedList;
     FREELIST mFreeList;
@@ -146,12 +162,17 @@ private:
     FREELIST* mCurrentFreeList = nullptr;
     std::vector<std::shared_ptr<FREELIST>> mGroups;
     std::shared_ptr<Allocator> mAllocator;
+    std::shared_ptr<TLSFAllocator> mTLSF;
     int mAlign;
     std::string mName = "static";
     std::map<std::string, size_t> mHeuristicStrategy;
     std::map<std::string, size_t> mAllocatedSize;
-    void* mHeuristicPtr;
-    size_t mHeuristicSize;
+    std::shared_ptr<PlanBundle> mHeuristicBundle;
+    int mHeuristicRung = -1;
+    // set when an allocation outgrows its planned size, the rest of the plan is not trusted anymore
+    bool mHeuristicStale = false;
+    void* mHeuristicPtr = nullptr;
+    size_t mHeuristicSize = 0;
     bool mDisableHeuristicWhileAdapting = false;
     std::vector<Tensor*> tensorReversedAfterShrink;
     size_t shrinkPointer;
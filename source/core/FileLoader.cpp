@@ -10,6 +10,10 @@
 #if defined(_MSC_VER)
 #include "Windows.h"
 #endif
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 namespace MNN {
 FileLoader::FileLoader(const char* file) {
 #if defined(_MSC_VER)
@@ -35,6 +39,11 @@ FileLoader::~FileLoader() {
     if (nullptr != mFile) {
         fclose(mFile);
     }
+#if !defined(_WIN32)
+    if (nullptr != mMapped) {
+        munmap(mMapped, mTotalSize);
+    }
+#endif
     for (auto iter : mBlocks) {
         MNNMemoryFreeAlign(iter.second);
     }
@@ -72,6 +81,28 @@ bool FileLoader::read() {
     return true;
 }
 
+bool FileLoader::map() {
+#if defined(_WIN32)
+    return false;
+#else
+    if (nullptr == mFile || nullptr != mMapped) {
+        return nullptr != mMapped;
+    }
+    auto fd = fileno(mFile);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        return false;
+    }
+    auto ptr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == ptr) {
+        return false;
+    }
+    mMapped    = (uint8_t*)ptr;
+    mTotalSize = st.st_size;
+    return true;
+#endif
+}
+
 bool FileLoader::merge(AutoStorage<uint8_t>& buffer) {
     buffer.reset((int)mTotalSize);
     if (buffer.get() == nullptr) {
@@ -6,6 +6,9 @@
 //  Copyright © 2018, Alibaba Group Holding Limited
 //
 
+#ifndef FileLoader_hpp
+#define FileLoader_hpp
+
 #include <vector>
 #include "core/AutoStorage.h"
 namespace MNN {
@@ -17,12 +20,23 @@ public:
 
     bool read();
 
+    /**
+     * @brief map the whole file private and writable instead of reading it. Pages stay in the page cache
+     * until they are written, a write copies only the touched page, the file is never modified.
+     * @return false if mapping is not supported or failed, use read() and merge() then.
+     */
+    bool map();
+
     bool valid() const {
         return mFile != nullptr;
     }
     inline size_t size() const {
         return mTotalSize;
     }
+    /** file content after a successful map(), nullptr otherwise */
+    uint8_t* mapped() const {
+        return mMapped;
+    }
 
     bool merge(AutoStorage<uint8_t>& buffer);
 
@@ -31,5 +45,8 @@ private:
     FILE* mFile                 = nullptr;
     static const int gCacheSize = 4096;
     size_t mTotalSize           = 0;
+    uint8_t* mMapped            = nullptr;
 };
 } // namespace MNN
+
+#endif /* FileLoader_hpp */
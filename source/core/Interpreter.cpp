@@ -22,6 +22,8 @@ namespace MNN {
 
 struct Content {
     AutoStorage<uint8_t> buffer;
+    // set instead of buffer when the model file is memory-mapped
+    std::unique_ptr<FileLoader> mapped;
     const Net* net = nullptr;
     std::vector<std::unique_ptr<Session>> sessions;
     std::map<const Tensor*, const Session*> tensorMap;
@@ -31,6 +33,13 @@ struct Content {
     size_t cacheOffset = 0;
     std::string cacheFile;
     std::mutex lock;
+
+    const uint8_t* modelBuffer() const {
+        return nullptr != mapped ? mapped->mapped() : buffer.get();
+    }
+    size_t modelSize() const {
+        return nullptr != mapped ? mapped->size() : buffer.size();
+    }
 };
 
 Interpreter* Interpreter::createFromFile(const char* file) {
@@ -43,18 +52,26 @@ Interpreter* Interpreter::createFromFile(const char* file) {
         MNN_PRINT("Create interpreter failed, open %s error\n", file);
         return nullptr;
     }
+    auto net = new Content;
+    if (loader->map()) {
+        // weights stay in the page cache instead of being copied
+        net->mapped = std::move(loader);
+        return createFromBufferInternal(net);
+    }
     bool result = loader->read();
     if (!result) {
         MNN_PRINT("Read file error\n");
+        delete net;
         return nullptr;
     }
     if (loader->size() == 0) {
         MNN_PRINT("Create interpreter failed, %s is empty\n", file);
+        delete net;
         return nullptr;
     }
-    auto net     = new Content;
     bool success = loader->merge(net->buffer);
     if (!success) {
+        delete net;
         return nullptr;
     }
     loader.reset();
@@ -81,13 +98,13 @@ Interpreter* Interpreter::createFromBufferInternal(Content* net) {
         MNN_PRINT("Buffer is null for create interpreter\n");
         return nullptr;
     }
-    flatbuffers::Verifier verify((const uint8_t*)(net->buffer.get()), net->buffer.size());
+    flatbuffers::Verifier verify(net->modelBuffer(), net->modelSize());
     if (false == VerifyNetBuffer(verify)) {
         MNN_PRINT("Invalidate buffer to create interpreter\n");
         delete net;
         return nullptr;
     }
-    net->net = GetNet(net->buffer.get());
+    net->net = GetNet(net->modelBuffer());
     if (nullptr == net->net->oplists()) {
         MNN_ERROR("Model has no oplist\n");
         delete net;
@@ -114,12 +131,12 @@ void Interpreter::setSessionMode(SessionMode mode) {
 }
 
 void Interpreter::setCacheFile(const char* cacheFile, size_t keySize) {
-    if (nullptr == cacheFile || nullptr == mNet->buffer.get()) {
+    if (nullptr == cacheFile || nullptr == mNet->modelBuffer()) {
         MNN_ERROR("Empty cacheFile or the interpreter invalid\n");
         return;
     }
     mNet->cacheFile   = std::string(cacheFile);
-    mNet->cacheOffset = mNet->buffer.size() > keySize ? keySize : mNet->buffer.size();
+    mNet->cacheOffset = mNet->modelSize() > keySize ? keySize : mNet->modelSize();
     std::unique_ptr<FileLoader> loader(new FileLoader(cacheFile));
     if (!loader->valid()) {
         MNN_ERROR("Load Cache file error.\n");
@@ -139,7 +156,7 @@ void Interpreter::setCacheFile(const char* cacheFile, size_t keySize) {
         MNN_ERROR("Alloc memory for Cache error.\n");
         return;
     }
-    if (0 != ::memcmp(mNet->cacheBuffer.get(), mNet->buffer.get(), mNet->cacheOffset)) {
+    if (0 != ::memcmp(mNet->cacheBuffer.get(), mNet->modelBuffer(), mNet->cacheOffset)) {
         MNN_ERROR("Cache model file key does not match.\n");
         mNet->cacheBuffer.release();
         return;
@@ -171,7 +188,7 @@ Session* Interpreter::createMultiPathSession(const std::vector<ScheduleConfig>&
 }
 
 Session* Interpreter::createMultiPathSession(const std::vector<ScheduleConfig>& configs, const RuntimeInfo& runtime) {
-    if (nullptr == mNet->buffer.get()) {
+    if (nullptr == mNet->modelBuffer()) {
         MNN_ERROR("The model buffer has been released. Can't create session\n");
         return nullptr;
     }
@@ -210,7 +227,7 @@ Session* Interpreter::createMultiPathSession(const std::vector<ScheduleConfig>&
                     break;
                 }
                 // Write key
-                auto tsize = fwrite((const char*)mNet->buffer.get(), 1, mNet->cacheOffset, f);
+                auto tsize = fwrite((const char*)mNet->modelBuffer(), 1, mNet->cacheOffset, f);
                 if (tsize != mNet->cacheOffset) {
                     MNN_ERROR("Write %s error\n", mNet->cacheFile.c_str());
                     break;
@@ -313,7 +330,7 @@ const std::map<std::string, Tensor*>& Interpreter::getSessionOutputAll(const Ses
 
 void Interpreter::resizeSession(Session* session) {
     std::unique_lock<std::mutex> _l(mNet->lock);
-    if (mNet->buffer.get() == nullptr) {
+    if (mNet->modelBuffer() == nullptr) {
         MNN_ERROR("The model buffer has been released. Can't resize session\n");
         return;
     }
@@ -345,6 +362,7 @@ const Backend* Interpreter::getBackend(const Session* session, const Tensor* ten
 void Interpreter::releaseModel() {
     std::unique_lock<std::mutex> _l(mNet->lock);
     mNet->buffer.release();
+    mNet->mapped.reset();
     mNet->cacheBuffer.release();
 }
 
@@ -391,11 +409,11 @@ const char* Interpreter::bizCode() const {
 }
 
 std::pair<const void*, size_t> Interpreter::getModelBuffer() const {
-    return std::make_pair(mNet->buffer.get(), mNet->buffer.size());
+    return std::make_pair(mNet->modelBuffer(), mNet->modelSize());
 }
 ErrorCode Interpreter::updateSessionToModel(Session* session) {
     std::unique_lock<std::mutex> _l(mNet->lock);
-    if (mNet->buffer.get() == nullptr) {
+    if (mNet->modelBuffer() == nullptr) {
         MNN_ERROR("Can't updateSessionToModel because you called releaseModel before\n");
         return INPUT_DATA_ERROR;
     }
@@ -120,6 +120,10 @@ Pipeline::Pipeline(std::vector<Schedule::PipelineInfo>&& infos, std::shared_ptr<
     mBackend       = backend;
     mAllocInput    = allocInput;
     mInfo          = std::move(infos);
+#ifndef MNN_BUILD_MINI
+    mContext.setPermitRegionInput(MNN_FORWARD_CPU == backend->type());
+    mContext.setPermitWeightInput(MNN_FORWARD_CPU == backend->type());
+#endif
     GeometryComputerUtils::buildConstantTensors(mInfo, mBackupBackend, !mAllocInput, mConstTensors, mMidConstTensors);
 }
 void Pipeline::cloneExecution(const std::map<const Op*, std::shared_ptr<Execution>>& cache) {
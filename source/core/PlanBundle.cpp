@@ -0,0 +1,268 @@
+//
+//  PlanBundle.cpp
+//  MNN
+//
+//  Created by MNN on 2021/07/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "core/PlanBundle.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "Plan_generated.h"
+#include "core/Macro.h"
+
+namespace MNN {
+
+static const int gPlanVersion = 2;
+
+// indexed by MemoryPlanAction, names are the ones used in *.execution.txt
+static const char* gActionNames[] = {"compute", "recompute", "release", "rerelease", "re-release", "pre-release", "swap-out", "swap-in"};
+static const int gActionCount     = sizeof(gActionNames) / sizeof(gActionNames[0]);
+
+static bool _parseId(const std::string& id, int32_t& op, int32_t& resize) {
+    char* end = nullptr;
+    op        = (int32_t)strtol(id.c_str(), &end, 10);
+    if (end == id.c_str()) {
+        return false;
+    }
+    resize = -1;
+    if (*end == ':') {
+        resize = (int32_t)strtol(end + 1, nullptr, 10);
+    }
+    return true;
+}
+
+static bool _addressLess(const MemoryPlanAddress& a, const MemoryPlanAddress& b) {
+    return a.op() < b.op() || (a.op() == b.op() && a.resize() < b.resize());
+}
+
+PlanBundle::~PlanBundle() {
+#if !defined(_WIN32)
+    if (mMapped && nullptr != mBase) {
+        munmap((void*)mBase, mSize);
+    }
+#endif
+}
+
+std::string PlanBundle::defaultPath(const std::string& model, int batch) {
+    return "heuristic/bundle/" + model + "/" + model + "." + std::to_string(batch) + ".bundle";
+}
+
+std::string PlanBundle::planPath(const std::string& model, int batch, int budgetMB) {
+    return "heuristic/plan/" + model + "/" + model + "." + std::to_string(batch) + "." + std::to_string(budgetMB) + ".plan";
+}
+
+uint64_t PlanBundle::fingerprint(const std::vector<int>& opTypes) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (auto type : opTypes) {
+        if (type < 0) {
+            return 0;
+        }
+        for (int i = 0; i < 4; ++i) {
+            hash ^= (uint64_t)((type >> (i * 8)) & 0xff);
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+std::shared_ptr<PlanBundle> PlanBundle::load(const std::string& path) {
+    std::shared_ptr<PlanBundle> bundle(new PlanBundle);
+#if !defined(_WIN32)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        MNN_DEBUG_PRINT("%s: can't open %s\n", __FUNCTION__, path.c_str())
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+    auto ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == ptr) {
+        return nullptr;
+    }
+    bundle->mBase   = (const uint8_t*)ptr;
+    bundle->mSize   = st.st_size;
+    bundle->mMapped = true;
+#else
+    std::ifstream ifs(path, std::ios::in | std::ios::binary);
+    if (!ifs.is_open()) {
+        return nullptr;
+    }
+    bundle->mCopy.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    bundle->mBase = bundle->mCopy.data();
+    bundle->mSize = bundle->mCopy.size();
+#endif
+    if (!bundle->parse()) {
+        MNN_ERROR("%s: %s is not a valid plan of version %d\n", __FUNCTION__, path.c_str(), gPlanVersion);
+        return nullptr;
+    }
+    return bundle;
+}
+
+bool PlanBundle::parse() {
+    flatbuffers::Verifier verify(mBase, mSize);
+    if (!VerifyMemoryPlanBuffer(verify)) {
+        return false;
+    }
+    mPlan = GetMemoryPlan(mBase);
+    if (mPlan->version() != gPlanVersion || nullptr == mPlan->rungs()) {
+        return false;
+    }
+    for (auto rung : *mPlan->rungs()) {
+        if (nullptr == rung->address() || nullptr == rung->sequence()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PlanBundle::save(const std::string& path, const std::string& model, int batch, const std::vector<int>& opTypes,
+                      std::vector<PlanRung> rungs) {
+    std::sort(rungs.begin(), rungs.end(),
+              [](const PlanRung& a, const PlanRung& b) { return a.budgetMB < b.budgetMB; });
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<flatbuffers::Offset<MemoryPlanRung>> rungOffsets;
+    for (auto& rung : rungs) {
+        std::vector<MemoryPlanAddress> addresses;
+        for (auto& iter : rung.address) {
+            int32_t op, resize;
+            if (!_parseId(iter.first, op, resize)) {
+                continue;
+            }
+            size_t size = 0;
+            auto sizeIter = rung.size.find(iter.first);
+            if (sizeIter != rung.size.end()) {
+                size = sizeIter->second;
+            }
+            addresses.emplace_back(op, resize, iter.second, size);
+        }
+        std::sort(addresses.begin(), addresses.end(), _addressLess);
+        std::vector<MemoryPlanStep> steps;
+        for (auto& step : rung.sequence) {
+            int action = -1;
+            for (int a = 0; a < gActionCount; ++a) {
+                if (step.first == gActionNames[a]) {
+                    action = a;
+                    break;
+                }
+            }
+            if (action < 0) {
+                MNN_ERROR("%s: unknown action %s\n", __FUNCTION__, step.first.c_str());
+                return false;
+            }
+            steps.emplace_back((MemoryPlanAction)action, step.second);
+        }
+        auto addressOffset  = builder.CreateVectorOfStructs(addresses);
+        auto sequenceOffset = builder.CreateVectorOfStructs(steps);
+        rungOffsets.emplace_back(CreateMemoryPlanRung(builder, rung.budgetMB, rung.maxSize, addressOffset, sequenceOffset));
+    }
+    auto modelOffset = builder.CreateString(model);
+    auto rungsOffset = builder.CreateVector(rungOffsets);
+    auto plan = CreateMemoryPlan(builder, gPlanVersion, modelOffset, batch, (int)opTypes.size(), fingerprint(opTypes), rungsOffset);
+    FinishMemoryPlanBuffer(builder, plan);
+
+    std::ofstream ofs(path, std::ios::out | std::ios::binary);
+    if (!ofs.is_open()) {
+        MNN_ERROR("%s: can't open %s\n", __FUNCTION__, path.c_str());
+        return false;
+    }
+    ofs.write((const char*)builder.GetBufferPointer(), builder.GetSize());
+    ofs.close();
+    return true;
+}
+
+size_t PlanBundle::availableMemoryMB() {
+    std::ifstream ifs("/proc/meminfo", std::ios::in);
+    std::string key;
+    size_t value;
+    std::string unit;
+    while (ifs >> key >> value >> unit) {
+        if (key == "MemAvailable:") {
+            return value >> 10;
+        }
+    }
+    return 0;
+}
+
+bool PlanBundle::matchGraph(const std::vector<int>& opTypes) const {
+    if (mPlan->opCount() != (int)opTypes.size()) {
+        return false;
+    }
+    // 0 means the generator didn't know the op types, only the op count can be checked
+    return 0 == mPlan->fingerprint() || mPlan->fingerprint() == fingerprint(opTypes);
+}
+
+int PlanBundle::rungCount() const {
+    return (int)mPlan->rungs()->size();
+}
+
+size_t PlanBundle::budgetMB(int rung) const {
+    return mPlan->rungs()->Get(rung)->budgetMB();
+}
+
+size_t PlanBundle::maxSize(int rung) const {
+    return mPlan->rungs()->Get(rung)->maxSize();
+}
+
+int PlanBundle::selectRung(size_t availableMB) const {
+    int count = rungCount();
+    if (0 == count) {
+        return -1;
+    }
+    int selected = 0;
+    for (int i = 0; i < count; ++i) {
+        if (budgetMB(i) <= availableMB) {
+            selected = i;
+        }
+    }
+    return selected;
+}
+
+bool PlanBundle::lookup(int rung, const std::string& id, size_t& offset, size_t& size) const {
+    int32_t op, resize;
+    if (!_parseId(id, op, resize)) {
+        return false;
+    }
+    MemoryPlanAddress key(op, resize, 0, 0);
+    auto address = mPlan->rungs()->Get(rung)->address();
+    auto begin   = reinterpret_cast<const MemoryPlanAddress*>(address->Data());
+    auto end     = begin + address->size();
+    auto iter    = std::lower_bound(begin, end, key, _addressLess);
+    if (iter == end || iter->op() != op || iter->resize() != resize) {
+        return false;
+    }
+    offset = iter->offset();
+    size   = iter->size();
+    return true;
+}
+
+void PlanBundle::loadSequence(int rung, std::vector<std::pair<std::string, int>>& sequence) const {
+    auto steps = mPlan->rungs()->Get(rung)->sequence();
+    sequence.clear();
+    sequence.reserve(steps->size());
+    for (auto step : *steps) {
+        auto action = (int)step->action();
+        if (action < 0 || action >= gActionCount) {
+            continue;
+        }
+        sequence.emplace_back(gActionNames[action], step->op());
+    }
+}
+
+} // namespace MNN
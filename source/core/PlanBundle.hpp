@@ -0,0 +1,101 @@
+//
+//  PlanBundle.hpp
+//  MNN
+//
+//  Created by MNN on 2021/07/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef PlanBundle_hpp
+#define PlanBundle_hpp
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <MNN/MNNDefine.h>
+#include "core/NonCopyable.hpp"
+
+namespace MNN {
+struct MemoryPlan;
+
+/** one budget of a plan ladder, as produced by the offline generator */
+struct PlanRung {
+    size_t budgetMB = 0;
+    size_t maxSize  = 0;
+    /** heuristic id ("op" or "op:resize") -> offset inside the pool */
+    std::map<std::string, size_t> address;
+    /** heuristic id -> planned size, an allocation larger than this means the plan is stale */
+    std::map<std::string, size_t> size;
+    /** (action, op index) pairs, same content as *.execution.txt */
+    std::vector<std::pair<std::string, int>> sequence;
+};
+
+/**
+ * @brief a ladder of (allocation, execution) plans for one model/batch, each generated under a
+ * different memory budget. All rungs live in one memory-mapped MemoryPlan flatbuffer (schema/default/Plan.fbs)
+ * so that switching between them at an iteration boundary costs a binary search instead of re-reading and
+ * re-parsing text plans. A single-budget plan is a bundle with one rung.
+ */
+class MNN_PUBLIC PlanBundle : public NonCopyable {
+public:
+    ~PlanBundle();
+
+    /**
+     * @brief map a bundle file.
+     * @param path bundle file path.
+     * @return bundle or nullptr if the file is missing or malformed.
+     */
+    static std::shared_ptr<PlanBundle> load(const std::string& path);
+    /**
+     * @brief write rungs to a bundle file, rungs are sorted by budget.
+     * @param opTypes op type of every command the plan was generated for, -1 if unknown.
+     * @return success or not.
+     */
+    static bool save(const std::string& path, const std::string& model, int batch, const std::vector<int>& opTypes,
+                     std::vector<PlanRung> rungs);
+    static std::string defaultPath(const std::string& model, int batch);
+    static std::string planPath(const std::string& model, int batch, int budgetMB);
+    /**
+     * @brief hash of the op types of a command buffer, 0 if any type is unknown.
+     */
+    static uint64_t fingerprint(const std::vector<int>& opTypes);
+    /**
+     * @brief memory the OS can still hand out, in MB. 0 if unknown.
+     */
+    static size_t availableMemoryMB();
+
+    /**
+     * @brief check the plan was generated for a graph with these op types.
+     */
+    bool matchGraph(const std::vector<int>& opTypes) const;
+    int rungCount() const;
+    size_t budgetMB(int rung) const;
+    size_t maxSize(int rung) const;
+    /**
+     * @brief pick the largest rung whose budget fits into availableMB, or the smallest rung if none fits.
+     */
+    int selectRung(size_t availableMB) const;
+    /**
+     * @brief find the pool offset and planned size of a heuristic id in a rung.
+     * @return false if the id is not planned in that rung.
+     */
+    bool lookup(int rung, const std::string& id, size_t& offset, size_t& size) const;
+    void loadSequence(int rung, std::vector<std::pair<std::string, int>>& sequence) const;
+
+private:
+    PlanBundle() = default;
+    bool parse();
+
+    const uint8_t* mBase    = nullptr;
+    size_t mSize            = 0;
+    bool mMapped            = false;
+    const MemoryPlan* mPlan = nullptr;
+    std::vector<uint8_t> mCopy;
+};
+
+} // namespace MNN
+
+#endif /* PlanBundle_hpp */
@@ -0,0 +1,243 @@
+//
+//  TLSFAllocator.cpp
+//  MNN
+//
+//  Created by MNN on 2021/07/28.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "core/TLSFAllocator.hpp"
+#include "core/Macro.h"
+
+namespace MNN {
+// index of the highest / lowest set bit, value must not be 0
+static inline int _highBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int index = 0;
+    while (value >>= 1) {
+        index++;
+    }
+    return index;
+#endif
+}
+static inline int _lowBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    int index = 0;
+    while (0 == (value & 1)) {
+        value >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+TLSFAllocator::TLSFAllocator(std::shared_ptr<BufferAllocator::Allocator> parent, size_t align) : mParent(parent), mAlign(align) {
+    ::memset(mSLBitmap, 0, sizeof(mSLBitmap));
+    ::memset(mFreeHeads, 0xff, sizeof(mFreeHeads));
+}
+
+TLSFAllocator::~TLSFAllocator() {
+    releaseAll();
+}
+
+// Sizes below SL_COUNT units have a class each, the larger ones split every power of two into SL_COUNT classes
+void TLSFAllocator::mapping(size_t units, int& fl, int& sl) const {
+    if (units < SL_COUNT) {
+        fl = 0;
+        sl = (int)units;
+        return;
+    }
+    auto high = _highBit(units);
+    fl        = high - SL_BITS + 1;
+    sl        = (int)(units >> (high - SL_BITS)) - SL_COUNT;
+}
+
+int TLSFAllocator::findFree(size_t size) const {
+    auto units = size / mAlign;
+    if (units >= SL_COUNT) {
+        // round up to the next class, so that any block in the found class fits
+        units += ((size_t)1 << (_highBit(units) - SL_BITS)) - 1;
+    }
+    int fl, sl;
+    mapping(units, fl, sl);
+    if (fl >= FL_COUNT) {
+        return -1;
+    }
+    uint32_t slMap = mSLBitmap[fl] & (~0u << sl);
+    if (0 == slMap) {
+        uint64_t flMap = fl + 1 < FL_COUNT ? mFLBitmap & (~(uint64_t)0 << (fl + 1)) : 0;
+        if (0 == flMap) {
+            return -1;
+        }
+        fl    = _lowBit(flMap);
+        slMap = mSLBitmap[fl];
+    }
+    return mFreeHeads[fl][_lowBit(slMap)];
+}
+
+void TLSFAllocator::insertFree(int index) {
+    auto& block = mBlocks[index];
+    int fl, sl;
+    mapping(block.size / mAlign, fl, sl);
+    block.free     = true;
+    block.prevFree = -1;
+    block.nextFree = mFreeHeads[fl][sl];
+    if (block.nextFree >= 0) {
+        mBlocks[block.nextFree].prevFree = index;
+    }
+    mFreeHeads[fl][sl] = index;
+    mSLBitmap[fl] |= 1u << sl;
+    mFLBitmap |= (uint64_t)1 << fl;
+}
+
+void TLSFAllocator::removeFree(int index) {
+    auto& block = mBlocks[index];
+    int fl, sl;
+    mapping(block.size / mAlign, fl, sl);
+    if (block.prevFree >= 0) {
+        mBlocks[block.prevFree].nextFree = block.nextFree;
+    } else {
+        mFreeHeads[fl][sl] = block.nextFree;
+    }
+    if (block.nextFree >= 0) {
+        mBlocks[block.nextFree].prevFree = block.prevFree;
+    }
+    if (mFreeHeads[fl][sl] < 0) {
+        mSLBitmap[fl] &= ~(1u << sl);
+        if (0 == mSLBitmap[fl]) {
+            mFLBitmap &= ~((uint64_t)1 << fl);
+        }
+    }
+    block.free = false;
+}
+
+void TLSFAllocator::absorb(int left, int right) {
+    auto& leftBlock  = mBlocks[left];
+    auto& rightBlock = mBlocks[right];
+    leftBlock.size += rightBlock.size;
+    leftBlock.nextPhys = rightBlock.nextPhys;
+    if (rightBlock.nextPhys >= 0) {
+        mBlocks[rightBlock.nextPhys].prevPhys = left;
+    }
+    rightBlock.size = 0;
+    mUnusedBlocks.push_back(right);
+}
+
+int TLSFAllocator::newBlock() {
+    if (!mUnusedBlocks.empty()) {
+        auto index = mUnusedBlocks.back();
+        mUnusedBlocks.pop_back();
+        mBlocks[index] = Block();
+        return index;
+    }
+    mBlocks.emplace_back();
+    return (int)mBlocks.size() - 1;
+}
+
+std::pair<void*, size_t> TLSFAllocator::alloc(size_t size, bool seperate) {
+    auto sizeAlign = UP_DIV(ALIMAX(size, (size_t)1), mAlign) * mAlign;
+    int index      = seperate ? -1 : findFree(sizeAlign);
+    if (index < 0) {
+        auto chunk = mParent->onAlloc(sizeAlign);
+        if (nullptr == chunk.first) {
+            return chunk;
+        }
+        index                  = newBlock();
+        mBlocks[index].pointer = chunk;
+        mBlocks[index].size    = sizeAlign;
+        mTotalSize += sizeAlign;
+    } else {
+        removeFree(index);
+        if (mBlocks[index].size - sizeAlign >= mAlign) {
+            // the rest stays free right after the block
+            auto rest          = newBlock();
+            auto& block        = mBlocks[index];
+            auto& restBlock    = mBlocks[rest];
+            restBlock.pointer  = std::make_pair(block.pointer.first, block.pointer.second + sizeAlign);
+            restBlock.size     = block.size - sizeAlign;
+            restBlock.prevPhys = index;
+            restBlock.nextPhys = block.nextPhys;
+            if (block.nextPhys >= 0) {
+                mBlocks[block.nextPhys].prevPhys = rest;
+            }
+            block.nextPhys = rest;
+            block.size     = sizeAlign;
+            insertFree(rest);
+        }
+    }
+    auto& block = mBlocks[index];
+    mUsedSize += block.size;
+    mUsedBlocks[block.pointer] = index;
+    return block.pointer;
+}
+
+void TLSFAllocator::onRelease(std::pair<void*, size_t> pointer) {
+    auto iter = mUsedBlocks.find(pointer);
+    if (iter == mUsedBlocks.end()) {
+        MNN_ASSERT(false);
+        return;
+    }
+    auto index = iter->second;
+    mUsedBlocks.erase(iter);
+    mUsedSize -= mBlocks[index].size;
+    // the left neighbour keeps its pointer when merged
+    auto prev = mBlocks[index].prevPhys;
+    if (prev >= 0 && mBlocks[prev].free) {
+        removeFree(prev);
+        absorb(prev, index);
+        index = prev;
+    }
+    auto next = mBlocks[index].nextPhys;
+    if (next >= 0 && mBlocks[next].free) {
+        removeFree(next);
+        absorb(index, next);
+    }
+    insertFree(index);
+}
+
+size_t TLSFAllocator::blockSize(std::pair<void*, size_t> pointer) const {
+    auto iter = mUsedBlocks.find(pointer);
+    if (iter == mUsedBlocks.end()) {
+        return 0;
+    }
+    return mBlocks[iter->second].size;
+}
+
+void TLSFAllocator::releaseFree() {
+    // a free block without neighbours covers its whole chunk
+    std::vector<int> chunks;
+    for (int i = 0; i < mBlocks.size(); ++i) {
+        auto& block = mBlocks[i];
+        if (block.size > 0 && block.free && block.prevPhys < 0 && block.nextPhys < 0) {
+            chunks.emplace_back(i);
+        }
+    }
+    for (auto index : chunks) {
+        removeFree(index);
+        mParent->onRelease(mBlocks[index].pointer);
+        mTotalSize -= mBlocks[index].size;
+        mBlocks[index].size = 0;
+        mUnusedBlocks.push_back(index);
+    }
+}
+
+void TLSFAllocator::releaseAll() {
+    for (auto& block : mBlocks) {
+        if (block.size > 0 && block.prevPhys < 0) {
+            mParent->onRelease(block.pointer);
+        }
+    }
+    mBlocks.clear();
+    mUnusedBlocks.clear();
+    mUsedBlocks.clear();
+    mFLBitmap = 0;
+    ::memset(mSLBitmap, 0, sizeof(mSLBitmap));
+    ::memset(mFreeHeads, 0xff, sizeof(mFreeHeads));
+    mTotalSize = 0;
+    mUsedSize  = 0;
+}
+} // namespace MNN
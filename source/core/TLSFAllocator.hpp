@@ -0,0 +1,99 @@
+//
+//  TLSFAllocator.hpp
+//  MNN
+//
+//  Created by MNN on 2021/07/28.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef TLSFAllocator_hpp
+#define TLSFAllocator_hpp
+
+#include <stdint.h>
+#include <unordered_map>
+#include "core/BufferAllocator.hpp"
+
+namespace MNN {
+
+/**
+ Two-level segregated fit pool over the chunks of a parent allocator.
+ Free blocks are kept in size classes found through two bitmaps, and every block links to its address neighbours
+ inside the chunk, so alloc, free and merging don't depend on how many blocks are free.
+ */
+class MNN_PUBLIC TLSFAllocator : public BufferAllocator::Allocator {
+public:
+    TLSFAllocator(std::shared_ptr<BufferAllocator::Allocator> parent, size_t align = MNN_MEMORY_ALIGN_DEFAULT);
+    virtual ~TLSFAllocator();
+
+    /**
+     * @brief take a block of the smallest size class that fits, or a new chunk from the parent.
+     * @param size      given size.
+     * @param seperate  if true, always take a new chunk from the parent.
+     * @return CHUNK pointer, nullptr if the parent fails.
+     */
+    std::pair<void*, size_t> alloc(size_t size, bool seperate = false);
+    virtual std::pair<void*, size_t> onAlloc(size_t size) override {
+        return alloc(size, false);
+    }
+    /**
+     * @brief free the block and merge it with its free neighbours. the chunks stay for reusing.
+     */
+    virtual void onRelease(std::pair<void*, size_t> pointer) override;
+
+    // size of the used block at pointer, 0 if pointer is not allocated from this pool
+    size_t blockSize(std::pair<void*, size_t> pointer) const;
+    // give the chunks without used blocks back to the parent
+    void releaseFree();
+    // give every chunk back to the parent
+    void releaseAll();
+
+    size_t totalSize() const {
+        return mTotalSize;
+    }
+    size_t usedSize() const {
+        return mUsedSize;
+    }
+
+private:
+    enum {
+        SL_BITS  = 4,
+        SL_COUNT = 1 << SL_BITS,
+        FL_COUNT = 64 - SL_BITS + 1,
+    };
+    struct Block {
+        std::pair<void*, size_t> pointer;
+        // 0 for the blocks waiting in mUnusedBlocks
+        size_t size = 0;
+        // address neighbours in the chunk, -1 at the chunk's ends
+        int prevPhys = -1, nextPhys = -1;
+        // neighbours in the size class while free
+        int prevFree = -1, nextFree = -1;
+        bool free    = false;
+    };
+    struct PointerHash {
+        size_t operator()(const std::pair<void*, size_t>& pointer) const {
+            return std::hash<void*>()(pointer.first) ^ (std::hash<size_t>()(pointer.second) * 31);
+        }
+    };
+
+    void mapping(size_t units, int& fl, int& sl) const;
+    int findFree(size_t size) const;
+    void insertFree(int index);
+    void removeFree(int index);
+    // right is merged into left, its address neighbour
+    void absorb(int left, int right);
+    int newBlock();
+
+    std::shared_ptr<BufferAllocator::Allocator> mParent;
+    size_t mAlign;
+    std::vector<Block> mBlocks;
+    std::vector<int> mUnusedBlocks;
+    std::unordered_map<std::pair<void*, size_t>, int, PointerHash> mUsedBlocks;
+    uint64_t mFLBitmap = 0;
+    uint32_t mSLBitmap[FL_COUNT];
+    int mFreeHeads[FL_COUNT][SL_COUNT];
+    size_t mTotalSize = 0;
+    size_t mUsedSize  = 0;
+};
+} // namespace MNN
+#endif
@@ -19,6 +19,9 @@
 #include "backend/cpu/CPUTensorConvert.hpp"
 #include <MNN/MNNForwardType.h>
 #include "core/Backend.hpp"
+#ifdef MNN_USE_THREAD_POOL
+#include "backend/cpu/ThreadPool.hpp"
+#endif
 #define CACHE_SIZE 256
 namespace MNN {
 namespace CV {
@@ -236,23 +239,42 @@ ErrorCode ImageProcess::convert(const uint8_t* source, int iw, int ih, int strid
     return convert(source, iw, ih, stride, dest->host<void>(), ow, oh, bpp, ow * bpp, dest->getType());
 }
 
-ErrorCode ImageProcess::convert(const uint8_t* source, int iw, int ih, int stride, void* dest, int ow, int oh,
-                                int outputBpp, int outputStride, halide_type_t type) {
-    auto sourceBpp = _getBpp(mInside->config.sourceFormat);
+// Everything needed to produce the rows of one image, the scratch buffers are passed per call so rows of
+// different images can be produced on different threads
+struct ImageRowContext {
+    const uint8_t* source;
+    int iw;
+    int ih;
+    int stride;
+    int sourceBpp;
+    uint8_t* dest;
+    int ow;
+    int bpp;
+    int destBytes;
+    bool needBlit;
+    bool isFloat;
+    ImageSampler::PROC sampler;
+    ImageBlitter::BLITTER blitter;
+    ImageFloatBlitter::BLIT_FLOAT blitFloat;
+    const ImageProcess::Config* config;
+    Matrix transform;
+    Matrix transformInvert;
+};
+
+static ErrorCode _prepareRowContext(ImageRowContext& context, const ImageProcess::Config& config, const Matrix& transform,
+                                    const uint8_t* source, int iw, int ih, int stride, void* dest, int ow, int oh,
+                                    int outputBpp, halide_type_t type) {
+    auto sourceBpp = _getBpp(config.sourceFormat);
     if (0 == stride) {
         stride = iw * sourceBpp;
     }
-
-    // AUTOTIME;
-    auto& config      = mInside->config;
     auto sourceFormat = config.sourceFormat;
-    auto destFormat   = config.destFormat;
-    destFormat        = _correctImageFormat(outputBpp, type, destFormat);
+    auto destFormat   = _correctImageFormat(outputBpp, type, config.destFormat);
     auto blitter      = ImageBlitter::choose(sourceFormat, destFormat);
     if (nullptr == blitter) {
         return INPUT_DATA_ERROR;
     }
-    bool identity = mTransform.isIdentity() && iw >= ow && ih >= oh; // TODO, no need for iw, ih limit
+    bool identity = transform.isIdentity() && iw >= ow && ih >= oh; // TODO, no need for iw, ih limit
     auto sampler  = ImageSampler::choose(sourceFormat, config.filterType, identity);
     if (nullptr == sampler) {
         return INPUT_DATA_ERROR;
@@ -260,94 +282,222 @@ ErrorCode ImageProcess::convert(const uint8_t* source, int iw, int ih, int strid
     if (0 == outputBpp) {
         outputBpp = _getBpp(destFormat);
     }
+    context.source    = source;
+    context.iw        = iw;
+    context.ih        = ih;
+    context.stride    = stride;
+    context.sourceBpp = sourceBpp;
+    context.dest      = (uint8_t*)dest;
+    context.ow        = ow;
+    context.bpp       = outputBpp;
+    context.destBytes = type.bytes();
+    context.needBlit  = sourceFormat != destFormat;
+    context.isFloat   = type.code == halide_type_float;
+    context.sampler   = sampler;
+    context.blitter   = blitter;
+    context.blitFloat = ImageFloatBlitter::choose(destFormat, outputBpp);
+    context.config    = &config;
+    context.transform = transform;
+    transform.invert(&context.transformInvert);
+    return NO_ERROR;
+}
 
-    int tileCount = UP_DIV(ow, CACHE_SIZE);
+// Sample, convert format and normalize tile by tile, so a tile stays in cache between the stages
+static void _convertRow(const ImageRowContext& context, int dy, uint8_t* sampleBuffer, uint8_t* rgbaBuffer) {
+    auto& config   = *context.config;
+    auto sourceBpp = context.sourceBpp;
+    auto ow        = context.ow;
+    auto bpp       = context.bpp;
+    auto destBytes = context.destBytes;
+    int tileCount  = UP_DIV(ow, CACHE_SIZE);
     Point points[2];
-    auto sampleBuffer = (uint8_t*)mInside->cacheBuffer.get();
-    auto srcData      = source;
-    auto destBytes    = type.bytes();
-    auto bpp          = outputBpp;
-    auto needBlit     = sourceFormat != destFormat;
-    bool isFloat      = type.code == halide_type_float;
-    //            MNN_PRINT("bpp:%d, destBytes:%d, destFormat:%d, %d, %d\n",bpp, destBytes, ow, oh, dimensionFormat);
-
-    auto blitFloat = ImageFloatBlitter::choose(destFormat, bpp);
-    for (int dy = 0; dy < oh; ++dy) {
-        auto dstY = (uint8_t*)dest + dy * destBytes * ow * bpp;
-        for (int tIndex = 0; tIndex < tileCount; ++tIndex) {
-            int xStart    = tIndex * CACHE_SIZE;
-            int count     = std::min(CACHE_SIZE, ow - xStart);
-            auto dstStart = dstY + destBytes * bpp * xStart;
+    auto dstY = context.dest + dy * destBytes * ow * bpp;
+    for (int tIndex = 0; tIndex < tileCount; ++tIndex) {
+        int xStart    = tIndex * CACHE_SIZE;
+        int count     = std::min(CACHE_SIZE, ow - xStart);
+        auto dstStart = dstY + destBytes * bpp * xStart;
 
-            auto samplerDest = sampleBuffer;
-            auto blitDest    = mInside->cacheBufferRGBA.get();
+        auto samplerDest = sampleBuffer;
+        auto blitDest    = rgbaBuffer;
 
-            if (!isFloat) {
-                blitDest = dstStart;
-            }
-            if (!needBlit) {
-                samplerDest = blitDest;
-            }
+        if (!context.isFloat) {
+            blitDest = dstStart;
+        }
+        if (!context.needBlit) {
+            samplerDest = blitDest;
+        }
+
+        // Sample
+        {
+            // Compute position
+            points[0].fX = xStart;
+            points[0].fY = dy;
+
+            points[1].fX = xStart + count;
+            points[1].fY = dy;
 
-            // Sample
-            {
-                // Compute position
-                points[0].fX = xStart;
+            context.transform.mapPoints(points, 2);
+            float deltaY = points[1].fY - points[0].fY;
+            float deltaX = points[1].fX - points[0].fX;
+
+            int sta = 0;
+            int end = count;
+
+            // FUNC_PRINT(sta);
+            if (config.wrap == ZERO) {
+                // Clip: Cohen-Sutherland
+                auto clip    = _computeClip(points, context.iw, context.ih, context.transformInvert, xStart, count);
+                sta          = clip.first;
+                end          = clip.second;
+                points[0].fX = sta + xStart;
                 points[0].fY = dy;
 
-                points[1].fX = xStart + count;
-                points[1].fY = dy;
-
-                mTransform.mapPoints(points, 2);
-                float deltaY = points[1].fY - points[0].fY;
-                float deltaX = points[1].fX - points[0].fX;
-
-                int sta = 0;
-                int end = count;
-
-                // FUNC_PRINT(sta);
-                if (config.wrap == ZERO) {
-                    // Clip: Cohen-Sutherland
-                    auto clip    = _computeClip(points, iw, ih, mTransformInvert, xStart, count);
-                    sta          = clip.first;
-                    end          = clip.second;
-                    points[0].fX = sta + xStart;
-                    points[0].fY = dy;
-
-                    mTransform.mapPoints(points, 1);
-                    if (sta != 0 || end < count) {
-                        if (sourceBpp > 0) {
-                            if (sta > 0) {
-                                ::memset(samplerDest, 0, sourceBpp * sta);
-                            }
-                            if (end < count) {
-                                ::memset(samplerDest + end * sourceBpp, 0, (count - end) * sourceBpp);
-                            }
-                        } else {
-                            // TODO, Only support NV12 / NV21
-                            ::memset(samplerDest, 0, count);
-                            ::memset(samplerDest + count, 128, UP_DIV(count, 2) * 2);
+                context.transform.mapPoints(points, 1);
+                if (sta != 0 || end < count) {
+                    if (sourceBpp > 0) {
+                        if (sta > 0) {
+                            ::memset(samplerDest, 0, sourceBpp * sta);
                         }
+                        if (end < count) {
+                            ::memset(samplerDest + end * sourceBpp, 0, (count - end) * sourceBpp);
+                        }
+                    } else {
+                        // TODO, Only support NV12 / NV21
+                        ::memset(samplerDest, 0, count);
+                        ::memset(samplerDest + count, 128, UP_DIV(count, 2) * 2);
                     }
                 }
-                points[1].fX = (deltaX) / (float)(count);
-                points[1].fY = (deltaY) / (float)(count);
-
-                sampler(srcData, samplerDest, points, sta, end - sta, count, iw, ih, stride);
-            }
-            // Convert format
-            if (needBlit) {
-                blitter(samplerDest, blitDest, count);
-            }
-            // Turn float
-            if (isFloat) {
-                auto normal = mInside->config.normal;
-                auto mean   = mInside->config.mean;
-                blitFloat(blitDest, (float*)dstStart, mean, normal, count);
             }
+            points[1].fX = (deltaX) / (float)(count);
+            points[1].fY = (deltaY) / (float)(count);
+
+            context.sampler(context.source, samplerDest, points, sta, end - sta, count, context.iw, context.ih,
+                            context.stride);
+        }
+        // Convert format
+        if (context.needBlit) {
+            context.blitter(samplerDest, blitDest, count);
+        }
+        // Turn float
+        if (context.isFloat) {
+            context.blitFloat(blitDest, (float*)dstStart, config.mean, config.normal, count);
+        }
+    }
+}
+
+ErrorCode ImageProcess::convert(const uint8_t* source, int iw, int ih, int stride, void* dest, int ow, int oh,
+                                int outputBpp, int outputStride, halide_type_t type) {
+    // AUTOTIME;
+    ImageRowContext context;
+    auto code = _prepareRowContext(context, mInside->config, mTransform, source, iw, ih, stride, dest, ow, oh,
+                                   outputBpp, type);
+    if (NO_ERROR != code) {
+        return code;
+    }
+    for (int dy = 0; dy < oh; ++dy) {
+        _convertRow(context, dy, mInside->cacheBuffer.get(), mInside->cacheBufferRGBA.get());
+    }
+    return NO_ERROR;
+}
+
+ErrorCode ImageProcess::convert(const std::vector<Image>& images, Tensor* destOrigin, int threadNumber) {
+    auto dest = destOrigin;
+    if (nullptr == dest || images.empty()) {
+        MNN_ERROR("null dest or empty images for image process\n");
+        return INPUT_DATA_ERROR;
+    }
+    if (TensorUtils::getDescribe(dest)->backend == nullptr && destOrigin->buffer().host == nullptr) {
+        MNN_ERROR("Invalid Tensor, the session may not be ready\n");
+        return INPUT_DATA_ERROR;
+    }
+    int batch = (int)images.size();
+    if (dest->batch() != batch) {
+        MNN_ERROR("Batch of dest is %d but %d images are given\n", dest->batch(), batch);
+        return INPUT_DATA_ERROR;
+    }
+    std::shared_ptr<Tensor> tempTensor;
+    auto ow              = dest->width();
+    auto oh              = dest->height();
+    auto bpp             = dest->channel();
+    auto dimensionFormat = TensorUtils::getDescribe(dest)->dimensionFormat;
+    auto tensorBn        = TensorUtils::getDescribe(dest)->backend;
+    auto bnType          = MNN_FORWARD_CPU;
+    if (tensorBn) {
+        bnType = tensorBn->type();
+    }
+    if (bnType != MNN_FORWARD_CPU) {
+        tempTensor.reset(Tensor::create({batch, bpp, oh, ow}, dest->getType(), nullptr, Tensor::CAFFE_C4), [destOrigin](void* p) {
+            auto hostTensor = (Tensor*)p;
+            destOrigin->copyFromHostTensor(hostTensor);
+            delete hostTensor;
+        });
+        dest = tempTensor.get();
+    } else if (MNN_DATA_FORMAT_NCHW == dimensionFormat) {
+        tempTensor.reset(Tensor::create(dest->shape(), dest->getType(), nullptr, Tensor::CAFFE_C4), [destOrigin](void* p) {
+            auto hostTensor = (Tensor*)p;
+            CPUTensorConverter::convert(hostTensor, destOrigin);
+            delete hostTensor;
+        });
+        dest = tempTensor.get();
+    }
+    dimensionFormat = TensorUtils::getDescribe(dest)->dimensionFormat;
+    if (dimensionFormat == MNN_DATA_FORMAT_NC4HW4) {
+        bpp = 4;
+    }
+    // With at most 4 channels an image of NC4HW4 / NHWC is one contiguous oh x ow x bpp block
+    auto type       = dest->getType();
+    auto imageBytes = (size_t)oh * ow * bpp * type.bytes();
+    std::vector<ImageRowContext> contexts(batch);
+    for (int n = 0; n < batch; ++n) {
+        auto& image = images[n];
+        if (nullptr == image.source) {
+            MNN_ERROR("null source of image %d for image process\n", n);
+            return INPUT_DATA_ERROR;
+        }
+        auto code = _prepareRowContext(contexts[n], mInside->config, image.matrix, image.source, image.width,
+                                       image.height, image.stride, dest->host<uint8_t>() + n * imageBytes, ow, oh,
+                                       bpp, type);
+        if (NO_ERROR != code) {
+            return code;
         }
     }
 
+    // Rows of all images form one work list, thread t takes rows t, t + threadNumber, ...
+    int rowCount = batch * oh;
+    threadNumber = std::max(1, std::min(threadNumber, rowCount));
+#ifdef MNN_USE_THREAD_POOL
+    threadNumber  = ThreadPool::init(threadNumber);
+    int taskIndex = threadNumber > 1 ? ThreadPool::acquireWorkIndex() : -1;
+    if (taskIndex < 0) {
+        // every slot of the pool is taken by a runtime, do it on this thread
+        threadNumber = 1;
+    }
+#endif
+    AutoStorage<uint8_t> cache(threadNumber * 8 * CACHE_SIZE);
+    auto task = [&](int tId) {
+        auto sampleBuffer = cache.get() + tId * 8 * CACHE_SIZE;
+        auto rgbaBuffer   = sampleBuffer + 4 * CACHE_SIZE;
+        for (int r = tId; r < rowCount; r += threadNumber) {
+            _convertRow(contexts[r / oh], r % oh, sampleBuffer, rgbaBuffer);
+        }
+    };
+#ifdef MNN_USE_THREAD_POOL
+    if (taskIndex >= 0) {
+        ThreadPool::active();
+        ThreadPool::enqueue(std::make_pair(std::function<void(int)>(task), threadNumber), taskIndex);
+        ThreadPool::deactive();
+        ThreadPool::releaseWorkIndex(taskIndex);
+    } else {
+        task(0);
+    }
+#else
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int tId = 0; tId < threadNumber; ++tId) {
+        task(tId);
+    }
+#endif
     return NO_ERROR;
 }
 
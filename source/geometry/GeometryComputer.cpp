@@ -38,6 +38,8 @@ GeometryComputer::Context::Context(std::shared_ptr<Backend> allocBackend, bool p
 void GeometryComputer::Context::clear() {
     mRasterCache.clear();
     pOutputs.clear();
+    mSkippedRaster = 0;
+    mRegionInput = 0;
 }
 const std::vector<std::shared_ptr<Tensor>>& GeometryComputer::Context::searchConst(const Op* op) const {
     auto iter = mConstTensors.find(op);
@@ -64,11 +66,8 @@ std::shared_ptr<Tensor> GeometryComputer::Context::allocConst(const Op* key, con
     return tensor;
 }
 
-Tensor* GeometryComputer::Context::getRasterCacheCreateRecurrse(Tensor* src, CommandBuffer& cmd) {
+void GeometryComputer::Context::realizeOrigins(Tensor* src, CommandBuffer& cmd) {
     auto srcDes = TensorUtils::getDescribe(src);
-    if (srcDes->memoryType != Tensor::InsideDescribe::MEMORY_VIRTUAL) {
-        return src;
-    }
     for (auto& input : srcDes->regions) {
         MNN_ASSERT(input.origin != src);
         auto inputDes = TensorUtils::getDescribe(input.origin);
@@ -88,8 +87,25 @@ Tensor* GeometryComputer::Context::getRasterCacheCreateRecurrse(Tensor* src, Com
         }
         MNN_ASSERT(TensorUtils::getDescribe(input.origin)->memoryType != Tensor::InsideDescribe::MEMORY_VIRTUAL);
     }
+}
+Tensor* GeometryComputer::Context::getRasterCacheCreateRecurrse(Tensor* src, CommandBuffer& cmd) {
+    auto srcDes = TensorUtils::getDescribe(src);
+    if (srcDes->memoryType != Tensor::InsideDescribe::MEMORY_VIRTUAL) {
+        return src;
+    }
+    realizeOrigins(src, cmd);
     return getRasterCacheCreate(src, cmd);
 }
+// field by field: memcmp would also compare the padding before origin, which isn't initialized
+static bool _regionEqual(const Tensor::InsideDescribe::Region& a, const Tensor::InsideDescribe::Region& b) {
+    for (int i = 0; i < 3; ++i) {
+        if (a.size[i] != b.size[i] || a.src.stride[i] != b.src.stride[i] || a.dst.stride[i] != b.dst.stride[i]) {
+            return false;
+        }
+    }
+    return a.src.offset == b.src.offset && a.dst.offset == b.dst.offset && a.origin == b.origin &&
+           a.offset == b.offset;
+}
 std::shared_ptr<Tensor> GeometryComputer::Context::getCachedTensor(Tensor* t) {
     auto findIter = mRasterCache.find(t);
     if (findIter != mRasterCache.end()) {
@@ -111,9 +127,7 @@ std::shared_ptr<Tensor> GeometryComputer::Context::getCachedTensor(Tensor* t) {
         if (tDes->regions.size() == sDes->regions.size()) {
             bool equal = true;
             for (int i = 0; i < sDes->regions.size(); i++) {
-                auto sReg = sDes->regions[i];
-                auto tReg = tDes->regions[i];
-                equal &= !::memcmp(&sReg, &tReg, sizeof(sReg));
+                equal &= _regionEqual(sDes->regions[i], tDes->regions[i]);
             }
             if (equal) {
                 return iter.second;
@@ -122,6 +136,74 @@ std::shared_ptr<Tensor> GeometryComputer::Context::getCachedTensor(Tensor* t) {
     }
     return nullptr;
 }
+// The virtual tensor is a linear copy of a whole real tensor with the same shape and format, such as a
+// NC4HW4 -> NCHW -> NC4HW4 round trip after region fusion, so readers can take the origin directly
+static Tensor* _identityOrigin(const Tensor* src) {
+    auto srcDes = TensorUtils::getDescribe(src);
+    if (1 != srcDes->regions.size()) {
+        return nullptr;
+    }
+    auto& reg  = srcDes->regions[0];
+    auto origin = reg.origin;
+    if (nullptr == origin || nullptr != reg.offset || 0 != reg.src.offset || 0 != reg.dst.offset) {
+        return nullptr;
+    }
+    auto originDes = TensorUtils::getDescribe(origin);
+    if (originDes->memoryType == Tensor::InsideDescribe::MEMORY_VIRTUAL ||
+        originDes->dimensionFormat != srcDes->dimensionFormat || origin->getType() != src->getType() ||
+        origin->dimensions() != src->dimensions()) {
+        return nullptr;
+    }
+    int size = 1;
+    for (int i = 0; i < src->dimensions(); ++i) {
+        if (origin->length(i) != src->length(i)) {
+            return nullptr;
+        }
+        size *= src->length(i);
+    }
+    // Regions index the logical layout, walk both sides with the same dense strides
+    int stride = 1;
+    for (int i = 2; i >= 0; --i) {
+        if (reg.size[i] <= 1) {
+            continue;
+        }
+        if (reg.src.stride[i] != stride || reg.dst.stride[i] != stride) {
+            return nullptr;
+        }
+        stride *= reg.size[i];
+    }
+    if (stride != size) {
+        return nullptr;
+    }
+    return origin;
+}
+
+Tensor* GeometryComputer::Context::getRegionInputCreate(Tensor* src, CommandBuffer& cmd) {
+    auto srcDes = TensorUtils::getDescribe(src);
+    if (srcDes->memoryType != Tensor::InsideDescribe::MEMORY_VIRTUAL) {
+        return src;
+    }
+    // The outputs must be real after makeRaster, and a tensor already rastered is cheaper to read
+    if (pOutputs.find(src) != pOutputs.end() || nullptr != getCachedTensor(src)) {
+        return getRasterCacheCreateRecurrse(src, cmd);
+    }
+    realizeOrigins(src, cmd);
+    auto origin = _identityOrigin(src);
+    if (nullptr != origin) {
+        mSkippedRaster++;
+        return origin;
+    }
+    for (auto& reg : srcDes->regions) {
+        // Offset lists and packed layouts still need CPURaster
+        if (nullptr != reg.offset || reg.origin->getType() != src->getType() ||
+            TensorUtils::getDescribe(reg.origin)->dimensionFormat == MNN_DATA_FORMAT_NC4HW4) {
+            return getRasterCacheCreate(src, cmd);
+        }
+    }
+    mRegionInput++;
+    return src;
+}
+
 Tensor* GeometryComputer::Context::getRasterCacheCreate(Tensor* src, CommandBuffer& cmdBuffer) {
     auto srcDes = TensorUtils::getDescribe(src);
     if (srcDes->memoryType != Tensor::InsideDescribe::MEMORY_VIRTUAL) {
@@ -134,6 +216,13 @@ Tensor* GeometryComputer::Context::getRasterCacheCreate(Tensor* src, CommandBuff
     Command cmd;
     cmd.op = flatbuffers::GetRoot<Op>(mRasterOp.data());
     auto iter = pOutputs.find(src);
+    if (iter == pOutputs.end()) {
+        auto origin = _identityOrigin(src);
+        if (nullptr != origin) {
+            mSkippedRaster++;
+            return origin;
+        }
+    }
     if (iter != pOutputs.end()) {
         auto output = src;
         auto oldDes = TensorUtils::getDescribe(output);
@@ -32,11 +32,35 @@ public:
             return mPermitVirtual;
         }
         Tensor* getRasterCacheCreateRecurrse(Tensor* src, CommandBuffer& cmd);
+        // Keep src virtual for a consumer that gathers its regions itself, only the origins are made real
+        Tensor* getRegionInputCreate(Tensor* src, CommandBuffer& cmd);
+        void setPermitRegionInput(bool permit) {
+            mPermitRegionInput = permit;
+        }
+        bool supportRegionInput() const {
+            return mPermitRegionInput;
+        }
+        // Convolution commands may take their weight as an input instead of being lowered to GEMM
+        void setPermitWeightInput(bool permit) {
+            mPermitWeightInput = permit;
+        }
+        bool supportWeightInput() const {
+            return mPermitWeightInput;
+        }
         const std::vector<std::shared_ptr<Tensor>>& searchConst(const Op* op) const;
         std::shared_ptr<Tensor> allocConst(const Op* key, const std::vector<int>& shape, halide_type_t type,
                                            Tensor::DimensionType dimType = Tensor::TENSORFLOW);
         std::set<Tensor*> pOutputs;
+        // number of rasters not created because the tensor was an unchanged view of another, since clear()
+        int skippedRaster() const {
+            return mSkippedRaster;
+        }
+        // number of virtual tensors read by their consumers without a raster, since clear()
+        int regionInput() const {
+            return mRegionInput;
+        }
     private:
+        void realizeOrigins(Tensor* src, CommandBuffer& cmd);
         Tensor* getRasterCacheCreate(Tensor* src, CommandBuffer& cmd);
         std::shared_ptr<Tensor> getCachedTensor(Tensor* t);
         std::map<Tensor*, std::shared_ptr<Tensor>> mRasterCache;
@@ -45,6 +69,10 @@ public:
         bool mPermitVirtual;
         std::shared_ptr<Backend> mBackend;
         std::vector<uint8_t> mRasterOp;
+        int mSkippedRaster = 0;
+        bool mPermitRegionInput = false;
+        bool mPermitWeightInput = false;
+        int mRegionInput = 0;
     };
     static void init();
     MNN_PUBLIC static const GeometryComputer* search(int type);
@@ -25,6 +25,41 @@ static bool _hasZeroShapeOutput(const Schedule::PipelineInfo& info) {
     }
     return false;
 }
+// CPUBinaryFloat gathers a virtual input itself for the elementwise ops, when both inputs and the output
+// share one shape and an unpacked float layout
+static bool _canReadRegions(const Command& cmd, const Op* op, int index) {
+    if (OpType_BinaryOp != op->type() || nullptr == op->main_as_BinaryOp() || 2 != cmd.inputs.size() ||
+        1 != cmd.outputs.size()) {
+        return false;
+    }
+    switch (op->main_as_BinaryOp()->opType()) {
+        case BinaryOpOperation_ADD:
+        case BinaryOpOperation_SUB:
+        case BinaryOpOperation_MUL:
+        case BinaryOpOperation_MAXIMUM:
+            break;
+        default:
+            return false;
+    }
+    auto output = cmd.outputs[0];
+    auto format = TensorUtils::getDescribe(output)->dimensionFormat;
+    if (TensorUtils::getDescribe(cmd.inputs[1 - index])->memoryType == Tensor::InsideDescribe::MEMORY_VIRTUAL ||
+        MNN_DATA_FORMAT_NC4HW4 == format) {
+        return false;
+    }
+    for (auto t : {cmd.inputs[0], cmd.inputs[1], output}) {
+        if (t->getType() != halide_type_of<float>() || TensorUtils::getDescribe(t)->dimensionFormat != format ||
+            t->dimensions() != output->dimensions()) {
+            return false;
+        }
+        for (int i = 0; i < t->dimensions(); ++i) {
+            if (t->length(i) != output->length(i)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
 flatbuffers::Offset<Op> GeometryComputerUtils::makePool(flatbuffers::FlatBufferBuilder& builder, std::pair<int, int> kernel, std::pair<int, int> stride, PoolType type, MNN::PoolPadType pad, std::pair<int, int> pads,  bool isglobal, AvgPoolCountType countType) {
     PoolBuilder poolB(builder);
     poolB.add_type(type);
@@ -362,6 +397,10 @@ void GeometryComputerUtils::makeRaster(const CommandBuffer& srcBuffer, CommandBu
             auto des = TensorUtils::getDescribe(cmd.inputs[i]);
             MNN_ASSERT(des->tensorArrayAttr == nullptr);
             if (des->memoryType == Tensor::InsideDescribe::MEMORY_VIRTUAL) {
+                if (ctx.supportRegionInput() && _canReadRegions(cmd, op, i)) {
+                    cmd.inputs[i] = ctx.getRegionInputCreate(cmd.inputs[i], dstBuffer);
+                    continue;
+                }
                 cmd.inputs[i] = ctx.getRasterCacheCreateRecurrse(cmd.inputs[i], dstBuffer);
             }
         }
@@ -212,14 +212,15 @@ public:
             res.extras.emplace_back(C);
 
             // Col2Im:
-            // 1. C-> C' batch, oc, oh, ow, kw*kh, 2. C' -> C'' batch, oc, oh, ow (reduce_sum)
+            // 1. C-> C' kw*kh, batch, oc, oh, ow, 2. C' -> C'' batch, oc, oh, ow (reduce_sum)
             // 3. C'' -> C'' + bias, 4. posttreat(C'' + bias)
-            std::shared_ptr<Tensor> C_(Tensor::createDevice<float>({batch, kw * kh, oc * oh * ow}));
+            // The kernel position is outside the batch, so that the images of a batch don't overlap in C'
+            std::shared_ptr<Tensor> C_(Tensor::createDevice<float>({1, kw * kh, batch * oc * oh * ow}));
             res.extras.emplace_back(C_);
             {
                 std::shared_ptr<Tensor> im2ColTemp(Tensor::createDevice<float>({oc * kw * kh, batch * ih * iw}));
                 // Swap ow, iw, oh, ih for im2Col
-                GeometryConvUtils::im2Col(im2ColTemp.get(), outputDiff, oc, kh, kw, batch, ih, iw, oh, ow, sh, sw, dh, dw, pads, oh * ow * oc);
+                GeometryConvUtils::im2Col(im2ColTemp.get(), outputDiff, oc, kh, kw, batch, ih, iw, oh, ow, sh, sw, dh, dw, pads, batch * oh * ow * oc);
                 auto des = TensorUtils::getDescribe(C_.get());
                 des->memoryType = Tensor::InsideDescribe::MEMORY_VIRTUAL;
                 auto originDes = TensorUtils::getDescribe(im2ColTemp.get());
@@ -232,13 +233,13 @@ public:
                     reg.dst = std::move(temp);
                 }
             }
-            std::shared_ptr<Tensor> C__(Tensor::createDevice<float>({batch, 1, oc * oh * ow}));
+            std::shared_ptr<Tensor> C__(Tensor::createDevice<float>({1, 1, batch * oc * oh * ow}));
             res.extras.emplace_back(C__);
             res.command.emplace_back(GeometryComputerUtils::makeReduce(ReductionType_SUM, C_.get(), C__.get()));
 
             if (inputs.size() > 2) {
                 MNN_ASSERT(oc == inputs[2]->elementSize());
-                std::shared_ptr<Tensor> biasLarge(Tensor::createDevice<float>({batch, 1, oc * oh * ow}));
+                std::shared_ptr<Tensor> biasLarge(Tensor::createDevice<float>({1, 1, batch * oc * oh * ow}));
                 res.extras.emplace_back(biasLarge);
                 auto des = TensorUtils::getDescribe(biasLarge.get());
                 des->memoryType = Tensor::InsideDescribe::MEMORY_VIRTUAL;
@@ -256,7 +257,7 @@ public:
                 reg.dst.stride[0] = oc * oh * ow;
                 reg.dst.stride[1] = oh * ow;
                 reg.dst.stride[2] = 1;
-                std::shared_ptr<Tensor> temp(Tensor::createDevice<float>({batch, 1, oh * ow * oc}));
+                std::shared_ptr<Tensor> temp(Tensor::createDevice<float>({1, 1, batch * oh * ow * oc}));
                 res.extras.emplace_back(temp);
                 res.command.emplace_back(GeometryComputerUtils::makeBinary(BinaryOpOperation_ADD, C__.get(), biasLarge.get(), temp.get()));
                 C__ = temp;
@@ -281,9 +282,9 @@ public:
                 std::shared_ptr<Tensor> C2(new Tensor);
                 C2->buffer().type       = halide_type_of<float>();
                 C2->buffer().dimensions = 3;
-                C2->setLength(0, batch);
+                C2->setLength(0, 1);
                 C2->setLength(1, 1);
-                C2->setLength(2, ow * oh * oc);
+                C2->setLength(2, batch * ow * oh * oc);
                 TensorUtils::getDescribe(C2.get())->dimensionFormat = MNN_DATA_FORMAT_NCHW;
                 auto cmd = GeometryComputerUtils::makeCommand(builder, {C__.get()}, {C2.get()});
                 res.command.emplace_back(cmd);
@@ -294,12 +295,97 @@ public:
         }
         return true;
     }
+    // With stride 1, the transposed convolution is a convolution of the input with the flipped weight:
+    // the backend picks Winograd for it instead of GEMM + Col2Im, which also saves the oc*kh*kw*n*ih*iw buffer
+    bool computeFlipConv(const Op* op, const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs,
+                         Context& context, CommandBuffer& res) const {
+        auto common = op->main_as_Convolution2D()->common();
+        auto input  = inputs[0];
+        auto output = outputs[0];
+        auto kw     = common->kernelX();
+        auto kh     = common->kernelY();
+        auto ic     = input->channel();
+        auto oc     = output->channel();
+        if (inputs.size() != 2 || common->group() != 1 || common->strideX() != 1 || common->strideY() != 1 ||
+            common->dilateX() != 1 || common->dilateY() != 1 || kw * kh <= 1) {
+            return false;
+        }
+        if (inputs[1]->getType() != halide_type_of<float>() || inputs[1]->elementSize() != ic * oc * kw * kh) {
+            return false;
+        }
+        auto pads = ConvolutionCommon::convolutionTransposePad(input, output, common);
+        int padX  = kw - 1 - pads.first;
+        int padY  = kh - 1 - pads.second;
+        if (padX < 0 || padY < 0 || output->width() != input->width() + 2 * padX - kw + 1 ||
+            output->height() != input->height() + 2 * padY - kh + 1) {
+            return false;
+        }
+        // Weight ic, oc, kh, kw -> oc, ic, kh, kw reversing the kernel
+        std::shared_ptr<Tensor> kernel(Tensor::createDevice<float>({oc, ic, kh, kw}, Tensor::CAFFE));
+        res.extras.emplace_back(kernel);
+        {
+            auto des        = TensorUtils::getDescribe(kernel.get());
+            des->memoryType = Tensor::InsideDescribe::MEMORY_VIRTUAL;
+            des->regions.resize(1);
+            auto& reg         = des->regions[0];
+            reg.origin        = inputs[1];
+            reg.size[0]       = oc;
+            reg.size[1]       = ic;
+            reg.size[2]       = kh * kw;
+            reg.src.offset    = kh * kw - 1;
+            reg.src.stride[0] = kh * kw;
+            reg.src.stride[1] = oc * kh * kw;
+            reg.src.stride[2] = -1;
+            reg.dst.offset    = 0;
+            reg.dst.stride[0] = ic * kh * kw;
+            reg.dst.stride[1] = kh * kw;
+            reg.dst.stride[2] = 1;
+        }
+        std::unique_ptr<OpT> convOp(new OpT);
+        convOp->type       = OpType_Convolution;
+        convOp->main.type  = OpParameter_Convolution2D;
+        convOp->main.value = new Convolution2DT;
+        auto conv2D        = convOp->main.AsConvolution2D();
+        conv2D->common.reset(new Convolution2DCommonT);
+        auto newCommon         = conv2D->common.get();
+        newCommon->kernelX     = kw;
+        newCommon->kernelY     = kh;
+        newCommon->padX        = padX;
+        newCommon->padY        = padY;
+        newCommon->inputCount  = ic;
+        newCommon->outputCount = oc;
+        newCommon->relu        = common->relu();
+        newCommon->relu6       = common->relu6();
+        flatbuffers::FlatBufferBuilder builder;
+        builder.Finish(Op::Pack(builder, convOp.get()));
+
+        // Convolution with format converter
+        Tensor* convInput  = input;
+        Tensor* convOutput = output;
+        if (MNN_DATA_FORMAT_NC4HW4 != TensorUtils::getDescribe(input)->dimensionFormat) {
+            std::shared_ptr<Tensor> newInput(new Tensor(input, Tensor::CAFFE_C4, false));
+            ConvertUtils::compute(input, newInput.get(), res);
+            convInput = newInput.get();
+            res.extras.emplace_back(std::move(newInput));
+            std::shared_ptr<Tensor> newOutput(new Tensor(output, Tensor::CAFFE_C4, false));
+            convOutput = newOutput.get();
+            res.extras.emplace_back(std::move(newOutput));
+        }
+        res.command.emplace_back(GeometryComputerUtils::makeCommand(builder, {convInput, kernel.get()}, {convOutput}));
+        if (convOutput != output) {
+            ConvertUtils::compute(convOutput, output, res);
+        }
+        return true;
+    }
     virtual bool onCompute(const Op* op, const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs,
                            Context& context, CommandBuffer& res) const override {
         if (inputs.size() == 1) {
             // Origin convolution with format converter
             return GeometryConvUtils::computeSingle(op, inputs, outputs, context, res);
         }
+        if (context.supportWeightInput() && computeFlipConv(op, inputs, outputs, context, res)) {
+            return true;
+        }
         return computeGEMM_Col2Im(op, inputs, outputs, context, res);
     }
 };
@@ -0,0 +1,44 @@
+//
+//  ShapeFakeQuant.cpp
+//  MNN
+//
+//  Created by MNN on 2021/07/29.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "shape/SizeComputer.hpp"
+#include "core/TensorUtils.hpp"
+
+namespace MNN {
+// The first output is like the input, the second holds the scale of the tensor or of each slice along axis
+class FakeQuantComputer : public SizeComputer {
+public:
+    virtual bool onComputeSize(const MNN::Op* op, const std::vector<Tensor*>& inputs,
+                               const std::vector<Tensor*>& outputs) const override {
+        MNN_ASSERT(inputs.size() >= 1);
+        MNN_ASSERT(2 == outputs.size());
+        auto input = inputs[0];
+        auto axis  = op->main_as_FakeQuant()->axis();
+        if (input->getType().code != halide_type_float || axis >= input->dimensions()) {
+            return false;
+        }
+        if (axis >= 0 && TensorUtils::getDescribe(input)->dimensionFormat == MNN_DATA_FORMAT_NC4HW4) {
+            return false;
+        }
+        TensorUtils::copyShape(input, outputs[0], true);
+        outputs[0]->buffer().type = input->getType();
+        auto scale                = outputs[1];
+        scale->buffer().type      = input->getType();
+        if (axis < 0) {
+            scale->buffer().dimensions = 0;
+        } else {
+            scale->buffer().dimensions = 1;
+            scale->setLength(0, input->length(axis));
+        }
+        TensorUtils::getDescribe(scale)->dimensionFormat = MNN_DATA_FORMAT_NCHW;
+        return true;
+    }
+};
+
+REGISTER_SHAPE(FakeQuantComputer, OpType_FakeQuant);
+} // namespace MNN
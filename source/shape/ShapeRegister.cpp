@@ -62,6 +62,7 @@ extern void ___CropAndResizeComputer__OpType_CropAndResize__();
 extern void ___QuantizedMaxPoolComputer__OpType_QuantizedMaxPool__();
 extern void ___Pool3DSizeComputer__OpType_Pooling3D__();
 extern void ___MomentsComputer__OpType_Moments__();
+extern void ___FakeQuantComputer__OpType_FakeQuant__();
 extern void ___RangeComputer__OpType_Range__();
 extern void ___UnpackComputer__OpType_Unpack__();
 extern void ___TopKV2SizeComputer__OpType_TopKV2__();
@@ -160,6 +161,7 @@ ___CropAndResizeComputer__OpType_CropAndResize__();
 ___QuantizedMaxPoolComputer__OpType_QuantizedMaxPool__();
 ___Pool3DSizeComputer__OpType_Pooling3D__();
 ___MomentsComputer__OpType_Moments__();
+___FakeQuantComputer__OpType_FakeQuant__();
 ___RangeComputer__OpType_Range__();
 ___UnpackComputer__OpType_Unpack__();
 ___TopKV2SizeComputer__OpType_TopKV2__();
@@ -56,3 +56,62 @@ public:
     }
 };
 MNNTestSuiteRegister(BufferAllocatorTest, "core/buffer_allocator");
+
+class TLSFBufferAllocatorTest : public MNNTestCase {
+public:
+    virtual ~TLSFBufferAllocatorTest() = default;
+    virtual bool run() {
+        auto alignment = MNN_MEMORY_ALIGN_DEFAULT;
+        BufferAllocator allocator(BufferAllocator::Allocator::createDefault());
+        allocator.setEngine(BufferAllocator::ENGINE_TLSF);
+
+        // alloc - free - release, sizes are aligned
+        auto p1 = allocator.alloc(5);
+        MNNTEST_ASSERT((size_t)p1.first % alignment == 0);
+        MNNTEST_ASSERT(allocator.totalSize() == alignment);
+        allocator.free(p1);
+        MNNTEST_ASSERT(allocator.totalSize() == alignment);
+        MNNTEST_ASSERT(allocator.usedSize() == 0);
+        allocator.release(false);
+        MNNTEST_ASSERT(allocator.totalSize() == 0);
+
+        // split and merge with both neighbours
+        auto big = allocator.alloc(alignment * 8);
+        allocator.free(big);
+        auto a = allocator.alloc(alignment);
+        auto b = allocator.alloc(alignment * 2);
+        auto c = allocator.alloc(alignment);
+        MNNTEST_ASSERT(allocator.totalSize() == alignment * 8);
+        MNNTEST_ASSERT(a == big);
+        MNNTEST_ASSERT(b.first == a.first && b.second == a.second + alignment);
+        MNNTEST_ASSERT(c.first == a.first && c.second == b.second + alignment * 2);
+        allocator.free(a);
+        allocator.free(c);
+        allocator.free(b);
+        auto whole = allocator.alloc(alignment * 8);
+        MNNTEST_ASSERT(whole == big);
+        MNNTEST_ASSERT(allocator.totalSize() == alignment * 8);
+
+        // freed inside a group, reused only by the group until the barrier ends
+        allocator.free(whole);
+        allocator.barrierBegin();
+        allocator.beginGroup();
+        auto g0 = allocator.alloc(alignment * 4);
+        allocator.free(g0);
+        MNNTEST_ASSERT(allocator.alloc(alignment * 2) == g0);
+        allocator.endGroup();
+        allocator.beginGroup();
+        auto g1 = allocator.alloc(alignment * 4);
+        MNNTEST_ASSERT(g1.second == g0.second + alignment * 4);
+        allocator.free(g1);
+        allocator.endGroup();
+        allocator.barrierEnd();
+        allocator.free(g0);
+        MNNTEST_ASSERT(allocator.usedSize() == 0);
+        MNNTEST_ASSERT(allocator.alloc(alignment * 8) == big);
+        allocator.release();
+        MNNTEST_ASSERT(allocator.totalSize() == 0);
+        return true;
+    }
+};
+MNNTestSuiteRegister(TLSFBufferAllocatorTest, "core/buffer_allocator_tlsf");
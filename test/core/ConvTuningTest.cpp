@@ -0,0 +1,102 @@
+//
+//  ConvTuningTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/07/23.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/expr/ExecutorScope.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "core/Backend.hpp"
+
+using namespace MNN;
+using namespace MNN::Express;
+
+static bool _checkConv(int ic, int oc, int h, int k) {
+    std::vector<float> input(ic * h * h), weight(oc * ic * k * k);
+    for (int i = 0; i < input.size(); ++i) {
+        input[i] = sinf(i * 0.1f);
+    }
+    for (int i = 0; i < weight.size(); ++i) {
+        weight[i] = cosf(i * 0.37f);
+    }
+    auto x = _Input({1, ic, h, h}, NCHW);
+    ::memcpy(x->writeMap<float>(), input.data(), input.size() * sizeof(float));
+    auto y   = _Conv(std::vector<float>(weight), std::vector<float>(oc, 0.0f), _Convert(x, NC4HW4), {ic, oc}, {k, k});
+    y        = _Convert(y, NCHW);
+    auto ptr = y->readMap<float>();
+    int oh   = h - k + 1;
+    if (nullptr == ptr) {
+        return false;
+    }
+    for (int o = 0; o < oc; ++o) {
+        for (int i = 0; i < oh * oh; ++i) {
+            float sum = 0.0f;
+            for (int c = 0; c < ic; ++c) {
+                for (int ky = 0; ky < k; ++ky) {
+                    for (int kx = 0; kx < k; ++kx) {
+                        sum += input[(c * h + i / oh + ky) * h + i % oh + kx] * weight[((o * ic + c) * k + ky) * k + kx];
+                    }
+                }
+            }
+            if (fabsf(ptr[o * oh * oh + i] - sum) > 1e-3f * (1.0f + fabsf(sum))) {
+                MNN_ERROR("kernel %d: %d: %f != %f\n", k, o * oh * oh + i, ptr[o * oh * oh + i], sum);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Tuned convolutions compute as the heuristic ones, and their choices go through the runtime's cache
+class ConvTuningTest : public MNNTestCase {
+public:
+    virtual ~ConvTuningTest() = default;
+    virtual bool run() {
+        BackendConfig config;
+        config.flags = MNN_CPU_TUNING;
+        auto exe     = Executor::newExecutor(MNN_FORWARD_CPU, config, 2);
+        ExecutorScope scope(exe);
+        // Winograd units and tiled for 3x3, Strassen depths and tiled for 1x1
+        MNNTEST_ASSERT(_checkConv(16, 16, 20, 3));
+        MNNTEST_ASSERT(_checkConv(8, 24, 14, 1));
+        auto runtime = Executor::getRuntime().first[MNN_FORWARD_CPU];
+        auto cache   = runtime->onGetCache();
+        MNNTEST_ASSERT(nullptr != cache.first && cache.second > 0);
+        std::vector<uint8_t> buffer((const uint8_t*)cache.first, (const uint8_t*)cache.first + cache.second);
+
+        // A runtime without tuning takes the choices and saves them again
+        Backend::Info info;
+        info.type      = MNN_FORWARD_CPU;
+        info.numThread = 2;
+        std::shared_ptr<Runtime> other(MNNGetExtraRuntimeCreator(MNN_FORWARD_CPU)->onCreate(info));
+        MNNTEST_ASSERT(nullptr == other->onGetCache().first);
+        MNNTEST_ASSERT(other->onSetCache(buffer.data(), buffer.size()));
+        other->onSetCache(nullptr, 0);
+        MNNTEST_ASSERT(other->onGetCache().second == buffer.size());
+
+        // Low memory leaves Winograd out, so it doesn't take the choices timed with it
+        {
+            BackendConfig lowConfig = config;
+            lowConfig.memory        = BackendConfig::Memory_Low;
+            auto lowExe             = Executor::newExecutor(MNN_FORWARD_CPU, lowConfig, 2);
+            ExecutorScope lowScope(lowExe);
+            auto lowRuntime = Executor::getRuntime().first[MNN_FORWARD_CPU];
+            MNNTEST_ASSERT(lowRuntime->onSetCache(buffer.data(), buffer.size()));
+            MNNTEST_ASSERT(_checkConv(16, 16, 20, 3));
+            MNNTEST_ASSERT(_checkConv(8, 24, 14, 1));
+            MNNTEST_ASSERT(lowRuntime->onGetCache().second > buffer.size());
+        }
+
+        // A broken file is refused
+        std::shared_ptr<Runtime> broken(MNNGetExtraRuntimeCreator(MNN_FORWARD_CPU)->onCreate(info));
+        std::vector<uint8_t> garbage(buffer.size(), 0x5a);
+        MNNTEST_ASSERT(!broken->onSetCache(garbage.data(), garbage.size()));
+        MNNTEST_ASSERT(nullptr == broken->onGetCache().first);
+        return true;
+    }
+};
+MNNTestSuiteRegister(ConvTuningTest, "core/conv_tuning");
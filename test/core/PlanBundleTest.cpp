@@ -0,0 +1,77 @@
+//
+//  PlanBundleTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/07/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <stdio.h>
+#include "MNNTestSuite.h"
+#include "core/BufferAllocator.hpp"
+#include "core/PlanBundle.hpp"
+
+using namespace MNN;
+
+class PlanBundleTest : public MNNTestCase {
+public:
+    virtual ~PlanBundleTest() = default;
+    virtual bool run() {
+        std::vector<PlanRung> rungs(2);
+        rungs[0].budgetMB = 5500;
+        rungs[0].maxSize  = 4096;
+        rungs[0].address  = {{"3", 0}, {"3:1", 1024}, {"12", 2048}};
+        rungs[0].size     = {{"3", 1024}, {"3:1", 512}, {"12", 2048}};
+        rungs[0].sequence = {{"compute", 3}, {"compute", 12}, {"release", 3}};
+        rungs[1].budgetMB = 3800;
+        rungs[1].maxSize  = 2048;
+        rungs[1].address  = {{"3", 0}, {"12", 1024}};
+        rungs[1].sequence = {{"compute", 3}, {"pre-release", 3}, {"compute", 12}, {"recompute", 3}, {"re-release", 3}};
+
+        const char* path = "plan_bundle_test.bundle";
+        std::vector<int> opTypes = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+        MNNTEST_ASSERT(PlanBundle::save(path, "Test", 4, opTypes, rungs));
+        auto bundle = PlanBundle::load(path);
+        MNNTEST_ASSERT(nullptr != bundle);
+
+        // rungs are sorted by budget
+        MNNTEST_ASSERT(bundle->rungCount() == 2);
+        MNNTEST_ASSERT(bundle->budgetMB(0) == 3800);
+        MNNTEST_ASSERT(bundle->maxSize(1) == 4096);
+
+        MNNTEST_ASSERT(bundle->selectRung(8000) == 1);
+        MNNTEST_ASSERT(bundle->selectRung(4000) == 0);
+        MNNTEST_ASSERT(bundle->selectRung(100) == 0);
+
+        size_t offset = 0, size = 0;
+        MNNTEST_ASSERT(bundle->lookup(1, "3:1", offset, size) && offset == 1024 && size == 512);
+        MNNTEST_ASSERT(bundle->lookup(0, "12", offset, size) && offset == 1024 && size == 0);
+        MNNTEST_ASSERT(!bundle->lookup(0, "3:1", offset, size));
+
+        // a plan is rejected by a graph with other ops
+        MNNTEST_ASSERT(bundle->matchGraph(opTypes));
+        opTypes[5] = 42;
+        MNNTEST_ASSERT(!bundle->matchGraph(opTypes));
+        opTypes.pop_back();
+        MNNTEST_ASSERT(!bundle->matchGraph(opTypes));
+
+        std::vector<std::pair<std::string, int>> sequence;
+        bundle->loadSequence(0, sequence);
+        MNNTEST_ASSERT(sequence == rungs[1].sequence);
+
+        // the pool follows the rung both ways, switching down gives memory back
+        {
+            BufferAllocator allocator(BufferAllocator::Allocator::createDefault());
+            allocator.setHeuristicBundle(bundle, 1);
+            MNNTEST_ASSERT(allocator.totalSize() == 4096);
+            allocator.setHeuristicBundle(bundle, 0);
+            MNNTEST_ASSERT(allocator.totalSize() == 2048);
+            allocator.setHeuristicBundle(bundle, 1);
+            MNNTEST_ASSERT(allocator.totalSize() == 4096);
+        }
+        bundle = nullptr;
+        remove(path);
+        return true;
+    }
+};
+MNNTestSuiteRegister(PlanBundleTest, "core/plan_bundle");
@@ -691,3 +691,58 @@ public:
 };
 // {YUV_NV21, YUV_NV12, YUV_I420} -> {RGBA, RGB, BGRA, BGR, GRAY} unit test
 MNNTestSuiteRegister(ImageProcessYUVBlitterTest, "cv/image_process/yuv_blitter");
+
+class ImageProcessBatchTest : public MNNTestCase {
+public:
+    virtual ~ImageProcessBatchTest() = default;
+    virtual bool run() {
+        ImageProcess::Config config;
+        config.sourceFormat = RGBA;
+        config.destFormat   = BGR;
+        config.filterType   = BILINEAR;
+        config.wrap         = ZERO;
+        for (int i = 0; i < 3; ++i) {
+            config.mean[i]   = 127.5f;
+            config.normal[i] = 1.0f / 127.5f;
+        }
+        std::shared_ptr<ImageProcess> process(ImageProcess::create(config));
+
+        // random crop / flip like augmentation, images of different sizes, dest wider than a tile
+        const int batch = 5, dw = 300, dh = 37;
+        std::vector<std::vector<uint8_t>> sources(batch);
+        std::vector<ImageProcess::Image> images(batch);
+        for (int n = 0; n < batch; ++n) {
+            int sw         = 320 + 17 * n;
+            int sh         = 40 + 3 * n;
+            sources[n]     = genSourceData(sh, sw, 4);
+            auto& image    = images[n];
+            image.source   = sources[n].data();
+            image.width    = sw;
+            image.height   = sh;
+            image.matrix.setScale(n % 2 ? -1.0f : 1.0f, 1.0f, dw / 2.0f, 0.0f);
+            image.matrix.postRotate(n * 7.0f, dw / 2.0f, dh / 2.0f);
+            image.matrix.postTranslate(n * 5.0f, n * 2.0f);
+        }
+        for (auto format : {Tensor::CAFFE_C4, Tensor::CAFFE, Tensor::TENSORFLOW}) {
+            auto shape = format == Tensor::TENSORFLOW ? std::vector<int>{batch, dh, dw, 3} : std::vector<int>{batch, 3, dh, dw};
+            std::shared_ptr<Tensor> batched(Tensor::create<float>(shape, nullptr, format));
+            if (NO_ERROR != process->convert(images, batched.get(), 3)) {
+                MNN_ERROR("Batch convert failed for format %d\n", format);
+                return false;
+            }
+            shape[0] = 1;
+            auto size = batched->elementSize() / batch;
+            for (int n = 0; n < batch; ++n) {
+                std::shared_ptr<Tensor> single(Tensor::create<float>(shape, nullptr, format));
+                process->setMatrix(images[n].matrix);
+                process->convert(images[n].source, images[n].width, images[n].height, 0, single.get());
+                if (0 != ::memcmp(single->host<float>(), batched->host<float>() + n * size, size * sizeof(float))) {
+                    MNN_ERROR("Batch convert of image %d differs from single convert for format %d\n", n, format);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(ImageProcessBatchTest, "cv/image_process/batch");
@@ -0,0 +1,59 @@
+//
+//  ConvertRoundTripTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/07/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+using namespace MNN::Express;
+
+static std::vector<float> _values(int size, float step) {
+    std::vector<float> res(size);
+    for (int i = 0; i < size; ++i) {
+        res[i] = sinf(i * step);
+    }
+    return res;
+}
+
+// Converts that end in the format they started from are skipped by the raster cache, the result must not change
+class ConvertRoundTripTest : public MNNTestCase {
+public:
+    virtual ~ConvertRoundTripTest() = default;
+    virtual bool run() {
+        // 6 channels, so NC4HW4 has padding
+        const int c = 6;
+        auto x      = _Input({2, c, 9, 9}, NCHW);
+        auto input  = _values(x->getInfo()->size, 0.37f);
+        ::memcpy(x->writeMap<float>(), input.data(), input.size() * sizeof(float));
+        std::vector<float> results[2];
+        for (int roundTrip = 0; roundTrip < 2; ++roundTrip) {
+            auto y = _Conv(_values(c * c * 9, 0.11f), _values(c, 0.5f), _Convert(x, NC4HW4), {c, c}, {3, 3}, SAME);
+            auto z = y;
+            auto w = y;
+            if (roundTrip) {
+                z = _Convert(_Convert(y, NCHW), NC4HW4);
+                w = _Convert(_Convert(_Convert(y, NHWC), NCHW), NC4HW4);
+            }
+            z        = _Conv(_values(c * c * 9, 0.21f), _values(c, 0.4f), z, {c, c}, {3, 3}, SAME);
+            auto out = _Convert(w + z, NCHW);
+            auto ptr = out->readMap<float>();
+            if (nullptr == ptr) {
+                MNN_ERROR("round trip %d compute error\n", roundTrip);
+                return false;
+            }
+            results[roundTrip].assign(ptr, ptr + out->getInfo()->size);
+        }
+        for (int i = 0; i < results[0].size(); ++i) {
+            if (results[0][i] != results[1][i]) {
+                MNN_ERROR("%d: %f != %f\n", i, results[1][i], results[0][i]);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(ConvertRoundTripTest, "expr/convert_round_trip");
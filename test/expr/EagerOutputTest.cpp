@@ -0,0 +1,87 @@
+//
+//  EagerOutputTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/08/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/expr/ExprCreator.hpp>
+#include <MNN/expr/ExecutorScope.hpp>
+#include "MNNTestSuite.h"
+using namespace MNN::Express;
+
+static bool _check(VARP v, const std::vector<float>& expect, const char* name) {
+    auto ptr = v->readMap<float>();
+    if (nullptr == ptr || v->getInfo()->size != expect.size()) {
+        MNN_ERROR("EagerOutputTest: can't read %s\n", name);
+        return false;
+    }
+    for (int i = 0; i < expect.size(); ++i) {
+        if (fabsf(ptr[i] - expect[i]) > 1e-4f) {
+            MNN_ERROR("EagerOutputTest: %s[%d] = %f, expect %f\n", name, i, ptr[i], expect[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// outputs of a heuristic cache are copied out after their last reader, mapOutput must still give their values
+class EagerOutputTest : public MNNTestCase {
+public:
+    virtual ~EagerOutputTest() = default;
+    virtual bool run() {
+        MNN::BackendConfig config;
+        auto exe = Executor::newExecutor(MNN_FORWARD_CPU, config, 1);
+        ExecutorScope scope(exe);
+        exe->configExecution("EagerOutputTest", 1, "mnn", 1024);
+        const int n = 4, k = 16;
+        std::vector<float> w(k * k);
+        for (int i = 0; i < w.size(); ++i) {
+            w[i] = cosf(i * 0.3f) * 0.25f;
+        }
+        auto x = _Input({n, k}, NCHW);
+        // a is an output that two later commands read, c is read by nothing, d reads a and b
+        auto a = _MatMul(x, _Const(w.data(), {k, k}, NCHW));
+        auto b = _Relu(a + _Scalar<float>(0.5f));
+        auto c = _MatMul(b, _Const(w.data(), {k, k}, NCHW));
+        auto d = a * b;
+        exe->setHeuristicAlloc(true);
+        exe->setEagerOutputs(true);
+        Variable::prepareCompute({a, c, d});
+        exe->setEagerOutputs(false);
+        bool success = true;
+        // the second round reruns the same cache, its drained copies must be refreshed
+        for (int round = 0; round < 2 && success; ++round) {
+            std::vector<float> input(n * k);
+            auto ptr = x->writeMap<float>();
+            for (int i = 0; i < input.size(); ++i) {
+                input[i] = ptr[i] = sinf(i * 0.1f + round);
+            }
+            std::vector<float> ea(n * k, 0.0f), eb(n * k), ec(n * k, 0.0f), ed(n * k);
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < k; ++j) {
+                    for (int l = 0; l < k; ++l) {
+                        ea[i * k + j] += input[i * k + l] * w[l * k + j];
+                    }
+                }
+            }
+            for (int i = 0; i < n * k; ++i) {
+                eb[i] = fmaxf(ea[i] + 0.5f, 0.0f);
+                ed[i] = ea[i] * eb[i];
+            }
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < k; ++j) {
+                    for (int l = 0; l < k; ++l) {
+                        ec[i * k + j] += eb[i * k + l] * w[l * k + j];
+                    }
+                }
+            }
+            success = _check(a, ea, "a") && _check(c, ec, "c") && _check(d, ed, "d");
+        }
+        exe->setHeuristicAlloc(false);
+        return success;
+    }
+};
+MNNTestSuiteRegister(EagerOutputTest, "expr/eager_output");
@@ -0,0 +1,133 @@
+//
+//  ExecutionCacheTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/07/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/expr/ExprCreator.hpp>
+#include <MNN/expr/ExecutorScope.hpp>
+#include "MNNTestSuite.h"
+using namespace MNN::Express;
+
+static std::vector<float> _reference(const std::vector<float>& input, const std::vector<float>& weight,
+                                     const std::vector<float>& bias, int ic, int oc, int h, int w, int k) {
+    int oh = h - k + 1, ow = w - k + 1;
+    std::vector<float> output(oc * oh * ow, 0.0f);
+    for (int o = 0; o < oc; ++o) {
+        for (int y = 0; y < oh; ++y) {
+            for (int x = 0; x < ow; ++x) {
+                float sum = bias[o];
+                for (int i = 0; i < ic; ++i) {
+                    for (int ky = 0; ky < k; ++ky) {
+                        for (int kx = 0; kx < k; ++kx) {
+                            sum += input[(i * h + y + ky) * w + x + kx] * weight[((o * ic + i) * k + ky) * k + kx];
+                        }
+                    }
+                }
+                output[(o * oh + y) * ow + x] = sum;
+            }
+        }
+    }
+    return output;
+}
+
+// stride 1, no padding, weight ic x oc x k x k
+static std::vector<float> _deconvReference(const std::vector<float>& input, const std::vector<float>& weight, int ic,
+                                           int oc, int h, int k) {
+    int oh = h + k - 1;
+    std::vector<float> output(oc * oh * oh, 0.0f);
+    for (int o = 0; o < oc; ++o) {
+        for (int y = 0; y < oh; ++y) {
+            for (int x = 0; x < oh; ++x) {
+                float sum = 0.0f;
+                for (int i = 0; i < ic; ++i) {
+                    for (int ky = 0; ky < k; ++ky) {
+                        for (int kx = 0; kx < k; ++kx) {
+                            int sy = y - ky, sx = x - kx;
+                            if (sy < 0 || sx < 0 || sy >= h || sx >= h) {
+                                continue;
+                            }
+                            sum += input[(i * h + sy) * h + sx] * weight[((i * oc + o) * k + ky) * k + kx];
+                        }
+                    }
+                }
+                output[(o * oh + y) * oh + x] = sum;
+            }
+        }
+    }
+    return output;
+}
+
+class ExecutionCacheTest : public MNNTestCase {
+public:
+    virtual ~ExecutionCacheTest() = default;
+    virtual bool run() {
+        const int ic = 8, oc = 16, h = 12, w = 12;
+        std::vector<float> input(ic * h * w);
+        for (int i = 0; i < input.size(); ++i) {
+            input[i] = sinf(i * 0.1f);
+        }
+        // 3x3 goes to Winograd, 1x1 to Strassen
+        for (int k : {3, 1}) {
+            // same weights three times: the later graphs reuse the first execution, then other weights, then the
+            // first weights with another bias
+            for (int round = 0; round < 5; ++round) {
+                float scale = 3 == round ? -0.5f : 1.0f;
+                std::vector<float> weight(oc * ic * k * k);
+                for (int i = 0; i < weight.size(); ++i) {
+                    weight[i] = cosf(i * 0.37f) * scale;
+                }
+                std::vector<float> bias(oc, 4 == round ? 0.25f : 0.0f);
+                auto expect = _reference(input, weight, bias, ic, oc, h, w, k);
+                auto x = _Input({1, ic, h, w}, NCHW);
+                ::memcpy(x->writeMap<float>(), input.data(), input.size() * sizeof(float));
+                auto y = _Conv(std::vector<float>(weight), std::vector<float>(bias), _Convert(x, NC4HW4), {ic, oc}, {k, k});
+                y = _Convert(y, NCHW);
+                auto ptr = y->readMap<float>();
+                if (nullptr == ptr) {
+                    MNN_ERROR("kernel %d round %d compute error\n", k, round);
+                    return false;
+                }
+                for (int i = 0; i < expect.size(); ++i) {
+                    if (fabsf(ptr[i] - expect[i]) > 1e-3f * (1.0f + fabsf(expect[i]))) {
+                        MNN_ERROR("kernel %d round %d: %d: %f != %f\n", k, round, i, ptr[i], expect[i]);
+                        return false;
+                    }
+                }
+            }
+        }
+        // weight as input, as the data gradient of a trainable convolution: the later graphs clone the first
+        // execution, which must pick up their own weights. 3x3 goes to Winograd, 2x2 to the tiled convolution
+        for (int k : {3, 2}) {
+            for (int round = 0; round < 3; ++round) {
+                std::vector<float> weight(ic * oc * k * k);
+                for (int i = 0; i < weight.size(); ++i) {
+                    weight[i] = cosf(i * 0.37f + round);
+                }
+                auto expect = _deconvReference(input, weight, ic, oc, h, k);
+                auto x = _Input({1, ic, h, w}, NCHW);
+                ::memcpy(x->writeMap<float>(), input.data(), input.size() * sizeof(float));
+                auto wv = _Input({ic, oc, k, k}, NCHW);
+                ::memcpy(wv->writeMap<float>(), weight.data(), weight.size() * sizeof(float));
+                auto y   = _Deconv(wv, nullptr, x, CAFFE, {1, 1}, {1, 1}, 1, {0, 0});
+                auto ptr = y->readMap<float>();
+                if (nullptr == ptr || y->getInfo()->size != expect.size()) {
+                    MNN_ERROR("weight input kernel %d round %d compute error\n", k, round);
+                    return false;
+                }
+                for (int i = 0; i < expect.size(); ++i) {
+                    if (fabsf(ptr[i] - expect[i]) > 1e-3f * (1.0f + fabsf(expect[i]))) {
+                        MNN_ERROR("weight input kernel %d round %d: %d: %f != %f\n", k, round, i, ptr[i], expect[i]);
+                        return false;
+                    }
+                }
+            }
+        }
+        ExecutorScope::Current()->gc(Executor::FULL);
+        return true;
+    }
+};
+MNNTestSuiteRegister(ExecutionCacheTest, "expr/execution_cache");
@@ -0,0 +1,62 @@
+//
+//  MappedLoadTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/07/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <stdio.h>
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class MappedLoadTest : public MNNTestCase {
+public:
+    virtual ~MappedLoadTest() = default;
+    virtual bool run() {
+        const char* path = "mapped_load_test.mnn";
+        {
+            auto x = _Input({4}, NCHW);
+            x->setName("x");
+            float values[] = {1.0f, 2.0f, 3.0f, 4.0f};
+            auto w = _TrainableParam(values, {4}, NCHW);
+            w->setName("w");
+            auto y = _Multiply(x, w);
+            y->setName("y");
+            Variable::save({y}, path);
+        }
+        {
+            auto varMap = Variable::loadMap(path);
+            MNNTEST_ASSERT(varMap.find("w") != varMap.end() && varMap.find("x") != varMap.end());
+            auto w = varMap["w"];
+            MNNTEST_ASSERT(w->expr().first->inputType() == VARP::TRAINABLE);
+            auto wPtr = w->readMap<float>();
+            MNNTEST_ASSERT(nullptr != wPtr && wPtr[3] == 4.0f);
+            auto x    = varMap["x"];
+            auto xPtr = x->writeMap<float>();
+            for (int i = 0; i < 4; ++i) {
+                xPtr[i] = 1.0f;
+            }
+            MNNTEST_ASSERT(varMap["y"]->readMap<float>()[2] == 3.0f);
+            // writing a mapped parameter must not reach the file
+            w->writeMap<float>()[0] = 10.0f;
+            MNNTEST_ASSERT(w->readMap<float>()[0] == 10.0f);
+        }
+        {
+            auto varMap = Variable::loadMap(path);
+            MNNTEST_ASSERT(varMap["w"]->readMap<float>()[0] == 1.0f);
+        }
+        {
+            std::shared_ptr<Interpreter> net(Interpreter::createFromFile(path));
+            MNNTEST_ASSERT(nullptr != net && nullptr != net->getModelBuffer().first);
+            net->releaseModel();
+            MNNTEST_ASSERT(nullptr == net->getModelBuffer().first);
+        }
+        remove(path);
+        return true;
+    }
+};
+MNNTestSuiteRegister(MappedLoadTest, "expr/mapped_load");
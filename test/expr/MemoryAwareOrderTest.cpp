@@ -0,0 +1,73 @@
+//
+//  MemoryAwareOrderTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/08/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/expr/ExprCreator.hpp>
+#include <MNN/expr/ExecutorScope.hpp>
+#include "MNNTestSuite.h"
+using namespace MNN::Express;
+
+// a chain whose every step is also reduced to an output, listed with the last one first: the original order
+// runs the whole chain before the first reduction, the reordered one frees each step once the next is done
+static std::vector<float> _run(int size) {
+    auto x   = _Input({size}, NCHW);
+    auto ptr = x->writeMap<float>();
+    for (int i = 0; i < size; ++i) {
+        ptr[i] = sinf(i * 0.01f);
+    }
+    auto h1 = _Sin(x);
+    auto h2 = _Cos(h1);
+    auto h3 = _Sin(h2);
+    std::vector<VARP> outputs = {_ReduceSum(h3, {}), _ReduceSum(h1, {}), _ReduceSum(h2, {})};
+    Variable::prepareCompute(outputs);
+    std::vector<float> values;
+    for (auto v : outputs) {
+        auto value = v->readMap<float>();
+        if (nullptr == value) {
+            return {};
+        }
+        values.emplace_back(value[0]);
+    }
+    return values;
+}
+
+class MemoryAwareOrderTest : public MNNTestCase {
+public:
+    virtual ~MemoryAwareOrderTest() = default;
+    virtual bool run() {
+        MNN::BackendConfig config;
+        auto exe = Executor::newExecutor(MNN_FORWARD_CPU, config, 1);
+        ExecutorScope scope(exe);
+        exe->configExecution("MemoryAwareOrderTest", 1, "mnn", 1024);
+        exe->setHeuristicAlloc(true);
+        const int size = 64 * 1024;
+        auto expect = _run(size);
+        exe->setMemoryAwareOrder(true);
+        auto ordered = _run(size);
+        auto peak    = exe->lastOrderPeak();
+        // the rebuilt graph reuses the order
+        auto again = _run(size);
+        auto cachedPeak = exe->lastOrderPeak();
+        exe->setMemoryAwareOrder(false);
+        exe->setHeuristicAlloc(false);
+        if (expect.size() != 3 || ordered != expect || again != expect) {
+            MNN_ERROR("MemoryAwareOrderTest: reordered graph gives other outputs\n");
+            return false;
+        }
+        if (peak.second >= peak.first || peak.first < 3 * size * (int64_t)sizeof(float)) {
+            MNN_ERROR("MemoryAwareOrderTest: peak %lld -> %lld bytes\n", (long long)peak.first, (long long)peak.second);
+            return false;
+        }
+        if (cachedPeak != peak) {
+            MNN_ERROR("MemoryAwareOrderTest: the rebuilt graph didn't reuse the order\n");
+            return false;
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(MemoryAwareOrderTest, "expr/memory_aware_order");
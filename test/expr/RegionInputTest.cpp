@@ -0,0 +1,103 @@
+//
+//  RegionInputTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/07/20.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+using namespace MNN::Express;
+
+static VARP _values(const std::vector<int>& shape, float step) {
+    auto x   = _Input(shape, NCHW);
+    auto ptr = x->writeMap<float>();
+    for (int i = 0; i < x->getInfo()->size; ++i) {
+        ptr[i] = sinf(i * step);
+    }
+    return x;
+}
+
+static bool _check(VARP y, const std::vector<float>& expect, const char* name) {
+    auto ptr = y->readMap<float>();
+    if (nullptr == ptr || y->getInfo()->size != expect.size()) {
+        MNN_ERROR("%s: compute error\n", name);
+        return false;
+    }
+    for (int i = 0; i < expect.size(); ++i) {
+        if (fabsf(ptr[i] - expect[i]) > 1e-6f) {
+            MNN_ERROR("%s: %d: %f != %f\n", name, i, ptr[i], expect[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Binary ops read transposed, sliced and padded inputs through their regions, the results must match a raster
+class RegionInputTest : public MNNTestCase {
+public:
+    virtual ~RegionInputTest() = default;
+    virtual bool run() {
+        const int n = 2, c = 5, h = 7, w = 300;
+        auto x  = _values({n, c, h, w}, 0.37f);
+        auto xp = x->readMap<float>();
+        {
+            // transposed input on the right of a sub
+            auto y  = _values({n, w, h, c}, 0.11f);
+            auto yp = y->readMap<float>();
+            std::vector<float> expect(n * c * h * w);
+            for (int b = 0; b < n; ++b) {
+                for (int i = 0; i < w; ++i) {
+                    for (int j = 0; j < h; ++j) {
+                        for (int k = 0; k < c; ++k) {
+                            int index     = ((b * w + i) * h + j) * c + k;
+                            expect[index] = yp[index] - xp[((b * c + k) * h + j) * w + i];
+                        }
+                    }
+                }
+            }
+            if (!_check(_Subtract(y, _Transpose(x, {0, 3, 2, 1})), expect, "transpose")) {
+                return false;
+            }
+        }
+        {
+            // channel slice on the left of a mul
+            auto y  = _values({n, 2, h, w}, 0.23f);
+            auto yp = y->readMap<float>();
+            auto s  = _Slice(x, _Const(std::vector<int>({0, 1, 0, 0}).data(), {4}, NCHW, halide_type_of<int>()),
+                             _Const(std::vector<int>({n, 2, h, w}).data(), {4}, NCHW, halide_type_of<int>()));
+            std::vector<float> expect(n * 2 * h * w);
+            for (int b = 0; b < n; ++b) {
+                for (int i = 0; i < 2 * h * w; ++i) {
+                    expect[b * 2 * h * w + i] = xp[(b * c + 1) * h * w + i] * yp[b * 2 * h * w + i];
+                }
+            }
+            if (!_check(_Multiply(s, y), expect, "slice")) {
+                return false;
+            }
+        }
+        {
+            // padding leaves part of the output uncovered by the regions
+            auto y  = _values({n, c, h + 2, w}, 0.29f);
+            auto yp = y->readMap<float>();
+            auto p  = _Pad(x, _Const(std::vector<int>({0, 0, 0, 0, 1, 1, 0, 0}).data(), {8}, NCHW, halide_type_of<int>()));
+            std::vector<float> expect(n * c * (h + 2) * w);
+            for (int b = 0; b < n * c; ++b) {
+                for (int j = 0; j < h + 2; ++j) {
+                    for (int i = 0; i < w; ++i) {
+                        int index     = (b * (h + 2) + j) * w + i;
+                        float value   = (j == 0 || j == h + 1) ? 0.0f : xp[(b * h + j - 1) * w + i];
+                        expect[index] = fmaxf(value, yp[index]);
+                    }
+                }
+            }
+            if (!_check(_Maximum(p, y), expect, "pad")) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(RegionInputTest, "expr/region_input");
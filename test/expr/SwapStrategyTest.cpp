@@ -0,0 +1,132 @@
+//
+//  SwapStrategyTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/08/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
+#include <MNN/expr/ExprCreator.hpp>
+#include <MNN/expr/ExecutorScope.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN;
+using namespace MNN::Express;
+
+static const char* gModel = "SwapStrategyTest";
+
+static std::string _planFile() {
+    return std::string("heuristic/execution/") + gModel + "/" + gModel + ".1.1.execution.txt";
+}
+
+static void _writePlan(const std::vector<std::pair<std::string, int>>& steps) {
+    mkdir("heuristic", 0755);
+    mkdir("heuristic/execution", 0755);
+    mkdir((std::string("heuristic/execution/") + gModel).c_str(), 0755);
+    std::ofstream ofs(_planFile());
+    for (auto& s : steps) {
+        ofs << s.first << "\t" << s.second << "\n";
+    }
+}
+
+static void _removePlan() {
+    remove(_planFile().c_str());
+    rmdir((std::string("heuristic/execution/") + gModel).c_str());
+    rmdir("heuristic/execution");
+    rmdir("heuristic");
+}
+
+// commands: 0 sin, 1 topk with two outputs, 2 cos of 0, 3 square of the values, 4 cast of the indices
+static std::vector<VARP> _build(std::vector<float>& input) {
+    auto x   = _Input({16, 64}, NCHW);
+    auto ptr = x->writeMap<float>();
+    for (int i = 0; i < input.size(); ++i) {
+        ptr[i] = input[i];
+    }
+    auto a = _Sin(x);
+    std::unique_ptr<OpT> op(new OpT);
+    op->type  = OpType_TopKV2;
+    auto expr = Expr::create(std::move(op), {a, _Scalar<int>(4)}, 2);
+    return {_Cos(a), _Square(Variable::create(expr, 0)), _Cast<float>(Variable::create(expr, 1))};
+}
+
+static std::vector<std::vector<float>> _read(const std::vector<VARP>& outputs) {
+    std::vector<std::vector<float>> values;
+    for (auto v : outputs) {
+        auto ptr = v->readMap<float>();
+        if (nullptr == ptr) {
+            return {};
+        }
+        values.emplace_back(ptr, ptr + v->getInfo()->size);
+    }
+    return values;
+}
+
+static int _countSwapFiles() {
+    int count = 0;
+    for (int i = 0; i < 64; ++i) {
+        auto f = fopen(("swap/" + std::to_string(i) + ".mnn.tensor").c_str(), "rb");
+        if (nullptr != f) {
+            fclose(f);
+            remove(("swap/" + std::to_string(i) + ".mnn.tensor").c_str());
+            count++;
+        }
+    }
+    return count;
+}
+
+// the topk outputs are written out and dropped while the cos runs, then read back for their readers
+class SwapStrategyTest : public MNNTestCase {
+public:
+    virtual ~SwapStrategyTest() = default;
+    virtual bool run() {
+        std::vector<float> input(16 * 64);
+        for (int i = 0; i < input.size(); ++i) {
+            input[i] = sinf(i * 0.37f) * 3.0f;
+        }
+        BackendConfig config;
+        auto exe = Executor::newExecutor(MNN_FORWARD_CPU, config, 1);
+        ExecutorScope scope(exe);
+        exe->setHeuristicAlloc(true);
+        exe->configExecution(gModel, 1, "mnn", 1);
+        auto expect = _read(_build(input));
+
+        bool hasSwapDir = 0 == access("swap", F_OK);
+        mkdir("swap", 0755);
+        _writePlan({{"compute", 0}, {"compute", 1}, {"swap-out", 1}, {"pre-release", 1}, {"compute", 2},
+                    {"swap-in", 1}, {"compute", 3}, {"compute", 4}});
+        exe->configExecution(gModel, 1, "ours", 1);
+        auto swapped = _read(_build(input));
+        auto files   = _countSwapFiles();
+
+        // a swap-out that can't write fails the run, also when nothing waits for it before the end
+        _writePlan({{"compute", 0}, {"compute", 1}, {"compute", 2}, {"compute", 3}, {"compute", 4}, {"swap-out", 1}});
+        if (!hasSwapDir) {
+            rmdir("swap");
+        }
+        bool failed = hasSwapDir || _read(_build(input)).empty();
+        exe->configExecution(gModel, 1, "mnn", 1);
+        exe->setHeuristicAlloc(false);
+        _removePlan();
+
+        if (expect.size() != 3 || swapped != expect) {
+            MNN_ERROR("SwapStrategyTest: outputs after a swap differ\n");
+            return false;
+        }
+        if (2 != files) {
+            MNN_ERROR("SwapStrategyTest: %d tensors swapped, expect both outputs of topk\n", files);
+            return false;
+        }
+        if (!failed) {
+            MNN_ERROR("SwapStrategyTest: a failed swap-out didn't fail the run\n");
+            return false;
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(SwapStrategyTest, "expr/swap_strategy");
@@ -0,0 +1,84 @@
+//
+//  DeconvWeightInputTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/07/22.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+
+using namespace MNN::Express;
+
+// Deconvolution reading its weight from an input, as the data gradient of a convolution in training:
+// stride 1 runs as a convolution with the flipped weight (Winograd or tiled), larger strides as GEMM + Col2Im
+class DeconvWeightInputTest : public MNNTestCase {
+public:
+    virtual ~DeconvWeightInputTest() = default;
+    virtual bool run() {
+        struct Case {
+            int batch, ic, oc, ih, kernel, stride, pad;
+        };
+        // a large 3x3 picks Winograd F(4x4), the 5x5 at most F(2x2), the small ones and 2x2 the tiled convolution
+        std::vector<Case> cases = {
+            {2, 16, 8, 28, 3, 1, 1}, {2, 3, 5, 7, 3, 1, 1}, {1, 4, 4, 20, 5, 1, 2},
+            {2, 5, 3, 9, 2, 1, 0},   {2, 3, 5, 7, 3, 1, 0}, {2, 4, 6, 8, 3, 2, 1},
+        };
+        for (auto& c : cases) {
+            int oh = (c.ih - 1) * c.stride + c.kernel - 2 * c.pad;
+            std::vector<float> input(c.batch * c.ic * c.ih * c.ih), weight(c.ic * c.oc * c.kernel * c.kernel);
+            for (int i = 0; i < input.size(); ++i) {
+                input[i] = sinf(i * 0.1f);
+            }
+            for (int i = 0; i < weight.size(); ++i) {
+                weight[i] = cosf(i * 0.37f);
+            }
+            auto x = _Input({c.batch, c.ic, c.ih, c.ih}, NCHW);
+            ::memcpy(x->writeMap<float>(), input.data(), input.size() * sizeof(float));
+            auto w = _Input({c.ic, c.oc, c.kernel, c.kernel}, NCHW);
+            ::memcpy(w->writeMap<float>(), weight.data(), weight.size() * sizeof(float));
+            auto y   = _Deconv(w, nullptr, x, CAFFE, {c.stride, c.stride}, {1, 1}, 1, {c.pad, c.pad});
+            auto ptr = y->readMap<float>();
+            if (nullptr == ptr || y->getInfo()->size != c.batch * c.oc * oh * oh) {
+                MNN_ERROR("deconv %d %d %d %d: compute error\n", c.ic, c.oc, c.ih, c.kernel);
+                return false;
+            }
+            for (int b = 0; b < c.batch; ++b) {
+                for (int o = 0; o < c.oc; ++o) {
+                    for (int dy = 0; dy < oh; ++dy) {
+                        for (int dx = 0; dx < oh; ++dx) {
+                            float sum = 0.0f;
+                            for (int i = 0; i < c.ic; ++i) {
+                                for (int ky = 0; ky < c.kernel; ++ky) {
+                                    for (int kx = 0; kx < c.kernel; ++kx) {
+                                        int sy = dy + c.pad - ky, sx = dx + c.pad - kx;
+                                        if (sy < 0 || sx < 0 || sy % c.stride != 0 || sx % c.stride != 0) {
+                                            continue;
+                                        }
+                                        sy /= c.stride;
+                                        sx /= c.stride;
+                                        if (sy >= c.ih || sx >= c.ih) {
+                                            continue;
+                                        }
+                                        sum += input[((b * c.ic + i) * c.ih + sy) * c.ih + sx] *
+                                               weight[((i * c.oc + o) * c.kernel + ky) * c.kernel + kx];
+                                    }
+                                }
+                            }
+                            int index = ((b * c.oc + o) * oh + dy) * oh + dx;
+                            if (fabsf(ptr[index] - sum) > 1e-3f * (1.0f + fabsf(sum))) {
+                                MNN_ERROR("deconv %d %d %d %d: %d: %f != %f\n", c.ic, c.oc, c.ih, c.kernel, index,
+                                          ptr[index], sum);
+                                return false;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(DeconvWeightInputTest, "op/deconv_weight_input");
@@ -0,0 +1,94 @@
+//
+//  FakeQuantTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/07/30.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/expr/Expr.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "TestUtils.h"
+
+using namespace MNN::Express;
+
+static VARP _values(const std::vector<int>& shape, std::vector<float>& values) {
+    auto x   = _Input(shape, NCHW);
+    auto ptr = x->writeMap<float>();
+    values.resize(x->getInfo()->size);
+    for (int i = 0; i < values.size(); ++i) {
+        values[i] = sinf(i * 0.37f) * (1.0f + i % 7);
+        ptr[i]    = values[i];
+    }
+    return x;
+}
+
+// Quantize count values of every line with the line's own abs max
+static std::vector<float> _reference(const std::vector<float>& values, int lines, float limit, float minScale,
+                                     std::vector<float>& scales) {
+    std::vector<float> result(values.size());
+    int count = (int)values.size() / lines;
+    scales.resize(lines);
+    for (int l = 0; l < lines; ++l) {
+        float maxValue = minScale;
+        for (int i = 0; i < count; ++i) {
+            maxValue = fmaxf(maxValue, fabsf(values[l * count + i]));
+        }
+        scales[l] = maxValue * (1.0f / limit);
+        for (int i = 0; i < count; ++i) {
+            result[l * count + i] = roundf(values[l * count + i] * (1.0f / scales[l])) * scales[l];
+        }
+    }
+    return result;
+}
+
+class FakeQuantTest : public MNNTestCase {
+public:
+    virtual ~FakeQuantTest() = default;
+    virtual bool run() {
+        const float limit = 127.0f;
+        std::vector<float> values, scales;
+        {
+            // per-tensor, on NC4HW4 with the padded channels of the last pack
+            auto x        = _values({2, 5, 3, 7}, values);
+            auto expect   = _reference(values, 1, limit, 0.0001f, scales);
+            auto res      = _FakeQuant(_Convert(x, NC4HW4), nullptr, limit);
+            auto output   = _Convert(res[0], NCHW);
+            if (!checkVector<float>(output->readMap<float>(), expect.data(), expect.size(), 1e-5f) ||
+                !checkVector<float>(res[1]->readMap<float>(), scales.data(), 1, 1e-6f)) {
+                MNN_ERROR("FakeQuant per-tensor test failed!\n");
+                return false;
+            }
+        }
+        {
+            // per-channel on axis 0, as for convolution weights
+            auto x      = _values({6, 3, 3, 3}, values);
+            auto expect = _reference(values, 6, limit, 1e-6f, scales);
+            auto res    = _FakeQuant(x, nullptr, limit, 0, 1e-6f);
+            if (!checkVector<float>(res[0]->readMap<float>(), expect.data(), expect.size(), 1e-5f) ||
+                !checkVector<float>(res[1]->readMap<float>(), scales.data(), scales.size(), 1e-6f)) {
+                MNN_ERROR("FakeQuant per-channel test failed!\n");
+                return false;
+            }
+        }
+        {
+            // the values use their own scale, only the returned scale follows the running one
+            auto x      = _values({1, 4, 5, 5}, values);
+            auto expect = _reference(values, 1, limit, 0.0001f, scales);
+            const float running = 0.01f;
+            for (bool maximum : {false, true}) {
+                float scale = maximum ? fmaxf(running, scales[0]) : running * 0.9f + scales[0] * 0.1f;
+                auto res = _FakeQuant(x, _Scalar<float>(running), limit, -1, 0.0001f, 0.9f, maximum);
+                if (!checkVector<float>(res[0]->readMap<float>(), expect.data(), expect.size(), 1e-5f) ||
+                    !checkVector<float>(res[1]->readMap<float>(), &scale, 1, 1e-6f)) {
+                    MNN_ERROR("FakeQuant running scale test failed, maximum = %d\n", maximum);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(FakeQuantTest, "op/fake_quant");
@@ -0,0 +1,85 @@
+//
+//  RasterTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/07/20.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/expr/ExecutorScope.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "TestUtils.h"
+
+using namespace MNN::Express;
+
+// Transpose, broadcast and concat on tensors large enough for the raster to split its regions between threads
+class RasterTest : public MNNTestCase {
+public:
+    virtual ~RasterTest() = default;
+    virtual bool run() {
+        MNN::BackendConfig config;
+        auto exe = Executor::newExecutor(MNN_FORWARD_CPU, config, 4);
+        ExecutorScope scope(exe);
+        const int n = 2, c = 19, h = 33, w = 37;
+        std::vector<float> data(n * c * h * w);
+        for (int i = 0; i < data.size(); ++i) {
+            data[i] = sinf(i * 0.01f);
+        }
+        auto x = _Const(data.data(), {n, c, h, w}, NCHW, halide_type_of<float>());
+        std::vector<std::vector<int>> perms = {{0, 2, 3, 1}, {0, 3, 1, 2}, {1, 0, 2, 3}, {3, 2, 1, 0}, {0, 1, 3, 2}};
+        for (auto& perm : perms) {
+            int dims[4] = {n, c, h, w};
+            int stride[4] = {c * h * w, h * w, w, 1};
+            auto y   = _Transpose(x, perm);
+            auto ptr = y->readMap<float>();
+            int index = 0;
+            for (int a = 0; a < dims[perm[0]]; ++a) {
+                for (int b = 0; b < dims[perm[1]]; ++b) {
+                    for (int d = 0; d < dims[perm[2]]; ++d) {
+                        for (int e = 0; e < dims[perm[3]]; ++e, ++index) {
+                            auto expect = data[a * stride[perm[0]] + b * stride[perm[1]] + d * stride[perm[2]] + e * stride[perm[3]]];
+                            if (ptr[index] != expect) {
+                                MNN_ERROR("transpose %d%d%d%d: %d: %f != %f\n", perm[0], perm[1], perm[2], perm[3], index,
+                                          ptr[index], expect);
+                                return false;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        {
+            std::vector<float> scale(c);
+            for (int i = 0; i < c; ++i) {
+                scale[i] = i * 0.5f;
+            }
+            auto s     = _Const(scale.data(), {1, c, 1, 1}, NCHW, halide_type_of<float>());
+            auto shape = _Const(std::vector<int>({n, c, h, w}).data(), {4}, NCHW, halide_type_of<int>());
+            auto y     = _BroadcastTo(s, shape);
+            auto ptr   = y->readMap<float>();
+            for (int i = 0; i < data.size(); ++i) {
+                if (ptr[i] != scale[(i / (h * w)) % c]) {
+                    MNN_ERROR("broadcast: %d: %f != %f\n", i, ptr[i], scale[(i / (h * w)) % c]);
+                    return false;
+                }
+            }
+        }
+        {
+            auto y   = _Concat({x, x}, 2);
+            auto ptr = y->readMap<float>();
+            for (int i = 0; i < n * c; ++i) {
+                for (int j = 0; j < 2 * h * w; ++j) {
+                    auto expect = data[i * h * w + j % (h * w)];
+                    if (ptr[i * 2 * h * w + j] != expect) {
+                        MNN_ERROR("concat: %d: %f != %f\n", i * 2 * h * w + j, ptr[i * 2 * h * w + j], expect);
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(RasterTest, "op/raster");
@@ -0,0 +1,119 @@
+//
+//  AllocatorSpeed.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/07/28.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <map>
+#include <MNN/AutoTime.hpp>
+#include <MNN/expr/ExecutorScope.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "backend/cpu/CPUBackend.hpp"
+#include "core/BufferAllocator.hpp"
+
+using namespace MNN;
+using namespace MNN::Express;
+#define ROUNDS 200
+
+// Residual blocks of varied widths, so that the buffers have many sizes and lifetimes
+static VARP _net(VARP x) {
+    x = _Conv(0.01f, 0.0f, x, {3, 16}, {3, 3}, SAME);
+    for (int i = 0; i < 4; ++i) {
+        int c    = 16 << i;
+        auto y   = _Relu(_Conv(0.01f, 0.0f, x, {c, c}, {3, 3}, SAME));
+        y        = _Conv(0.01f, 0.0f, y, {c, c}, {3, 3}, SAME);
+        x        = _Relu(x + y);
+        auto z   = _Conv(0.01f, 0.0f, x, {c, c}, {1, 1});
+        x        = _Concat({x, z}, 1);
+        x        = _MaxPool(x, {2, 2}, {2, 2});
+    }
+    return _ReduceMean(x, {2, 3});
+}
+
+// Run the requests of one trace, blocks alive at the end are freed so that every round starts the same
+static bool _replay(const std::vector<CPUBackend::AllocRecord>& trace, BufferAllocator* staticAllocator,
+                    BufferAllocator* dynamicAllocator, bool check) {
+    std::map<const Tensor*, std::pair<BufferAllocator*, std::pair<void*, size_t>>> live;
+    // address -> end of the live blocks
+    std::map<size_t, size_t> used;
+    for (auto& record : trace) {
+        auto allocator = Backend::STATIC == record.storageType ? staticAllocator : dynamicAllocator;
+        auto iter      = live.find(record.tensor);
+        if (0 == record.size) {
+            if (iter != live.end() && Backend::DYNAMIC_SEPERATE != record.storageType) {
+                if (check) {
+                    used.erase((size_t)iter->second.second.first + iter->second.second.second);
+                }
+                iter->second.first->free(iter->second.second);
+                live.erase(iter);
+            }
+            continue;
+        }
+        auto pointer = allocator->alloc(record.size, Backend::DYNAMIC_SEPERATE == record.storageType);
+        if (nullptr == pointer.first) {
+            return false;
+        }
+        if (check) {
+            auto start = (size_t)pointer.first + pointer.second;
+            auto next  = used.lower_bound(start);
+            if ((next != used.end() && next->first < start + record.size) ||
+                (next != used.begin() && (--next)->second > start)) {
+                MNN_ERROR("%d bytes at %p overlap a live buffer\n", record.size, (void*)start);
+                return false;
+            }
+            used[start] = start + record.size;
+        }
+        live[record.tensor] = std::make_pair(allocator, pointer);
+    }
+    for (auto& iter : live) {
+        iter.second.first->free(iter.second.second);
+    }
+    return true;
+}
+
+// Replays the buffer requests CPUBackend::allocBuffer saw for a small network, on the tree and the TLSF engines
+class AllocatorSpeed : public MNNTestCase {
+public:
+    virtual bool run() {
+        std::vector<CPUBackend::AllocRecord> trace;
+        CPUBackend::setAllocTrace(&trace);
+        {
+            auto exe = Executor::newExecutor(MNN_FORWARD_CPU, BackendConfig(), 1);
+            ExecutorScope scope(exe);
+            for (int size = 64; size <= 128; size += 32) {
+                auto x = _Input({1, 3, size, size}, NC4HW4);
+                ::memset(x->writeMap<float>(), 0, x->getInfo()->size * sizeof(float));
+                auto y = _net(x);
+                if (nullptr == y->readMap<float>()) {
+                    CPUBackend::setAllocTrace(nullptr);
+                    return false;
+                }
+            }
+        }
+        CPUBackend::setAllocTrace(nullptr);
+        MNN_PRINT("Replay %d buffer requests, %d times\n", (int)trace.size(), ROUNDS);
+        const char* names[] = {"tree", "tlsf"};
+        for (auto engine : {BufferAllocator::ENGINE_TREE, BufferAllocator::ENGINE_TLSF}) {
+            BufferAllocator staticAllocator(BufferAllocator::Allocator::createDefault());
+            staticAllocator.setEngine(engine);
+            BufferAllocator dynamicAllocator(BufferAllocator::Allocator::createRecurse(&staticAllocator));
+            dynamicAllocator.setEngine(engine);
+            if (!_replay(trace, &staticAllocator, &dynamicAllocator, true)) {
+                MNN_ERROR("%s engine failed\n", names[engine]);
+                return false;
+            }
+            MNN::Timer timer;
+            for (int i = 0; i < ROUNDS; ++i) {
+                _replay(trace, &staticAllocator, &dynamicAllocator, false);
+            }
+            float ns = (float)timer.durationInUs() * 1000.0f / ROUNDS / trace.size();
+            MNN_PRINT("%s: %.1f ns per request, %.2f MB from the OS\n", names[engine], ns,
+                      staticAllocator.totalSize() / 1024.0f / 1024.0f);
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(AllocatorSpeed, "speed/Allocator");
@@ -0,0 +1,150 @@
+//
+//  TrainKernelSpeed.cpp
+//  MNNTests
+//
+//  Created by MNN on 2021/07/26.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/AutoTime.hpp>
+#include <MNN/expr/Expr.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+#define BATCH 16
+#define CHANNEL 63
+#define PLANE 56
+#define TIME 20
+
+static VARP _GradOp(MNN::OpType type, VARP origin, VARP diff) {
+    using namespace MNN;
+    std::unique_ptr<OpT> op(new OpT);
+    op->type = type;
+    if (OpType_SoftmaxGrad == type) {
+        op->main.type           = OpParameter_Axis;
+        op->main.value          = new AxisT;
+        op->main.AsAxis()->axis = 1;
+    } else {
+        op->main.type  = OpParameter_Relu;
+        op->main.value = new ReluT;
+    }
+    return Variable::create(Expr::create(std::move(op), {origin, diff}));
+}
+
+static VARP _values(const std::vector<int>& shape, float step, float scale) {
+    auto x   = _Input(shape, NCHW);
+    auto ptr = x->writeMap<float>();
+    for (int i = 0; i < x->getInfo()->size; ++i) {
+        ptr[i] = sinf(i * step) * scale;
+    }
+    return x;
+}
+
+static bool _check(const float* ptr, const std::vector<float>& expect, const char* name) {
+    for (int i = 0; i < expect.size(); ++i) {
+        if (fabsf(ptr[i] - expect[i]) > 1e-4f * (1.0f + fabsf(expect[i]))) {
+            MNN_ERROR("%s: %d: %f != %f\n", name, i, ptr[i], expect[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Time the output over inputs rewritten each round, bytes is the traffic of one run
+static void _speed(const std::vector<VARP>& inputs, VARP output, float bytes, const char* name) {
+    MNN::Timer timer;
+    for (int i = 0; i < TIME; ++i) {
+        for (auto x : inputs) {
+            x->writeMap<float>();
+        }
+        output->readMap<float>();
+    }
+    float us = (float)timer.durationInUs() / TIME;
+    MNN_PRINT("%s: %.3f ms, %.2f GB/s\n", name, us / 1000.0f, bytes / us / 1000.0f);
+}
+
+// Training-only kernels: relu / relu6 / softmax gradients, moments, mean reduction and the optimizer's product
+class TrainKernelSpeed : public MNNTestCase {
+public:
+    virtual bool run() {
+        const int size = BATCH * CHANNEL * PLANE * PLANE;
+        auto origin    = _values({BATCH, CHANNEL, PLANE, PLANE}, 0.37f, 8.0f);
+        auto diff      = _values({BATCH, CHANNEL, PLANE, PLANE}, 0.11f, 1.0f);
+        auto op        = origin->readMap<float>();
+        auto dp        = diff->readMap<float>();
+        MNN_PRINT("Test training kernels for %d x %d x %d x %d, %d times\n", BATCH, CHANNEL, PLANE, PLANE, TIME);
+        {
+            std::vector<float> relu(size), relu6(size), prod(size);
+            for (int i = 0; i < size; ++i) {
+                relu[i]  = op[i] > 0.0f ? dp[i] : 0.0f;
+                relu6[i] = (op[i] > 0.0f && op[i] <= 6.0f) ? dp[i] : 0.0f;
+                prod[i]  = op[i] * dp[i];
+            }
+            auto reluGrad  = _GradOp(MNN::OpType_ReluGrad, origin, diff);
+            auto relu6Grad = _GradOp(MNN::OpType_Relu6Grad, origin, diff);
+            auto product   = _Multiply(origin, diff);
+            if (!_check(reluGrad->readMap<float>(), relu, "ReluGrad") ||
+                !_check(relu6Grad->readMap<float>(), relu6, "Relu6Grad") ||
+                !_check(product->readMap<float>(), prod, "Mul")) {
+                return false;
+            }
+            _speed({origin, diff}, reluGrad, size * 12.0f, "ReluGrad");
+            _speed({origin, diff}, relu6Grad, size * 12.0f, "Relu6Grad");
+            _speed({origin, diff}, product, size * 12.0f, "Mul");
+        }
+        {
+            // softmax lines keep values around 1 / line
+            const int line  = CHANNEL * PLANE;
+            const int lines = BATCH * PLANE;
+            auto softmax    = _values({lines, line}, 0.37f, 1.0f / line);
+            auto grad       = _values({lines, line}, 0.11f, 1.0f);
+            auto sp         = softmax->readMap<float>();
+            auto gp         = grad->readMap<float>();
+            std::vector<float> expect(size);
+            for (int b = 0; b < lines; ++b) {
+                float sum = 0.0f;
+                for (int i = 0; i < line; ++i) {
+                    sum += sp[b * line + i] * gp[b * line + i];
+                }
+                for (int i = 0; i < line; ++i) {
+                    expect[b * line + i] = sp[b * line + i] * (gp[b * line + i] - sum);
+                }
+            }
+            auto softmaxGrad = _GradOp(MNN::OpType_SoftmaxGrad, softmax, grad);
+            if (!_check(softmaxGrad->readMap<float>(), expect, "SoftmaxGrad")) {
+                return false;
+            }
+            _speed({softmax, grad}, softmaxGrad, size * 16.0f, "SoftmaxGrad");
+        }
+        {
+            std::vector<float> mean(BATCH * CHANNEL), variance(BATCH * CHANNEL);
+            for (int i = 0; i < BATCH * CHANNEL; ++i) {
+                double sum = 0.0, square = 0.0;
+                for (int j = 0; j < PLANE * PLANE; ++j) {
+                    sum += op[i * PLANE * PLANE + j];
+                }
+                sum = sum / (PLANE * PLANE);
+                for (int j = 0; j < PLANE * PLANE; ++j) {
+                    square += (op[i * PLANE * PLANE + j] - sum) * (op[i * PLANE * PLANE + j] - sum);
+                }
+                mean[i]     = sum;
+                variance[i] = square / (PLANE * PLANE);
+            }
+            auto moments    = _Moments(_Convert(origin, NC4HW4), {2, 3}, nullptr, true);
+            auto meanOutput = _Convert(moments[0], NCHW);
+            auto varOutput  = _Convert(moments[1], NCHW);
+            auto reduceMean = _ReduceMean(origin, {2, 3}, true);
+            if (!_check(meanOutput->readMap<float>(), mean, "Moments mean") ||
+                !_check(varOutput->readMap<float>(), variance, "Moments variance") ||
+                !_check(reduceMean->readMap<float>(), mean, "ReduceMean")) {
+                return false;
+            }
+            _speed({origin}, varOutput, size * 8.0f, "Moments");
+            _speed({origin}, reduceMean, size * 4.0f, "ReduceMean");
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(TrainKernelSpeed, "speed/TrainKernel");
@@ -17,6 +17,12 @@
 #include <sys/types.h>
 #include <dirent.h>
 #endif
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
@@ -128,3 +134,92 @@ void Helper::invertData(float* dst, const float* src, int size) {
         }
     }
 }
+
+namespace {
+// workers kept across parallelFor calls, calibration makes several of them per batch
+class WorkerPool {
+public:
+    static WorkerPool& get() {
+        static WorkerPool pool;
+        return pool;
+    }
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mWake.notify_all();
+        for (auto& t : mWorkers) {
+            t.join();
+        }
+    }
+    // run work(t) for t in [0, number), the calling thread takes t = 0
+    void run(int number, const std::function<void(int)>& work) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            while ((int)mWorkers.size() < number - 1) {
+                int index = (int)mWorkers.size() + 1;
+                mWorkers.emplace_back([this, index]() { loop(index); });
+            }
+            mWork    = &work;
+            mNumber  = number;
+            mPending = number - 1;
+            mGeneration++;
+        }
+        mWake.notify_all();
+        work(0);
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [this]() { return 0 == mPending; });
+        mWork = nullptr;
+    }
+
+private:
+    void loop(int index) {
+        int seen = 0;
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true) {
+            mWake.wait(lock, [this, &seen]() { return mStop || mGeneration != seen; });
+            if (mStop) {
+                return;
+            }
+            seen = mGeneration;
+            if (index >= mNumber) {
+                continue;
+            }
+            auto work = mWork;
+            lock.unlock();
+            (*work)(index);
+            lock.lock();
+            if (0 == --mPending) {
+                mDone.notify_one();
+            }
+        }
+    }
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    const std::function<void(int)>* mWork = nullptr;
+    int mNumber     = 0;
+    int mPending    = 0;
+    int mGeneration = 0;
+    bool mStop      = false;
+};
+} // namespace
+
+void Helper::parallelFor(int size, int threadNumber, const std::function<void(int, int)>& task) {
+    threadNumber = std::max(1, std::min(threadNumber, size));
+    if (threadNumber <= 1) {
+        for (int i = 0; i < size; ++i) {
+            task(i, 0);
+        }
+        return;
+    }
+    // items differ a lot in cost (a stem conv output vs. a 7x7 feature map), so threads pull them one by one
+    std::atomic<int> next(0);
+    WorkerPool::get().run(threadNumber, [&next, &task, size](int t) {
+        for (int i = next++; i < size; i = next++) {
+            task(i, t);
+        }
+    });
+}
@@ -6,6 +6,7 @@
 //  Copyright © 2018, Alibaba Group Holding Limited
 //
 
+#include <functional>
 #include <set>
 #include <string>
 #include <MNN/ImageProcess.hpp>
@@ -28,4 +29,7 @@ public:
     static void preprocessInput(MNN::CV::ImageProcess* pretreat, int targetWidth, int targetHeight,
                                 const std::string& inputImageFileName, MNN::Tensor* input);
     static void invertData(float* dst, const float* src, int size);
+    // run task(index, threadIndex) for index in [0, size) on threadNumber threads, blocks until all are done.
+    // The calling thread takes part, the other threads are kept for the next call
+    static void parallelFor(int size, int threadNumber, const std::function<void(int, int)>& task);
 };
@@ -56,13 +56,21 @@ TensorStatistic::TensorStatistic(const MNN::Tensor* tensor, std::string method,
         }
     }
 }
-void TensorStatistic::updateRange() {
-    if (mUpdatedRangeFlags) {
-        return;
+bool TensorStatistic::fetch() {
+    if (mFetched) {
+        return false;
     }
-    mUpdatedRangeFlags = true;
+    mFetched = true;
     mOriginTensor->copyToHostTensor(mHostTensor.get());
-    int batch   = mHostTensor->batch();
+    mVisited = true;
+    return true;
+}
+
+void TensorStatistic::updateRange(int validBatch) {
+    if (!mFetched) {
+        return;
+    }
+    int batch   = std::min(mHostTensor->batch(), validBatch);
     int channel = mHostTensor->channel();
     int width   = mHostTensor->width();
     int height  = mHostTensor->height();
@@ -86,7 +94,6 @@ void TensorStatistic::updateRange() {
             mRangePerChannel[cIndex].second = maxValue;
         }
     }
-    mVisited = true;
 }
 
 void TensorStatistic::resetDistribution() {
@@ -108,13 +115,11 @@ void TensorStatistic::resetDistribution() {
     // MNN_PRINT("==> %s max: %f\n", mName.c_str(),std::max(fabsf(mRangePerChannel[0].second),
     // fabsf(mRangePerChannel[0].first)));
 }
-void TensorStatistic::updateDistribution() {
-    if (mUpdatedDistributionFlag) {
+void TensorStatistic::updateDistribution(int validBatch) {
+    if (!mFetched) {
         return;
     }
-    mUpdatedDistributionFlag = true;
-    mOriginTensor->copyToHostTensor(mHostTensor.get());
-    int batch   = mHostTensor->batch();
+    int batch   = std::min(mHostTensor->batch(), validBatch);
     int channel = mHostTensor->channel();
     int width   = mHostTensor->width();
     int height  = mHostTensor->height();
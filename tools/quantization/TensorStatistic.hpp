@@ -23,15 +23,16 @@ public:
         // Do nothing
     }
 
-    void resetUpdatedDistributionFlag() {
-        mUpdatedDistributionFlag = false;
+    void resetFetched() {
+        mFetched = false;
     }
-    void resetUpdatedRangeFlags() {
-        mUpdatedRangeFlags = false;
-    }
-    void updateRange();
+    // copy the tensor inside the session callback, returns false if it was already copied since resetFetched
+    bool fetch();
+    // the update functions only read the fetched copy, so different statistics can be updated in parallel,
+    // validBatch limits them to the first images of a partially filled batch
+    void updateRange(int validBatch);
     void resetDistribution();
-    void updateDistribution();
+    void updateDistribution(int validBatch);
 
     void setThresholdMethod(GET_THRESHOLD_METHOD thresholdMethod);
     void setChannelWise(bool mergeChannel);
@@ -66,8 +67,7 @@ private:
     std::shared_ptr<MNN::Tensor> mHostTensor;
     const MNN::Tensor* mOriginTensor;
     int mBinNumber;
-    bool mUpdatedDistributionFlag = false;
-    bool mUpdatedRangeFlags       = false;
+    bool mFetched = false;
 
     bool mMergeChannel                    = true;
     std::string mName;
@@ -11,6 +11,7 @@
 #include <fstream>
 #include <iostream>
 #include <set>
+#include <thread>
 #include <algorithm>
 #include <MNN/ImageProcess.hpp>
 #include "flatbuffers/util.h"
@@ -152,9 +153,19 @@ Calibration::Calibration(MNN::NetT* model, const uint8_t* modelBuffer, const int
         if (picObj.HasMember("debug")) {
             _debug = picObj["debug"].GetBool();
         }
+        _threadNumber = std::max(1, (int)std::thread::hardware_concurrency());
+        if (picObj.HasMember("thread_number")) {
+            _threadNumber = std::max(1, picObj["thread_number"].GetInt());
+        }
+        if (picObj.HasMember("batch_size")) {
+            _batch = std::max(1, picObj["batch_size"].GetInt());
+        }
+        DLOG(INFO) << "calibration batch: " << _batch << ", threads: " << _threadNumber;
+    }
+    for (int i = 0; i < _threadNumber; ++i) {
+        _processes.emplace_back(ImageProcess::create(config));
     }
-    std::shared_ptr<ImageProcess> process(ImageProcess::create(config));
-    _process = process;
+    _process = _processes[0];
 
     // read images file names
     Helper::readImages(_imgaes, imagePath.c_str(), &_imageNum);
@@ -195,6 +206,7 @@ void Calibration::_initMNNSession(const uint8_t* modelBuffer, const int bufferSi
         _inputTensorDims[3] = _width;
     }
     if (_featureQuantizeMethod == "KL") {
+        _inputTensorDims[0] = _batch;
         _interpreter->resizeTensor(_inputTensor, _inputTensorDims);
         _interpreter->resizeSession(_session);
         _interpreterOrigin->resizeTensor(_inputTensorOrigin, _inputTensorDims);
@@ -317,44 +329,62 @@ void Calibration::_initMaps() {
     }
 }
 
+int Calibration::_feedImages(int begin) {
+    int batch                           = std::min(_batch, (int)_imgaes.size() - begin);
+    std::vector<int> oneImageTensorDims = _inputTensorDims;
+    oneImageTensorDims[0]               = 1;
+    auto inputTensorDataFormat          = MNN::TensorUtils::getDescribe(_inputTensor)->dimensionFormat;
+    auto dimType                        = MNN::Tensor::CAFFE_C4;
+    if (inputTensorDataFormat == MNN::MNN_DATA_FORMAT_NHWC) {
+        dimType = MNN::Tensor::TENSORFLOW;
+    }
+    Helper::parallelFor(batch, _threadNumber, [&](int i, int threadIndex) {
+        auto curPtr = _inputTensor->host<float>() + i * _inputTensor->stride(0);
+        std::shared_ptr<MNN::Tensor> tensorWarp(
+            MNN::Tensor::create(oneImageTensorDims, _inputTensor->getType(), curPtr, dimType));
+        Helper::preprocessInput(_processes[threadIndex].get(), _width, _height, _imgaes[begin + i], tensorWarp.get());
+    });
+    return batch;
+}
+
+void Calibration::_updateFeatureStatistics(bool range, int validBatch) {
+    // every statistic has its own histogram and range, so a tensor is never updated by two threads
+    std::vector<TensorStatistic*> statistics;
+    for (auto& iter : _featureInfo) {
+        statistics.emplace_back(iter.second.get());
+    }
+    Helper::parallelFor((int)statistics.size(), _threadNumber, [&](int i, int threadIndex) {
+        if (range) {
+            statistics[i]->updateRange(validBatch);
+        } else {
+            statistics[i]->updateDistribution(validBatch);
+        }
+    });
+}
+
 void Calibration::_computeFeatureMapsRange() {
-    // feed input data according to input images
+    // the callbacks only copy the feature maps, the statistics are updated after the run on all threads
+    MNN::TensorCallBackWithInfo fetch = [&](const std::vector<MNN::Tensor*>& nTensors,
+                                            const MNN::OperatorInfo* info) {
+        for (auto t : nTensors) {
+            auto iter = _featureInfo.find(t);
+            if (iter != _featureInfo.end()) {
+                iter->second->fetch();
+            }
+        }
+        return true;
+    };
     int count = 0;
-    for (const auto& img : _imgaes) {
+    while (count < _imgaes.size()) {
         for (auto& iter : _featureInfo) {
             iter.second->setVisited(false);
+            iter.second->resetFetched();
         }
+        auto batch = _feedImages(count);
+        count += batch;
 
-        for (auto& iter : _featureInfo) {
-            iter.second->resetUpdatedRangeFlags();
-        }
-        count++;
-        Helper::preprocessInput(_process.get(), _width, _height, img, _inputTensor);
-
-        MNN::TensorCallBackWithInfo before = [&](const std::vector<MNN::Tensor*>& nTensors,
-                                                 const MNN::OperatorInfo* info) {
-            for (auto t : nTensors) {
-                if (_featureInfo.find(t) != _featureInfo.end()) {
-                    if (_featureInfo[t]->visited() == false) {
-                        _featureInfo[t]->updateRange();
-                    }
-                }
-            }
-            return true;
-        };
-        MNN::TensorCallBackWithInfo after = [&](const std::vector<MNN::Tensor*>& nTensors,
-                                                const MNN::OperatorInfo* info) {
-            for (auto t : nTensors) {
-                if (_featureInfo.find(t) != _featureInfo.end()) {
-                    if (_featureInfo[t]->visited() == false) {
-                        _featureInfo[t]->updateRange();
-                    }
-                }
-            }
-            return true;
-        };
-
-        _interpreter->runSessionWithCallBackInfo(_session, before, after);
+        _interpreter->runSessionWithCallBackInfo(_session, fetch, fetch);
+        _updateFeatureStatistics(true, batch);
         MNN_PRINT("\rComputeFeatureRange: %.2lf %%", (float)count * 100.0f / (float)_imageNum);
         fflush(stdout);
     }
@@ -365,40 +395,26 @@ void Calibration::_collectFeatureMapsDistribution() {
     for (auto& iter : _featureInfo) {
         iter.second->resetDistribution();
     }
-    // feed input data according to input images
-    MNN::TensorCallBackWithInfo before = [&](const std::vector<MNN::Tensor*>& nTensors, const MNN::OperatorInfo* info) {
+    MNN::TensorCallBackWithInfo fetch = [&](const std::vector<MNN::Tensor*>& nTensors, const MNN::OperatorInfo* info) {
         for (auto t : nTensors) {
-            if (_featureInfo.find(t) != _featureInfo.end()) {
-                if (_featureInfo[t]->visited() == false) {
-                    _featureInfo[t]->updateDistribution();
-                }
-            }
-        }
-        return true;
-    };
-    MNN::TensorCallBackWithInfo after = [&](const std::vector<MNN::Tensor*>& nTensors, const MNN::OperatorInfo* info) {
-        for (auto t : nTensors) {
-            if (_featureInfo.find(t) != _featureInfo.end()) {
-                if (_featureInfo[t]->visited() == false) {
-                    _featureInfo[t]->updateDistribution();
-                }
+            auto iter = _featureInfo.find(t);
+            if (iter != _featureInfo.end()) {
+                iter->second->fetch();
             }
         }
         return true;
     };
     int count = 0;
-    for (const auto& img : _imgaes) {
-        count++;
-
+    while (count < _imgaes.size()) {
         for (auto& iter : _featureInfo) {
             iter.second->setVisited(false);
+            iter.second->resetFetched();
         }
+        auto batch = _feedImages(count);
+        count += batch;
 
-        for (auto& iter : _featureInfo) {
-            iter.second->resetUpdatedDistributionFlag();
-        }
-        Helper::preprocessInput(_process.get(), _width, _height, img, _inputTensor);
-        _interpreter->runSessionWithCallBackInfo(_session, before, after);
+        _interpreter->runSessionWithCallBackInfo(_session, fetch, fetch);
+        _updateFeatureStatistics(false, batch);
 
         MNN_PRINT("\rCollectFeatureDistribution: %.2lf %%", (float)count * 100.0f / (float)_imageNum);
         fflush(stdout);
@@ -411,9 +427,17 @@ void Calibration::_computeFeatureScaleKL() {
     _collectFeatureMapsDistribution();
 
     _scales.clear();
+    // the KL threshold search is the most expensive part, every tensor is searched on its own thread
+    std::vector<std::pair<const MNN::Tensor*, TensorStatistic*>> statistics;
     for (auto& iter : _featureInfo) {
-        AUTOTIME;
-        _scales[iter.first] = iter.second->finishAndCompute();
+        statistics.emplace_back(iter.first, iter.second.get());
+    }
+    std::vector<std::vector<float>> scales(statistics.size());
+    Helper::parallelFor((int)statistics.size(), _threadNumber, [&](int i, int threadIndex) {
+        scales[i] = statistics[i].second->finishAndCompute();
+    });
+    for (int i = 0; i < statistics.size(); ++i) {
+        _scales[statistics[i].first] = std::move(scales[i]);
     }
     //_featureInfo.clear();//No need now
 }
@@ -35,8 +35,12 @@ private:
     Calibration();
     MNN::NetT* _originaleModel;
     std::shared_ptr<MNN::CV::ImageProcess> _process;
+    // one per thread, ImageProcess keeps the matrix of the last image
+    std::vector<std::shared_ptr<MNN::CV::ImageProcess>> _processes;
     const int _binNums = 2048;
     int _imageNum      = 0;
+    int _batch         = 1;
+    int _threadNumber  = 1;
     int _width;
     int _height;
     std::vector<std::string> _imgaes;
@@ -73,6 +77,10 @@ private:
     void _initMNNSession(const uint8_t* modelBuffer, const int bufferSize, const int channels);
     void _initMaps();
 
+    // preprocess images [begin, begin + batch) into the input tensor, return how many were fed
+    int _feedImages(int begin);
+    // update the statistics fetched by the last run on all threads
+    void _updateFeatureStatistics(bool range, int validBatch);
     void _computeFeatureMapsRange();
     void _collectFeatureMapsDistribution();
     void _computeFeatureScaleKL();
@@ -7,7 +7,9 @@
 //
 
 #include "DataLoader.hpp"
+#include <algorithm>
 #include "LambdaTransform.hpp"
+#include "MemoryBudget.hpp"
 #include "RandomSampler.hpp"
 #include "Sampler.hpp"
 #include "StackTransform.hpp"
@@ -21,29 +23,113 @@ DataLoader::DataLoader(std::shared_ptr<BatchDataset> dataset, std::shared_ptr<Sa
     mDataset = dataset;
     mSampler = sampler;
     mConfig  = config;
+    mDepth   = mConfig->numJobs;
+    mBatches.resize(mConfig->numWorkers > 0 ? mConfig->numJobs + 1 : 1);
+    for (size_t i = 0; i < mBatches.size(); i++) {
+        mFreeSlots.emplace_back(mBatches.size() - 1 - i);
+    }
     if (mConfig->numJobs > 0) {
         mJobs      = std::make_shared<BlockingQueue<Job>>(mConfig->numJobs);
-        mDataQueue = std::make_shared<BlockingQueue<std::vector<Example>>>(mConfig->numJobs);
-        prefetch(mConfig->numJobs);
-        for (int i = 0; i < mConfig->numWorkers; i++) {
-            mWorkers.emplace_back([&] { workerThread(); });
+        mDataQueue = std::make_shared<BlockingQueue<std::pair<size_t, std::vector<Example>>>>(mConfig->numJobs);
+        prefetch(mDepth);
+        resizeWorkers(mConfig->numWorkers);
+    }
+}
+
+static size_t _batchBytes(const std::vector<Example>& batch) {
+    size_t bytes = 0;
+    for (auto& example : batch) {
+        for (auto vars : {&example.first, &example.second}) {
+            for (auto& var : *vars) {
+                auto info = var->getInfo();
+                if (nullptr != info) {
+                    bytes += info->size * info->type.bytes();
+                }
+            }
         }
     }
+    return bytes;
 }
 
 std::vector<Example> DataLoader::next() {
+    std::vector<Example> batch;
     if (mConfig->numWorkers == 0) {
         auto batchIndices = mSampler->next(mConfig->batchSize);
         MNN_ASSERT(batchIndices.size() != 0); // the sampler is exhausted, should reset the data loader
         if (mConfig->dropLast && batchIndices.size() < mConfig->batchSize) {
             MNN_ASSERT(false); // the sampler is exhausted
         }
-        auto batch = mDataset->getBatch(batchIndices);
-        return batch;
+        Job j;
+        j.job     = std::move(batchIndices);
+        batch     = fetch(j);
+        mHeldSlot = 0;
     } else {
-        auto batch = mDataQueue->pop();
-        prefetch(1);
-        return batch;
+        auto result = mDataQueue->pop();
+        mPending--;
+        if (mHeldSlot >= 0) {
+            mFreeSlots.emplace_back(mHeldSlot);
+        }
+        mHeldSlot = (int)result.first;
+        batch     = std::move(result.second);
+    }
+    // filled in place without informing the graphs that read the slot before, that is done on this thread
+    for (auto& example : batch) {
+        for (auto vars : {&example.first, &example.second}) {
+            for (auto& var : *vars) {
+                var->writeMap<void>();
+            }
+        }
+    }
+    if (0 == mBatchBytes) {
+        mBatchBytes = _batchBytes(batch);
+    }
+    adapt();
+    if (mConfig->numWorkers > 0) {
+        prefetch(mDepth > mPending ? mDepth - mPending : 0);
+        // slots left free after prefetching would only keep memory
+        for (auto slot : mFreeSlots) {
+            mBatches[slot] = Example();
+        }
+    }
+    if (nullptr != mBudget) {
+        // the trainer's batch and one in flight are the least the loader works with
+        mBudget->setLoaderBytes(residentBytes(), mBatchBytes * (mConfig->numWorkers > 0 ? 2 : 1));
+    }
+    return batch;
+}
+
+void DataLoader::setMemoryBudget(std::shared_ptr<MemoryBudget> budget) {
+    mBudget = budget;
+}
+
+size_t DataLoader::residentBytes() const {
+    return mBatchBytes * (mPending + (mHeldSlot >= 0 ? 1 : 0));
+}
+
+void DataLoader::adapt() {
+    if (nullptr == mBudget || 0 == mBatchBytes || 0 == mConfig->numWorkers) {
+        return;
+    }
+    // prefetch into what the plan leaves, one batch is held by the trainer
+    auto batches = mBudget->loaderAvailableBytes() / mBatchBytes;
+    auto depth   = std::min(std::max(batches, (size_t)2) - 1, mConfig->numJobs);
+    if (depth != mDepth) {
+        MNN_DEBUG_PRINT("DataLoader: prefetch %lu batches of %lu KB\n", (unsigned long)depth, (unsigned long)(mBatchBytes >> 10));
+        mDepth = depth;
+    }
+    // more workers than pending jobs only idle
+    resizeWorkers(std::min(mConfig->numWorkers, mDepth));
+}
+
+void DataLoader::resizeWorkers(size_t number) {
+    for (; mLiveWorkers < number; mLiveWorkers++) {
+        mWorkers.emplace_back([&] { workerThread(); });
+    }
+    for (; mLiveWorkers > number; mLiveWorkers--) {
+        // the thread taking it exits after the jobs before it, and is joined in join()
+        Job j;
+        j.quit = true;
+        mJobs->push(std::move(j));
     }
 }
 
@@ -57,6 +143,10 @@ void DataLoader::prefetch(size_t nJobs) {
             if (mConfig->dropLast && batchIndices.size() < mConfig->batchSize) {
                 // drop the job
             } else {
+                MNN_ASSERT(!mFreeSlots.empty());
+                j.slot = mFreeSlots.back();
+                mFreeSlots.pop_back();
+                mPending++;
                 mJobs->push(std::move(j)); // the job may be empty when sampler is exhausted
             }
         }
@@ -71,13 +161,20 @@ void DataLoader::workerThread() {
         }
         // make sure there are no empty jobs, so that there are no empty batch
         MNN_ASSERT(currentJob.job.size() != 0);
-        auto batch = mDataset->getBatch(currentJob.job);
-        mDataQueue->push(std::move(batch));
+        mDataQueue->push(std::make_pair(currentJob.slot, fetch(currentJob)));
+    }
+}
+
+std::vector<Example> DataLoader::fetch(const Job& job) {
+    auto& batch = mBatches[job.slot];
+    if (mDataset->getBatchInto(job.job, batch)) {
+        return {batch};
     }
+    return mDataset->getBatch(job.job);
 }
 
 void DataLoader::join() {
-    for (int i = 0; i < mConfig->numWorkers; i++) {
+    for (; mLiveWorkers > 0; mLiveWorkers--) {
         Job j;
         j.quit = true;
         mJobs->push(std::move(j));
@@ -85,25 +182,30 @@ void DataLoader::join() {
     for (auto& worker : mWorkers) {
         worker.join();
     }
+    mWorkers.clear();
 }
 
 void DataLoader::reset() {
     clean();
 
     if (mConfig->numWorkers > 0) {
-        prefetch(mConfig->numJobs);
-        for (int i = 0; i < mConfig->numWorkers; i++) {
-            mWorkers.emplace_back([&] { workerThread(); });
-        }
+        prefetch(mDepth);
+        resizeWorkers(std::min(mConfig->numWorkers, mDepth));
     }
 }
 
 void DataLoader::clean() {
     if (mJobs != nullptr) {
         join();
-        mWorkers.clear();
         mJobs->clear();
         mDataQueue->clear();
+        // every batch is given back, they are refilled from the start
+        mPending  = 0;
+        mHeldSlot = -1;
+        mFreeSlots.clear();
+        for (size_t i = 0; i < mBatches.size(); i++) {
+            mFreeSlots.emplace_back(mBatches.size() - 1 - i);
+        }
     }
     // should reset sampler before prefetch
     mSampler->reset(mSampler->size());
@@ -20,6 +20,7 @@ namespace Train {
 class BatchDataset;
 class Sampler;
 class BatchTransform;
+class MemoryBudget;
 class MNN_PUBLIC DataLoader {
 public:
     DataLoader(std::shared_ptr<BatchDataset> dataset, std::shared_ptr<Sampler> sampler,
@@ -49,6 +50,11 @@ public:
 
     size_t iterNumber() const;
     size_t size() const;
+
+    // adapt prefetch depth and workers to what the budget, shared with the execution plan, leaves
+    void setMemoryBudget(std::shared_ptr<MemoryBudget> budget);
+    // bytes of the batches prefetched, being filled and held by the trainer
+    size_t residentBytes() const;
     static DataLoader* makeDataLoader(std::shared_ptr<BatchDataset> dataset,
                                       const int batchSize,
                                       const bool stack = true,
@@ -63,14 +69,30 @@ public:
 private:
     struct Job {
         std::vector<size_t> job;
+        // the batch in mBatches to fill
+        size_t slot = 0;
         bool quit = false;
     };
+    std::vector<Example> fetch(const Job& job);
+    void adapt();
+    void resizeWorkers(size_t number);
     std::shared_ptr<BatchDataset> mDataset;
     std::shared_ptr<Sampler> mSampler;
     std::shared_ptr<DataLoaderConfig> mConfig;
     std::shared_ptr<BlockingQueue<Job>> mJobs;
-    std::shared_ptr<BlockingQueue<std::vector<Example>>> mDataQueue;
+    std::shared_ptr<BlockingQueue<std::pair<size_t, std::vector<Example>>>> mDataQueue;
     std::vector<std::thread> mWorkers;
+    size_t mLiveWorkers = 0;
+    // batches filled in place, one more than the queue holds, so a batch given by next()
+    // stays valid until the following next() or reset()
+    std::vector<Example> mBatches;
+    std::vector<size_t> mFreeSlots;
+    int mHeldSlot = -1;
+    // jobs pushed and not yet given by next(), kept at mDepth
+    size_t mPending = 0;
+    size_t mDepth   = 0;
+    size_t mBatchBytes = 0;
+    std::shared_ptr<MemoryBudget> mBudget;
 };
 
 } // namespace Train
@@ -41,6 +41,26 @@ public:
 
     // size of the dataset
     virtual size_t size() = 0;
+
+    // write the batch of indices into the tensors of batch, which are reused while their shapes fit.
+    // the users of the tensors aren't marked dirty, which the thread using the batch does with writeMap.
+    // return false if there is no such fast path, then getBatch should be used
+    virtual bool getBatchInto(const std::vector<size_t>& indices, Example& batch) {
+        return false;
+    }
+
+    // write the example of index into one row of stacked tensors, data and target hold the row address
+    // of each tensor and dataBytes and targetBytes its size. return false if the example doesn't fit the
+    // rows or can only be made by getBatch
+    virtual bool fill(size_t index, const std::vector<void*>& data, const std::vector<void*>& target,
+                      const std::vector<size_t>& dataBytes, const std::vector<size_t>& targetBytes) {
+        return false;
+    }
+
+    // whether fill is implemented, batches are only stacked in place if it is
+    virtual bool supportFill() {
+        return false;
+    }
 };
 
 class MNN_PUBLIC Dataset : public BatchDataset {
@@ -0,0 +1,76 @@
+//
+//  MemoryBudget.cpp
+//  MNN
+//
+//  Created by MNN on 2021/08/04.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "MemoryBudget.hpp"
+#include <algorithm>
+#include <MNN/expr/Executor.hpp>
+#include "core/PlanBundle.hpp"
+
+namespace MNN {
+namespace Train {
+
+MemoryBudget::MemoryBudget(size_t limitMB) : mLimit(limitMB << 20), mPlan(0), mLoader(0), mLoaderMinimum(0) {
+}
+
+size_t MemoryBudget::limitBytes() const {
+    return mLimit;
+}
+
+void MemoryBudget::setPlanBytes(size_t bytes) {
+    mPlan = bytes;
+}
+
+size_t MemoryBudget::planBytes() const {
+    if (mPlanQuery) {
+        return mPlanQuery();
+    }
+    return mPlan;
+}
+
+void MemoryBudget::setLoaderBytes(size_t bytes, size_t minimumBytes) {
+    mLoader        = bytes;
+    mLoaderMinimum = minimumBytes;
+}
+
+size_t MemoryBudget::loaderBytes() const {
+    return mLoader;
+}
+
+size_t MemoryBudget::loaderAvailableBytes() const {
+    auto plan = planBytes();
+    return plan >= mLimit ? 0 : mLimit - plan;
+}
+
+size_t MemoryBudget::planAvailableMB() const {
+    size_t minimum = mLoaderMinimum;
+    size_t share   = minimum >= mLimit ? 0 : (mLimit - minimum) >> 20;
+    // the OS still has its say: what it has free, plus the plan in use which goes back when the plan is switched
+    auto os = PlanBundle::availableMemoryMB();
+    if (0 != os) {
+        share = std::min(share, os + (planBytes() >> 20));
+    }
+    // 0 would read as unknown, the smallest plan is what is left when the loader needs the whole limit
+    return std::max(share, (size_t)1);
+}
+
+void MemoryBudget::bind(std::shared_ptr<Express::Executor> executor) {
+    std::weak_ptr<MemoryBudget> self = shared_from_this();
+    // 0 once the budget is gone lets the executor fall back to what the OS reports
+    executor->setMemoryProvider([self]() -> size_t {
+        auto budget = self.lock();
+        return nullptr == budget ? 0 : budget->planAvailableMB();
+    });
+    std::weak_ptr<Express::Executor> weak = executor;
+    mPlanQuery = [weak]() -> size_t {
+        auto exe = weak.lock();
+        return nullptr == exe ? 0 : exe->planBudgetMB() << 20;
+    };
+}
+
+} // namespace Train
+} // namespace MNN
@@ -0,0 +1,63 @@
+//
+//  MemoryBudget.hpp
+//  MNN
+//
+//  Created by MNN on 2021/08/04.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef MemoryBudget_hpp
+#define MemoryBudget_hpp
+
+#include <MNN/MNNDefine.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace MNN {
+namespace Express {
+class Executor;
+}
+namespace Train {
+
+/**
+ The memory of one training process, shared by the execution plan and the data pipeline.
+ The plan comes first: the loader only prefetches into what the plan leaves of the limit,
+ and a plan chosen at runtime (target "bundle") is offered the limit minus the least the loader can live with.
+ */
+class MNN_PUBLIC MemoryBudget : public std::enable_shared_from_this<MemoryBudget> {
+public:
+    explicit MemoryBudget(size_t limitMB);
+
+    size_t limitBytes() const;
+
+    // memory of the execution plan, queried from the executor once bound
+    void setPlanBytes(size_t bytes);
+    size_t planBytes() const;
+
+    // memory held by the data pipeline, and the part of it the loader can't give up
+    void setLoaderBytes(size_t bytes, size_t minimumBytes);
+    size_t loaderBytes() const;
+
+    // what the loader may hold without pushing the plan over the limit
+    size_t loaderAvailableBytes() const;
+
+    // what a plan may use while the loader keeps its minimum, within what the OS has free besides the plan in use,
+    // in MB. At least 1, which selects the smallest plan
+    size_t planAvailableMB() const;
+
+    // let the executor pick its plan from planAvailableMB and report the plan it runs
+    void bind(std::shared_ptr<Express::Executor> executor);
+
+private:
+    size_t mLimit;
+    std::atomic<size_t> mPlan;
+    std::atomic<size_t> mLoader;
+    std::atomic<size_t> mLoaderMinimum;
+    std::function<size_t()> mPlanQuery;
+};
+
+} // namespace Train
+} // namespace MNN
+
+#endif // MemoryBudget_hpp
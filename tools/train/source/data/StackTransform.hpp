@@ -10,6 +10,7 @@
 #define StackTransform_hpp
 
 #include <MNN/expr/ExprCreator.hpp>
+#include "Dataset.hpp"
 #include "Transform.hpp"
 
 namespace MNN {
@@ -41,6 +42,76 @@ class MNN_PUBLIC StackTransform : public BatchTransform {
 
         return {example};
     }
+
+    // fill the rows of batch from dataset, no example is made unless the tensors of batch must be (re)allocated
+    bool transformBatchInto(BatchDataset* dataset, const std::vector<size_t>& indices, Example& batch) override {
+        const int number = (int)indices.size();
+        if (!dataset->supportFill()) {
+            return false;
+        }
+        if (!fits(batch, number)) {
+            // learn the shapes from the first example
+            auto first = dataset->getBatch({indices[0]});
+            batch      = {allocate(first[0].first, number), allocate(first[0].second, number)};
+        }
+        std::vector<void*> data(batch.first.size()), target(batch.second.size());
+        std::vector<size_t> dataStride(data.size()), targetStride(target.size());
+        for (int j = 0; j < data.size(); j++) {
+            // a worker may fill the batch while the trainer runs what read it before, the thread taking
+            // the batch marks them dirty
+            data[j]       = batch.first[j]->writeInternal(false);
+            dataStride[j] = rowBytes(batch.first[j]);
+        }
+        for (int j = 0; j < target.size(); j++) {
+            target[j]       = batch.second[j]->writeInternal(false);
+            targetStride[j] = rowBytes(batch.second[j]);
+        }
+        for (int i = 0; i < number; i++) {
+            if (!dataset->fill(indices[i], data, target, dataStride, targetStride)) {
+                return false;
+            }
+            for (int j = 0; j < data.size(); j++) {
+                data[j] = (uint8_t*)data[j] + dataStride[j];
+            }
+            for (int j = 0; j < target.size(); j++) {
+                target[j] = (uint8_t*)target[j] + targetStride[j];
+            }
+        }
+        return true;
+    }
+
+private:
+    // the rows are checked by fill, here only that every tensor holds number of them
+    static bool fits(const Example& batch, int number) {
+        if (batch.first.empty()) {
+            return false;
+        }
+        for (auto vars : {&batch.first, &batch.second}) {
+            for (auto& var : *vars) {
+                auto info = var->getInfo();
+                if (nullptr == info || info->dim.empty() || info->dim[0] != number) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    static std::vector<VARP> allocate(const std::vector<VARP>& example, int number) {
+        std::vector<VARP> stacked;
+        for (auto& var : example) {
+            auto info = var->getInfo();
+            std::vector<int> dims = {number};
+            dims.insert(dims.end(), info->dim.begin(), info->dim.end());
+            stacked.emplace_back(_Input(dims, info->order, info->type));
+        }
+        return stacked;
+    }
+
+    static size_t rowBytes(VARP var) {
+        auto info = var->getInfo();
+        return info->size / info->dim[0] * info->type.bytes();
+    }
 };
 
 } // namespace Train
@@ -14,12 +14,18 @@
 
 namespace MNN {
 namespace Train {
+class BatchDataset;
 
 class MNN_PUBLIC BatchTransform {
 public:
     virtual ~BatchTransform() = default;
 
     virtual std::vector<Example> transformBatch(std::vector<Example> batch) = 0;
+
+    // transform the examples of indices in dataset straight into batch, return false if not supported
+    virtual bool transformBatchInto(BatchDataset* dataset, const std::vector<size_t>& indices, Example& batch) {
+        return false;
+    }
 };
 
 class MNN_PUBLIC Transform : public BatchTransform {
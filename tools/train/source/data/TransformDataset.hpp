@@ -34,6 +34,13 @@ public:
         return batch;
     }
 
+    bool getBatchInto(const std::vector<size_t>& indices, Example& batch) override {
+        if (mTransform == nullptr) {
+            return mDataset->getBatchInto(indices, batch);
+        }
+        return mTransform->transformBatchInto(mDataset.get(), indices, batch);
+    }
+
     size_t size() override {
         return mDataset->size();
     }
@@ -10,6 +10,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <fstream>
+#include <functional>
 #include <string>
 #include <vector>
 #include "MNN/ImageProcess.hpp"
@@ -107,13 +108,16 @@ void ImageDataset::getAllDataAndLabelsFromTxt(const std::string pathToImages, st
     txtFile.close();
 }
 
-VARP ImageDataset::convertImage(const std::string& imageName, const ImageConfig& mConfig, const MNN::CV::ImageProcess::Config& mProcessConfig) {
+// decode and transform the image into the memory dest gives for the output height, width and bpp
+static bool _convertImage(const std::string& imageName, const ImageDataset::ImageConfig& mConfig,
+                          const MNN::CV::ImageProcess::Config& mProcessConfig,
+                          const std::function<float*(int, int, int)>& dest) {
     int originalWidth, originalHeight, comp;
     auto bitmap32bits = stbi_load(imageName.c_str(), &originalWidth, &originalHeight, &comp, 4);
     if (bitmap32bits == nullptr) {
         MNN_PRINT("can not open image: %s\n", imageName.c_str());
         MNN_ASSERT(false);
-        return nullptr;
+        return false;
     }
     
     // choose resize or crop
@@ -191,10 +195,21 @@ VARP ImageDataset::convertImage(const std::string& imageName, const ImageConfig&
         }
     }
 
-    auto data      = _Input({oh, ow, bpp}, NHWC, halide_type_of<float>());
-    process->convert(bitmap32bits, originalWidth, originalHeight, 0, data->writeMap<float>(), ow, oh, bpp, ow * bpp,
-                      halide_type_of<float>());
+    auto dstPtr = dest(oh, ow, bpp);
+    if (dstPtr != nullptr) {
+        process->convert(bitmap32bits, originalWidth, originalHeight, 0, dstPtr, ow, oh, bpp, ow * bpp,
+                         halide_type_of<float>());
+    }
     stbi_image_free(bitmap32bits);
+    return dstPtr != nullptr;
+}
+
+VARP ImageDataset::convertImage(const std::string& imageName, const ImageConfig& mConfig, const MNN::CV::ImageProcess::Config& mProcessConfig) {
+    VARP data = nullptr;
+    _convertImage(imageName, mConfig, mProcessConfig, [&](int oh, int ow, int bpp) {
+        data = _Input({oh, ow, bpp}, NHWC, halide_type_of<float>());
+        return data->writeMap<float>();
+    });
     return data;
 }
 
@@ -213,5 +228,37 @@ std::pair<VARP, VARP> ImageDataset::getDataAndLabelsFrom(std::pair<std::string,
     return std::make_pair(data, labels);
 }
 
+bool ImageDataset::fill(size_t index, const std::vector<void*>& data, const std::vector<void*>& target,
+                        const std::vector<size_t>& dataBytes, const std::vector<size_t>& targetBytes) {
+    // without resizing the rows of a batch may differ in size
+    if (mConfig.resizeHeight <= 0 || mConfig.resizeWidth <= 0 || data.size() != 1 || target.size() != 1) {
+        return false;
+    }
+    // the lines may have different numbers of labels
+    if (mReadAllToMemory) {
+        auto& dataAndLabels = mDataAndLabels[index];
+        auto imageBytes     = dataAndLabels.first->getInfo()->size * sizeof(float);
+        auto labelBytes     = dataAndLabels.second->getInfo()->size * sizeof(int32_t);
+        if (imageBytes != dataBytes[0] || labelBytes != targetBytes[0]) {
+            return false;
+        }
+        ::memcpy(data[0], dataAndLabels.first->readMap<float>(), imageBytes);
+        ::memcpy(target[0], dataAndLabels.second->readMap<int32_t>(), labelBytes);
+        return true;
+    }
+    auto& txtLine = mAllTxtLines[index];
+    if (txtLine.second.size() * sizeof(int32_t) != targetBytes[0]) {
+        return false;
+    }
+    auto success = _convertImage(txtLine.first, mConfig, mProcessConfig, [&](int oh, int ow, int bpp) -> float* {
+        if (oh * ow * bpp * sizeof(float) != dataBytes[0]) {
+            return nullptr;
+        }
+        return (float*)data[0];
+    });
+    ::memcpy(target[0], txtLine.second.data(), txtLine.second.size() * sizeof(int32_t));
+    return success;
+}
+
 } // namespace Train
 } // namespace MNN
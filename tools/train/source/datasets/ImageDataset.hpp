@@ -68,6 +68,14 @@ public:
 
     size_t size() override;
 
+    bool fill(size_t index, const std::vector<void*>& data, const std::vector<void*>& target,
+              const std::vector<size_t>& dataBytes, const std::vector<size_t>& targetBytes) override;
+
+    // without resizing the rows of a batch may differ in size
+    bool supportFill() override {
+        return mConfig.resizeHeight > 0 && mConfig.resizeWidth > 0;
+    }
+
 private:
     ImageDataset(){}
     bool mReadAllToMemory;
@@ -130,6 +130,19 @@ Example MnistDataset::get(size_t index) {
     return {{data, returnIndex}, {label}};
 }
 
+bool MnistDataset::fill(size_t index, const std::vector<void*>& data, const std::vector<void*>& target,
+                        const std::vector<size_t>& dataBytes, const std::vector<size_t>& targetBytes) {
+    // the same layout as get: image and index, then label
+    if (dataBytes.size() != 2 || targetBytes.size() != 1 || dataBytes[0] != kImageRows * kImageColumns ||
+        dataBytes[1] != sizeof(float) || targetBytes[0] != 1) {
+        return false;
+    }
+    ::memcpy(data[0], mImagePtr + index * kImageRows * kImageColumns, kImageRows * kImageColumns);
+    *(float*)data[1]     = (float)index;
+    *(uint8_t*)target[0] = mLabelsPtr[index];
+    return true;
+}
+
 size_t MnistDataset::size() {
     return mImages->getInfo()->dim[0];
 }
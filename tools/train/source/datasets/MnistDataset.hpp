@@ -23,6 +23,13 @@ public:
 
     size_t size() override;
 
+    bool fill(size_t index, const std::vector<void*>& data, const std::vector<void*>& target,
+              const std::vector<size_t>& dataBytes, const std::vector<size_t>& targetBytes) override;
+
+    bool supportFill() override {
+        return true;
+    }
+
     const VARP images();
 
     const VARP labels();
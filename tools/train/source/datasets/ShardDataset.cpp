@@ -0,0 +1,362 @@
+//
+//  ShardDataset.cpp
+//  MNN
+//
+//  Created by MNN on 2021/08/02.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "ShardDataset.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include "RandomGenerator.hpp"
+
+namespace MNN {
+namespace Train {
+
+// shard layout: magic, version, example number, data and target tensor number,
+// then code, bits, order, dimension number and dims of each tensor, then the raw examples
+static const int32_t kShardMagic   = 0x4d534844;
+static const int32_t kShardVersion = 1;
+
+static std::string _shardName(const std::string& prefix, int index) {
+    return prefix + "." + std::to_string(index) + ".shard";
+}
+
+static bool _readInt(FILE* f, int32_t& value) {
+    return fread(&value, sizeof(int32_t), 1, f) == 1;
+}
+
+static void _writeInt(FILE* f, int32_t value) {
+    fwrite(&value, sizeof(int32_t), 1, f);
+}
+
+static bool _sameDesc(const std::vector<VARP>& vars, const std::vector<VARP>& first) {
+    if (vars.size() != first.size()) {
+        return false;
+    }
+    for (int i = 0; i < vars.size(); ++i) {
+        auto info      = vars[i]->getInfo();
+        auto firstInfo = first[i]->getInfo();
+        if (info->type != firstInfo->type || info->order != firstInfo->order || info->dim != firstInfo->dim) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::vector<VARP> _plain(const std::vector<VARP>& vars) {
+    std::vector<VARP> result;
+    for (auto var : vars) {
+        if (var->getInfo()->order == NC4HW4) {
+            var = _Convert(var, NCHW);
+        }
+        result.emplace_back(var);
+    }
+    return result;
+}
+
+int ShardDataset::write(DatasetPtr dataset, const std::string prefix, size_t examplesPerShard) {
+    if (0 == examplesPerShard) {
+        MNN_ERROR("A shard must hold at least one example\n");
+        return -1;
+    }
+    auto source = dataset.mDataset;
+    auto number = source->size();
+    int shards  = 0;
+    // the reader takes every record to have the size of the first
+    std::vector<VARP> firstData, firstTarget;
+    auto removeShards = [&]() {
+        for (int i = 0; i <= shards; ++i) {
+            remove(_shardName(prefix, i).c_str());
+        }
+        return -1;
+    };
+    for (size_t start = 0; start < number; start += examplesPerShard) {
+        auto end  = std::min(number, start + examplesPerShard);
+        auto name = _shardName(prefix, shards);
+        FILE* f   = fopen(name.c_str(), "wb");
+        if (nullptr == f) {
+            MNN_ERROR("Can't open %s to write shard\n", name.c_str());
+            return shards;
+        }
+        for (size_t i = start; i < end; ++i) {
+            auto example = source->getBatch({i})[0];
+            auto data    = _plain(example.first);
+            auto target  = _plain(example.second);
+            if (0 == i) {
+                firstData   = data;
+                firstTarget = target;
+            } else if (!_sameDesc(data, firstData) || !_sameDesc(target, firstTarget)) {
+                MNN_ERROR("Example %lu doesn't have the shapes of the first, no shard is written\n", (unsigned long)i);
+                fclose(f);
+                return removeShards();
+            }
+            if (i == start) {
+                _writeInt(f, kShardMagic);
+                _writeInt(f, kShardVersion);
+                _writeInt(f, (int32_t)(end - start));
+                _writeInt(f, (int32_t)data.size());
+                _writeInt(f, (int32_t)target.size());
+                for (auto vars : {&data, &target}) {
+                    for (auto& var : *vars) {
+                        auto info = var->getInfo();
+                        _writeInt(f, info->type.code);
+                        _writeInt(f, info->type.bits);
+                        _writeInt(f, info->order);
+                        _writeInt(f, (int32_t)info->dim.size());
+                        for (auto d : info->dim) {
+                            _writeInt(f, d);
+                        }
+                    }
+                }
+            }
+            for (auto vars : {&data, &target}) {
+                for (auto& var : *vars) {
+                    auto info = var->getInfo();
+                    fwrite(var->readMap<uint8_t>(), 1, info->size * info->type.bytes(), f);
+                }
+            }
+        }
+        fclose(f);
+        shards++;
+    }
+    return shards;
+}
+
+DatasetPtr ShardDataset::create(const std::string prefix, size_t bufferBytes, size_t chunkBytes) {
+    DatasetPtr res;
+    std::shared_ptr<ShardDataset> dataset(new ShardDataset);
+    if (!dataset->open(prefix, bufferBytes, chunkBytes)) {
+        return res;
+    }
+    res.mDataset = dataset;
+    return res;
+}
+
+bool ShardDataset::open(const std::string& prefix, size_t bufferBytes, size_t chunkBytes) {
+    for (int index = 0;; ++index) {
+        auto name = _shardName(prefix, index);
+        FILE* f   = fopen(name.c_str(), "rb");
+        if (nullptr == f) {
+            break;
+        }
+        int32_t magic = 0, version = 0, number = 0, dataNumber = 0, targetNumber = 0;
+        bool valid = _readInt(f, magic) && _readInt(f, version) && _readInt(f, number) && _readInt(f, dataNumber) &&
+                     _readInt(f, targetNumber) && magic == kShardMagic && version == kShardVersion;
+        std::vector<TensorDesc> descs(valid ? dataNumber + targetNumber : 0);
+        for (auto& desc : descs) {
+            int32_t code = 0, bits = 0, order = 0, dimNumber = 0;
+            valid = valid && _readInt(f, code) && _readInt(f, bits) && _readInt(f, order) && _readInt(f, dimNumber);
+            if (!valid) {
+                break;
+            }
+            desc.type  = halide_type_t((halide_type_code_t)code, bits);
+            desc.order = (Dimensionformat)order;
+            desc.dim.resize(dimNumber);
+            size_t count = 1;
+            for (auto& d : desc.dim) {
+                valid = valid && _readInt(f, d);
+                count *= d;
+            }
+            desc.bytes = count * desc.type.bytes();
+        }
+        auto offset = (size_t)ftell(f);
+        fclose(f);
+        if (!valid) {
+            MNN_ERROR("%s is not a valid shard\n", name.c_str());
+            return false;
+        }
+        if (mShards.empty()) {
+            mData.assign(descs.begin(), descs.begin() + dataNumber);
+            mTarget.assign(descs.begin() + dataNumber, descs.end());
+            for (auto& desc : descs) {
+                mRecordBytes += desc.bytes;
+            }
+        } else if (dataNumber != mData.size() || targetNumber != mTarget.size() ||
+                   !std::equal(mData.begin(), mData.end(), descs.begin()) ||
+                   !std::equal(mTarget.begin(), mTarget.end(), descs.begin() + dataNumber)) {
+            MNN_ERROR("%s doesn't have the examples of the first shard\n", name.c_str());
+            return false;
+        }
+        mShards.emplace_back(name);
+        mShardSize.emplace_back(number);
+        mShardOffset.emplace_back(offset);
+        mSize += number;
+    }
+    if (0 == mSize || 0 == mRecordBytes) {
+        MNN_ERROR("No example found in shards of %s\n", prefix.c_str());
+        return false;
+    }
+    // the buffer can't hold more than the whole dataset, or the stream would repeat within it
+    auto capacity = std::min(mSize, std::max((size_t)1, bufferBytes / mRecordBytes));
+    mChunkRecords = std::max((size_t)1, chunkBytes / mRecordBytes);
+    mMinFilled    = std::max((size_t)1, capacity / 2);
+    mBuffer.resize(capacity * mRecordBytes);
+    mFree.resize(capacity);
+    for (int i = 0; i < capacity; ++i) {
+        mFree[i] = (int)capacity - 1 - i;
+    }
+    mFilled.reserve(capacity);
+    mGenerator.seed(RandomGenerator::generator()());
+    auto seed = mGenerator();
+    mReader   = std::thread([this, seed] {
+        readThread(seed);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mReaderDone = true;
+        }
+        mCondVar.notify_all();
+    });
+    return true;
+}
+
+ShardDataset::~ShardDataset() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondVar.notify_all();
+    if (mReader.joinable()) {
+        mReader.join();
+    }
+}
+
+void ShardDataset::readThread(unsigned int seed) {
+    std::vector<uint8_t> chunk(mChunkRecords * mRecordBytes);
+    std::vector<int> order(mShards.size());
+    std::vector<int> slots;
+    std::mt19937 generator(seed);
+    for (int i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    while (true) {
+        // visit the shards in a new order every pass
+        std::shuffle(order.begin(), order.end(), generator);
+        bool read = false;
+        for (auto s : order) {
+            FILE* f = fopen(mShards[s].c_str(), "rb");
+            if (nullptr == f) {
+                MNN_ERROR("Can't open %s\n", mShards[s].c_str());
+                continue;
+            }
+            fseek(f, mShardOffset[s], SEEK_SET);
+            auto remain = mShardSize[s];
+            while (remain > 0) {
+                auto number = fread(chunk.data(), mRecordBytes, std::min(remain, mChunkRecords), f);
+                if (0 == number) {
+                    MNN_ERROR("%s is truncated\n", mShards[s].c_str());
+                    break;
+                }
+                read = true;
+                remain -= number;
+                for (size_t i = 0; i < number;) {
+                    {
+                        std::unique_lock<std::mutex> lock(mMutex);
+                        mCondVar.wait(lock, [this] { return mStop || !mFree.empty(); });
+                        if (mStop) {
+                            fclose(f);
+                            return;
+                        }
+                        auto count = std::min(number - i, mFree.size());
+                        slots.assign(mFree.end() - count, mFree.end());
+                        mFree.resize(mFree.size() - count);
+                    }
+                    // the slots are owned by this thread until they are put into mFilled
+                    for (auto slot : slots) {
+                        ::memcpy(mBuffer.data() + slot * mRecordBytes, chunk.data() + i * mRecordBytes, mRecordBytes);
+                        i++;
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(mMutex);
+                        mFilled.insert(mFilled.end(), slots.begin(), slots.end());
+                    }
+                    mCondVar.notify_all();
+                }
+            }
+            fclose(f);
+        }
+        // a pass without any record would repeat forever
+        if (!read) {
+            return;
+        }
+    }
+}
+
+bool ShardDataset::take(const std::vector<void*>& dst) {
+    int slot = 0;
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondVar.wait(lock, [this] { return mFilled.size() >= mMinFilled || mReaderDone; });
+        if (mFilled.empty()) {
+            MNN_ERROR("No shard can be read\n");
+            return false;
+        }
+        std::uniform_int_distribution<size_t> dis(0, mFilled.size() - 1);
+        auto pos     = dis(mGenerator);
+        slot         = mFilled[pos];
+        mFilled[pos] = mFilled.back();
+        mFilled.pop_back();
+    }
+    auto src = mBuffer.data() + slot * mRecordBytes;
+    for (int i = 0; i < dst.size(); ++i) {
+        auto bytes = i < mData.size() ? mData[i].bytes : mTarget[i - mData.size()].bytes;
+        ::memcpy(dst[i], src, bytes);
+        src += bytes;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFree.emplace_back(slot);
+    }
+    mCondVar.notify_all();
+    return true;
+}
+
+Example ShardDataset::get(size_t index) {
+    Example example;
+    std::vector<void*> dst;
+    for (auto& desc : mData) {
+        example.first.emplace_back(_Input(desc.dim, desc.order, desc.type));
+        dst.emplace_back(example.first.back()->writeMap<uint8_t>());
+    }
+    for (auto& desc : mTarget) {
+        example.second.emplace_back(_Input(desc.dim, desc.order, desc.type));
+        dst.emplace_back(example.second.back()->writeMap<uint8_t>());
+    }
+    if (!take(dst)) {
+        return {};
+    }
+    return example;
+}
+
+bool ShardDataset::fill(size_t index, const std::vector<void*>& data, const std::vector<void*>& target,
+                        const std::vector<size_t>& dataBytes, const std::vector<size_t>& targetBytes) {
+    if (dataBytes.size() != mData.size() || targetBytes.size() != mTarget.size()) {
+        return false;
+    }
+    for (int i = 0; i < mData.size(); ++i) {
+        if (dataBytes[i] != mData[i].bytes) {
+            return false;
+        }
+    }
+    for (int i = 0; i < mTarget.size(); ++i) {
+        if (targetBytes[i] != mTarget[i].bytes) {
+            return false;
+        }
+    }
+    std::vector<void*> dst(data);
+    dst.insert(dst.end(), target.begin(), target.end());
+    return take(dst);
+}
+
+size_t ShardDataset::size() {
+    return mSize;
+}
+
+size_t ShardDataset::residentBytes() const {
+    return mBuffer.size() + mChunkRecords * mRecordBytes;
+}
+
+} // namespace Train
+} // namespace MNN
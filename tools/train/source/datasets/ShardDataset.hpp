@@ -0,0 +1,101 @@
+//
+//  ShardDataset.hpp
+//  MNN
+//
+//  Created by MNN on 2021/08/02.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef ShardDataset_hpp
+#define ShardDataset_hpp
+
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Dataset.hpp"
+#include "Example.hpp"
+
+//
+// the ShardDataset streams examples of fixed shapes from the shard files written by ShardDataset::write:
+//      prefix.0.shard
+//      prefix.1.shard
+//      ...
+// a background thread reads the shards one after another in large sequential chunks into a bounded
+// shuffle buffer, and every example is drawn at random from that buffer. so the index asked for is
+// ignored, and an epoch is just size() examples drawn from the stream.
+//
+
+namespace MNN {
+namespace Train {
+class MNN_PUBLIC ShardDataset : public Dataset {
+public:
+    // bufferBytes bounds the shuffle buffer, chunkBytes is the size of one sequential read
+    static DatasetPtr create(const std::string prefix, size_t bufferBytes = 64 * 1024 * 1024,
+                             size_t chunkBytes = 4 * 1024 * 1024);
+    // write all examples of dataset into shards of examplesPerShard examples, return the number of shards.
+    // all examples must have the shapes and types of the first and examplesPerShard be positive,
+    // otherwise nothing is written and -1 returned
+    static int write(DatasetPtr dataset, const std::string prefix, size_t examplesPerShard = 10000);
+
+    ~ShardDataset();
+
+    Example get(size_t index) override;
+
+    size_t size() override;
+
+    bool fill(size_t index, const std::vector<void*>& data, const std::vector<void*>& target,
+              const std::vector<size_t>& dataBytes, const std::vector<size_t>& targetBytes) override;
+
+    bool supportFill() override {
+        return true;
+    }
+
+    // memory held by the shuffle buffer and the read chunk
+    size_t residentBytes() const;
+
+private:
+    struct TensorDesc {
+        halide_type_t type;
+        Dimensionformat order;
+        std::vector<int> dim;
+        size_t bytes;
+        bool operator==(const TensorDesc& other) const {
+            return type == other.type && order == other.order && dim == other.dim;
+        }
+    };
+    ShardDataset() = default;
+    bool open(const std::string& prefix, size_t bufferBytes, size_t chunkBytes);
+    void readThread(unsigned int seed);
+    // move a random example out of the buffer to the addresses of its tensors, false if the reader has
+    // stopped and the buffer is empty
+    bool take(const std::vector<void*>& dst);
+
+    std::vector<std::string> mShards;
+    // examples and header bytes of each shard
+    std::vector<size_t> mShardSize;
+    std::vector<size_t> mShardOffset;
+    std::vector<TensorDesc> mData;
+    std::vector<TensorDesc> mTarget;
+    size_t mRecordBytes  = 0;
+    size_t mSize         = 0;
+    size_t mChunkRecords = 1;
+    size_t mMinFilled    = 1;
+
+    std::vector<uint8_t> mBuffer;
+    std::vector<int> mFilled;
+    std::vector<int> mFree;
+    std::mutex mMutex;
+    std::condition_variable mCondVar;
+    std::mt19937 mGenerator;
+    bool mStop = false;
+    // no shard can be read anymore
+    bool mReaderDone = false;
+    std::thread mReader;
+};
+} // namespace Train
+} // namespace MNN
+
+#endif // ShardDataset_hpp
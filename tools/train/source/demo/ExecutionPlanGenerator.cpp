@@ -1,5 +1,9 @@
 #include "ExecutionPlanGenerator.hpp"
+#include <unistd.h>
+#include <MNN/expr/ExprCreator.hpp>
+#include <MNN/expr/NN.hpp>
 #include "SegmentTree.hpp"
+#include "SGD.hpp"
 
 string RECOMPUTE_SUFFIX = "_recompute";
 
@@ -32,7 +36,10 @@ int align_size(int size, int alignment = 64) {
     return (size + alignment - 1) / alignment * alignment;
 }
 
-Profiler::Profiler(string mn, int bs) : modelname(std::move(mn)), batchsize(bs) {
+static const string kCalibrationFile = "data/profiler/calibration.txt";
+
+Profiler::Profiler(string mn, int bs, string dev) : modelname(std::move(mn)), device(std::move(dev)), batchsize(bs) {
+    calibration = load_calibration(kCalibrationFile);
     string fileDir = "data/profiler/" + modelname + "/";
     bool load = true;
     string filenames[5] = {
@@ -167,6 +174,8 @@ void Profiler::load_io_info(string filename) {
         if (tag == "opid") {
             info = OpInfo();
             iss >> info.opid;
+        } else if (tag == "type") {
+            iss >> info.type;
         } else if (tag == "inputs") {
             while (iss >> a) {
                 info.inputs.push_back(a);
@@ -187,7 +196,7 @@ void Profiler::load_io_info(string filename) {
             io_info.push_back(info);
 //            debug_print("%s: %zu %zu %zu\n", info.opid.c_str(), info.inputs.size(), info.outputs.size(), info.release.size())
         } else {
-            debug_print("invalid tag! choices are [inputs, outputs, release, temporary, finish]")
+            debug_print("invalid tag! choices are [type, inputs, outputs, release, temporary, finish]")
             return;
         }
     }
@@ -226,9 +235,14 @@ void Profiler::set_thres_layers() {
 }
 
 void Profiler::init_from_scratch() {
-    profile_from_scratch("profile/" + modelname + "/" + modelname + "." + to_string(batchsize) + ".profile.out");
-    resize_from_scratch("resize/" + modelname + "/" + modelname + "." + to_string(batchsize) + ".resize.out");
-    cost_from_scratch("cost/" + modelname + "/" + modelname + "." + to_string(batchsize) + ".cost.out");
+    string name = modelname + "/" + modelname + "." + to_string(batchsize);
+    if (estimate_from_scratch("estimate/" + name + ".estimate.out")) {
+        refine_from_scratch("resize/" + name + ".resize.out", "cost/" + name + ".cost.out");
+    } else {
+        profile_from_scratch("profile/" + name + ".profile.out");
+        resize_from_scratch("resize/" + name + ".resize.out");
+        cost_from_scratch("cost/" + name + ".cost.out");
+    }
     dump_information();
 }
 
@@ -252,6 +266,11 @@ void Profiler::profile_from_scratch(string filename) {
 
         if (strip(s, "\t").find("current Op") == 0) {
             io_info.emplace_back(OpInfo(to_string(io_info.size())));
+            // current Op is %dth:%d:%s
+            auto items = split(strip(s, "\t"), ":");
+            if (items.size() >= 2) {
+                io_info.back().type = atoi(items[1].c_str());
+            }
         } else if (strip(s, "\t").find("outputs") == 0) {
             add_info(s, io_info[io_info.size() - 1].outputs);
         } else if (strip(s, "\t").find("inputs") == 0) {
@@ -387,6 +406,186 @@ void Profiler::cost_from_scratch(string filename) {
     ifs.close();
 }
 
+bool Profiler::estimate_from_scratch(string filename) {
+    ifstream ifs(filename, std::ios::in);
+    if (!ifs.is_open()) {
+        debug_print("error to %s\n", __FUNCTION__)
+        return false;
+    }
+    string s;
+    bool estimate_flag = false;
+    int opidx = 0;
+    string op;
+    while (getline(ifs, s)) {
+        if (s.find("start read-map") != string::npos) {
+            estimate_flag = true;
+        } else if (s.find("finish read-map & start replace") != string::npos) {
+            estimate_flag = false;
+        }
+        if (!estimate_flag) {
+            continue;
+        }
+        if (strip(s, "\t").find("current Op") == 0) {
+            op = to_string(opidx++);
+        } else if (strip(s, "\t").find("estimate flops") == 0) {
+            // estimate flops: %f bytes: %f
+            auto tmp = split(strip(s, "\t"));
+            op_workload[op] = make_pair(stod(tmp[2]), stod(tmp[4]));
+        }
+    }
+    ifs.close();
+    if (op_workload.empty()) {
+        return false;
+    }
+    // the io lines of the estimate log are the ones of target "profile"
+    profile_from_scratch(filename);
+    for (auto &t: tensor_size) {
+        t.second = align_size(t.second);
+    }
+    auto &calib = calibration;
+    for (auto &w: op_workload) {
+        cost_info[w.first] = calib.overhead_ms + max(w.second.first / (calib.gflops * 1e6), w.second.second / (calib.gbps * 1e6));
+    }
+    // temporaries of an execution are only known once it is resized
+    resize_info.assign(io_info.size(), {});
+    return !io_info.empty();
+}
+
+void Profiler::refine_from_scratch(string resize_file, string cost_file) {
+    if (ifstream(resize_file).good()) {
+        resize_info.clear();
+        resize_from_scratch(resize_file);
+        if (resize_info.size() != io_info.size()) {
+            debug_print("%s: %s doesn't match the estimated graph\n", __FUNCTION__, resize_file.c_str())
+            resize_info.assign(io_info.size(), {});
+        }
+    }
+    auto estimated = cost_info;
+    cost_info.clear();
+    cost_from_scratch(cost_file);
+    if (cost_info.empty()) {
+        cost_info = estimated;
+        return;
+    }
+    // scale the roofline part of the calibration so that the estimate meets the measured total
+    auto &calib = calibration;
+    double measured = 0, roofline = 0;
+    for (auto &c: cost_info) {
+        if (estimated.find(c.first) != estimated.end()) {
+            measured += max(0.0, c.second - calib.overhead_ms);
+            roofline += estimated[c.first] - calib.overhead_ms;
+        }
+    }
+    if (measured > 0 && roofline > 0) {
+        auto scale = measured / roofline;
+        calib.gflops /= scale;
+        calib.gbps /= scale;
+        for (auto &e: estimated) {
+            if (cost_info.find(e.first) == cost_info.end()) {
+                cost_info[e.first] = calib.overhead_ms + (e.second - calib.overhead_ms) * scale;
+            }
+        }
+    }
+}
+
+bool Profiler::calibrate() {
+    io_info.clear();
+    tensor_size.clear();
+    cost_info.clear();
+    resize_info.clear();
+    redundent_parent.clear();
+    op_workload.clear();
+    string name = modelname + "/" + modelname + "." + to_string(batchsize);
+    if (!estimate_from_scratch("estimate/" + name + ".estimate.out")) {
+        return false;
+    }
+    refine_from_scratch("resize/" + name + ".resize.out", "cost/" + name + ".cost.out");
+    measure_storage(calibration);
+    dump_calibration(kCalibrationFile, calibration);
+    return true;
+}
+
+Profiler::Calibration Profiler::load_calibration(string filename) {
+    Calibration calib;
+    ifstream infile(filename);
+    if (!infile.is_open()) {
+        debug_print("%s: no %s, use the default calibration\n", __FUNCTION__, filename.c_str())
+        return calib;
+    }
+    // device gflops gbps overhead_ms [read_gbps write_gbps]
+    string line, dev;
+    while (getline(infile, line)) {
+        istringstream iss(line);
+        Calibration c;
+        if (!(iss >> dev >> c.gflops >> c.gbps >> c.overhead_ms) || dev != device) {
+            continue;
+        }
+        iss >> c.read_gbps >> c.write_gbps;
+        calib = c;
+        break;
+    }
+    infile.close();
+    return calib;
+}
+
+void Profiler::measure_storage(Calibration &calib, string dir) {
+    // the executor swaps through files in this directory, so time a round trip through it
+    const size_t bytes = 64 << 20;
+    vector<char> buffer(bytes, 1);
+    string filename = dir + "/bandwidth.tmp";
+    auto start = chrono::steady_clock::now();
+    FILE *f = fopen(filename.c_str(), "wb");
+    if (nullptr == f) {
+        debug_print("%s: can't open %s\n", __FUNCTION__, filename.c_str())
+        return;
+    }
+    auto written = fwrite(buffer.data(), 1, bytes, f);
+    fclose(f);
+    auto middle = chrono::steady_clock::now();
+    f = fopen(filename.c_str(), "rb");
+    size_t readed = 0;
+    if (nullptr != f) {
+        readed = fread(buffer.data(), 1, bytes, f);
+        fclose(f);
+    }
+    auto end = chrono::steady_clock::now();
+    remove(filename.c_str());
+    auto write_s = chrono::duration<double>(middle - start).count();
+    auto read_s = chrono::duration<double>(end - middle).count();
+    if (written == bytes && write_s > 0) {
+        calib.write_gbps = bytes / write_s / 1e9;
+    }
+    if (readed == bytes && read_s > 0) {
+        calib.read_gbps = bytes / read_s / 1e9;
+    }
+    debug_print("%s: read %.3lf GB/s, write %.3lf GB/s\n", __FUNCTION__, calib.read_gbps, calib.write_gbps)
+}
+
+void Profiler::dump_calibration(string filename, Calibration calib) {
+    vector<string> lines;
+    {
+        ifstream infile(filename);
+        string line;
+        while (getline(infile, line)) {
+            auto items = split(strip(line));
+            if (!items.empty() && !items[0].empty() && items[0] != device) {
+                lines.push_back(line);
+            }
+        }
+    }
+    ofstream ofs(filename, ios::out);
+    if (!ofs.is_open()) {
+        debug_print("error to %s\n", __FUNCTION__)
+        return;
+    }
+    for (auto &line: lines) {
+        ofs << line << "\n";
+    }
+    ofs << device << " " << calib.gflops << " " << calib.gbps << " " << calib.overhead_ms << " "
+        << calib.read_gbps << " " << calib.write_gbps << "\n";
+    ofs.close();
+}
+
 void Profiler::add_info(string line, vector<string> &vec) {
     stringstream ss(line);
     char c;
@@ -423,6 +622,7 @@ void Profiler::dump_io_info(string filename) {
     }
     for (auto info: io_info) {
         ofs << "opid " << info.opid << "\n";
+        ofs << "type " << info.type << "\n";
         ofs << "inputs ";
         for (auto i: info.inputs) {
             ofs << i << " ";
@@ -519,6 +719,14 @@ void Profiler::dump_original_execution_info(string filename) {
     ofs.close();
 }
 
+vector<int> Profiler::op_types() {
+    vector<int> types;
+    for (auto &info: io_info) {
+        types.push_back(info.type);
+    }
+    return types;
+}
+
 
 Recomputer::Recomputer(shared_ptr<Profiler> profiler_ptr, shared_ptr<GreedyAllocator> allocator_ptr, size_t budget, double thres)
         : profiler(profiler_ptr), grd_allocator(allocator_ptr), budget_mb(budget), threshold(thres) {
@@ -596,7 +804,13 @@ Recomputer::Recomputer(shared_ptr<Profiler> profiler_ptr, shared_ptr<GreedyAlloc
             {112, 1700},
             {128, 1400},
     };
-    budget_b = computing_budget[profiler->modelname + ":" + to_string(budget_mb)][profiler->batchsize] << 20;
+    auto key = profiler->modelname + ":" + to_string(budget_mb);
+    if (computing_budget.count(key) && computing_budget[key].count(profiler->batchsize)) {
+        budget_b = computing_budget[key][profiler->batchsize] << 20;
+    } else {
+        // budgets outside the calibrated table (e.g. rungs of a plan bundle) use the budget itself
+        budget_b = budget_mb << 20;
+    }
     debug_print("budget_b = %lu\n", budget_b)
 }
 
@@ -751,8 +965,9 @@ void Recomputer::adjust_exe_seq() {
         auto pos = -1;
         for (auto i = idx; i >= 0; i--) {
             auto &inputs = profiler->io_info[stoi(exe_seq[i].second)].inputs;
-            if (exe_seq[i].first.find("compute") != string::npos &&
-                (exe_seq[i].second == p.second || find(inputs.begin(), inputs.end(), p.second) != inputs.end())) {
+            if ((exe_seq[i].first.find("compute") != string::npos &&
+                 (exe_seq[i].second == p.second || find(inputs.begin(), inputs.end(), p.second) != inputs.end())) ||
+                (exe_seq[i].first.find("swap") == 0 && exe_seq[i].second == p.second)) {
                 pos = i + 1;
                 break;
             }
@@ -867,6 +1082,208 @@ void Recomputer::dump_exe_seq() {
     ofs.close();
 }
 
+HybridPlanner::HybridPlanner(shared_ptr<Profiler> profiler_ptr, shared_ptr<GreedyAllocator> allocator_ptr, size_t budget,
+                             Profiler::Calibration calibration)
+        : Recomputer(profiler_ptr, allocator_ptr, budget), calib(calibration) {
+    op_time.assign(profiler->io_info.size() + 1, 0);
+    for (int i = 0; i < profiler->io_info.size(); i++) {
+        op_time[i + 1] = op_time[i] + profiler->cost_info[profiler->io_info[i].opid];
+    }
+}
+
+double HybridPlanner::io_ms(string tid, double gbps) {
+    if (gbps <= 0) {
+        // never measured, don't swap
+        return numeric_limits<double>::max() / 4;
+    }
+    return profiler->tensor_size[tid] / (gbps * 1e6);
+}
+
+int HybridPlanner::next_use(string tid, int from) {
+    int use = -1;
+    for (auto op: table_out[tid]) {
+        auto idx = stoi(op);
+        if (idx >= from && (use == -1 || idx < use)) {
+            use = idx;
+        }
+    }
+    return use;
+}
+
+void HybridPlanner::sources(string ith, set<string> &recompute, set<string> &swap_in) {
+    queue<string> que;
+    for (auto tid : table_in[ith]) {
+        if (allocated_tensor.find(tid) == allocated_tensor.end() && allocated_tensor.find(tid + RECOMPUTE_SUFFIX) == allocated_tensor.end()) {
+            que.push(tid);
+        }
+    }
+    while (!que.empty()) {
+        auto cur = que.front();
+        que.pop();
+        if (recompute.count(cur) || swap_in.count(cur) || allocated_tensor.count(cur)) {
+            continue;
+        }
+        // a swapped tensor is read back instead of recomputing what it was computed from
+        if (swapped.count(cur)) {
+            swap_in.insert(cur);
+            continue;
+        }
+        recompute.insert(cur);
+        for (auto t : table_in[cur]) {
+            que.push(t);
+        }
+    }
+}
+
+double HybridPlanner::recompute_cost(string tid) {
+    set<string> recompute, swap_in;
+    sources(tid, recompute, swap_in);
+    double cost = profiler->cost_info[tid];
+    for (auto t: recompute) {
+        cost += profiler->cost_info[t];
+    }
+    for (auto t: swap_in) {
+        cost += io_ms(t, calib.read_gbps);
+    }
+    return cost;
+}
+
+double HybridPlanner::swap_cost(string tid, int opidx) {
+    auto use = next_use(tid, opidx);
+    if (use == -1) {
+        return 0;
+    }
+    // the write runs from the producer until the last read before the eviction
+    double write = 0;
+    if (!on_disk.count(tid)) {
+        write = max(0.0, io_ms(tid, calib.write_gbps) - (touched_time[tid] - produced_time[tid]));
+    }
+    // the read can be prefetched behind the compute until the next use
+    double read = max(0.0, io_ms(tid, calib.read_gbps) - (op_time[use] - op_time[opidx]));
+    return write + read;
+}
+
+void HybridPlanner::swap_in(string tid) {
+    grd_allocator->insert_tensors({tid}, calibrated_timestamp);
+    exe_seq.emplace_back("swap-in", tid);
+    debug_print("exe_seq[%zu]=(%s, %s)\n", exe_seq.size() - 1, exe_seq[exe_seq.size() - 1].first.c_str(), exe_seq[exe_seq.size() - 1].second.c_str())
+    produced_step[tid] = exe_seq.size() - 1;
+    allocated_tensor.insert(tid);
+    swapped.erase(tid);
+    incoming.insert(tid);
+    calibrated_timestamp++;
+}
+
+void HybridPlanner::planned_compute(string ith, int opidx, bool recompute) {
+    while (grd_allocator->current_size(calibrated_timestamp) > budget_b) {
+        string evict_t;
+        double best = -1;
+        bool by_swap = false;
+        for (auto t: allocated_tensor) {
+            // the inputs of ith and the tensors prefetched for it have to stay, and so do the outputs of
+            // the step: never released, nothing computes them again before they are read back
+            if (table_in[ith].count(t) || incoming.count(t) || (release_point.count(t) && stoi(release_point[t]) >= profiler->io_info.size())) {
+                continue;
+            }
+            auto rc = recompute_cost(t), sc = swap_cost(t, opidx);
+            auto m = profiler->tensor_size[t] * (stod(release_point[t]) - opidx) / max(min(rc, sc), 1e-6);
+            if (evict_t.empty() || m > best) {
+                evict_t = t;
+                best = m;
+                by_swap = sc < rc;
+            }
+        }
+        if (evict_t.empty()) {
+            debug_print("cannot evict any tensor because current allocated-tensor set is empty")
+            break;
+        }
+        if (by_swap) {
+            if (!on_disk.count(evict_t)) {
+                // start writing right after the tensor is produced
+                auto pos = produced_step[evict_t] + 1;
+                exe_seq.insert(exe_seq.begin() + pos, make_pair(string("swap-out"), evict_t));
+                for (auto &p: produced_step) {
+                    if (p.second >= pos) {
+                        p.second++;
+                    }
+                }
+                on_disk.insert(evict_t);
+            }
+            swapped.insert(evict_t);
+            swap_count++;
+        }
+        grd_allocator->remove_tensor(evict_t, calibrated_timestamp);
+        exe_seq.emplace_back("pre-release", evict_t);
+        debug_print("exe_seq[%zu]=(%s, %s)\n", exe_seq.size() - 1, exe_seq[exe_seq.size() - 1].first.c_str(), exe_seq[exe_seq.size() - 1].second.c_str())
+        allocated_tensor.erase(evict_t);
+    }
+    for (auto t : profiler->io_info[stoi(ith)].outputs) {
+        grd_allocator->allocate(t);
+        allocated_tensor.insert(t);
+        // a recomputed tensor is the same content, what is on disk stays valid
+    }
+    exe_seq.emplace_back(recompute ? "recompute" : "compute", ith);
+    debug_print("exe_seq[%zu]=(%s, %s)\n", exe_seq.size() - 1, exe_seq[exe_seq.size() - 1].first.c_str(), exe_seq[exe_seq.size() - 1].second.c_str())
+    recompute_count += recompute;
+    elapsed += profiler->cost_info[ith];
+    for (auto t : profiler->io_info[stoi(ith)].outputs) {
+        produced_step[t] = exe_seq.size() - 1;
+        produced_time[t] = elapsed;
+        touched_time[t] = elapsed;
+    }
+    for (auto t : table_in[ith]) {
+        touched_time[t] = elapsed;
+        incoming.erase(t);
+    }
+    for (auto t : profiler->io_info[stoi(ith)].release) {
+        swapped.erase(t);
+        if (allocated_tensor.find(t) == allocated_tensor.end()) {
+            debug_print("%s: %s is not allocated\n", __FUNCTION__, t.c_str())
+        } else {
+            allocated_tensor.erase(t);
+            exe_seq.emplace_back(recompute ? "re-release" : "release", t);
+            debug_print("exe_seq[%zu]=(%s, %s)\n", exe_seq.size() - 1, exe_seq[exe_seq.size() - 1].first.c_str(), exe_seq[exe_seq.size() - 1].second.c_str())
+        }
+    }
+    calibrated_timestamp++;
+}
+
+void HybridPlanner::progressive_planning() {
+    debug_print("profiler.io_info.size() = %zu\n", profiler->io_info.size())
+    for (auto opidx = 0; opidx < profiler->io_info.size(); ++opidx) {
+        auto &info = profiler->io_info[opidx];
+        // prefetch what can't be read back behind the compute left before its use any later
+        vector<string> pending(swapped.begin(), swapped.end());
+        for (auto t: pending) {
+            auto use = next_use(t, opidx);
+            if (use == -1) {
+                swapped.erase(t);
+            } else if (op_time[use] - op_time[opidx] <= io_ms(t, calib.read_gbps)) {
+                swap_in(t);
+            }
+        }
+        set<string> recompute, need_swap;
+        sources(info.opid, recompute, need_swap);
+        for (auto t: need_swap) {
+            swap_in(t);
+        }
+        if (!recompute.empty()) {
+            vector<string> src(recompute.begin(), recompute.end());
+            sort(src.begin(), src.end(), [](string a, string b) { return stoi(a) < stoi(b); });
+            grd_allocator->insert_tensors(src, calibrated_timestamp);
+            for (auto tid: src) {
+                planned_compute(tid, opidx, true);
+            }
+        }
+        planned_compute(info.opid, opidx, false);
+        current_progress = info.opid;
+    }
+    adjust_exe_seq();
+    dump_exe_seq();
+    debug_print("model=%s\tbatch=%d\tbudget=%zu\texe_seq.size()=%lu\tswap=%d\trecompute=%d\n",
+                profiler->modelname.c_str(), profiler->batchsize, budget_mb, exe_seq.size(), swap_count, recompute_count)
+}
+
 GreedyAllocator::GreedyAllocator(shared_ptr<Profiler> profiler_ptr, size_t bgt_mb, bool norecomp)
         : profiler(std::move(profiler_ptr)), budget_mb(bgt_mb), noRecompute(norecomp) {}
 
@@ -915,10 +1332,18 @@ bool GreedyAllocator::load_info_via_exe_seq() {
     string a, op;
     vector<pair<string, string>> update_redundent_parent;
     map<string, shared_ptr<Tensor>> heu_info;
+    set<int> swapped_in;
     while (ifs >> a >> op) {
-        if (a.find("compute") != string::npos) {
+        if (a == "swap-out") {
+            // the tensor stays until its release, writing it out takes no memory
+            continue;
+        }
+        if (a.find("compute") != string::npos || a == "swap-in") {
             op_comp_idx[op] = ++idx;
             recomp_seq_info.emplace_back(op, idx);
+            if (a == "swap-in") {
+                swapped_in.insert(idx);
+            }
             if (a == "recompute") {
                 for (const auto &iter : profiler->redundent_parent) {
                     auto pos = iter.first.find(":");
@@ -946,7 +1371,10 @@ bool GreedyAllocator::load_info_via_exe_seq() {
         // output info
         auto &info = recomp_seq_info[i];
         heu_info[to_string(i)] = make_shared<Tensor>(to_string(i), info.alloc, info.free, profiler->tensor_size[info.id]);
-        // resize info
+        // resize info, a swap-in reads the output back without resizing the op
+        if (swapped_in.count(i)) {
+            continue;
+        }
         for (auto p : profiler->resize_info[stoi(info.id)]) {
             if (p.first == "alloc") {
                 string rsid = to_string(i) + ":" + p.second.substr(p.second.find(':') + 1);
@@ -1294,4 +1722,230 @@ void GreedyAllocator::dump_heuristic_result() {
     ofs.close();
 }
 
+MNN::PlanRung generate_plan_rung(string modelname, int batchsize, int mem_bgt, vector<int> &op_types) {
+    // a fresh profiler per rung, load_info_via_exe_seq() patches redundent_parent in place
+    shared_ptr<Profiler> profiler = make_shared<Profiler>(modelname, batchsize);
+    shared_ptr<GreedyAllocator> grd_allocator = make_shared<GreedyAllocator>(profiler, mem_bgt, true);
+    grd_allocator->heuristic_alloc();
+    // CalibrateProfiler keeps the measured storage, until then it is measured for every plan
+    auto calib = profiler->calibration;
+    if (calib.read_gbps <= 0 || calib.write_gbps <= 0) {
+        profiler->measure_storage(calib);
+    }
+    shared_ptr<HybridPlanner> recomputer = make_shared<HybridPlanner>(profiler, grd_allocator, mem_bgt, calib);
+    recomputer->progressive_planning();
+    shared_ptr<GreedyAllocator> plan_allocator = make_shared<GreedyAllocator>(profiler, mem_bgt);
+    plan_allocator->load_info_via_exe_seq();
+    plan_allocator->heuristic_alloc();
+
+    MNN::PlanRung rung;
+    rung.budgetMB = mem_bgt;
+    rung.maxSize = plan_allocator->max_address;
+    for (auto &iter : plan_allocator->tensor2address) {
+        rung.address[iter.first->id] = iter.second.first;
+        rung.size[iter.first->id] = iter.first->size;
+    }
+    for (auto &p : recomputer->exe_seq) {
+        rung.sequence.emplace_back(p.first, stoi(p.second));
+    }
+    op_types = profiler->op_types();
+    debug_print("budget %dMB: maxsize = %zu, %zu steps\n", mem_bgt, rung.maxSize, rung.sequence.size())
+    return rung;
+}
+
+int GeneratePlanBundle::run(int argc, const char *argv[]) {
+    if (argc < 4) {
+        std::cout << "./runTrainDemo GeneratePlanBundle MODEL BATCH BUDGET [BUDGET ...]\n";
+        return 0;
+    }
+    std::string modelname = argv[1];
+    int batchsize = atoi(argv[2]);
+    vector<MNN::PlanRung> rungs;
+    vector<int> op_types;
+    for (int i = 3; i < argc; i++) {
+        int mem_bgt = atoi(argv[i]);
+        if (mem_bgt <= 0) {
+            cout << "invalid budget " << argv[i] << "\n";
+            return 0;
+        }
+        rungs.emplace_back(generate_plan_rung(modelname, batchsize, mem_bgt, op_types));
+    }
+    auto filename = MNN::PlanBundle::defaultPath(modelname, batchsize);
+    if (!MNN::PlanBundle::save(filename, modelname, batchsize, op_types, rungs)) {
+        cout << "error to save plan bundle to " << filename << "\n";
+        return 0;
+    }
+    cout << "save " << rungs.size() << " plans to " << filename << "\n";
+    return 0;
+}
+
+// stdout of fn goes to filename, the executor logs through MNN_PRINT
+static bool capture_stdout(string filename, function<void()> fn) {
+    fflush(stdout);
+    int saved = dup(fileno(stdout));
+    if (nullptr == freopen(filename.c_str(), "w", stdout)) {
+        return false;
+    }
+    fn();
+    fflush(stdout);
+    dup2(saved, fileno(stdout));
+    close(saved);
+    return true;
+}
+
+// one step of the same small conv net under target "profile" and under target "estimate": the profiler
+// must read the same ops and tensors from both logs, and estimate a cost for every op
+class EstimateProfileTest : public DemoUnit {
+public:
+    virtual int run(int argc, const char *argv[]) override {
+        using namespace MNN::Express;
+        using namespace MNN::Train;
+#ifndef PROFILE_EXECUTION_IN_LOG
+        MNN_PRINT("EstimateProfileTest needs a build with PROFILE_EXECUTION_IN_LOG, skipped\n");
+        return 0;
+#endif
+        auto exe = Executor::getGlobalExecutor();
+        string targets[2] = {"profile", "estimate"};
+        string logs[2] = {"estimate_test.profile.out", "estimate_test.estimate.out"};
+        for (int i = 0; i < 2; i++) {
+            // a new net for each run, the estimate computes nothing and so would update with garbage
+            NN::ConvOption option;
+            option.kernelSize = {3, 3};
+            option.channel = {4, 8};
+            shared_ptr<Module> conv(NN::Conv(option));
+            shared_ptr<Module> linear(NN::Linear(8 * 6 * 6, 10));
+            auto parameters = conv->parameters();
+            for (auto p: linear->parameters()) {
+                parameters.emplace_back(p);
+            }
+            shared_ptr<Module> net(Module::createEmpty(parameters));
+            shared_ptr<SGD> sgd(new SGD(net));
+            sgd->setLearningRate(0.01f);
+            auto x = _Input({2, 4, 8, 8}, NCHW);
+            ::memset(x->writeMap<float>(), 0, x->getInfo()->size * sizeof(float));
+            exe->configExecution("EstimateTest", 2, targets[i], 1024);
+            bool captured = capture_stdout(logs[i], [&]() {
+                auto y = _Convert(_Relu(conv->forward(_Convert(x, NC4HW4))), NCHW);
+                auto loss = _ReduceMean(linear->forward(_Reshape(y, {2, -1})), {});
+                sgd->step(loss);
+            });
+            if (!captured) {
+                MNN_ERROR("EstimateProfileTest: can't write %s\n", logs[i].c_str());
+                return 1;
+            }
+        }
+        exe->configExecution("", 0, "mnn", 0);
+
+        Profiler measured("EstimateTest", 2), estimated("EstimateTest", 2);
+        measured.profile_from_scratch(logs[0]);
+        estimated.profile_from_scratch(logs[1]);
+        if (measured.io_info.empty() || measured.io_info.size() != estimated.io_info.size()) {
+            MNN_ERROR("EstimateProfileTest: %d ops profiled, %d estimated\n", (int)measured.io_info.size(),
+                      (int)estimated.io_info.size());
+            return 1;
+        }
+        for (int i = 0; i < measured.io_info.size(); i++) {
+            auto &m = measured.io_info[i], &e = estimated.io_info[i];
+            if (m.type != e.type || m.inputs != e.inputs || m.outputs != e.outputs || m.release != e.release ||
+                m.temporary != e.temporary) {
+                MNN_ERROR("EstimateProfileTest: op %d differs\n", i);
+                return 1;
+            }
+            for (auto tensors: {&m.inputs, &m.outputs}) {
+                for (auto &t: *tensors) {
+                    if (measured.tensor_size[t] != estimated.tensor_size[t]) {
+                        MNN_ERROR("EstimateProfileTest: tensor %s of op %d differs in size\n", t.c_str(), i);
+                        return 1;
+                    }
+                }
+            }
+        }
+        Profiler costed("EstimateTest", 2);
+        if (!costed.estimate_from_scratch(logs[1]) || costed.op_workload.size() != measured.io_info.size()) {
+            MNN_ERROR("EstimateProfileTest: the estimate log has no workload for every op\n");
+            return 1;
+        }
+        for (auto &info: costed.io_info) {
+            if (costed.cost_info[info.opid] <= 0) {
+                MNN_ERROR("EstimateProfileTest: op %s has no cost\n", info.opid.c_str());
+                return 1;
+            }
+        }
+        remove(logs[0].c_str());
+        remove(logs[1].c_str());
+        MNN_PRINT("EstimateProfileTest passed\n");
+        return 0;
+    }
+};
+
+DemoUnitSetRegister(EstimateProfileTest, "EstimateProfileTest");
+
+// five ops over a budget of two tensors, where tensor 0 is read by op 1 and again by op 4. It is evicted at
+// op 2, by swap if the storage hides the io and its recompute costs more, else to be recomputed for op 4
+static shared_ptr<HybridPlanner> plan_synthetic(double gbps, double cost) {
+    size_t mb = 1 << 20;
+    auto profiler = make_shared<Profiler>("HybridPlannerTest", 1);
+    profiler->io_info.clear();
+    profiler->tensor_size.clear();
+    profiler->cost_info.clear();
+    profiler->resize_info.clear();
+    vector<vector<string>> inputs = {{}, {"0"}, {"1"}, {"2"}, {"3", "0"}};
+    vector<vector<string>> release = {{}, {}, {"1"}, {"2"}, {"3", "0"}};
+    for (int i = 0; i < inputs.size(); i++) {
+        Profiler::OpInfo info(to_string(i));
+        info.inputs = inputs[i];
+        info.outputs = {to_string(i)};
+        info.release = release[i];
+        profiler->io_info.push_back(info);
+        profiler->tensor_size[to_string(i)] = mb;
+        profiler->cost_info[to_string(i)] = 0 == i ? cost : 1.0;
+        profiler->resize_info.emplace_back();
+    }
+    // lifetimes in compute steps, as load_info_via_exe_seq counts them
+    auto allocator = make_shared<GreedyAllocator>(profiler, 2, true);
+    int frees[] = {5, 3, 4, 5, 5};
+    for (int i = 0; i < inputs.size(); i++) {
+        auto t = make_shared<GreedyAllocator::Tensor>(to_string(i), i, frees[i], mb);
+        allocator->infos.push_back(t);
+        allocator->id2tensor[t->id] = t;
+    }
+    allocator->id2originalTensor = allocator->id2tensor;
+    allocator->heuristic_alloc();
+    Profiler::Calibration calib;
+    calib.read_gbps = calib.write_gbps = gbps;
+    auto planner = make_shared<HybridPlanner>(profiler, allocator, 2, calib);
+    planner->progressive_planning();
+    return planner;
+}
+
+class HybridPlannerTest : public DemoUnit {
+public:
+    virtual int run(int argc, const char *argv[]) override {
+        auto at = [](shared_ptr<HybridPlanner> planner, string action, string tid) {
+            auto &seq = planner->exe_seq;
+            return (int)(find(seq.begin(), seq.end(), make_pair(action, tid)) - seq.begin());
+        };
+        // fast storage and a slow producer: written out right after it is computed, read back before op 4
+        auto swap = plan_synthetic(10, 100);
+        auto end = (int)swap->exe_seq.size();
+        if (swap->swap_count != 1 || swap->recompute_count != 0 || at(swap, "swap-out", "0") != at(swap, "compute", "0") + 1 ||
+            at(swap, "pre-release", "0") < at(swap, "swap-out", "0") || at(swap, "pre-release", "0") > at(swap, "swap-in", "0") ||
+            at(swap, "swap-in", "0") > at(swap, "compute", "4") || at(swap, "compute", "4") == end) {
+            MNN_ERROR("HybridPlannerTest: tensor 0 should be swapped\n");
+            return 1;
+        }
+        // storage never measured: recomputed for op 4, nothing touches the disk
+        auto recompute = plan_synthetic(0, 1);
+        end = (int)recompute->exe_seq.size();
+        if (recompute->swap_count != 0 || recompute->recompute_count != 1 || at(recompute, "swap-out", "0") != end ||
+            at(recompute, "swap-in", "0") != end || at(recompute, "pre-release", "0") == end ||
+            at(recompute, "recompute", "0") > at(recompute, "compute", "4") || at(recompute, "compute", "4") == end) {
+            MNN_ERROR("HybridPlannerTest: tensor 0 should be recomputed\n");
+            return 1;
+        }
+        MNN_PRINT("HybridPlannerTest passed\n");
+        return 0;
+    }
+};
 
+DemoUnitSetRegister(HybridPlannerTest, "HybridPlannerTest");
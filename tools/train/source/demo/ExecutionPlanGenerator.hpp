@@ -1,9 +1,13 @@
 #include <algorithm>
+#include <chrono>
 #include <climits>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <map>
 #include <queue>
 #include <regex>
@@ -14,6 +18,7 @@
 #include <vector>
 #include <regex>
 #include "DemoUnit.hpp"
+#include "core/PlanBundle.hpp"
 
 using namespace std;
 
@@ -60,6 +65,7 @@ class Profiler {
 public:
     struct OpInfo {
         string opid;
+        int type = -1;  // MNN::OpType, -1 if the profile log doesn't carry it
         vector<string> inputs, outputs, release, temporary;
 
         OpInfo(string op = "") {
@@ -69,15 +75,25 @@ public:
         friend ostream &operator<<(ostream &out, OpInfo &info);
     };
 
-    Profiler(string mn, int bs);
+    // what one device achieves, turns the flops and bytes of an estimated op into cost (ms)
+    // and the bytes of a swapped tensor into io time, read/write bandwidth is 0 until measured
+    struct Calibration {
+        double gflops = 16.0, gbps = 6.0, overhead_ms = 0.02;
+        double read_gbps = 0, write_gbps = 0;
+    };
+
+    Profiler(string mn, int bs, string dev = "default");
 
     vector<OpInfo> io_info;
     map<string, size_t> tensor_size;
     map<string, double> cost_info;
     vector<vector<pair<string, string>>> resize_info;
     map<string, string> redundent_parent;
-    string modelname;
+    map<string, pair<double, double>> op_workload;  // op -> (flops, bytes), only for estimated profiles
+    string modelname, device;
     int batchsize, fp_thres = -1, num_layers = 0;
+    // of this device, loaded once, refined logs refit it in memory and only calibrate() saves it
+    Calibration calibration;
 
     void load_infomation(string basename);
 
@@ -101,6 +117,22 @@ public:
 
     void cost_from_scratch(string filename);
 
+    // io, tensor sizes and cost from the log of target "estimate", false if there is no such log
+    bool estimate_from_scratch(string filename);
+
+    // replace estimated temporaries and cost by measured ones where the logs exist, and refit the calibration
+    void refine_from_scratch(string resize_file, string cost_file);
+
+    // refit the calibration to the estimate and cost logs of this model, measure the storage and save it,
+    // false if there is no estimate log
+    bool calibrate();
+
+    Calibration load_calibration(string filename);
+
+    void dump_calibration(string filename, Calibration calib);
+
+    void measure_storage(Calibration &calib, string dir = "swap");
+
     void add_info(string ln, vector<string> &vec);
 
     void dump_information();
@@ -116,6 +148,8 @@ public:
     void dump_redundent_parent(string filename);
 
     void dump_original_execution_info(string filename);
+
+    vector<int> op_types();
 };
 
 class Recomputer {
@@ -155,6 +189,41 @@ public:
     void calibrated_compute(string ith, bool recompute=false);
 };
 
+// decides per evicted feature map whether to drop and recompute it or to swap it to storage, by what
+// each costs on top of the compute: recomputation costs its sources (cost_info), a swap only costs the
+// io (measured read/write bandwidth) that the compute between producer, eviction and consumer can't hide.
+// swap-out starts right after the producer, swap-in is prefetched as late as still hides the read.
+class HybridPlanner : public Recomputer {
+public:
+    HybridPlanner(shared_ptr<Profiler> profiler_ptr, shared_ptr<GreedyAllocator> allocator_ptr, size_t budget,
+                  Profiler::Calibration calibration);
+
+    void progressive_planning();
+
+    Profiler::Calibration calib;
+    set<string> swapped, on_disk, incoming;
+    map<string, double> produced_time, touched_time;  // elapsed compute when a tensor was produced / last read
+    map<string, int> produced_step;  // index in exe_seq of the step that materialized a tensor
+    vector<double> op_time;  // op_time[i] is the cost of ops [0, i)
+    double elapsed = 0;
+    int swap_count = 0, recompute_count = 0;
+
+private:
+    double io_ms(string tid, double gbps);
+
+    int next_use(string tid, int from);
+
+    void sources(string ith, set<string> &recompute, set<string> &swap_in);
+
+    double recompute_cost(string tid);
+
+    double swap_cost(string tid, int opidx);
+
+    void swap_in(string tid);
+
+    void planned_compute(string ith, int opidx, bool recompute);
+};
+
 class GreedyAllocator {
 public:
     struct Tensor;
@@ -202,6 +271,9 @@ public:
     vector<string> allocated_sequence;
 };
 
+// run recomputation and allocation under one budget, also dumps the *.execution.txt / *.address.txt
+MNN::PlanRung generate_plan_rung(string modelname, int batchsize, int mem_bgt, vector<int> &op_types);
+
 class GeneratePlan : public DemoUnit {
 public:
     virtual int run(int argc, const char *argv[]) override {
@@ -221,12 +293,48 @@ public:
             return 0;
         }
         debug_print("model=%s, batch=%d, budget=%d\n", modelname.c_str(), batchsize, mem_bgt)
-        shared_ptr<Profiler> profiler = make_shared<Profiler>(modelname, batchsize);
-        debug_print("finish load info with io_info.size = %lu\n", profiler->io_info.size())
-        shared_ptr<GreedyAllocator> grd_allocator = make_shared<GreedyAllocator>(profiler, mem_bgt, true);
-        shared_ptr<Recomputer> recomputer = make_shared<Recomputer>(profiler, grd_allocator, mem_bgt);
-        recomputer->memory_calibrated_progressive_recomputation();
+        if (noRecompute) {
+            shared_ptr<Profiler> profiler = make_shared<Profiler>(modelname, batchsize);
+            shared_ptr<GreedyAllocator> grd_allocator = make_shared<GreedyAllocator>(profiler, mem_bgt, true);
+            grd_allocator->heuristic_alloc();
+            return 0;
+        }
+        vector<int> op_types;
+        auto rung = generate_plan_rung(modelname, batchsize, mem_bgt, op_types);
+        auto filename = MNN::PlanBundle::planPath(modelname, batchsize, mem_bgt);
+        if (!MNN::PlanBundle::save(filename, modelname, batchsize, op_types, {rung})) {
+            cout << "error to save plan to " << filename << "\n";
+        }
+        return 0;
+    }
+};
+
+DemoUnitSetRegister(GeneratePlan, "GeneratePlan");
+
+class GeneratePlanBundle : public DemoUnit {
+public:
+    virtual int run(int argc, const char *argv[]) override;
+};
+
+DemoUnitSetRegister(GeneratePlanBundle, "GeneratePlanBundle");
+
+class CalibrateProfiler : public DemoUnit {
+public:
+    virtual int run(int argc, const char *argv[]) override {
+        if (argc < 3) {
+            std::cout << "./runTrainDemo CalibrateProfiler MODEL BATCH [DEVICE=default]\n";
+            return 0;
+        }
+        Profiler profiler(argv[1], atoi(argv[2]), argc > 3 ? argv[3] : "default");
+        if (!profiler.calibrate()) {
+            cout << "no estimate log of " << argv[1] << " to calibrate with\n";
+            return 0;
+        }
+        auto &calib = profiler.calibration;
+        cout << profiler.device << ": " << calib.gflops << " gflops, " << calib.gbps << " GB/s, read "
+             << calib.read_gbps << " GB/s, write " << calib.write_gbps << " GB/s\n";
+        return 0;
     }
 };
 
-DemoUnitSetRegister(GeneratePlan, "GeneratePlan");
\ No newline at end of file
+DemoUnitSetRegister(CalibrateProfiler, "CalibrateProfiler");
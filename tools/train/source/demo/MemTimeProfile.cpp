@@ -83,15 +83,15 @@ public:
                     } else if (bgt == 8) {
                         bgt = 5500;
                     }
-                    if (bgt != 5500 && bgt != 3800) {
+                    if (method != "bundle" && bgt != 5500 && bgt != 3800) {
                         std::cout << "usage: \n"
                                      "\t./runTrainDemo.out MemTimeProfile Lenet /path/to/unzipped/mnist/data/ BatchSize MicroBatchSize\n"
                                      "\t./runTrainDemo.out MemTimeProfile MODEL path/to/images/ path/to/txt [BatchSize MicroBatchSize method, budget, budget_adaptive, prog]\n"
                                      "\t\tMODEL=[MobilenetV2|Alexnet|Squeezenet|Googlenet]\n"
                                      "\t\toptional params:\n"
                                      "\t\tBatchSize % MicroBatchSize == 0 or default is 8\n"
-                                     "\t\tmethod=[resize|profile|cost | read|write | mnn|sublinear|capuchin|swap|ours | adaptive], mnn by default\n"
-                                     "\t\tbudget_adaptive budget=[6|8|5500|3800], 8GB device is used by default\n"
+                                     "\t\tmethod=[resize|profile|cost | read|write | mnn|sublinear|capuchin|swap|ours | adaptive | bundle], mnn by default\n"
+                                     "\t\tbudget_adaptive budget=[6|8|5500|3800], 8GB device is used by default, any cap in MB for bundle\n"
                                      "\t\tprog: float value in [0.0, 1.0], 1.0 by default (no adaptiveness)\n";
                         return 0;
                     }
@@ -149,7 +149,7 @@ public:
                                  "\t./runTrainDemo.out MemTimeProfile MODEL path/to/images/ path/to/txt [BatchSize MicroBatchSize method, budget, budget_adaptive, prog]\n"
                                  "\t\tMODEL=[MobilenetV2|Alexnet|Squeezenet|Googlenet]\n"
                                  "\t\tBatchSize % MicroBatchSize == 0 or default is 8\n"
-                                 "\t\tmethod=[resize|profile|cost | read|write | mnn|sublinear|capuchin|swap|ours | adaptive]\n"
+                                 "\t\tmethod=[resize|profile|cost | read|write | mnn|sublinear|capuchin|swap|ours | adaptive | bundle]\n"
                                  "\t\tbudget_adaptive budget=[6|8|5500|3800]\n"
                                  "\t\tprog: [0.0, 1.0]\n";
                     return 0;
@@ -164,7 +164,7 @@ public:
                      "\t./runTrainDemo.out MemTimeProfile MODEL path/to/images/ path/to/txt [BatchSize MicroBatchSize method, budget, budget_adaptive, prog]\n"
                      "\t\tMODEL=[MobilenetV2|Alexnet|Squeezenet|Googlenet]\n"
                      "\t\tBatchSize % MicroBatchSize == 0 or default is 8\n"
-                     "\t\tmethod=[resize|profile|cost | read|write | mnn|sublinear|capuchin|swap|ours | adaptive]\n"
+                     "\t\tmethod=[resize|profile|cost | read|write | mnn|sublinear|capuchin|swap|ours | adaptive | bundle]\n"
                      "\t\tbudget_adaptive budget=[6|8|5500|3800]\n"
                      "\t\tprog: [0.0, 1.0]\n";
         return 0;
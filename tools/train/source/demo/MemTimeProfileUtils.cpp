@@ -23,6 +23,7 @@
 #include "Loss.hpp"
 #include "Transformer.hpp"
 #include "ImageDataset.hpp"
+#include "MemoryBudget.hpp"
 #include "module/PipelineModule.hpp"
 #include "OpGrad.hpp"
 #include<fstream>
@@ -137,7 +138,7 @@ public:
         std::shared_ptr<MicroSGD> solver(new MicroSGD(model, trainBatchSize, trainMicroBatchsize));
         solver->setMomentum(0.9f);
         // solver->setMomentum2(0.99f);
-        solver->setHeuristicFlag(target == "ours");
+        solver->setHeuristicFlag(target == "ours" || target == "bundle");
         solver->setWeightDecay(0.00004f);
 
         auto converImagesToFormat  = CV::RGB;
@@ -158,6 +159,10 @@ public:
 
         auto trainDataLoader = trainDataset.createLoader(trainMicroBatchsize, true, true, trainNumWorkers);
         auto testDataLoader = testDataset.createLoader(testBatchSize, true, true, testNumWorkers);
+        // prefetched batches and the plan share the budget
+        auto memoryBudget = std::make_shared<MemoryBudget>(memoryBudgetMB);
+        memoryBudget->bind(exe);
+        trainDataLoader->setMemoryBudget(memoryBudget);
 
         const int trainIterations = trainDataLoader->iterNumber();
         const int testIterations = testDataLoader->iterNumber();
@@ -177,7 +182,7 @@ public:
                 }
                 int numIteration = 2;
                 if (target == "adaptive") numIteration = 1;
-                if (target == "profile" || target == "resize" || target == "cost") {
+                if (target == "profile" || target == "resize" || target == "cost" || target == "estimate") {
                     numIteration = 1;
                 }
                 for (int i = 0; i < numIteration * (trainBatchSize / trainMicroBatchsize); i++) {
@@ -8,15 +8,23 @@
 
 #include <MNN/expr/ExprCreator.hpp>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <iostream>
+#include <map>
+#include <set>
+#include <thread>
 #include <vector>
 #include "DataLoader.hpp"
+#include "Dataset.hpp"
 #include "DemoUnit.hpp"
 #include "MnistDataset.hpp"
 #include "LambdaTransform.hpp"
+#include "MemoryBudget.hpp"
 #include "RandomSampler.hpp"
 #include "Sampler.hpp"
+#include "ShardDataset.hpp"
 #include "StackTransform.hpp"
 #include "Transform.hpp"
 #include "TransformDataset.hpp"
@@ -270,3 +278,313 @@ public:
 };
 
 DemoUnitSetRegister(DataLoaderTest, "DataLoaderTest");
+
+// example i is a 2x3 data of i and labels of i, all with one label but mLongIndex, which has two
+class RowDataset : public Dataset {
+public:
+    RowDataset(size_t size, size_t longIndex = -1) : mSize(size), mLongIndex(longIndex) {
+    }
+    Example get(size_t index) override {
+        mGets++;
+        auto data = _Input({2, 3}, NCHW, halide_type_of<float>());
+        std::fill(data->writeMap<float>(), data->writeMap<float>() + 6, (float)index);
+        int labels  = index == mLongIndex ? 2 : 1;
+        auto target = _Input({labels}, NCHW, halide_type_of<int32_t>());
+        std::fill(target->writeMap<int32_t>(), target->writeMap<int32_t>() + labels, (int32_t)index);
+        return {{data}, {target}};
+    }
+    bool fill(size_t index, const std::vector<void*>& data, const std::vector<void*>& target,
+              const std::vector<size_t>& dataBytes, const std::vector<size_t>& targetBytes) override {
+        int labels = index == mLongIndex ? 2 : 1;
+        if (dataBytes[0] != 6 * sizeof(float) || targetBytes[0] != labels * sizeof(int32_t)) {
+            return false;
+        }
+        std::fill((float*)data[0], (float*)data[0] + 6, (float)index);
+        std::fill((int32_t*)target[0], (int32_t*)target[0] + labels, (int32_t)index);
+        return true;
+    }
+    bool supportFill() override {
+        return true;
+    }
+    size_t size() override {
+        return mSize;
+    }
+    std::atomic<int> mGets{0};
+
+private:
+    size_t mSize;
+    size_t mLongIndex;
+};
+
+// RowDataset without fill
+class GetOnlyDataset : public RowDataset {
+public:
+    GetOnlyDataset(size_t size) : RowDataset(size) {
+    }
+    bool supportFill() override {
+        return false;
+    }
+};
+
+static bool _checkRows(const Example& batch, const std::vector<size_t>& indices) {
+    auto data   = batch.first[0]->readMap<float>();
+    auto target = batch.second[0]->readMap<int32_t>();
+    if (batch.first[0]->getInfo()->dim[0] != indices.size() || batch.second[0]->getInfo()->dim[0] != indices.size()) {
+        return false;
+    }
+    for (int i = 0; i < indices.size(); ++i) {
+        if (target[i] != indices[i]) {
+            return false;
+        }
+        for (int j = 0; j < 6; ++j) {
+            if (data[i * 6 + j] != indices[i]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// the workers of a loader finish their jobs in any order, the rows of a job of 4 start at the label of its first row
+static std::vector<size_t> _jobRows(const Example& batch) {
+    auto first = (size_t)batch.second[0]->readMap<int32_t>()[0];
+    return {first, first + 1, first + 2, first + 3};
+}
+
+class BatchIntoTest : public DemoUnit {
+public:
+    virtual int run(int argc, const char* argv[]) override {
+        auto rows    = std::make_shared<RowDataset>(64, 13);
+        auto stacked = std::make_shared<BatchTransformDataset>(rows, std::make_shared<StackTransform>());
+
+        // the tensors are made once from an example, then refilled in place
+        Example batch;
+        if (!stacked->getBatchInto({0, 1, 2, 3}, batch) || !_checkRows(batch, {0, 1, 2, 3})) {
+            MNN_ERROR("BatchIntoTest: first batch is wrong\n");
+            return 1;
+        }
+        auto address = batch.first[0]->readMap<float>();
+        if (!stacked->getBatchInto({4, 5, 6, 7}, batch) || !_checkRows(batch, {4, 5, 6, 7}) ||
+            batch.first[0]->readMap<float>() != address || rows->mGets != 1) {
+            MNN_ERROR("BatchIntoTest: batch isn't refilled in place\n");
+            return 1;
+        }
+        // a shorter batch reallocates
+        if (!stacked->getBatchInto({8, 9}, batch) || !_checkRows(batch, {8, 9})) {
+            MNN_ERROR("BatchIntoTest: short batch is wrong\n");
+            return 1;
+        }
+        // every tensor must hold the rows, not only the first one
+        batch.second[0] = _Input({3, 1}, NCHW, halide_type_of<int32_t>());
+        if (!stacked->getBatchInto({10, 11}, batch) || !_checkRows(batch, {10, 11})) {
+            MNN_ERROR("BatchIntoTest: target of another batch size is reused\n");
+            return 1;
+        }
+        // an example that doesn't fit the rows is rejected, not written past them
+        if (stacked->getBatchInto({12, 13}, batch)) {
+            MNN_ERROR("BatchIntoTest: example of other shape is filled\n");
+            return 1;
+        }
+        // without fill no example is made to learn the shapes
+        {
+            auto getOnly = std::make_shared<GetOnlyDataset>(8);
+            Example unused;
+            if (BatchTransformDataset(getOnly, std::make_shared<StackTransform>()).getBatchInto({0, 1}, unused) ||
+                getOnly->mGets != 0) {
+                MNN_ERROR("BatchIntoTest: batch is made for a dataset without fill\n");
+                return 1;
+            }
+        }
+
+        // the loader fills its slots in place: numJobs batches queued and one held by the trainer. the slots
+        // left free at the end of an epoch are released, so they are counted per epoch
+        auto loaderRows = std::make_shared<RowDataset>(64);
+        auto config     = std::make_shared<DataLoaderConfig>(4, 2);
+        auto sampler    = std::make_shared<RandomSampler>(loaderRows->size(), false);
+        DataLoader loader(std::make_shared<BatchTransformDataset>(loaderRows, std::make_shared<StackTransform>()),
+                          sampler, config);
+        // sums read the slots as they were first given, they must see the slots refilled
+        std::map<const float*, VARP> sums;
+        for (int epoch = 0; epoch < 3; ++epoch) {
+            std::set<const float*> slots;
+            std::set<size_t> jobs;
+            loaderRows->mGets = 0;
+            for (size_t i = 0; i < loader.iterNumber(); ++i) {
+                auto current = loader.next();
+                auto indices = _jobRows(current[0]);
+                if (indices[0] % 4 != 0 || !jobs.insert(indices[0]).second || !_checkRows(current[0], indices)) {
+                    MNN_ERROR("BatchIntoTest: loader batch %d is wrong\n", (int)i);
+                    return 1;
+                }
+                // the workers go on filling while the trainer holds the batch
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                if (!_checkRows(current[0], indices)) {
+                    MNN_ERROR("BatchIntoTest: held batch %d is overwritten\n", (int)i);
+                    return 1;
+                }
+                auto slot = current[0].first[0]->readMap<float>();
+                slots.insert(slot);
+                if (sums.find(slot) == sums.end()) {
+                    sums[slot] = _ReduceSum(current[0].first[0], {});
+                }
+                if (sums[slot]->readMap<float>()[0] != 6.0f * (4 * indices[0] + 6)) {
+                    MNN_ERROR("BatchIntoTest: what read the slot of batch %d isn't recomputed\n", (int)i);
+                    return 1;
+                }
+            }
+            if (slots.size() > config->numJobs + 1 || loaderRows->mGets > config->numJobs + 1) {
+                MNN_ERROR("BatchIntoTest: %d batches allocated for %d slots\n", (int)loaderRows->mGets,
+                          (int)config->numJobs + 1);
+                return 1;
+            }
+            loader.reset();
+        }
+        MNN_PRINT("BatchIntoTest passed\n");
+        return 0;
+    }
+};
+
+DemoUnitSetRegister(BatchIntoTest, "BatchIntoTest");
+
+class ShardDatasetTest : public DemoUnit {
+public:
+    virtual int run(int argc, const char* argv[]) override {
+        std::string prefix = argc > 1 ? argv[1] : "shard_test";
+        if (nullptr != ShardDataset::create(prefix).mDataset) {
+            MNN_ERROR("ShardDatasetTest: opened shards that don't exist\n");
+            return 1;
+        }
+
+        // an example of another shape would be read with the record size of the first
+        DatasetPtr mixed;
+        mixed.mDataset = std::make_shared<RowDataset>(10, 6);
+        if (ShardDataset::write(mixed, prefix, 4) != -1 || nullptr != ShardDataset::create(prefix).mDataset) {
+            MNN_ERROR("ShardDatasetTest: examples of different shapes are written\n");
+            return 1;
+        }
+
+        DatasetPtr rows;
+        rows.mDataset = std::make_shared<RowDataset>(10);
+        if (ShardDataset::write(rows, prefix, 0) != -1 || nullptr != ShardDataset::create(prefix).mDataset) {
+            MNN_ERROR("ShardDatasetTest: shards of no example are written\n");
+            return 1;
+        }
+        if (ShardDataset::write(rows, prefix, 4) != 3) {
+            MNN_ERROR("ShardDatasetTest: write failed\n");
+            return 1;
+        }
+        // the stream draws at random, so every example read must be whole and all of them show up
+        std::set<int> seen;
+        {
+            auto shards = ShardDataset::create(prefix, 6 * 28);
+            if (nullptr == shards.mDataset || shards.mDataset->size() != 10) {
+                MNN_ERROR("ShardDatasetTest: can't open the shards written\n");
+                return 1;
+            }
+            for (int i = 0; i < 200; ++i) {
+                auto example = shards.mDataset->getBatch({0})[0];
+                auto index   = example.second[0]->readMap<int32_t>()[0];
+                if (!_checkRows({{_Unsqueeze(example.first[0], {0})}, {_Unsqueeze(example.second[0], {0})}},
+                                {(size_t)index})) {
+                    MNN_ERROR("ShardDatasetTest: example %d is read wrong\n", index);
+                    return 1;
+                }
+                seen.insert(index);
+            }
+        }
+        if (seen.size() != 10) {
+            MNN_ERROR("ShardDatasetTest: %d of 10 examples read\n", (int)seen.size());
+            return 1;
+        }
+
+        // shards gone after opening end the stream with an error, no reader waits for them
+        auto shards = ShardDataset::create(prefix, 6 * 28);
+        for (int i = 0; i < 3; ++i) {
+            remove((prefix + "." + std::to_string(i) + ".shard").c_str());
+        }
+        bool failed = false;
+        for (int i = 0; i <= 10 && !failed; ++i) {
+            failed = shards.mDataset->getBatch({0})[0].first.empty();
+        }
+        if (!failed) {
+            MNN_ERROR("ShardDatasetTest: read more examples than the shards hold\n");
+            return 1;
+        }
+        MNN_PRINT("ShardDatasetTest passed\n");
+        return 0;
+    }
+};
+
+DemoUnitSetRegister(ShardDatasetTest, "ShardDatasetTest");
+
+class MemoryBudgetTest : public DemoUnit {
+public:
+    virtual int run(int argc, const char* argv[]) override {
+        auto budget = std::make_shared<MemoryBudget>(16);
+        budget->setPlanBytes(budget->limitBytes() - 1000);
+        budget->setLoaderBytes(300, 200);
+        if (budget->loaderAvailableBytes() != 1000 || budget->planAvailableMB() != 15) {
+            MNN_ERROR("MemoryBudgetTest: budget split is wrong\n");
+            return 1;
+        }
+
+        // 4 rows of 2x3 floats and an int label
+        const size_t batchBytes = 4 * (6 * sizeof(float) + sizeof(int32_t));
+        auto rows    = std::make_shared<RowDataset>(4096);
+        auto config  = std::make_shared<DataLoaderConfig>(4, 4);
+        auto sampler = std::make_shared<RandomSampler>(rows->size(), false);
+        DataLoader loader(std::make_shared<BatchTransformDataset>(rows, std::make_shared<StackTransform>()), sampler,
+                          config);
+        loader.setMemoryBudget(budget);
+        size_t index = 0;
+        std::set<size_t> jobs;
+        // the loader follows the budget within a few batches, the ones already prefetched are kept
+        auto check = [&](size_t planBytes, size_t maxBatches, const char* name) {
+            budget->setPlanBytes(planBytes);
+            for (int i = 0; i < config->numJobs + 2; ++i, ++index) {
+                auto batch = loader.next();
+                auto indices = _jobRows(batch[0]);
+                if (indices[0] % 4 != 0 || !jobs.insert(indices[0]).second || !_checkRows(batch[0], indices)) {
+                    MNN_ERROR("MemoryBudgetTest: batch %d is wrong\n", (int)index);
+                    return false;
+                }
+            }
+            if (loader.residentBytes() > maxBatches * batchBytes || budget->loaderBytes() != loader.residentBytes()) {
+                MNN_ERROR("MemoryBudgetTest: %s: loader holds %d bytes, %d allowed\n", name,
+                          (int)loader.residentBytes(), (int)(maxBatches * batchBytes));
+                return false;
+            }
+            return true;
+        };
+        // room for three batches: two prefetched and the trainer's
+        if (!check(budget->limitBytes() - 3 * batchBytes, 3, "three batches")) {
+            return 1;
+        }
+        // no room: the loader keeps its minimum, one batch in flight and the trainer's
+        if (!check(budget->limitBytes(), 2, "no room")) {
+            return 1;
+        }
+        if (budget->planAvailableMB() != (budget->limitBytes() - 2 * batchBytes) >> 20) {
+            MNN_ERROR("MemoryBudgetTest: loader minimum isn't reported\n");
+            return 1;
+        }
+        // a loader minimum taking the whole limit leaves the smallest plan, not an unknown 0
+        {
+            auto full = std::make_shared<MemoryBudget>(16);
+            full->setLoaderBytes(full->limitBytes(), full->limitBytes());
+            if (full->planAvailableMB() != 1) {
+                MNN_ERROR("MemoryBudgetTest: a full loader leaves %d MB to the plan\n", (int)full->planAvailableMB());
+                return 1;
+            }
+        }
+        // all the room: every job is prefetched
+        if (!check(0, config->numJobs + 1, "all room") || loader.residentBytes() != (config->numJobs + 1) * batchBytes) {
+            MNN_ERROR("MemoryBudgetTest: loader doesn't grow back\n");
+            return 1;
+        }
+        MNN_PRINT("MemoryBudgetTest passed\n");
+        return 0;
+    }
+};
+
+DemoUnitSetRegister(MemoryBudgetTest, "MemoryBudgetTest");
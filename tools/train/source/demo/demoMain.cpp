@@ -34,6 +34,5 @@ int main(int argc, const char* argv[]) {
         MNN_ERROR("Can't find demo %s\n", argv[1]);
         return 0;
     }
-    demo->run(argc - 1, argv + 1);
-    return 0;
+    return demo->run(argc - 1, argv + 1);
 }
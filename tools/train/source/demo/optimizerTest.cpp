@@ -0,0 +1,275 @@
+//
+//  optimizerTest.cpp
+//  MNN
+//
+//  Created by MNN on 2021/08/06.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <stdio.h>
+#include <math.h>
+#include <atomic>
+#include <MNN/expr/ExprCreator.hpp>
+#include <MNN/expr/NN.hpp>
+#include "DemoUnit.hpp"
+#include "MicroSGD.hpp"
+#include "SGD.hpp"
+using namespace MNN::Express;
+using namespace MNN::Train;
+
+static void _fill(const std::vector<VARP>& vars, float value) {
+    for (auto v : vars) {
+        auto ptr  = v->writeMap<float>();
+        auto size = v->getInfo()->size;
+        for (int i = 0; i < size; ++i) {
+            ptr[i] = value;
+        }
+    }
+}
+
+static bool _equal(VARP v, float value) {
+    auto ptr  = v->readMap<float>();
+    auto size = v->getInfo()->size;
+    for (int i = 0; i < size; ++i) {
+        if (fabsf(ptr[i] - value) > 1e-6f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// a small MLP with the same parameters every time it is made
+class TestNet : public Module {
+public:
+    TestNet() {
+        for (int i = 0; i < 3; ++i) {
+            mLayers.emplace_back(NN::Linear(64, 64));
+        }
+        registerModel(mLayers);
+        int k = 0;
+        for (auto p : parameters()) {
+            auto ptr = p->writeMap<float>();
+            for (int i = 0; i < p->getInfo()->size; ++i) {
+                ptr[i] = ((k++ * 7919) % 101 - 50) * 0.002f;
+            }
+        }
+    }
+    virtual std::vector<VARP> onForward(const std::vector<VARP>& inputs) override {
+        auto x = inputs[0];
+        for (auto& l : mLayers) {
+            x = _Relu(l->forward(x));
+        }
+        return {x};
+    }
+
+private:
+    std::vector<std::shared_ptr<Module>> mLayers;
+};
+
+static VARP _testData(int step, int start, int number) {
+    auto x   = _Input({number, 64}, NCHW);
+    auto ptr = x->writeMap<float>();
+    for (int i = 0; i < number * 64; ++i) {
+        ptr[i] = (((i + start * 64) * 13 + step) % 17) * 0.05f;
+    }
+    return x;
+}
+
+static VARP _testLoss(std::shared_ptr<Module> net, VARP x) {
+    auto diff = net->forward(x) - _Scalar<float>(1.0f);
+    return _ReduceMean(diff * diff, {});
+}
+
+template <typename T>
+static std::shared_ptr<T> _testSGD(T* sgd) {
+    std::shared_ptr<T> res(sgd);
+    res->setLearningRate(0.1f);
+    res->setMomentum(0.9f);
+    res->setWeightDecay(0.001f);
+    return res;
+}
+
+static bool _sameParameters(std::shared_ptr<Module> a, std::shared_ptr<Module> b) {
+    auto pa = a->parameters();
+    auto pb = b->parameters();
+    for (int i = 0; i < pa.size(); ++i) {
+        auto x = pa[i]->readMap<float>();
+        auto y = pb[i]->readMap<float>();
+        for (int j = 0; j < pa[i]->getInfo()->size; ++j) {
+            if (fabsf(x[j] - y[j]) > 1e-5f) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+class CompiledStepTest : public DemoUnit {
+public:
+    virtual int run(int argc, const char* argv[]) override {
+        std::shared_ptr<Module> eager(new TestNet);
+        std::shared_ptr<Module> compiled(new TestNet);
+        std::shared_ptr<Module> eagerOutputs(new TestNet);
+        auto eagerSGD    = _testSGD(new SGD(eager));
+        auto compiledSGD = _testSGD(new SGD(compiled));
+        // the update of compile, run once per step with its outputs copied out early
+        auto eagerOutputsSGD = _testSGD(new SGD(eagerOutputs));
+        eagerOutputsSGD->setEagerUpdate(true);
+        auto x           = _Input({16, 64}, NCHW);
+        if (!compiledSGD->compile({x}, [&]() { return _testLoss(compiled, x); })) {
+            MNN_ERROR("CompiledStepTest: compile failed\n");
+            return 1;
+        }
+        for (int step = 0; step < 4; ++step) {
+            auto loss         = _testLoss(eager, _testData(step, 0, 16));
+            auto eagerLoss    = loss->readMap<float>()[0];
+            eagerSGD->step(loss);
+            eagerOutputsSGD->step(_testLoss(eagerOutputs, _testData(step, 0, 16)));
+            auto compiledLoss = compiledSGD->stepCompiled({_testData(step, 0, 16)});
+            if (nullptr == compiledLoss || fabsf(compiledLoss->readMap<float>()[0] - eagerLoss) > 1e-5f) {
+                MNN_ERROR("CompiledStepTest: loss of step %d differs\n", step);
+                return 1;
+            }
+        }
+        if (!_sameParameters(eager, compiled) || !_sameParameters(eager, eagerOutputs) ||
+            compiledSGD->currentStep() != eagerSGD->currentStep()) {
+            MNN_ERROR("CompiledStepTest: parameters differ\n");
+            return 1;
+        }
+        MNN_PRINT("CompiledStepTest passed\n");
+        return 0;
+    }
+};
+
+class MicroBatchTest : public DemoUnit {
+public:
+    virtual int run(int argc, const char* argv[]) override {
+        // 4 compiled micro-batches of 16 make the same update as a compiled batch of 64
+        std::shared_ptr<Module> batchNet(new TestNet);
+        std::shared_ptr<Module> microNet(new TestNet);
+        auto batchSGD = _testSGD(new SGD(batchNet));
+        auto microSGD = _testSGD(new MicroSGD(microNet, 64, 16));
+        auto x      = _Input({64, 64}, NCHW);
+        auto xMicro = _Input({16, 64}, NCHW);
+        if (!batchSGD->compile({x}, [&]() { return _testLoss(batchNet, x); }) ||
+            !microSGD->compileMicroBatch({xMicro}, [&]() { return _testLoss(microNet, xMicro); })) {
+            MNN_ERROR("MicroBatchTest: compile failed\n");
+            return 1;
+        }
+        for (int step = 0; step < 3; ++step) {
+            auto batchLoss = batchSGD->stepCompiled({_testData(step, 0, 64)});
+            std::atomic<int> given(0);
+            auto microLoss = microSGD->stepBatch([&]() {
+                int index = given++;
+                return index < 4 ? std::vector<VARP>{_testData(step, index * 16, 16)} : std::vector<VARP>();
+            });
+            if (nullptr == batchLoss || nullptr == microLoss ||
+                fabsf(batchLoss->readMap<float>()[0] - microLoss->readMap<float>()[0]) > 1e-5f) {
+                MNN_ERROR("MicroBatchTest: loss of step %d differs\n", step);
+                return 1;
+            }
+        }
+        if (!_sameParameters(batchNet, microNet) || microSGD->currentStep() != batchSGD->currentStep()) {
+            MNN_ERROR("MicroBatchTest: parameters differ from the batch step\n");
+            return 1;
+        }
+
+        // a batch cut short after 2 micro-batches updates like a batch of 32, and the next one starts clean
+        std::shared_ptr<Module> eagerNet(new TestNet);
+        std::shared_ptr<Module> shortNet(new TestNet);
+        auto eagerSGD = _testSGD(new SGD(eagerNet));
+        auto shortSGD = _testSGD(new MicroSGD(shortNet, 64, 16));
+        auto xShort = _Input({16, 64}, NCHW);
+        if (!shortSGD->compileMicroBatch({xShort}, [&]() { return _testLoss(shortNet, xShort); })) {
+            MNN_ERROR("MicroBatchTest: compile failed\n");
+            return 1;
+        }
+        const int sizes[] = {32, 64};
+        for (int step = 0; step < 2; ++step) {
+            eagerSGD->step(_testLoss(eagerNet, _testData(step, 0, sizes[step])));
+            std::atomic<int> given(0);
+            auto loss = shortSGD->stepBatch([&]() {
+                int index = given++;
+                return index * 16 < sizes[step] ? std::vector<VARP>{_testData(step, index * 16, 16)}
+                                                 : std::vector<VARP>();
+            });
+            if (nullptr == loss) {
+                MNN_ERROR("MicroBatchTest: short batch %d failed\n", step);
+                return 1;
+            }
+        }
+        if (!_sameParameters(eagerNet, shortNet) || shortSGD->currentStep() != 2) {
+            MNN_ERROR("MicroBatchTest: parameters differ after a short batch\n");
+            return 1;
+        }
+        MNN_PRINT("MicroBatchTest passed\n");
+        return 0;
+    }
+};
+
+class CheckpointTest : public DemoUnit {
+public:
+    virtual int run(int argc, const char* argv[]) override {
+        std::string path = argc > 1 ? argv[1] : "checkpoint_test.mnn";
+        std::vector<VARP> params;
+        for (int i = 0; i < 4; ++i) {
+            params.emplace_back(_TrainableParam(0.0f, {1024, 1024}, NCHW));
+            params.back()->setName("w" + std::to_string(i));
+        }
+        std::shared_ptr<Module> module(Module::createEmpty(params));
+        std::shared_ptr<SGD> sgd(new SGD(module));
+
+        // the parameters change right after every checkpoint, while its write may still run
+        _fill(params, 1.0f);
+        sgd->setCurrentStep(1);
+        sgd->checkpoint(path);
+        _fill(params, 2.0f);
+        sgd->setCurrentStep(2);
+        sgd->checkpoint(path, 0.5f);
+        _fill({params[0]}, 3.0f);
+        sgd->setCurrentStep(3);
+        sgd->checkpoint(path, 0.5f);
+        _fill(params, 4.0f);
+        if (!sgd->waitCheckpoint()) {
+            MNN_ERROR("CheckpointTest: write failed\n");
+            return 1;
+        }
+
+        // the full checkpoint keeps what it took, not what was copied while it was written
+        auto full = Variable::loadMap(path.c_str());
+        for (int i = 0; i < params.size(); ++i) {
+            auto iter = full.find(params[i]->name());
+            if (iter == full.end() || !_equal(iter->second, 1.0f)) {
+                MNN_ERROR("CheckpointTest: full checkpoint of %s is wrong\n", params[i]->name().c_str());
+                return 1;
+            }
+        }
+
+        std::vector<VARP> loaded;
+        for (int i = 0; i < params.size(); ++i) {
+            loaded.emplace_back(_TrainableParam(0.0f, {1024, 1024}, NCHW));
+            loaded.back()->setName("w" + std::to_string(i));
+        }
+        std::shared_ptr<Module> loadedModule(Module::createEmpty(loaded));
+        std::shared_ptr<SGD> loadedSgd(new SGD(loadedModule));
+        if (!loadedSgd->loadCheckpoint(path) || loadedSgd->currentStep() != 3) {
+            MNN_ERROR("CheckpointTest: can't load %s\n", path.c_str());
+            return 1;
+        }
+        auto current = loadedModule->parameters();
+        for (int i = 0; i < current.size(); ++i) {
+            if (!_equal(current[i], 0 == i ? 3.0f : 2.0f)) {
+                MNN_ERROR("CheckpointTest: %s doesn't match the last checkpoint\n", params[i]->name().c_str());
+                return 1;
+            }
+        }
+        remove(path.c_str());
+        remove((path + ".delta").c_str());
+        MNN_PRINT("CheckpointTest passed\n");
+        return 0;
+    }
+};
+
+DemoUnitSetRegister(CheckpointTest, "CheckpointTest");
+DemoUnitSetRegister(CompiledStepTest, "CompiledStepTest");
+DemoUnitSetRegister(MicroBatchTest, "MicroBatchTest");
@@ -0,0 +1,170 @@
+//
+//  trainFusionTest.cpp
+//  MNN
+//
+//  Created by MNN on 2021/07/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <string.h>
+#include <map>
+#include <set>
+#include <MNN/expr/ExprCreator.hpp>
+#include "DemoUnit.hpp"
+#include "MNN_generated.h"
+#include "OpGrad.hpp"
+#include "TrainFusion.hpp"
+#include "Transformer.hpp"
+using namespace MNN;
+using namespace MNN::Express;
+using namespace MNN::Train;
+
+static const int gIc   = 3;
+static const int gOc   = 8;
+static const int gOc2  = 5;
+static const int gSize = 7;
+
+static std::vector<float> _values(int size, float offset, float amplitude) {
+    std::vector<float> res(size);
+    for (int i = 0; i < size; ++i) {
+        res[i] = offset + amplitude * sinf(0.37f * i + offset);
+    }
+    return res;
+}
+
+// conv (constant weight) -> Scale -> ReLU -> NCHW -> NC4HW4 -> 1x1 conv -> ReLU6, as loaded from an inference model.
+// Scale has no grad, so the reference for the grads does its affine with Multiply and Add
+static VARP _model(VARP x, bool scaleOp) {
+    auto y = _Convert(x, NC4HW4);
+    y      = _Conv(_values(gOc * gIc * 3 * 3, 0.0f, 0.5f), _values(gOc, 0.1f, 0.5f), y, {gIc, gOc}, {3, 3}, SAME);
+    y->setName("conv1");
+    if (scaleOp) {
+        y = _Scale(y, gOc, _values(gOc, 1.0f, 0.5f), _values(gOc, 0.2f, 1.0f));
+        y = _Relu(y);
+        y = _Convert(_Convert(y, NCHW), NC4HW4);
+    } else {
+        auto alpha = _Const(_values(gOc, 1.0f, 0.5f).data(), {1, gOc, 1, 1}, NCHW);
+        auto beta  = _Const(_values(gOc, 0.2f, 1.0f).data(), {1, gOc, 1, 1}, NCHW);
+        y          = _Relu(_Add(_Multiply(_Convert(y, NCHW), alpha), beta));
+        y          = _Convert(y, NC4HW4);
+    }
+    y = _Conv(_values(gOc2 * gOc, 0.3f, 0.5f), _values(gOc2, 0.5f, 2.0f), y, {gOc, gOc2}, {1, 1});
+    y->setName("conv2");
+    y = _Relu6(y);
+    return _Convert(y, NCHW);
+}
+
+static std::map<std::string, VARP> _trainables(VARP output) {
+    std::map<std::string, VARP> res;
+    for (auto expr : Variable::getExecuteOrder({output})) {
+        if (nullptr == expr->get() && VARP::TRAINABLE == expr->inputType()) {
+            res[expr->name()] = Variable::create(expr, 0);
+        }
+    }
+    return res;
+}
+
+static bool _close(const float* a, const float* b, int size, const std::vector<float>& scale, int partSize) {
+    for (int i = 0; i < size; ++i) {
+        float expect = b[i];
+        if (!scale.empty()) {
+            expect *= scale[i / partSize];
+        }
+        if (fabsf(a[i] - expect) > 1e-4f * (1.0f + fabsf(expect))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class TrainFusionTest : public DemoUnit {
+public:
+    virtual int run(int argc, const char* argv[]) override {
+        auto input = _Input({1, gIc, gSize, gSize}, NCHW);
+        auto data  = _values(gIc * gSize * gSize, 0.0f, 2.0f);
+        ::memcpy(input->writeMap<float>(), data.data(), data.size() * sizeof(float));
+        auto origin    = _model(input, true);
+        auto reference = _model(input, false);
+        auto fused     = _model(input, true);
+
+        Transformer::TrainConfig config;
+        // Keep the affine constants of the reference out of the trainable variables
+        config.variableLimits = {"conv"};
+        Transformer::turnModelToTrainable(config)->onExecute({origin});
+        Transformer::turnModelToTrainable(config)->onExecute({reference});
+        int folds = TrainFusion::foldBatchNorm({fused});
+        Transformer::turnModelToTrainable(config)->onExecute({fused});
+        int activations = TrainFusion::fuseActivation({fused});
+        int converts    = TrainFusion::eliminateConvert({fused});
+        if (folds != 1 || activations != 2 || converts < 1) {
+            MNN_ERROR("TrainFusionTest: fold %d, fuse %d, skip %d convert\n", folds, activations, converts);
+            return 1;
+        }
+        for (auto expr : Variable::getExecuteOrder({fused})) {
+            auto op = expr->get();
+            if (nullptr != op && (op->type() == OpType_Scale || op->type() == OpType_ReLU ||
+                                  op->type() == OpType_ReLU6)) {
+                MNN_ERROR("TrainFusionTest: op %s is left\n", EnumNameOpType(op->type()));
+                return 1;
+            }
+        }
+
+        auto size = origin->getInfo()->size;
+        if (!_close(fused->readMap<float>(), origin->readMap<float>(), size, {}, 1) ||
+            !_close(reference->readMap<float>(), origin->readMap<float>(), size, {}, 1)) {
+            MNN_ERROR("TrainFusionTest: output differs\n");
+            return 1;
+        }
+
+        auto referenceParameters = _trainables(reference);
+        auto fusedParameters     = _trainables(fused);
+        if (referenceParameters.size() != 4 || fusedParameters.size() != 4) {
+            MNN_ERROR("TrainFusionTest: %d and %d trainable variables\n", (int)referenceParameters.size(),
+                      (int)fusedParameters.size());
+            return 1;
+        }
+        // Any loss reaching every output
+        auto mask = _Const(_values(size, 0.0f, 1.0f).data(), {1, gOc2, gSize, gSize}, NCHW);
+        std::set<VARP> referenceSet{input}, fusedSet{input};
+        for (auto& iter : referenceParameters) {
+            referenceSet.insert(iter.second);
+            fusedSet.insert(fusedParameters[iter.first]);
+        }
+        auto referenceGrad = OpGrad::grad(_ReduceSum(_Multiply(reference, mask), {}), referenceSet);
+        auto fusedGrad     = OpGrad::grad(_ReduceSum(_Multiply(fused, mask), {}), fusedSet);
+
+        // conv1's weight and bias were scaled by the Scale op, so their grads are scaled back
+        auto alpha = _values(gOc, 1.0f, 0.5f);
+        std::map<std::string, std::pair<std::vector<float>, int>> scales{
+            {"conv1_Weight", {alpha, gIc * 3 * 3}}, {"conv1_Bias", {alpha, 1}}};
+        for (auto& iter : referenceParameters) {
+            auto o = referenceGrad[iter.second];
+            auto f = fusedGrad[fusedParameters[iter.first]];
+            if (nullptr == o || nullptr == f) {
+                MNN_ERROR("TrainFusionTest: no grad for %s\n", iter.first.c_str());
+                return 1;
+            }
+            std::vector<float> scale;
+            int partSize = 1;
+            if (scales.find(iter.first) != scales.end()) {
+                scale    = scales[iter.first].first;
+                partSize = scales[iter.first].second;
+            }
+            if (!_close(o->readMap<float>(), f->readMap<float>(), o->getInfo()->size, scale, partSize)) {
+                MNN_ERROR("TrainFusionTest: grad of %s differs\n", iter.first.c_str());
+                return 1;
+            }
+        }
+        auto o = referenceGrad[input];
+        auto f = fusedGrad[input];
+        if (nullptr == o || nullptr == f ||
+            !_close(o->readMap<float>(), f->readMap<float>(), o->getInfo()->size, {}, 1)) {
+            MNN_ERROR("TrainFusionTest: grad of input differs\n");
+            return 1;
+        }
+        MNN_PRINT("TrainFusionTest passed\n");
+        return 0;
+    }
+};
+DemoUnitSetRegister(TrainFusionTest, "TrainFusionTest");
@@ -49,6 +49,7 @@ int main(int argc, const char* argv[]) {
     }
     auto configObject = document.GetObject();
     std::vector<std::string> variableLimits;
+    bool fuse = false;
     if (configObject.HasMember("Optimizor")) {
         auto optimizor = configObject["Optimizor"].GetObject();
         if (optimizor.HasMember("Variables")) {
@@ -58,6 +59,9 @@ int main(int argc, const char* argv[]) {
                 MNN_PRINT("Variabale contain : %s \n", vIter->GetString());
             }
         }
+        if (optimizor.HasMember("Fuse")) {
+            fuse = optimizor["Fuse"].GetBool();
+        }
     }
     const char* inputModeFileName = argv[1];
     FUNC_PRINT_ALL(inputModeFileName, s);
@@ -70,6 +74,7 @@ int main(int argc, const char* argv[]) {
     }
     Transformer::TrainConfig trainConfig;
     trainConfig.variableLimits = std::move(variableLimits);
+    trainConfig.fuse = fuse;
     Transformer::turnModelToTrainable(trainConfig)->onExecute(Variable::mapToSequence(outputVars));
     if (configObject.HasMember("Shape")) {
         auto shapeArray = configObject["Shape"].GetObject();
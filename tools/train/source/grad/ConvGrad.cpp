@@ -23,6 +23,18 @@ public:
         auto forwardName = expr->name();
         std::shared_ptr<OpT> forwardOp(expr->get()->UnPack());
         auto outputDiff = backwardOutput[0];
+        auto forwardCommon = forwardOp->main.AsConvolution2D()->common.get();
+        if (forwardCommon->relu || forwardCommon->relu6) {
+            // Fused activation (TrainFusion), the mask comes from the output so the pre-activation isn't needed
+            auto output = Variable::create(expr, 0);
+            auto mask   = _Sign(output);
+            if (forwardCommon->relu6) {
+                mask = mask * _Sign(_Scalar<float>(6.0f) - output);
+            }
+            outputDiff           = outputDiff * mask;
+            forwardCommon->relu  = false;
+            forwardCommon->relu6 = false;
+        }
         //FUNC_PRINT_ALL(_ReduceMax(outputDiff)->readMap<float>()[0], f);
         {
             // Create Input Grad
@@ -0,0 +1,30 @@
+//
+//  FakeQuantGrad.cpp
+//  MNN
+//
+//  Created by MNN on 2021/07/29.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "OpGrad.hpp"
+using namespace std;
+using namespace MNN;
+
+// The scale covers the largest magnitude, nothing is clipped and the gradient goes straight through
+class FakeQuantGrad : public OpGrad {
+public:
+    FakeQuantGrad() {
+        mType = LINEAR;
+    }
+    virtual std::vector<Express::VARP> onGrad(Express::EXPRP expr,
+                                              const std::vector<Express::VARP>& backwardOutput) override {
+        std::vector<Express::VARP> result(expr->inputs().size(), nullptr);
+        result[0] = backwardOutput[0];
+        return result;
+    }
+};
+static const auto gRegister = []() {
+    static FakeQuantGrad _c;
+    OpGrad::insert(OpType_FakeQuant, &_c);
+    return true;
+}();
@@ -8,6 +8,7 @@
 
 #include "ADAM.hpp"
 #include "OpGrad.hpp"
+#include <math.h>
 
 using namespace MNN::Express;
 
@@ -20,6 +21,23 @@ ADAM::ADAM(std::shared_ptr<Module> module) : SGD(module) {
     }
 }
 
+void ADAM::onGetState(std::vector<std::pair<std::string, Express::VARP>>& state) {
+    SGD::onGetState(state);
+    for (auto& iter : mHistory2) {
+        state.emplace_back("momentum2/" + parameterKey(iter.first), iter.second);
+    }
+}
+
+void ADAM::onSetState(const std::map<std::string, Express::VARP>& state) {
+    SGD::onSetState(state);
+    for (auto& iter : mHistory2) {
+        auto value = state.find("momentum2/" + parameterKey(iter.first));
+        if (value != state.end()) {
+            iter.second = value->second;
+        }
+    }
+}
+
 void ADAM::setMomentum2(float momentum2) {
     mMomentum2 = momentum2;
 }
@@ -59,5 +77,25 @@ Express::VARP ADAM::onComputeUpdateValue(Express::VARP param, Express::VARP grad
     return updateValue;
 }
 
+Express::VARP ADAM::onCompileUpdateValue(Express::VARP param, Express::VARP grad,
+                                         std::vector<std::pair<Express::VARP, Express::VARP>>& updates) {
+    auto beta1 = _Const(mMomentum, {}, NCHW);
+    auto beta2 = _Const(mMomentum2, {}, NCHW);
+    auto eps   = _Const(mEps, {}, NCHW);
+
+    auto m = beta1 * mHistory[param] + (_Const(1.0f, {}, NCHW) - beta1) * grad;
+    auto v = beta2 * mHistory2[param] + (_Const(1.0f, {}, NCHW) - beta2) * _Square(grad);
+    updates.emplace_back(mHistory[param], m);
+    updates.emplace_back(mHistory2[param], v);
+    // mLearningRateLeaf carries the bias correction of the current step
+    return mLearningRateLeaf * (m / (_Sqrt(v) + eps));
+}
+
+void ADAM::onCompiledStep() {
+    float step       = (float)currentStep();
+    float correction = sqrtf(1.0f - powf(mMomentum2, step)) / (1.0f - powf(mMomentum, step));
+    mLearningRateLeaf->writeMap<float>()[0] = mLearningRate * correction;
+}
+
 } // namespace Train
 } // namespace MNN
@@ -33,6 +33,13 @@ public:
 
     void setEps(float eps);
 
+protected:
+    virtual void onGetState(std::vector<std::pair<std::string, Express::VARP>>& state) override;
+    virtual void onSetState(const std::map<std::string, Express::VARP>& state) override;
+    virtual void onCompiledStep() override;
+    virtual Express::VARP onCompileUpdateValue(Express::VARP param, Express::VARP grad,
+                                               std::vector<std::pair<Express::VARP, Express::VARP>>& updates) override;
+
 private:
     float mMomentum2 = 0.999; // default 0.999
     float mEps       = 1e-8;
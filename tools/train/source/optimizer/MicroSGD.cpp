@@ -7,6 +7,9 @@
 //
 
 #include "MicroSGD.hpp"
+#include <string.h>
+#include <future>
+#include <MNN/expr/ExecutorScope.hpp>
 #include "OpGrad.hpp"
 using namespace MNN::Express;
 
@@ -67,5 +70,198 @@ bool MicroSGD::step(Express::VARP loss) {
     return true;
 }
 
+// read every result before writing any back: written through writeMap, every cache reading a state is marked dirty
+static bool _writeBack(const std::vector<std::pair<VARP, VARP>>& updates) {
+    std::vector<const void*> results(updates.size());
+    for (int i = 0; i < updates.size(); ++i) {
+        results[i] = updates[i].second->readMap<void>();
+        if (nullptr == results[i]) {
+            return false;
+        }
+    }
+    for (int i = 0; i < updates.size(); ++i) {
+        auto info = updates[i].first->getInfo();
+        auto dst  = updates[i].first->writeMap<void>();
+        ::memcpy(dst, results[i], info->size * info->type.bytes());
+    }
+    return true;
+}
+
+bool MicroSGD::compileMicroBatch(const std::vector<VARP>& inputs, const std::function<VARP()>& lossFunction) {
+    mMicroInputs.clear();
+    mMicroLoss = nullptr;
+    mMicroUpdates.clear();
+    mBatchUpdates.clear();
+    mGradSum.clear();
+    auto before = module()->parameters();
+    auto loss   = lossFunction();
+    if (nullptr == loss) {
+        return false;
+    }
+    auto after = module()->parameters();
+    auto grad  = OpGrad::grad(loss, trainable(), SGD::mGradBlockExprName);
+    if (nullptr == mLearningRateLeaf) {
+        mLearningRateLeaf = _Const(SGD::mLearningRate, {}, NCHW);
+    }
+    // the sums add up to the mean gradient of a batch
+    auto scale = _Scalar<float>(1.0f / (mBatchSize / mMicroBatchSize));
+    std::vector<std::pair<VARP, VARP>> micro, batch;
+    std::vector<VARP> sums;
+    for (auto& iter : grad) {
+        auto info = iter.first->getInfo();
+        auto sum  = _Const(0.0f, info->dim, info->order);
+        micro.emplace_back(sum, sum + iter.second * scale);
+        auto addWeightDecayGrad = regularizeParameters(iter.first, sum);
+        auto updateValue        = this->onCompileUpdateValue(iter.first, addWeightDecayGrad, batch);
+        batch.emplace_back(iter.first, iter.first - updateValue);
+        sums.emplace_back(sum);
+    }
+    // parameters the module replaced while building the loss are carried from one micro-step to the next
+    for (int i = 0; i < before.size() && i < after.size(); ++i) {
+        if (nullptr == before[i].get() || before[i].get() == after[i].get()) {
+            continue;
+        }
+        if (before[i]->expr().first->get() == nullptr && after[i]->expr().first->get() != nullptr) {
+            micro.emplace_back(before[i], after[i]);
+        }
+    }
+    std::vector<VARP> prepareCompute;
+    for (auto& iter : micro) {
+        if (iter.first->expr().first->get() != nullptr) {
+            MNN_ERROR("Compiled state must be a leaf\n");
+            return false;
+        }
+        prepareCompute.emplace_back(iter.second);
+    }
+    prepareCompute.emplace_back(loss);
+    // the plan of the executor is made for the micro-batch graph, the update has no use for it
+    ExecutorScope::Current()->setHeuristicAlloc(true);
+    Variable::prepareCompute(prepareCompute);
+    ExecutorScope::Current()->setHeuristicAlloc(false);
+    prepareCompute.clear();
+    for (auto& iter : batch) {
+        prepareCompute.emplace_back(iter.second);
+    }
+    Variable::prepareCompute(prepareCompute);
+    mMicroInputs  = inputs;
+    mMicroLoss    = loss;
+    mMicroUpdates = std::move(micro);
+    mBatchUpdates = std::move(batch);
+    mGradSum      = std::move(sums);
+    return true;
+}
+
+bool MicroSGD::feedMicroBatch(const std::vector<VARP>& feeds) {
+    if (nullptr == mMicroLoss) {
+        MNN_ERROR("stepMicroBatch called before compileMicroBatch\n");
+        return false;
+    }
+    if (feeds.size() != mMicroInputs.size()) {
+        MNN_ERROR("Compiled micro-batch needs %d inputs, %d fed\n", (int)mMicroInputs.size(), (int)feeds.size());
+        return false;
+    }
+    for (int i = 0; i < feeds.size(); ++i) {
+        auto srcInfo = feeds[i]->getInfo();
+        auto dstInfo = mMicroInputs[i]->getInfo();
+        if (nullptr == srcInfo || srcInfo->size != dstInfo->size || srcInfo->type != dstInfo->type) {
+            MNN_ERROR("Compiled micro-batch input %d doesn't match\n", i);
+            return false;
+        }
+        auto src = feeds[i]->readMap<void>();
+        auto dst = mMicroInputs[i]->writeMap<void>();
+        if (nullptr == src || nullptr == dst) {
+            return false;
+        }
+        ::memcpy(dst, src, srcInfo->size * srcInfo->type.bytes());
+    }
+    return true;
+}
+
+VARP MicroSGD::runMicroBatch() {
+    auto lossInfo = mMicroLoss->getInfo();
+    auto lossPtr  = mMicroLoss->readMap<void>();
+    if (nullptr == lossPtr) {
+        MNN_ERROR("Compute error in compiled micro-batch\n");
+        return nullptr;
+    }
+    auto loss = _Const(lossPtr, lossInfo->dim, lossInfo->order, lossInfo->type);
+    if (!_writeBack(mMicroUpdates)) {
+        MNN_ERROR("Compute error in compiled micro-batch\n");
+        return nullptr;
+    }
+    mMicroStep++;
+    if (mMicroStep % (mBatchSize / mMicroBatchSize) != 0) {
+        return loss;
+    }
+    if (!updateBatch()) {
+        return nullptr;
+    }
+    return loss;
+}
+
+bool MicroSGD::updateBatch() {
+    // end of the batch
+    setCurrentStep(currentStep() + 1);
+    this->onCompiledStep();
+    if (!_writeBack(mBatchUpdates)) {
+        MNN_ERROR("Compute error in compiled update\n");
+        return false;
+    }
+    for (auto& sum : mGradSum) {
+        auto info = sum->getInfo();
+        ::memset(sum->writeMap<void>(), 0, info->size * info->type.bytes());
+    }
+    return true;
+}
+
+VARP MicroSGD::stepMicroBatch(const std::vector<VARP>& feeds) {
+    if (!feedMicroBatch(feeds)) {
+        return nullptr;
+    }
+    return runMicroBatch();
+}
+
+VARP MicroSGD::stepBatch(const std::function<std::vector<VARP>()>& next) {
+    auto number = mBatchSize / mMicroBatchSize;
+    auto feeds  = next();
+    float total = 0.0f;
+    int count   = 0;
+    for (; count < number && !feeds.empty(); ++count) {
+        if (!feedMicroBatch(feeds)) {
+            return nullptr;
+        }
+        // the feeds are copied in, so the loader may reuse their memory for the next micro-batch
+        std::future<std::vector<VARP>> loading;
+        if (count + 1 < number) {
+            loading = std::async(std::launch::async, next);
+        }
+        auto loss = runMicroBatch();
+        feeds     = loading.valid() ? loading.get() : std::vector<VARP>();
+        if (nullptr == loss) {
+            return nullptr;
+        }
+        total += loss->readMap<float>()[0];
+    }
+    if (0 == count) {
+        return nullptr;
+    }
+    auto pending = mMicroStep % number;
+    if (0 != pending) {
+        // next ran out inside the batch, update with the mean gradient of the micro-batches it gave
+        for (auto& sum : mGradSum) {
+            auto info = sum->getInfo();
+            auto ptr  = sum->writeMap<float>();
+            for (int i = 0; i < info->size; ++i) {
+                ptr[i] *= (float)number / pending;
+            }
+        }
+        mMicroStep += number - pending;
+        if (!updateBatch()) {
+            return nullptr;
+        }
+    }
+    return _Scalar<float>(total / count);
+}
+
 } // namespace Train
 } // namespace MNN
@@ -10,6 +10,7 @@
 #define MicroSGD_hpp
 
 #include <MNN/expr/ExprCreator.hpp>
+#include <functional>
 #include <string>
 #include <vector>
 #include "SGD.hpp"
@@ -26,6 +27,32 @@ public:
     virtual ~ MicroSGD() = default;
     bool step(Express::VARP loss);
 
+    /**
+     * @brief build one micro-batch, its backward pass and the accumulation of its gradients into persistent
+     * buffers into a single compute cache, and the averaged update of a batch into a second, small one. Every
+     * micro-step then reruns the same commands with the same memory plan, the one made for the micro-batch size,
+     * instead of building a gradient graph per micro-step like step does. loadCheckpoint replaces the parameter
+     * variables, so call it before, the compiled graph keeps reading the ones it was built from.
+     * @param inputs placeholders of one micro-batch made by _Input, the micro-steps feed them in the same order.
+     * @param lossFunction builds the loss from inputs, called once.
+     * @return false if the graphs can't be prepared.
+     */
+    bool compileMicroBatch(const std::vector<Express::VARP>& inputs, const std::function<Express::VARP()>& lossFunction);
+    /**
+     * @brief run one compiled micro-batch, the parameters are updated after every batchSize / microBatchSize of them.
+     * @param feeds values for the compiled inputs, same order, size and type.
+     * @return loss of this micro-batch, nullptr on error.
+     */
+    Express::VARP stepMicroBatch(const std::vector<Express::VARP>& feeds);
+    /**
+     * @brief run the compiled micro-batches of one batch, loading the next micro-batch while the current one computes.
+     * @param next gives the feeds of the next micro-batch, empty when there is none. It is called from another
+     * thread, as DataLoader workers are. If it runs out inside the batch, the parameters are updated with the mean
+     * gradient of the micro-batches it gave, so the next call starts a new batch.
+     * @return mean loss of the micro-batches run, nullptr on error or if next gave nothing.
+     */
+    Express::VARP stepBatch(const std::function<std::vector<Express::VARP>()>& next);
+
 protected:
     float mLearningRate                        = 0.001f;
     float mMomentum                            = 0;
@@ -41,6 +68,18 @@ protected:
     int mMicroStep = 0;
     int mBatchSize = 1;
     int mMicroBatchSize = 1;
+
+private:
+    bool feedMicroBatch(const std::vector<Express::VARP>& feeds);
+    Express::VARP runMicroBatch();
+    bool updateBatch();
+
+    // compiled micro-step: the micro-batch cache adds its gradients to mGradSum, the batch cache reads them
+    std::vector<Express::VARP> mMicroInputs;
+    Express::VARP mMicroLoss;
+    std::vector<std::pair<Express::VARP, Express::VARP>> mMicroUpdates;
+    std::vector<std::pair<Express::VARP, Express::VARP>> mBatchUpdates;
+    std::vector<Express::VARP> mGradSum;
 };
 
 } // namespace Train
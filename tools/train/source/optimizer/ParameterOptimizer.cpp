@@ -7,11 +7,33 @@
 //
 
 #include "ParameterOptimizer.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+#include <MNN/expr/ExprCreator.hpp>
+#include <MNN/expr/ExecutorScope.hpp>
+#include "MNN_generated.h"
 #include "SGD.hpp"
 #include "ADAM.hpp"
 using namespace MNN::Express;
 namespace MNN {
 namespace Train {
+static const char* gStepKey = "__checkpoint_step";
+static const char* gBaseKey = "__checkpoint_base";
+
+struct ParameterOptimizer::CheckpointTensor {
+    std::string key;
+    bool trainable = false;
+    INTS dim;
+    Dimensionformat order;
+    halide_type_t type;
+    std::vector<uint8_t> data;
+};
+
 ParameterOptimizer::ParameterOptimizer(std::shared_ptr<Module> module) {
     auto parameters = module->parameters();
     for (auto p : parameters) {
@@ -22,12 +44,27 @@ ParameterOptimizer::ParameterOptimizer(std::shared_ptr<Module> module) {
             continue;
         }
         if (p->expr().first->inputType() == Express::VARP::TRAINABLE) {
-            mTrainable.insert(p);
+            if (mTrainable.insert(p).second) {
+                mOrdered.emplace_back(p);
+            }
         }
     }
+    std::set<std::string> used;
+    for (int i = 0; i < mOrdered.size(); ++i) {
+        auto key = mOrdered[i]->name();
+        if (key.empty() || used.find(key) != used.end()) {
+            key = key + "#" + std::to_string(i);
+        }
+        used.insert(key);
+        mKeys[mOrdered[i]] = key;
+    }
     mModule = module;
 }
 
+ParameterOptimizer::~ParameterOptimizer() {
+    waitCheckpoint();
+}
+
 ParameterOptimizer* ParameterOptimizer::createSGD(std::shared_ptr<Module> module, float lr, float momentum, float weightDecay, RegularizationMethod method) {
     auto sgd = new SGD(module);
     sgd->setLearningRate(lr);
@@ -60,6 +97,315 @@ bool ParameterOptimizer::step(Express::VARP loss) {
     return !res.empty();
 }
 
+bool ParameterOptimizer::compile(const std::vector<VARP>& inputs, const std::function<VARP()>& lossFunction) {
+    mCompiledInputs.clear();
+    mCompiledLoss = nullptr;
+    mCompiledUpdates.clear();
+    auto before = mModule->parameters();
+    auto loss   = lossFunction();
+    if (nullptr == loss) {
+        return false;
+    }
+    auto after = mModule->parameters();
+    std::vector<std::pair<VARP, VARP>> updates;
+    if (!this->onCompile(loss, updates)) {
+        MNN_ERROR("This optimizer can't compile its update\n");
+        return false;
+    }
+    for (int i = 0; i < before.size() && i < after.size(); ++i) {
+        if (nullptr == before[i].get() || before[i].get() == after[i].get()) {
+            continue;
+        }
+        if (before[i]->expr().first->get() == nullptr && after[i]->expr().first->get() != nullptr) {
+            updates.emplace_back(before[i], after[i]);
+        }
+    }
+    std::vector<VARP> prepareCompute;
+    for (auto& iter : updates) {
+        if (iter.first->expr().first->get() != nullptr) {
+            MNN_ERROR("Compiled state must be a leaf\n");
+            return false;
+        }
+        prepareCompute.emplace_back(iter.second);
+    }
+    prepareCompute.emplace_back(loss);
+    ExecutorScope::Current()->setHeuristicAlloc(true);
+    Variable::prepareCompute(prepareCompute);
+    ExecutorScope::Current()->setHeuristicAlloc(false);
+    mCompiledInputs  = inputs;
+    mCompiledLoss    = loss;
+    mCompiledUpdates = std::move(updates);
+    return true;
+}
+
+VARP ParameterOptimizer::stepCompiled(const std::vector<VARP>& feeds) {
+    if (nullptr == mCompiledLoss) {
+        MNN_ERROR("stepCompiled called before compile\n");
+        return nullptr;
+    }
+    if (feeds.size() != mCompiledInputs.size()) {
+        MNN_ERROR("Compiled step needs %d inputs, %d fed\n", (int)mCompiledInputs.size(), (int)feeds.size());
+        return nullptr;
+    }
+    mStep++;
+    this->onCompiledStep();
+    for (int i = 0; i < feeds.size(); ++i) {
+        auto srcInfo = feeds[i]->getInfo();
+        auto dstInfo = mCompiledInputs[i]->getInfo();
+        if (nullptr == srcInfo || srcInfo->size != dstInfo->size || srcInfo->type != dstInfo->type) {
+            MNN_ERROR("Compiled step input %d doesn't match\n", i);
+            return nullptr;
+        }
+        auto src = feeds[i]->readMap<void>();
+        auto dst = mCompiledInputs[i]->writeMap<void>();
+        if (nullptr == src || nullptr == dst) {
+            return nullptr;
+        }
+        ::memcpy(dst, src, srcInfo->size * srcInfo->type.bytes());
+    }
+    // read every result before writing any back, a write marks the step dirty again
+    auto lossInfo = mCompiledLoss->getInfo();
+    auto lossPtr  = mCompiledLoss->readMap<void>();
+    if (nullptr == lossPtr) {
+        MNN_ERROR("Compute error in compiled step\n");
+        return nullptr;
+    }
+    auto loss = _Const(lossPtr, lossInfo->dim, lossInfo->order, lossInfo->type);
+    std::vector<const void*> results(mCompiledUpdates.size());
+    for (int i = 0; i < mCompiledUpdates.size(); ++i) {
+        results[i] = mCompiledUpdates[i].second->readMap<void>();
+        if (nullptr == results[i]) {
+            MNN_ERROR("Compute error in compiled step\n");
+            return nullptr;
+        }
+    }
+    // write through writeMap so every cache reading the parameter is marked dirty, not only the one the feeds reach
+    for (int i = 0; i < mCompiledUpdates.size(); ++i) {
+        auto info = mCompiledUpdates[i].first->getInfo();
+        auto dst  = mCompiledUpdates[i].first->writeMap<void>();
+        ::memcpy(dst, results[i], info->size * info->type.bytes());
+    }
+    return loss;
+}
+
+static bool _writeFile(const std::string& path, const flatbuffers::FlatBufferBuilder& builder) {
+    auto temp = path + ".tmp";
+    FILE* f   = fopen(temp.c_str(), "wb");
+    if (nullptr == f) {
+        MNN_ERROR("Open %s error\n", temp.c_str());
+        return false;
+    }
+    auto size = fwrite(builder.GetBufferPointer(), 1, builder.GetSize(), f);
+    fflush(f);
+#if !defined(_WIN32)
+    fsync(fileno(f));
+#endif
+    fclose(f);
+    if (size != builder.GetSize()) {
+        MNN_ERROR("Write %s error\n", temp.c_str());
+        return false;
+    }
+    // a crash before this point leaves the previous checkpoint untouched
+    if (0 != rename(temp.c_str(), path.c_str())) {
+        MNN_ERROR("Rename %s to %s error\n", temp.c_str(), path.c_str());
+        return false;
+    }
+    return true;
+}
+
+static void _addBlob(NetT* net, const std::string& name, bool trainable, const INTS& dim, Dimensionformat order,
+                     halide_type_t type, const void* ptr, size_t bytes) {
+    std::unique_ptr<OpT> op(new OpT);
+    auto blob        = new BlobT;
+    blob->dims       = dim;
+    blob->dataFormat = NCHW == order ? MNN_DATA_FORMAT_NCHW : (NC4HW4 == order ? MNN_DATA_FORMAT_NC4HW4 : MNN_DATA_FORMAT_NHWC);
+    if (type.code == halide_type_float) {
+        blob->dataType = DataType_DT_FLOAT;
+        blob->float32s.resize(bytes / sizeof(float));
+        ::memcpy(blob->float32s.data(), ptr, bytes);
+    } else if (type.code == halide_type_int && type.bits == 32) {
+        blob->dataType = DataType_DT_INT32;
+        blob->int32s.resize(bytes / sizeof(int32_t));
+        ::memcpy(blob->int32s.data(), ptr, bytes);
+    } else if (type.code == halide_type_int && type.bits == 8) {
+        blob->dataType = DataType_DT_INT8;
+        blob->int8s.resize(bytes);
+        ::memcpy(blob->int8s.data(), ptr, bytes);
+    } else {
+        blob->dataType = DataType_DT_UINT8;
+        blob->uint8s.resize(bytes);
+        ::memcpy(blob->uint8s.data(), ptr, bytes);
+    }
+    op->type       = trainable ? OpType_TrainableParam : OpType_Const;
+    op->main.type  = OpParameter_Blob;
+    op->main.value = blob;
+    op->name       = name;
+    op->outputIndexes.push_back((int)net->tensorName.size());
+    net->tensorName.push_back(name);
+    net->oplists.emplace_back(std::move(op));
+}
+
+bool ParameterOptimizer::waitCheckpoint() {
+    for (auto& writer : mWriter) {
+        if (writer.joinable()) {
+            writer.join();
+        }
+    }
+    return mWriteSuccess;
+}
+
+bool ParameterOptimizer::checkpoint(const std::string& path, float threshold) {
+    // the slot is free once the write taken two checkpoints ago is done, the last one may still run
+    auto& writer = mWriter[mWriteSlot];
+    if (writer.joinable()) {
+        writer.join();
+    }
+    mWriteSlot       = 1 - mWriteSlot;
+    bool lastSuccess = mWriteSuccess;
+    bool full        = threshold <= 0.0f || mBaseStep < 0 || mBasePath != path;
+    if (full) {
+        mDirty.clear();
+    }
+
+    std::vector<std::pair<std::string, VARP>> state;
+    for (auto p : mOrdered) {
+        state.emplace_back(mKeys[p], p);
+    }
+    onGetState(state);
+    for (int i = 0; i < state.size(); ++i) {
+        auto& key  = state[i].first;
+        auto var   = state[i].second;
+        auto info  = var->getInfo();
+        auto ptr   = var->readMap<uint8_t>();
+        if (nullptr == info || nullptr == ptr) {
+            MNN_ERROR("Can't read %s for checkpoint\n", key.c_str());
+            continue;
+        }
+        size_t bytes = info->size * info->type.bytes();
+        auto iter    = mSnapshotIndex.find(key);
+        std::shared_ptr<CheckpointTensor> tensor;
+        if (iter == mSnapshotIndex.end()) {
+            tensor.reset(new CheckpointTensor);
+            tensor->key = key;
+            mSnapshotIndex[key] = tensor;
+            mSnapshot.emplace_back(tensor);
+        } else {
+            tensor = iter->second;
+            if (!full && tensor->data.size() == bytes) {
+                bool changed = false;
+                if (info->type.code == halide_type_float) {
+                    auto src = (const float*)ptr;
+                    auto dst = (const float*)tensor->data.data();
+                    for (int j = 0; j < info->size && !changed; ++j) {
+                        changed = fabsf(src[j] - dst[j]) > threshold;
+                    }
+                } else {
+                    changed = 0 != ::memcmp(ptr, tensor->data.data(), bytes);
+                }
+                if (!changed) {
+                    continue;
+                }
+            }
+            // held by mSnapshot, mSnapshotIndex and here unless the pending write still reads it
+            if (tensor.use_count() > 3) {
+                auto copy = std::make_shared<CheckpointTensor>();
+                copy->key = key;
+                std::replace(mSnapshot.begin(), mSnapshot.end(), tensor, copy);
+                mSnapshotIndex[key] = copy;
+                tensor              = copy;
+            }
+        }
+        tensor->trainable = i < mOrdered.size();
+        tensor->dim       = info->dim;
+        tensor->order     = info->order;
+        tensor->type      = info->type;
+        tensor->data.resize(bytes);
+        ::memcpy(tensor->data.data(), ptr, bytes);
+        mDirty.insert(key);
+    }
+
+    std::vector<std::shared_ptr<CheckpointTensor>> tensors;
+    for (auto& t : mSnapshot) {
+        if (full || mDirty.find(t->key) != mDirty.end()) {
+            tensors.emplace_back(t);
+        }
+    }
+    if (full) {
+        mDirty.clear();
+        mBasePath = path;
+        mBaseStep = mStep;
+    }
+    int step     = mStep;
+    int baseStep = full ? -1 : mBaseStep;
+    auto target   = full ? path : path + ".delta";
+    auto previous = mLastWrite;
+    auto done     = std::make_shared<std::promise<void>>();
+    mLastWrite    = done->get_future().share();
+    writer        = std::thread([this, tensors, step, baseStep, target, full, previous, done]() {
+        std::unique_ptr<NetT> net(new NetT);
+        for (auto& t : tensors) {
+            _addBlob(net.get(), t->key, t->trainable, t->dim, t->order, t->type, t->data.data(), t->data.size());
+        }
+        _addBlob(net.get(), gStepKey, false, {}, NCHW, halide_type_of<int32_t>(), &step, sizeof(int32_t));
+        if (baseStep >= 0) {
+            _addBlob(net.get(), gBaseKey, false, {}, NCHW, halide_type_of<int32_t>(), &baseStep, sizeof(int32_t));
+        }
+        flatbuffers::FlatBufferBuilder builder(1024);
+        builder.Finish(Net::Pack(builder, net.get()));
+        // a delta must not land before the full checkpoint it is based on
+        if (previous.valid()) {
+            previous.wait();
+        }
+        bool success = _writeFile(target, builder);
+        if (success && full) {
+            // a delta of an older base is ignored by loadCheckpoint anyway, drop it to save space
+            remove((target + ".delta").c_str());
+        }
+        mWriteSuccess = success;
+        done->set_value();
+    });
+    return lastSuccess;
+}
+
+bool ParameterOptimizer::loadCheckpoint(const std::string& path) {
+    waitCheckpoint();
+    auto varMap   = Variable::loadMap(path.c_str());
+    auto stepIter = varMap.find(gStepKey);
+    if (stepIter == varMap.end()) {
+        MNN_ERROR("%s is not a checkpoint\n", path.c_str());
+        return false;
+    }
+    int step = stepIter->second->readMap<int32_t>()[0];
+    std::map<std::string, VARP> delta;
+    auto deltaFile = fopen((path + ".delta").c_str(), "rb");
+    if (nullptr != deltaFile) {
+        fclose(deltaFile);
+        delta = Variable::loadMap((path + ".delta").c_str());
+    }
+    auto baseIter = delta.find(gBaseKey);
+    if (baseIter != delta.end() && baseIter->second->readMap<int32_t>()[0] == step) {
+        for (auto& iter : delta) {
+            varMap[iter.first] = iter.second;
+        }
+    }
+    for (auto p : mOrdered) {
+        auto iter = varMap.find(mKeys[p]);
+        if (iter == varMap.end()) {
+            MNN_ERROR("Can't find %s in checkpoint %s\n", mKeys[p].c_str(), path.c_str());
+            return false;
+        }
+        p->input(iter->second);
+    }
+    onSetState(varMap);
+    mStep = varMap[gStepKey]->readMap<int32_t>()[0];
+    // the next incremental checkpoint needs a full one of its own first
+    mBaseStep = -1;
+    mSnapshot.clear();
+    mSnapshotIndex.clear();
+    mDirty.clear();
+    return true;
+}
+
 int ParameterOptimizer::currentStep() {
     return mStep;
 }
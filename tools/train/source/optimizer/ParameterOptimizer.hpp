@@ -11,7 +11,14 @@
 #include <MNN/expr/Expr.hpp>
 #include <MNN/expr/Module.hpp>
 #include <MNN/expr/Executor.hpp>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <map>
 #include <set>
+#include <string>
+#include <thread>
+#include <vector>
 namespace MNN {
 namespace Train {
 class MNN_PUBLIC ParameterOptimizer {
@@ -23,7 +30,7 @@ public:
     };
 
     ParameterOptimizer(std::shared_ptr<Express::Module> module);
-    virtual ~ParameterOptimizer() = default;
+    virtual ~ParameterOptimizer();
 
     virtual bool step(Express::VARP loss);
     int currentStep();
@@ -34,6 +41,45 @@ public:
     virtual std::map<Express::VARP, Express::VARP> onGetNextParameter(Express::VARP loss) = 0;
     virtual void profile(Express::VARP loss) = 0;
 
+    /**
+     * @brief snapshot trainable parameters, optimizer state and step, then write them to path from a background
+     * thread. The snapshot is double buffered: the training thread copies while the previous write still runs,
+     * and only waits when the write before that one isn't done. Writes land in the order they were taken.
+     * The file loads with Variable::load, parameters come first in module order.
+     * @param threshold if > 0 and path already holds a full checkpoint of this optimizer, only tensors that moved
+     * more than threshold (max abs diff) since they were last written are copied, and every tensor changed since
+     * the full checkpoint goes to path + ".delta". Otherwise a full checkpoint is written.
+     * @return false if the last finished write failed.
+     */
+    bool checkpoint(const std::string& path, float threshold = 0.0f);
+    /**
+     * @brief wait for the pending checkpoint writes.
+     * @return false if the last one failed.
+     */
+    bool waitCheckpoint();
+    /**
+     * @brief restore parameters, optimizer state and step from path, and from path + ".delta" if it was written
+     * on top of that checkpoint.
+     */
+    bool loadCheckpoint(const std::string& path);
+
+    /**
+     * @brief build forward, backward and update once into a single compute cache. stepCompiled then only writes
+     * the inputs and reruns the same commands, executions and memory plan, instead of rebuilding the gradient
+     * graph, its shapes and its executions every iteration like step does. Call loadCheckpoint before compile.
+     * @param inputs placeholders made by _Input, stepCompiled feeds them in the same order.
+     * @param lossFunction builds the loss from inputs, called once. Parameters the module replaces while
+     * building it (e.g. BatchNorm running statistics) are carried from one step to the next.
+     * @return false if the optimizer can't express its update as a graph or the graph can't be prepared.
+     */
+    bool compile(const std::vector<Express::VARP>& inputs, const std::function<Express::VARP()>& lossFunction);
+    /**
+     * @brief run one compiled step.
+     * @param feeds values for the compiled inputs, same order, size and type.
+     * @return loss of this step, nullptr on error.
+     */
+    Express::VARP stepCompiled(const std::vector<Express::VARP>& feeds);
+
     static ParameterOptimizer* createSGD(std::shared_ptr<Express::Module> module, float lr, float momentum, float weightDecay, RegularizationMethod method);
     static ParameterOptimizer* createADAM(std::shared_ptr<Express::Module> module, float lr, float momentum, float momentum2, float weightDecay, float eps, RegularizationMethod method);
 protected:
@@ -43,11 +89,55 @@ protected:
     std::shared_ptr<Express::Module> module() const {
         return mModule;
     }
+    /** name of a trainable parameter inside checkpoints */
+    const std::string& parameterKey(Express::VARP p) const {
+        return mKeys.find(p)->second;
+    }
+    /** optimizer state to checkpoint besides the parameters */
+    virtual void onGetState(std::vector<std::pair<std::string, Express::VARP>>& state) {
+    }
+    /** restore the state, keys are the ones of onGetState, missing keys keep their value */
+    virtual void onSetState(const std::map<std::string, Express::VARP>& state) {
+    }
+    /**
+     * @brief build the update of every trainable parameter for compile. State the update reads must be a leaf
+     * that is never replaced, its next value is written back after every step.
+     * @param updates (leaf, next value) pairs, trainable parameters included.
+     * @return false if not supported.
+     */
+    virtual bool onCompile(Express::VARP loss, std::vector<std::pair<Express::VARP, Express::VARP>>& updates) {
+        return false;
+    }
+    /** called before every compiled step, after the step counter moved, to write per-step hyper parameters */
+    virtual void onCompiledStep() {
+    }
 private:
+    struct CheckpointTensor;
     int mStep = 0;
     bool mFlag = false;
     std::shared_ptr<Express::Module> mModule;
     std::set<Express::VARP> mTrainable;
+
+    // trainable parameters in module order with their checkpoint keys
+    std::vector<Express::VARP> mOrdered;
+    std::map<Express::VARP, std::string> mKeys;
+    // content as last taken, a tensor still held by a pending write is copied to a new buffer instead of overwritten
+    std::vector<std::shared_ptr<CheckpointTensor>> mSnapshot;
+    std::map<std::string, std::shared_ptr<CheckpointTensor>> mSnapshotIndex;
+    // keys changed since the last full checkpoint
+    std::set<std::string> mDirty;
+    std::string mBasePath;
+    int mBaseStep = -1;
+    // one writer per snapshot slot, each one starts writing when the previous write is done
+    std::thread mWriter[2];
+    int mWriteSlot = 0;
+    std::shared_future<void> mLastWrite;
+    std::atomic<bool> mWriteSuccess{true};
+
+    // compiled step, all of them are computed by one cache
+    std::vector<Express::VARP> mCompiledInputs;
+    Express::VARP mCompiledLoss;
+    std::vector<std::pair<Express::VARP, Express::VARP>> mCompiledUpdates;
 };
 
 } // namespace Train
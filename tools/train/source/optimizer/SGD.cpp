@@ -7,6 +7,7 @@
 //
 
 #include "SGD.hpp"
+#include <string.h>
 #include "OpGrad.hpp"
 #include <MNN/expr/ExecutorScope.hpp>
 #define MNN_OPEN_TIME_TRACE
@@ -22,6 +23,21 @@ SGD::SGD(std::shared_ptr<Module> module) : ParameterOptimizer(module) {
     }
 }
 
+void SGD::onGetState(std::vector<std::pair<std::string, Express::VARP>>& state) {
+    for (auto& iter : mHistory) {
+        state.emplace_back("momentum/" + parameterKey(iter.first), iter.second);
+    }
+}
+
+void SGD::onSetState(const std::map<std::string, Express::VARP>& state) {
+    for (auto& iter : mHistory) {
+        auto value = state.find("momentum/" + parameterKey(iter.first));
+        if (value != state.end()) {
+            iter.second = value->second;
+        }
+    }
+}
+
 void SGD::setLearningRate(float rate) {
     mLearningRate = rate;
 }
@@ -79,7 +95,123 @@ Express::VARP SGD::onComputeUpdateValue(Express::VARP param, Express::VARP grad)
     return mHistory[param];
 }
 
+Express::VARP SGD::onCompileUpdateValue(Express::VARP param, Express::VARP grad,
+                                        std::vector<std::pair<Express::VARP, Express::VARP>>& updates) {
+    auto history = mHistory[param];
+    auto next    = mLearningRateLeaf * grad + _Const(mMomentum, {}, NCHW) * history;
+    updates.emplace_back(history, next);
+    return next;
+}
+
+void SGD::compileUpdates(Express::VARP loss, std::vector<std::pair<Express::VARP, Express::VARP>>& updates) {
+    auto grad = OpGrad::grad(loss, trainable(), mGradBlockExprName);
+    if (nullptr == mLearningRateLeaf) {
+        mLearningRateLeaf = _Const(mLearningRate, {}, NCHW);
+    }
+    auto parameters = module()->parameters();
+    auto execOrder  = Variable::getExecuteOrder({loss});
+    std::map<EXPRP, VARP> paramExpr;
+    for (auto param : parameters) {
+        paramExpr.insert(std::make_pair(param->expr().first, param));
+    }
+    for (auto iter = execOrder.rbegin(); iter != execOrder.rend(); iter++) {
+        auto param = paramExpr.find(*iter);
+        if (param == paramExpr.end() || grad.find(param->second) == grad.end()) {
+            continue;
+        }
+        auto p                  = param->second;
+        auto addWeightDecayGrad = regularizeParameters(p, grad[p]);
+        auto updateValue        = this->onCompileUpdateValue(p, addWeightDecayGrad, updates);
+        updates.emplace_back(p, p - updateValue);
+    }
+}
+
+bool SGD::onCompile(Express::VARP loss, std::vector<std::pair<Express::VARP, Express::VARP>>& updates) {
+    compileUpdates(loss, updates);
+    return true;
+}
+
+void SGD::onCompiledStep() {
+    mLearningRateLeaf->writeMap<float>()[0] = mLearningRate;
+}
+
+// compute vars under the heuristic plan and keep their values as constants. The Profiler parses the per-op log
+// between the two markers, so every way of getting the next parameters prints them
+static bool _computeUnderPlan(const std::vector<VARP>& vars, std::vector<VARP>& results, bool eagerOutputs) {
+    MNN_DEBUG_PRINT("%s:%s: begin prepare compute\n", __FILE_NAME__, __FUNCTION__ );
+    ExecutorScope::Current()->setHeuristicAlloc(true);
+    ExecutorScope::Current()->setEagerOutputs(eagerOutputs);
+    Variable::prepareCompute(vars);
+    ExecutorScope::Current()->setEagerOutputs(false);
+    MNN_PRINT("%s:%s: finish prepare compute & start read-map\n", __FILE_NAME__, __FUNCTION__ );
+    results.resize(vars.size());
+    for (int i = 0; i < vars.size(); ++i) {
+        auto info = vars[i]->getInfo();
+        auto ptr  = vars[i]->readMap<void>();
+        if (nullptr == ptr) {
+            MNN_ERROR("Compute error in SGD\n");
+            ExecutorScope::Current()->setHeuristicAlloc(false);
+            return false;
+        }
+        results[i] = _Const(ptr, info->dim, info->order, info->type);
+    }
+    ExecutorScope::Current()->setHeuristicAlloc(false);
+    MNN_PRINT("%s:%s: finish read-map & start replace\n", __FILE_NAME__, __FUNCTION__ );
+    return true;
+}
+
+std::map<Express::VARP, Express::VARP> SGD::eagerNextParameter(Express::VARP loss) {
+    auto parameters = module()->parameters();
+    std::vector<VARP> prepareCompute;
+    for (auto iter : parameters) {
+        if (iter->expr().first->get() != nullptr) {
+            prepareCompute.emplace_back(iter);
+        }
+    }
+    auto replaced = prepareCompute.size();
+    // the same update as compile: optimizer state comes in as leaves, their next values are outputs
+    std::vector<std::pair<VARP, VARP>> updates;
+    compileUpdates(loss, updates);
+    this->onCompiledStep();
+    for (auto& iter : updates) {
+        prepareCompute.emplace_back(iter.second);
+    }
+    std::vector<VARP> results;
+    if (!_computeUnderPlan(prepareCompute, results, true)) {
+        return {};
+    }
+    for (int i = 0; i < replaced; ++i) {
+        Variable::replace(prepareCompute[i], results[i]);
+    }
+    std::map<VARP, VARP> next;
+    // read every result before writing any back, a write marks the caches reading the state dirty
+    std::vector<std::pair<VARP, const void*>> states;
+    for (int i = 0; i < updates.size(); ++i) {
+        auto& result = results[replaced + i];
+        if (trainable().find(updates[i].first) != trainable().end()) {
+            next[updates[i].first] = result;
+            continue;
+        }
+        auto ptr = result->readMap<void>();
+        if (nullptr == ptr) {
+            MNN_ERROR("Compute error in SGD\n");
+            return {};
+        }
+        states.emplace_back(updates[i].first, ptr);
+    }
+    // optimizer state, written in place through writeMap like a compiled step does
+    for (auto& state : states) {
+        auto info = state.first->getInfo();
+        auto dst  = state.first->writeMap<void>();
+        ::memcpy(dst, state.second, info->size * info->type.bytes());
+    }
+    return next;
+}
+
 std::map<Express::VARP, Express::VARP> SGD::onGetNextParameter(Express::VARP loss) {
+    if (mEagerUpdate) {
+        return eagerNextParameter(loss);
+    }
 //    ExecutorScope::Current()->setHeuristicAlloc(true);
     MNN_DEBUG_PRINT("%s:%s: begin compute grad graph\n", __FILE_NAME__, __FUNCTION__ );
     auto grad = OpGrad::grad(loss, trainable(), mGradBlockExprName);
@@ -119,31 +251,10 @@ std::map<Express::VARP, Express::VARP> SGD::onGetNextParameter(Express::VARP los
 //        prepareCompute.emplace_back(iter.second);
 //    }
 //    MNN_PRINT("%s:%s: prepareCompute.size() = %d\ttrainable.size() = %d\n",  __FILE_NAME__, __FUNCTION__ , prepareCompute.size(), trainable().size());
-    MNN_DEBUG_PRINT("%s:%s: begin setHeuristicAlloc\n", __FILE_NAME__, __FUNCTION__ );
-    ExecutorScope::Current()->setHeuristicAlloc(true);
-    MNN_DEBUG_PRINT("%s:%s: begin prepare compute\n", __FILE_NAME__, __FUNCTION__ );
-    Variable::prepareCompute(prepareCompute);
-    MNN_PRINT("%s:%s: finish prepare compute & start read-map\n", __FILE_NAME__, __FUNCTION__ );
-    std::vector<VARP> replaceOp(prepareCompute.size());
-    {
-//        AUTOTIME;
-        for (int i=0; i<prepareCompute.size(); ++i) {
-//            AUTOTIME;
-            auto info = prepareCompute[i]->getInfo();
-            auto ptr = prepareCompute[i]->readMap<void>();
-//#if defined(DEBUG_EXECUTION_DETAIL)
-//            break;
-//#endif
-            if (nullptr == ptr) {
-                MNN_ERROR("Compute error in SGD\n");
-                return {};
-            }
-            auto newVar = _Const(ptr, info->dim, info->order, info->type);
-            replaceOp[i]= newVar;
-        }
+    std::vector<VARP> replaceOp;
+    if (!_computeUnderPlan(prepareCompute, replaceOp, false)) {
+        return {};
     }
-    ExecutorScope::Current()->setHeuristicAlloc(false);
-    MNN_PRINT("%s:%s: finish read-map & start replace\n", __FILE_NAME__, __FUNCTION__ );
     for (int i=0; i<prepareCompute.size(); ++i) {
 //        MNN_ASSERT(prepareCompute[i]->expr().first->outputSize() == replaceOp[i]->expr().first->outputSize())
         Variable::replace(prepareCompute[i], replaceOp[i]);
@@ -48,17 +48,40 @@ public:
         mGradBlockExprName = std::move(block);
     }
 
+    /**
+     * @brief build the update of every parameter into the backward graph, so that it runs as soon as the
+     * gradient is final and the gradient is freed right after, instead of keeping all gradients alive until
+     * the backward pass ends. The updated values are copied out of the memory pool after their last use.
+     */
+    void setEagerUpdate(bool flag) {
+        mEagerUpdate = flag;
+    }
+
 protected:
+    virtual void onGetState(std::vector<std::pair<std::string, Express::VARP>>& state) override;
+    virtual void onSetState(const std::map<std::string, Express::VARP>& state) override;
+    virtual bool onCompile(Express::VARP loss, std::vector<std::pair<Express::VARP, Express::VARP>>& updates) override;
+    virtual void onCompiledStep() override;
+    /** like onComputeUpdateValue, but reads the history leaves and appends their next values to updates */
+    virtual Express::VARP onCompileUpdateValue(Express::VARP param, Express::VARP grad,
+                                               std::vector<std::pair<Express::VARP, Express::VARP>>& updates);
+    /** the gradients of loss and the update of every trainable parameter, in backward order, for onCompile */
+    void compileUpdates(Express::VARP loss, std::vector<std::pair<Express::VARP, Express::VARP>>& updates);
+    std::map<Express::VARP, Express::VARP> eagerNextParameter(Express::VARP loss);
+
     float mLearningRate                        = 0.001f;
     float mMomentum                            = 0;
     float mWeightDecay                         = 0;
     RegularizationMethod mRegularizationMethod = L2;
     std::map<MNN::Express::VARP, MNN::Express::VARP> mHistory;
+    // step size read by the compiled update, written before every compiled step
+    Express::VARP mLearningRateLeaf;
 
     // For Cache
     const Express::Expr* mLoss = nullptr;
     int mLossFromIndex         = 0;
     std::string mGradBlockExprName;
+    bool mEagerUpdate = false;
 };
 
 } // namespace Train
@@ -0,0 +1,216 @@
+//
+//  TrainFusion.cpp
+//  MNN
+//
+//  Created by MNN on 2021/07/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "TrainFusion.hpp"
+#include <math.h>
+#include <set>
+#include "MNN_generated.h"
+using namespace MNN::Express;
+namespace MNN {
+namespace Train {
+
+static std::set<Expr*> _outputExprs(const std::vector<VARP>& outputs) {
+    std::set<Expr*> res;
+    for (auto& v : outputs) {
+        res.insert(v->expr().first.get());
+    }
+    return res;
+}
+
+// A producer can only be merged into its consumer if nothing else reads it
+static bool _onlyFeeds(EXPRP producer, Expr* consumer, const std::set<Expr*>& outputExprs) {
+    if (outputExprs.find(producer.get()) != outputExprs.end()) {
+        return false;
+    }
+    for (auto& weak : producer->outputs()) {
+        auto next = weak.lock();
+        if (nullptr != next && next.get() != consumer) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool _isConvolution(const Op* op) {
+    return nullptr != op && (op->type() == OpType_Convolution || op->type() == OpType_ConvolutionDepthwise);
+}
+
+// Replace expr by the same op on other inputs, keeping its names
+static void _replaceKeepName(EXPRP expr, EXPRP newExpr, const std::string& name) {
+    for (int i = 0; i < expr->outputSize(); ++i) {
+        Variable::create(newExpr, i)->setName(expr->outputName(i));
+    }
+    newExpr->setName(name);
+    Expr::replace(expr, newExpr);
+}
+
+static bool _affine(const Op* op, int channel, std::vector<float>& alpha, std::vector<float>& bias) {
+    alpha.resize(channel);
+    bias.resize(channel);
+    if (op->type() == OpType_BatchNorm) {
+        auto bn = op->main_as_BatchNorm();
+        if (nullptr == bn || nullptr == bn->slopeData() || nullptr == bn->meanData() || nullptr == bn->varData() ||
+            nullptr == bn->biasData() || bn->slopeData()->size() != channel || bn->meanData()->size() != channel ||
+            bn->varData()->size() != channel || bn->biasData()->size() != channel) {
+            return false;
+        }
+        for (int i = 0; i < channel; ++i) {
+            float sqrtVar = sqrtf(bn->varData()->data()[i] + bn->epsilon());
+            alpha[i]      = bn->slopeData()->data()[i] / sqrtVar;
+            bias[i]       = bn->biasData()->data()[i] - alpha[i] * bn->meanData()->data()[i];
+        }
+        return true;
+    }
+    auto scale = op->main_as_Scale();
+    if (nullptr == scale || nullptr == scale->scaleData() || scale->scaleData()->size() != channel) {
+        return false;
+    }
+    bool hasBias = nullptr != scale->biasData() && scale->biasData()->size() == channel;
+    for (int i = 0; i < channel; ++i) {
+        alpha[i] = scale->scaleData()->data()[i];
+        bias[i]  = hasBias ? scale->biasData()->data()[i] : 0.0f;
+    }
+    return true;
+}
+
+int TrainFusion::foldBatchNorm(const std::vector<VARP>& outputs) {
+    auto exprs       = Variable::getExecuteOrder(outputs);
+    auto outputExprs = _outputExprs(outputs);
+    int count        = 0;
+    for (auto expr : exprs) {
+        auto op = expr->get();
+        if (nullptr == op || (op->type() != OpType_BatchNorm && op->type() != OpType_Scale) ||
+            expr->inputs().size() != 1) {
+            continue;
+        }
+        auto convExpr = expr->inputs()[0]->expr().first;
+        if (!_isConvolution(convExpr->get()) || convExpr->inputs().size() != 1 ||
+            !_onlyFeeds(convExpr, expr.get(), outputExprs)) {
+            continue;
+        }
+        std::unique_ptr<OpT> conv(convExpr->get()->UnPack());
+        auto conv2D = conv->main.AsConvolution2D();
+        auto common = conv2D->common.get();
+        if (common->relu || common->relu6 || nullptr != conv2D->quanParameter.get() || conv2D->weight.empty()) {
+            continue;
+        }
+        int outputCount = common->outputCount;
+        std::vector<float> alpha, bias;
+        if (!_affine(op, outputCount, alpha, bias)) {
+            continue;
+        }
+        conv2D->bias.resize(outputCount, 0.0f);
+        int weightPartSize = (int)conv2D->weight.size() / outputCount;
+        for (int i = 0; i < outputCount; ++i) {
+            conv2D->bias[i] = conv2D->bias[i] * alpha[i] + bias[i];
+            for (int j = 0; j < weightPartSize; ++j) {
+                conv2D->weight[i * weightPartSize + j] *= alpha[i];
+            }
+        }
+        // Keep the convolution's name, the trainable weight and bias are named after it
+        _replaceKeepName(expr, Expr::create(conv.get(), convExpr->inputs()), convExpr->name());
+        count++;
+    }
+    return count;
+}
+
+int TrainFusion::fuseActivation(const std::vector<VARP>& outputs) {
+    auto exprs       = Variable::getExecuteOrder(outputs);
+    auto outputExprs = _outputExprs(outputs);
+    int count        = 0;
+    for (auto expr : exprs) {
+        auto op = expr->get();
+        if (nullptr == op || expr->inputs().size() != 1) {
+            continue;
+        }
+        bool relu6 = false;
+        if (op->type() == OpType_ReLU) {
+            if (nullptr != op->main_as_Relu() && op->main_as_Relu()->slope() != 0.0f) {
+                continue;
+            }
+        } else if (op->type() == OpType_ReLU6) {
+            auto param = op->main_as_Relu6();
+            if (nullptr != param && (param->minValue() != 0.0f || param->maxValue() != 6.0f)) {
+                continue;
+            }
+            relu6 = true;
+        } else {
+            continue;
+        }
+        auto convExpr = expr->inputs()[0]->expr().first;
+        // Only the trainable form, the constant one keeps its activation through OpConverter
+        if (!_isConvolution(convExpr->get()) || convExpr->inputs().size() < 2 ||
+            !_onlyFeeds(convExpr, expr.get(), outputExprs)) {
+            continue;
+        }
+        std::unique_ptr<OpT> conv(convExpr->get()->UnPack());
+        auto common = conv->main.AsConvolution2D()->common.get();
+        if (common->relu || common->relu6) {
+            continue;
+        }
+        common->relu  = !relu6;
+        common->relu6 = relu6;
+        _replaceKeepName(expr, Expr::create(conv.get(), convExpr->inputs()), expr->name());
+        count++;
+    }
+    return count;
+}
+
+// The earliest variable of a ConvertTensor chain ending in var that has var's format
+static VARP _skipConvert(VARP var) {
+    auto info = var->getInfo();
+    if (nullptr == info) {
+        return var;
+    }
+    auto order   = info->order;
+    auto type    = info->type;
+    auto source  = var;
+    auto current = var;
+    while (true) {
+        auto expr = current->expr().first;
+        if (nullptr == expr->get() || expr->get()->type() != OpType_ConvertTensor) {
+            break;
+        }
+        current          = expr->inputs()[0];
+        auto currentInfo = current->getInfo();
+        if (nullptr == currentInfo) {
+            break;
+        }
+        if (currentInfo->order == order && currentInfo->type == type) {
+            source = current;
+        }
+    }
+    return source;
+}
+
+int TrainFusion::eliminateConvert(const std::vector<VARP>& outputs) {
+    auto exprs = Variable::getExecuteOrder(outputs);
+    int count  = 0;
+    for (auto expr : exprs) {
+        if (nullptr == expr->get()) {
+            continue;
+        }
+        auto inputs  = expr->inputs();
+        bool changed = false;
+        for (auto& input : inputs) {
+            auto source = _skipConvert(input);
+            if (source.get() != input.get()) {
+                input   = source;
+                changed = true;
+                count++;
+            }
+        }
+        if (changed) {
+            _replaceKeepName(expr, Expr::create(expr->extra(), std::move(inputs), expr->outputSize()), expr->name());
+        }
+    }
+    return count;
+}
+
+} // namespace Train
+} // namespace MNN
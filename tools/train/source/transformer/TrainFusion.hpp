@@ -0,0 +1,32 @@
+//
+//  TrainFusion.hpp
+//  MNN
+//
+//  Created by MNN on 2021/07/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef TrainFusion_hpp
+#define TrainFusion_hpp
+#include <MNN/MNNDefine.h>
+#include <MNN/expr/Expr.hpp>
+
+namespace MNN {
+namespace Train {
+// Rewrites a graph loaded from an inference model before OpGrad::grad, each pass returns the number of rewrites
+class MNN_PUBLIC TrainFusion {
+public:
+    // Fold BatchNorm / Scale into the constant weight convolution (or depthwise) before it,
+    // their statistics are frozen in the model and they have no grad
+    static int foldBatchNorm(const std::vector<Express::VARP>& outputs);
+
+    // Fold ReLU / ReLU6 into the trainable convolution before it, ConvGrad masks the grad by the output,
+    // so the pre-activation tensor needn't be kept for backward
+    static int fuseActivation(const std::vector<Express::VARP>& outputs);
+
+    // Let ops read past ConvertTensor chains that end in the format they started from
+    static int eliminateConvert(const std::vector<Express::VARP>& outputs);
+};
+} // namespace Train
+} // namespace MNN
+#endif
@@ -8,6 +8,7 @@
 
 #include "Transformer.hpp"
 #include "OpConverter.hpp"
+#include "TrainFusion.hpp"
 #include "MNN_generated.h"
 using namespace MNN::Express;
 namespace MNN {
@@ -23,6 +24,12 @@ public:
         return Cost();
     }
     virtual bool onExecute(const std::vector<VARP>& outputs, std::shared_ptr<Parameters> p) override {
+        if (mConfig.fuse) {
+            auto number = TrainFusion::foldBatchNorm(outputs);
+            if (number > 0) {
+                MNN_PRINT("Fold %d BatchNorm / Scale into convolution\n", number);
+            }
+        }
         auto exprs = Variable::getExecuteOrder(outputs);
         {
             // Turn convolution be trainable convolution
@@ -33,6 +40,13 @@ public:
                 }
             }
         }
+        if (mConfig.fuse) {
+            auto activations = TrainFusion::fuseActivation(outputs);
+            auto converts    = TrainFusion::eliminateConvert(outputs);
+            if (activations > 0 || converts > 0) {
+                MNN_PRINT("Fuse %d activation into convolution, skip %d tensor convert\n", activations, converts);
+            }
+        }
         exprs                = Variable::getExecuteOrder(outputs);
         auto& variableLimits = mConfig.variableLimits;
         // Collect Const Variable and turn to Trainable
@@ -16,6 +16,9 @@ class MNN_PUBLIC Transformer {
 public:
     struct TrainConfig {
         std::vector<std::string> variableLimits;
+        // fold frozen BatchNorm, fuse activations into trainable convolutions and skip redundant tensor converts,
+        // off by default: a folded BatchNorm can't be trained or exported as BatchNorm any more
+        bool fuse = false;
     };
 
     static std::shared_ptr<Express::Optimizer> turnModelToTrainable(TrainConfig config);